@@ -0,0 +1,85 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <franka/admittance_controller.h>
+#include <franka/exception.h>
+#include <franka/robot.h>
+
+#include "examples_common.h"
+
+/**
+ * @example admittance_guiding.cpp
+ * An example showing how to guide the robot by hand with franka::AdmittanceController. Pressing
+ * Enter toggles between light and heavy virtual dynamics while the robot is being guided. After 30
+ * seconds, the motion finishes as soon as the robot is released and has come to rest.
+ *
+ * @warning Before executing this example, make sure there is enough space around the robot.
+ */
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <robot-hostname>" << std::endl;
+    return -1;
+  }
+  try {
+    franka::Robot robot(argv[1]);
+    setDefaultBehavior(robot);
+
+    // First move the robot to a suitable joint configuration
+    std::array<double, 7> q_goal = {{0, -M_PI_4, 0, -3 * M_PI_4, 0, M_PI_2, M_PI_4}};
+    MotionGenerator motion_generator(0.5, q_goal);
+    std::cout << "WARNING: This example will move the robot! "
+              << "Please make sure to have the user stop button at hand!" << std::endl
+              << "Press Enter to continue..." << std::endl;
+    std::cin.ignore();
+    robot.control(motion_generator);
+    std::cout << "Finished moving to initial joint configuration." << std::endl;
+
+    franka::AdmittanceParameters light;
+    light.workspace_minimum = {{0.2, -0.4, 0.1}};
+    light.workspace_maximum = {{0.7, 0.4, 0.8}};
+    franka::AdmittanceParameters heavy = light;
+    for (size_t i = 0; i < 6; i++) {
+      heavy.mass[i] *= 4.0;
+      heavy.damping[i] *= 3.0;
+    }
+    auto controller = std::make_shared<franka::AdmittanceController>(light);
+
+    // Parameters can be changed from another thread while the control loop is running. The thread
+    // blocks on std::cin, so it is detached and shares ownership of the controller.
+    std::thread parameter_thread([controller, light, heavy]() {
+      bool use_heavy = false;
+      while (std::cin.get() != EOF) {
+        use_heavy = !use_heavy;
+        controller->setParameters(use_heavy ? heavy : light);
+        std::cout << (use_heavy ? "Heavy" : "Light") << " dynamics" << std::endl;
+      }
+    });
+    parameter_thread.detach();
+
+    std::cout << "Guide the robot by hand. Press Enter to toggle the virtual dynamics." << std::endl;
+    double time = 0.0;
+    robot.control([&](const franka::RobotState& robot_state,
+                      franka::Duration period) -> franka::CartesianVelocities {
+      time += period.toSec();
+      franka::CartesianVelocities velocities = (*controller)(robot_state, period);
+      bool at_rest = std::all_of(velocities.O_dP_EE.cbegin(), velocities.O_dP_EE.cend(),
+                                 [](double v) { return std::abs(v) < 1e-3; });
+      if (time >= 30.0 && at_rest) {
+        std::cout << std::endl << "Finished motion, shutting down example" << std::endl;
+        return franka::MotionFinished(velocities);
+      }
+      return velocities;
+    });
+  } catch (const franka::Exception& e) {
+    std::cout << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
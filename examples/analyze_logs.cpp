@@ -0,0 +1,55 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <franka/exception.h>
+#include <franka/log_analytics.h>
+#include <franka/model.h>
+
+/**
+ * @example analyze_logs.cpp
+ * An example showing how to analyze a set of log files in parallel. Prints the control command
+ * success rate per hour and the residuals between the logged joint torques and the torques
+ * calculated with the model library of the robot the logs have been recorded with.
+ */
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <model-library> <log-file> [<log-file> ...]"
+              << std::endl;
+    return -1;
+  }
+
+  try {
+    franka::Model model(argv[1]);
+    franka::LogDataset dataset(std::vector<std::string>(argv + 2, argv + argc));
+    std::cout << "Analyzing " << dataset.size() << " records using "
+              << franka::LogDataset::workerCount(0) << " threads." << std::endl;
+
+    std::cout << "Control command success rate per hour:" << std::endl;
+    for (const franka::SuccessRateBucket& bucket :
+         franka::computeSuccessRates(dataset, std::chrono::hours(1))) {
+      std::cout << "  " << std::chrono::duration_cast<std::chrono::hours>(bucket.start).count()
+                << " h: mean " << bucket.mean << ", min " << bucket.min << " (" << bucket.samples
+                << " records)" << std::endl;
+    }
+
+    franka::ModelResiduals residuals = franka::computeModelResiduals(dataset, model);
+    std::cout << "Gravity torque residuals of " << residuals.samples << " records:" << std::endl;
+    for (size_t i = 0; i < 7; i++) {
+      std::cout << "  Joint " << i + 1 << ": mean " << residuals.gravity.mean[i] << " Nm, RMS "
+                << residuals.gravity.rms[i] << " Nm, max " << residuals.gravity.max[i] << " Nm"
+                << std::endl;
+    }
+    std::cout << "End effector translation RMS " << residuals.translational_rms << " m, max "
+              << residuals.translational_max << " m" << std::endl;
+  } catch (const franka::Exception& e) {
+    std::cout << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
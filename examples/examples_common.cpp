@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <stdexcept>
 
 #include <franka/exception.h>
 #include <franka/robot.h>
@@ -19,8 +20,10 @@ void setDefaultBehavior(franka::Robot& robot) {
   robot.setCartesianImpedance({{3000, 3000, 3000, 300, 300, 300}});
 }
 
-MotionGenerator::MotionGenerator(double speed_factor, const std::array<double, 7> q_goal)
-    : q_goal_(q_goal.data()) {
+MotionGenerator::MotionGenerator(double speed_factor,
+                                 const std::array<double, 7> q_goal,
+                                 franka::TrajectoryCache* cache)
+    : q_goal_(q_goal.data()), speed_factor_(speed_factor), cache_(cache) {
   dq_max_ *= speed_factor;
   ddq_max_start_ *= speed_factor;
   ddq_max_goal_ *= speed_factor;
@@ -111,6 +114,44 @@ void MotionGenerator::calculateSynchronizedValues() {
   }
 }
 
+void MotionGenerator::recordProfile(double t) {
+  // Also fills in the samples of lost control cycles.
+  size_t size = static_cast<size_t>(std::lround(t * 1000.0)) + 1;
+  Vector7d delta_q_d;
+  while (recorded_profile_.size() < size) {
+    calculateDesiredValues(recorded_profile_.size() / 1000.0, &delta_q_d);
+    recorded_profile_.emplace_back();
+    Eigen::VectorXd::Map(recorded_profile_.back().data(), 7) = delta_q_d;
+  }
+}
+
+bool MotionGenerator::replayProfile(uint64_t index, Vector7d* delta_q_d) const {
+  // The cached profile moves from its own start to its own goal, which differ from the actual ones
+  // by up to the cache resolution. The remaining difference to the actual goal is added with the
+  // progress of each joint along the profile, so that the motion still starts smoothly and ends
+  // exactly at the goal. Joints that do not move in the profile follow the progress of the joint
+  // with the largest motion.
+  size_t last = cached_profile_.size() - 1;
+  Vector7d sample(cached_profile_.at(franka::Duration(index)).data());
+  Vector7d cached_delta_q(cached_profile_[last].data());
+
+  Eigen::Index reference_joint;
+  cached_delta_q.cwiseAbs().maxCoeff(&reference_joint);
+  double reference_progress = 1.0;
+  if (std::abs(cached_delta_q[reference_joint]) >= kDeltaQMotionFinished) {
+    reference_progress = sample[reference_joint] / cached_delta_q[reference_joint];
+  }
+
+  for (size_t i = 0; i < 7; i++) {
+    double progress = reference_progress;
+    if (std::abs(cached_delta_q[i]) >= kDeltaQMotionFinished) {
+      progress = sample[i] / cached_delta_q[i];
+    }
+    (*delta_q_d)[i] = sample[i] + progress * (delta_q_[i] - cached_delta_q[i]);
+  }
+  return index >= last;
+}
+
 franka::JointPositions MotionGenerator::operator()(const franka::RobotState& robot_state,
                                                    franka::Duration period) {
   time_ += period.toSec();
@@ -118,11 +159,40 @@ franka::JointPositions MotionGenerator::operator()(const franka::RobotState& rob
   if (time_ == 0.0) {
     q_start_ = Vector7d(robot_state.q_d.data());
     delta_q_ = q_goal_ - q_start_;
-    calculateSynchronizedValues();
+    if (cache_ != nullptr) {
+      std::array<double, 7> q_goal;
+      Eigen::VectorXd::Map(&q_goal[0], 7) = q_goal_;
+      cache_key_ = cache_->makeKey(robot_state.q_d, q_goal, {speed_factor_});
+      cached_profile_ = cache_->find(cache_key_);
+    }
+    if (cached_profile_.empty()) {
+      calculateSynchronizedValues();
+      if (cache_ != nullptr) {
+        recorded_profile_.clear();
+        recorded_profile_.reserve(static_cast<size_t>(std::ceil(t_f_sync_.maxCoeff() * 1000.0)) +
+                                  2);
+      }
+    }
   }
 
   Vector7d delta_q_d;
-  bool motion_finished = calculateDesiredValues(time_, &delta_q_d);
+  bool motion_finished;
+  if (!cached_profile_.empty()) {
+    motion_finished =
+        replayProfile(static_cast<uint64_t>(std::lround(time_ * 1000.0)), &delta_q_d);
+  } else {
+    motion_finished = calculateDesiredValues(time_, &delta_q_d);
+    if (cache_ != nullptr) {
+      recordProfile(time_);
+      if (motion_finished) {
+        try {
+          cache_->insert(cache_key_, recorded_profile_);
+        } catch (const std::invalid_argument&) {
+          // The profile is too long for the cache, so it is computed again next time.
+        }
+      }
+    }
+  }
 
   std::array<double, 7> joint_positions;
   Eigen::VectorXd::Map(&joint_positions[0], 7) = (q_start_ + delta_q_d);
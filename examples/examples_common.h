@@ -3,6 +3,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include <Eigen/Core>
 
@@ -10,6 +11,7 @@
 #include <franka/duration.h>
 #include <franka/robot.h>
 #include <franka/robot_state.h>
+#include <franka/trajectory_cache.h>
 
 /**
  * @file examples_common.h
@@ -35,8 +37,14 @@ class MotionGenerator {
    *
    * @param[in] speed_factor General speed factor in range [0, 1].
    * @param[in] q_goal Target joint positions.
+   * @param[in] cache Optional cache for the motion profile. Profiles are stored as offsets from the
+   * start configuration. On a hit, the cached profile is replayed instead of being computed. As the
+   * cache only matches start and goal to within its resolution, the replayed profile is corrected
+   * to end exactly at q_goal.
    */
-  MotionGenerator(double speed_factor, const std::array<double, 7> q_goal);
+  MotionGenerator(double speed_factor,
+                  const std::array<double, 7> q_goal,
+                  franka::TrajectoryCache* cache = nullptr);
 
   /**
    * Sends joint position calculations
@@ -54,6 +62,8 @@ class MotionGenerator {
 
   bool calculateDesiredValues(double t, Vector7d* delta_q_d) const;
   void calculateSynchronizedValues();
+  void recordProfile(double t);
+  bool replayProfile(uint64_t index, Vector7d* delta_q_d) const;
 
   static constexpr double kDeltaQMotionFinished = 1e-6;
   const Vector7d q_goal_;
@@ -69,6 +79,12 @@ class MotionGenerator {
 
   double time_ = 0.0;
 
+  const double speed_factor_;
+  franka::TrajectoryCache* cache_;
+  franka::TrajectoryCache::Key cache_key_;
+  franka::TrajectoryCache::Profile cached_profile_;
+  std::vector<franka::TrajectoryCache::Sample> recorded_profile_;
+
   Vector7d dq_max_ = (Vector7d() << 2.0, 2.0, 2.0, 2.0, 2.5, 2.5, 2.5).finished();
   Vector7d ddq_max_start_ = (Vector7d() << 5, 5, 5, 5, 5, 5, 5).finished();
   Vector7d ddq_max_goal_ = (Vector7d() << 5, 5, 5, 5, 5, 5, 5).finished();
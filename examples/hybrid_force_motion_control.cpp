@@ -0,0 +1,77 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#include <franka/duration.h>
+#include <franka/exception.h>
+#include <franka/hybrid_force_motion_controller.h>
+#include <franka/model.h>
+#include <franka/robot.h>
+
+#include "examples_common.h"
+
+/**
+ * @example hybrid_force_motion_control.cpp
+ * An example showing how to press on a horizontal surface with franka::HybridForceMotionController.
+ * The robot applies a force in negative z direction while holding its position in x and y and its
+ * orientation.
+ *
+ * @warning: make sure that the end effector is close to a horizontal rigid surface before starting.
+ */
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <robot-hostname>" << std::endl;
+    return -1;
+  }
+
+  constexpr double kDesiredForce{-5.0};
+  constexpr double kRampTime{2.0};
+  constexpr double kDuration{10.0};
+
+  try {
+    franka::Robot robot(argv[1]);
+    setDefaultBehavior(robot);
+    franka::Model model = robot.loadModel();
+
+    robot.setCollisionBehavior({{100.0, 100.0, 100.0, 100.0, 100.0, 100.0, 100.0}},
+                               {{100.0, 100.0, 100.0, 100.0, 100.0, 100.0, 100.0}},
+                               {{100.0, 100.0, 100.0, 100.0, 100.0, 100.0}},
+                               {{100.0, 100.0, 100.0, 100.0, 100.0, 100.0}});
+
+    franka::HybridForceMotionController controller;
+    franka::ModelQuantities quantities;
+    double time = 0.0;
+    auto control_callback = [&](const franka::RobotState& robot_state,
+                                franka::Duration period) -> franka::Torques {
+      time += period.toSec();
+
+      // Ramp up the force smoothly.
+      double force = kDesiredForce * (1.0 - std::cos(M_PI * std::min(time / kRampTime, 1.0))) / 2.0;
+      controller.setDesiredWrench({{0.0, 0.0, force, 0.0, 0.0, 0.0}});
+
+      model.computeQuantities(robot_state, &quantities);
+      franka::Torques torques = controller(robot_state, period, quantities);
+      if (time >= kDuration) {
+        std::cout << std::endl << "Finished motion, shutting down example" << std::endl;
+        return franka::MotionFinished(torques);
+      }
+      return torques;
+    };
+
+    std::cout << "WARNING: Make sure that the end effector is close to a horizontal rigid surface "
+                 "before starting. Keep in mind that collision thresholds are set to high values."
+              << std::endl
+              << "Press Enter to continue..." << std::endl;
+    std::cin.ignore();
+    robot.control(control_callback);
+  } catch (const franka::Exception& e) {
+    std::cout << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <franka/exception.h>
+#include <franka/log_file.h>
+#include <franka/log_merge.h>
+
+/**
+ * @example merge_logs.cpp
+ * An example showing how to merge log files of several robots into one CSV table with a common
+ * host timeline. The log files can be recorded with franka::LogFileWriter.
+ */
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <output-csv-file> <log-file> [<log-file> ...]"
+              << std::endl;
+    return -1;
+  }
+
+  try {
+    std::vector<std::unique_ptr<std::ifstream>> files;
+    std::vector<std::unique_ptr<franka::LogFileReader>> readers;
+    std::vector<std::unique_ptr<franka::RobotStateSource>> sources;
+    std::vector<franka::LogSource*> source_pointers;
+    for (int i = 2; i < argc; i++) {
+      files.emplace_back(new std::ifstream(argv[i], std::ios::binary));
+      if (!*files.back()) {
+        std::cerr << "Could not open " << argv[i] << std::endl;
+        return -1;
+      }
+      readers.emplace_back(new franka::LogFileReader(*files.back()));
+      sources.emplace_back(
+          new franka::RobotStateSource("robot" + std::to_string(i - 2), *readers.back()));
+      source_pointers.push_back(sources.back().get());
+    }
+
+    std::ofstream output(argv[1]);
+    size_t rows = franka::mergeLogs(source_pointers, output);
+    std::cout << "Wrote " << rows << " rows to " << argv[1] << std::endl;
+  } catch (const franka::Exception& e) {
+    std::cout << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
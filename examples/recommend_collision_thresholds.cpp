@@ -0,0 +1,60 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <franka/collision_thresholds.h>
+#include <franka/exception.h>
+
+/**
+ * @example recommend_collision_thresholds.cpp
+ * An example showing how to derive collision thresholds from log files of collision-free motions.
+ * The log files can be recorded with franka::LogFileWriter.
+ */
+
+namespace {
+
+template <size_t N>
+void printArray(const std::string& name, const std::array<double, N>& array) {
+  std::cout << name << " = {{";
+  for (size_t i = 0; i < N; i++) {
+    std::cout << array[i] << (i + 1 < N ? ", " : "");
+  }
+  std::cout << "}};" << std::endl;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <false-trigger-rate> <log-file> [<log-file> ...]"
+              << std::endl;
+    return -1;
+  }
+
+  try {
+    std::vector<std::string> log_files(argv + 2, argv + argc);
+    franka::CollisionThresholds thresholds =
+        franka::recommendCollisionThresholds(log_files, std::stod(argv[1]));
+
+    printArray("lower_torque_thresholds_acceleration",
+               thresholds.lower_torque_thresholds_acceleration);
+    printArray("upper_torque_thresholds_acceleration",
+               thresholds.upper_torque_thresholds_acceleration);
+    printArray("lower_torque_thresholds_nominal", thresholds.lower_torque_thresholds_nominal);
+    printArray("upper_torque_thresholds_nominal", thresholds.upper_torque_thresholds_nominal);
+    printArray("lower_force_thresholds_acceleration",
+               thresholds.lower_force_thresholds_acceleration);
+    printArray("upper_force_thresholds_acceleration",
+               thresholds.upper_force_thresholds_acceleration);
+    printArray("lower_force_thresholds_nominal", thresholds.lower_force_thresholds_nominal);
+    printArray("upper_force_thresholds_nominal", thresholds.upper_force_thresholds_nominal);
+  } catch (const std::exception& e) {
+    std::cout << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
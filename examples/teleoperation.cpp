@@ -0,0 +1,98 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include <franka/exception.h>
+#include <franka/robot.h>
+#include <franka/teleoperation.h>
+
+#include "examples_common.h"
+
+/**
+ * @example teleoperation.cpp
+ * An example showing how to follow the poses of a teleoperation input device with
+ * franka::TeleoperationBridge. A stand-in input thread moves a virtual handle on a circle with a
+ * radius of 5 cm and delivers its poses at about 400 Hz with random jitter. After 20 seconds, the
+ * latency statistics are printed.
+ *
+ * @warning Before executing this example, make sure there is enough space in front of the robot.
+ */
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <robot-hostname>" << std::endl;
+    return -1;
+  }
+  try {
+    franka::Robot robot(argv[1]);
+    setDefaultBehavior(robot);
+
+    // First move the robot to a suitable joint configuration
+    std::array<double, 7> q_goal = {{0, -M_PI_4, 0, -3 * M_PI_4, 0, M_PI_2, M_PI_4}};
+    MotionGenerator motion_generator(0.5, q_goal);
+    std::cout << "WARNING: This example will move the robot! "
+              << "Please make sure to have the user stop button at hand!" << std::endl
+              << "Press Enter to continue..." << std::endl;
+    std::cin.ignore();
+    robot.control(motion_generator);
+    std::cout << "Finished moving to initial joint configuration." << std::endl;
+
+    franka::TeleoperationParameters parameters;
+    parameters.interpolation_delay = 0.005;
+    parameters.maximum_translational_velocity = 0.2;
+    franka::TeleoperationBridge bridge(parameters);
+
+    std::atomic<bool> running{true};
+    std::thread input_thread([&]() {
+      constexpr double kRadius = 0.05;
+      std::mt19937 generator(std::random_device{}());
+      std::uniform_int_distribution<int> interval(1500, 3500);
+      auto start = std::chrono::steady_clock::now();
+      while (running) {
+        franka::TeleoperationTarget target;
+        target.time = std::chrono::steady_clock::now();
+        double angle = 0.5 * std::chrono::duration<double>(target.time - start).count();
+        target.position = {{kRadius * (std::cos(angle) - 1.0), kRadius * std::sin(angle), 0.0}};
+        bridge.push(target);
+        std::this_thread::sleep_for(std::chrono::microseconds(interval(generator)));
+      }
+    });
+
+    double time = 0.0;
+    try {
+      robot.control([&](const franka::RobotState& robot_state,
+                        franka::Duration period) -> franka::CartesianPose {
+        time += period.toSec();
+        franka::CartesianPose pose = bridge(robot_state, period);
+        if (time >= 20.0) {
+          std::cout << std::endl << "Finished motion, shutting down example" << std::endl;
+          return franka::MotionFinished(pose);
+        }
+        return pose;
+      });
+    } catch (const franka::Exception&) {
+      running = false;
+      input_thread.join();
+      throw;
+    }
+    running = false;
+    input_thread.join();
+
+    franka::TeleoperationStatistics statistics = bridge.statistics();
+    std::cout << "Commands: " << statistics.commands
+              << ", extrapolated: " << statistics.extrapolated << ", held: " << statistics.held
+              << ", dropped targets: " << statistics.dropped << std::endl
+              << "Input to command latency: mean " << statistics.mean_latency * 1000.0
+              << " ms, maximum " << statistics.maximum_latency * 1000.0 << " ms" << std::endl;
+  } catch (const franka::Exception& e) {
+    std::cout << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,203 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <limits>
+#include <mutex>
+
+#include <franka/control_types.h>
+#include <franka/duration.h>
+#include <franka/lowpass_filter.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file admittance_controller.h
+ * Contains an admittance controller for hand guiding.
+ */
+
+namespace franka {
+
+/**
+ * Parameters of an AdmittanceController.
+ *
+ * Arrays with six elements are ordered as \f$(x, y, z, R, P, Y)\f$ and expressed in the base
+ * frame.
+ */
+struct AdmittanceParameters {
+  /**
+   * Maximum number of snap points.
+   */
+  static constexpr size_t kMaxSnapPoints = 8;
+
+  /**
+   * Virtual mass in \f$[kg]\f$ and virtual inertia in \f$[kg \times m^2]\f$. Must be positive.
+   */
+  std::array<double, 6> mass{{2.0, 2.0, 2.0, 0.1, 0.1, 0.1}};
+
+  /**
+   * Virtual damping in \f$[\frac{Ns}{m}]\f$ and \f$[\frac{Nms}{rad}]\f$. Must not be negative.
+   */
+  std::array<double, 6> damping{{30.0, 30.0, 30.0, 2.0, 2.0, 2.0}};
+
+  /**
+   * Virtual stiffness towards the pose at the last reset in \f$[\frac{N}{m}]\f$ and
+   * \f$[\frac{Nm}{rad}]\f$. Must not be negative. Zero stiffness allows free guiding.
+   */
+  std::array<double, 6> stiffness{};
+
+  /**
+   * External forces in \f$[N]\f$ and torques in \f$[Nm]\f$ below these values are ignored. Larger
+   * values are reduced by the deadband, so that the response stays continuous.
+   */
+  std::array<double, 6> deadband{{3.0, 3.0, 3.0, 0.5, 0.5, 0.5}};
+
+  /**
+   * Maximum velocity in \f$[\frac{m}{s}]\f$ and \f$[\frac{rad}{s}]\f$ per axis.
+   */
+  std::array<double, 6> maximum_velocity{{0.5, 0.5, 0.5, 1.0, 1.0, 1.0}};
+
+  /**
+   * Cutoff frequency of the low-pass filter on the external wrench in \f$[Hz]\f$. The filter is
+   * disabled for values of at least franka::kMaxCutoffFrequency.
+   */
+  double wrench_cutoff_frequency{20.0};
+
+  /**
+   * Lower corner of the allowed workspace box of the end effector position in \f$[m]\f$.
+   */
+  std::array<double, 3> workspace_minimum{{-std::numeric_limits<double>::infinity(),
+                                           -std::numeric_limits<double>::infinity(),
+                                           -std::numeric_limits<double>::infinity()}};
+
+  /**
+   * Upper corner of the allowed workspace box of the end effector position in \f$[m]\f$.
+   */
+  std::array<double, 3> workspace_maximum{{std::numeric_limits<double>::infinity(),
+                                           std::numeric_limits<double>::infinity(),
+                                           std::numeric_limits<double>::infinity()}};
+
+  /**
+   * Positions in \f$[m]\f$ the end effector is pulled towards when it is close to them. Only the
+   * first snap_point_count entries are used.
+   */
+  std::array<std::array<double, 3>, kMaxSnapPoints> snap_points{};
+
+  /**
+   * Number of valid entries in snap_points.
+   */
+  size_t snap_point_count{0};
+
+  /**
+   * Distance to a snap point in \f$[m]\f$ below which the end effector is pulled towards it.
+   */
+  double snap_radius{0.02};
+
+  /**
+   * Stiffness in \f$[\frac{N}{m}]\f$ pulling the end effector towards a close snap point.
+   */
+  double snap_stiffness{500.0};
+
+  /**
+   * Damping factor \f$\lambda\f$ of the pseudoinverse used to compute joint velocities.
+   */
+  double jacobian_damping{0.05};
+};
+
+/**
+ * Admittance controller for hand guiding.
+ *
+ * Maps the wrench applied to the robot, i.e. \f$-^O\hat{F}_{K,\text{ext}}\f$, to end effector
+ * velocities by simulating the virtual mass-spring-damper system
+ * \f$M \dot{v} + D v + K \Delta x = F\f$ per axis, so that the end effector yields to the hand
+ * guiding it. The controller can be used as motion generator callback for Cartesian or joint
+ * velocity motions:
+ *
+ * @code{.cpp}
+ * franka::AdmittanceController controller;
+ * robot.control([&controller](const franka::RobotState& robot_state, franka::Duration period) {
+ *   return controller(robot_state, period);
+ * });
+ * @endcode
+ *
+ * The control callbacks do not allocate memory and do not block. Parameters can be changed from
+ * other threads with setParameters while the controller is running.
+ */
+class AdmittanceController {
+ public:
+  /**
+   * Creates a new AdmittanceController instance.
+   *
+   * @param[in] parameters Controller parameters.
+   *
+   * @throw std::invalid_argument if a parameter is out of range.
+   */
+  explicit AdmittanceController(const AdmittanceParameters& parameters = {});
+
+  /**
+   * Computes the commanded end effector velocity for the next control cycle.
+   *
+   * The virtual system starts at rest at the pose of the first robot state after construction or
+   * reset.
+   *
+   * @param[in] robot_state Current robot state.
+   * @param[in] period Time since the last call.
+   *
+   * @return Commanded Cartesian velocity.
+   */
+  CartesianVelocities operator()(const RobotState& robot_state, Duration period);
+
+  /**
+   * Computes the commanded joint velocities for the next control cycle.
+   *
+   * The Cartesian velocity of the virtual system is mapped to joint velocities with the damped
+   * pseudoinverse of the zero Jacobian.
+   *
+   * @param[in] robot_state Current robot state.
+   * @param[in] period Time since the last call.
+   * @param[in] zero_jacobian Zero Jacobian of the end effector, e.g. from Model::zeroJacobian.
+   *
+   * @return Commanded joint velocities.
+   */
+  JointVelocities operator()(const RobotState& robot_state,
+                             Duration period,
+                             const std::array<double, 42>& zero_jacobian);
+
+  /**
+   * Updates the parameters. The new parameters are used from the next control cycle on.
+   *
+   * Can be called from any thread.
+   *
+   * @param[in] parameters New controller parameters.
+   *
+   * @throw std::invalid_argument if a parameter is out of range.
+   */
+  void setParameters(const AdmittanceParameters& parameters);
+
+  /**
+   * Returns the most recently set parameters.
+   *
+   * @return Controller parameters.
+   */
+  AdmittanceParameters parameters() const;
+
+  /**
+   * Brings the virtual system to rest. The next robot state defines the new rest pose.
+   */
+  void reset() noexcept;
+
+ private:
+  std::array<double, 6> step(const RobotState& robot_state, Duration period);
+
+  mutable std::mutex parameters_mutex_;
+  AdmittanceParameters pending_parameters_;
+  bool parameters_updated_;
+
+  AdmittanceParameters parameters_;
+  bool initialized_;
+  std::array<double, 16> rest_pose_;
+  std::array<double, 6> wrench_;
+  std::array<double, 6> velocity_;
+};
+
+}  // namespace franka
@@ -0,0 +1,177 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <franka/duration.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file anomaly_detection.h
+ * Contains types for detecting anomalies in the estimated external torques and forces.
+ */
+
+namespace franka {
+
+/**
+ * Parameters of an AnomalyDetector.
+ */
+struct AnomalyDetectionParameters {
+  /**
+   * Number of configuration bins per joint. Each joint keeps a separate baseline of its external
+   * torque for every bin of its joint angle in \f$[-\pi, \pi]\f$. The Cartesian baselines are
+   * binned by the angles of joints 2 and 4.
+   */
+  size_t configuration_bins{16};
+
+  /**
+   * Weight of a new sample in the exponentially weighted baselines, in range (0, 1].
+   */
+  double baseline_weight{0.002};
+
+  /**
+   * Number of samples a configuration bin needs before its baseline is used for detection.
+   */
+  uint64_t warmup_samples{500};
+
+  /**
+   * A channel is flagged if the absolute z-score of a single sample exceeds this value.
+   */
+  double z_score_threshold{6.0};
+
+  /**
+   * Slack subtracted from the z-score in each step of the two-sided CUSUM.
+   */
+  double cusum_drift{1.0};
+
+  /**
+   * A channel is flagged if one of its CUSUM sums exceeds this value.
+   */
+  double cusum_threshold{20.0};
+
+  /**
+   * Lower bound of the standard deviation of the joint torque baselines in \f$[Nm]\f$.
+   */
+  double minimum_torque_deviation{0.05};
+
+  /**
+   * Lower bound of the standard deviation of the Cartesian baselines in \f$[N]\f$ or \f$[Nm]\f$.
+   */
+  double minimum_wrench_deviation{0.2};
+};
+
+/**
+ * Anomaly reported by an AnomalyDetector.
+ */
+struct AnomalyEvent {
+  /**
+   * Time of the robot state that raised the event.
+   */
+  Duration time{};
+
+  /**
+   * Joints whose \f$\hat{\tau}_{\text{ext}}\f$ deviates from its baseline.
+   */
+  std::array<bool, 7> joint_anomaly{};
+
+  /**
+   * Axes of \f$^O\hat{F}_{K,\text{ext}}\f$ that deviate from their baseline.
+   */
+  std::array<bool, 6> cartesian_anomaly{};
+
+  /**
+   * Current z-scores of \f$\hat{\tau}_{\text{ext}}\f$.
+   */
+  std::array<double, 7> joint_z_score{};
+
+  /**
+   * Current z-scores of \f$^O\hat{F}_{K,\text{ext}}\f$.
+   */
+  std::array<double, 6> cartesian_z_score{};
+};
+
+/**
+ * Detects deviations of the filtered external torques and the external wrench from baselines
+ * learned online.
+ *
+ * Baselines are exponentially weighted means and variances, kept separately for each joint
+ * configuration bin, so that configuration-dependent model errors do not raise events. Each
+ * channel is flagged by a z-score threshold for sudden changes, and by a two-sided CUSUM for slow
+ * drifts. Flagged samples do not update the baselines.
+ *
+ * All memory is allocated on construction, so the detector can be updated from within a control
+ * loop.
+ */
+class AnomalyDetector {
+ public:
+  /**
+   * Creates a new AnomalyDetector instance.
+   *
+   * @param[in] parameters Detection parameters.
+   *
+   * @throw std::invalid_argument if a parameter is out of range.
+   */
+  explicit AnomalyDetector(const AnomalyDetectionParameters& parameters = {});
+
+  /**
+   * Processes a robot state.
+   *
+   * @param[in] robot_state Robot state.
+   * @param[out] event Filled with the current detection result if an anomaly was raised.
+   *
+   * @return True if an anomaly started with this robot state, i.e. if a channel is flagged that
+   * was not flagged for the previous robot state.
+   */
+  bool update(const RobotState& robot_state, AnomalyEvent* event) noexcept;
+
+  /**
+   * Discards all baselines and detection states.
+   */
+  void reset() noexcept;
+
+  /**
+   * Returns the parameters of this detector.
+   *
+   * @return Detection parameters.
+   */
+  const AnomalyDetectionParameters& parameters() const noexcept;
+
+ private:
+  struct Baseline {
+    double mean;
+    double variance;
+    uint64_t samples;
+  };
+
+  template <size_t N>
+  struct Channels {
+    std::array<double, N> z_score;
+    std::array<double, N> cusum_high;
+    std::array<double, N> cusum_low;
+    std::array<bool, N> flagged;
+  };
+
+  template <size_t N>
+  bool detect(const std::array<double, N>& values,
+              const std::array<size_t, N>& bins,
+              double minimum_deviation,
+              std::vector<Baseline>* baselines,
+              Channels<N>* channels) noexcept;
+
+  size_t configurationBin(double joint_angle) const noexcept;
+
+  AnomalyDetectionParameters parameters_;
+
+  // Baselines are stored bin-major, i.e. baseline j of bin b is at b * N + j.
+  std::vector<Baseline> joint_baselines_;
+  std::vector<Baseline> cartesian_baselines_;
+
+  Channels<7> joint_channels_;
+  Channels<6> cartesian_channels_;
+  bool anomaly_active_;
+};
+
+}  // namespace franka
@@ -0,0 +1,188 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <franka/log.h>
+
+/**
+ * @file collision_thresholds.h
+ * Contains helpers for deriving collision thresholds from recorded logs.
+ */
+
+namespace franka {
+
+/**
+ * Collision thresholds in the order of the arguments of Robot::setCollisionBehavior.
+ */
+struct CollisionThresholds {
+  /**
+   * Contact torque thresholds during acceleration/deceleration in \f$[Nm]\f$.
+   */
+  std::array<double, 7> lower_torque_thresholds_acceleration{};
+
+  /**
+   * Collision torque thresholds during acceleration/deceleration in \f$[Nm]\f$.
+   */
+  std::array<double, 7> upper_torque_thresholds_acceleration{};
+
+  /**
+   * Contact torque thresholds in \f$[Nm]\f$.
+   */
+  std::array<double, 7> lower_torque_thresholds_nominal{};
+
+  /**
+   * Collision torque thresholds in \f$[Nm]\f$.
+   */
+  std::array<double, 7> upper_torque_thresholds_nominal{};
+
+  /**
+   * Contact force thresholds during acceleration/deceleration in \f$[N]\f$.
+   */
+  std::array<double, 6> lower_force_thresholds_acceleration{};
+
+  /**
+   * Collision force thresholds during acceleration/deceleration in \f$[N]\f$.
+   */
+  std::array<double, 6> upper_force_thresholds_acceleration{};
+
+  /**
+   * Contact force thresholds in \f$[N]\f$.
+   */
+  std::array<double, 6> lower_force_thresholds_nominal{};
+
+  /**
+   * Collision force thresholds in \f$[N]\f$.
+   */
+  std::array<double, 6> upper_force_thresholds_nominal{};
+};
+
+/**
+ * Recommends collision thresholds from the external torques and forces observed in recorded
+ * collision-free motions.
+ *
+ * For each joint and Cartesian axis, the distribution of \f$|\hat{\tau}_{\text{ext}}|\f$ and
+ * \f$|^O\hat{F}_{K,\text{ext}}|\f$ is collected in fixed-size histograms, separately for
+ * acceleration/deceleration and constant velocity phases. Recommenders filled from different logs
+ * can be merged, e.g. after processing logs in parallel.
+ */
+class CollisionThresholdRecommender {
+ public:
+  /**
+   * Joint acceleration norm in \f$[\frac{rad}{s^2}]\f$ above which a sample is assigned to the
+   * acceleration/deceleration phase.
+   */
+  static constexpr double kDefaultAccelerationThreshold = 0.5;
+
+  /**
+   * Creates a new, empty CollisionThresholdRecommender instance.
+   *
+   * @param[in] acceleration_threshold Norm of \f$\ddot{q}_d\f$ in \f$[\frac{rad}{s^2}]\f$ above
+   * which a sample is assigned to the acceleration/deceleration phase.
+   *
+   * @throw std::invalid_argument if acceleration_threshold is negative.
+   */
+  explicit CollisionThresholdRecommender(
+      double acceleration_threshold = kDefaultAccelerationThreshold);
+
+  /**
+   * Adds a recorded robot state.
+   *
+   * @param[in] robot_state Robot state of a collision-free motion.
+   */
+  void add(const RobotState& robot_state) noexcept;
+
+  /**
+   * Adds all robot states of a log.
+   *
+   * @param[in] log Log of a collision-free motion.
+   */
+  void add(const std::vector<Record>& log) noexcept;
+
+  /**
+   * Adds the samples collected by another recommender.
+   *
+   * @param[in] other Recommender to merge.
+   *
+   * @throw std::invalid_argument if the recommenders use different acceleration thresholds.
+   */
+  void merge(const CollisionThresholdRecommender& other);
+
+  /**
+   * Returns the number of samples collected in the acceleration/deceleration phase.
+   *
+   * @return Number of samples.
+   */
+  uint64_t accelerationSamples() const noexcept;
+
+  /**
+   * Returns the number of samples collected in the constant velocity phase.
+   *
+   * @return Number of samples.
+   */
+  uint64_t nominalSamples() const noexcept;
+
+  /**
+   * Recommends collision thresholds.
+   *
+   * The contact threshold of each joint and axis is the \f$1 - r\f$ quantile of the observed
+   * absolute values, with \f$r\f$ being the target false-trigger rate per sample. The collision
+   * threshold is the contact threshold multiplied by the given safety factor. If no samples were
+   * collected for one of the phases, the thresholds of the other phase are used for it.
+   *
+   * @param[in] false_trigger_rate Target rate of samples exceeding the contact thresholds in
+   * collision-free motions, in range (0, 1).
+   * @param[in] safety_factor Factor between contact and collision thresholds, at least 1.
+   *
+   * @return Recommended thresholds.
+   *
+   * @throw std::invalid_argument if a parameter is out of range.
+   * @throw InvalidOperationException if no samples have been added.
+   */
+  CollisionThresholds recommend(double false_trigger_rate, double safety_factor = 1.5) const;
+
+ private:
+  struct Histograms {
+    Histograms();
+
+    void merge(const Histograms& other) noexcept;
+
+    uint64_t samples;
+    // Bins are stored channel-major, i.e. bin b of channel c is at c * kBins + b.
+    std::vector<uint64_t> torque_bins;
+    std::vector<uint64_t> force_bins;
+  };
+
+  double acceleration_threshold_;
+  Histograms acceleration_;
+  Histograms nominal_;
+};
+
+/**
+ * Recommends collision thresholds from a set of log files written by LogFileWriter.
+ *
+ * The files are processed in parallel.
+ *
+ * @param[in] log_files Paths of log files containing collision-free motions.
+ * @param[in] false_trigger_rate Target rate of samples exceeding the contact thresholds.
+ * @param[in] safety_factor Factor between contact and collision thresholds.
+ * @param[in] threads Number of worker threads. If zero, one thread per hardware thread is used.
+ *
+ * @return Recommended thresholds.
+ *
+ * @throw LogFileException if a log file cannot be read.
+ * @throw std::invalid_argument if a parameter is out of range.
+ * @throw InvalidOperationException if the log files contain no samples.
+ *
+ * @see CollisionThresholdRecommender::recommend for the meaning of the parameters.
+ */
+CollisionThresholds recommendCollisionThresholds(const std::vector<std::string>& log_files,
+                                                 double false_trigger_rate,
+                                                 double safety_factor = 1.5,
+                                                 size_t threads = 0);
+
+}  // namespace franka
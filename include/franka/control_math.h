@@ -0,0 +1,130 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+
+/**
+ * @file control_math.h
+ * Contains fixed-size linear algebra kernels for the matrices used in control callbacks.
+ *
+ * All matrices are stored in column-major order, like the matrices in franka::RobotState and the
+ * results of franka::Model. The kernels do not allocate memory and can be called from the
+ * realtime thread.
+ */
+
+namespace franka {
+
+/**
+ * LDL^T factorization of a symmetric positive definite 7x7 matrix, such as the mass matrix.
+ *
+ * The matrix is factorized without pivoting as \f$M = L D L^T\f$ with a unit lower triangular
+ * \f$L\f$ and a diagonal \f$D\f$.
+ */
+class JointMatrixLDLT {
+ public:
+  /**
+   * Creates an empty factorization. Call compute() before solving.
+   */
+  JointMatrixLDLT() noexcept = default;
+
+  /**
+   * Factorizes the given matrix.
+   *
+   * @param[in] matrix Column-major 7x7 matrix. Only the lower triangle is read.
+   */
+  explicit JointMatrixLDLT(const std::array<double, 49>& matrix) noexcept;
+
+  /**
+   * Factorizes the given matrix.
+   *
+   * @param[in] matrix Column-major 7x7 matrix. Only the lower triangle is read.
+   *
+   * @return True if the matrix is positive definite. Otherwise, the results of solve() are
+   * undefined.
+   */
+  bool compute(const std::array<double, 49>& matrix) noexcept;
+
+  /**
+   * Returns whether the last factorized matrix was positive definite.
+   *
+   * @return True if the factorization can be used for solving.
+   */
+  bool positiveDefinite() const noexcept;
+
+  /**
+   * Solves \f$M x = b\f$.
+   *
+   * @param[in] b Right-hand side.
+   *
+   * @return Solution \f$x\f$.
+   */
+  std::array<double, 7> solve(const std::array<double, 7>& b) const noexcept;
+
+  /**
+   * Calculates \f$A M^{-1}\f$ for a 6x7 matrix, e.g. \f$J M^{-1}\f$ for a Jacobian.
+   *
+   * @param[in] matrix Column-major 6x7 matrix \f$A\f$.
+   *
+   * @return Column-major 6x7 matrix \f$A M^{-1}\f$.
+   */
+  std::array<double, 42> solveRight(const std::array<double, 42>& matrix) const noexcept;
+
+ private:
+  // Strictly lower triangle of L, column-major. The other elements are zero.
+  std::array<double, 49> lower_{};
+  std::array<double, 7> inverse_diagonal_{};
+  bool positive_definite_{false};
+};
+
+/**
+ * Calculates \f$J M^{-1} J^T\f$, the inverse of the Cartesian inertia matrix.
+ *
+ * @param[in] jacobian Column-major 6x7 Jacobian, e.g. from franka::Model::zeroJacobian.
+ * @param[in] mass_matrix Column-major 7x7 mass matrix, e.g. from franka::Model::mass.
+ * @param[out] result Column-major 6x6 symmetric matrix.
+ *
+ * @return False if the mass matrix is not positive definite. `result` is not changed in this
+ * case.
+ */
+bool inverseCartesianInertia(const std::array<double, 42>& jacobian,
+                             const std::array<double, 49>& mass_matrix,
+                             std::array<double, 36>* result) noexcept;
+
+/**
+ * Multiplies two homogeneous transformations.
+ *
+ * The last row of both transformations is assumed to be \f$(0, 0, 0, 1)\f$.
+ *
+ * @param[in] a Column-major 4x4 transformation \f$^AT_B\f$.
+ * @param[in] b Column-major 4x4 transformation \f$^BT_C\f$.
+ *
+ * @return Column-major 4x4 transformation \f$^AT_C\f$.
+ */
+std::array<double, 16> multiplyTransforms(const std::array<double, 16>& a,
+                                          const std::array<double, 16>& b) noexcept;
+
+/**
+ * Inverts a homogeneous transformation with an orthonormal rotation.
+ *
+ * @param[in] transform Column-major 4x4 transformation \f$^AT_B\f$.
+ *
+ * @return Column-major 4x4 transformation \f$^BT_A\f$.
+ */
+std::array<double, 16> invertTransform(const std::array<double, 16>& transform) noexcept;
+
+/**
+ * Calculates the orientation error between two poses.
+ *
+ * The error is the vector part of the quaternion \f$q q_d^{-1}\f$ with a non-negative scalar
+ * part, as in the Cartesian impedance control example. It is expressed in the base frame.
+ *
+ * @param[in] pose Column-major 4x4 pose, e.g. franka::RobotState::O_T_EE.
+ * @param[in] desired_pose Column-major 4x4 desired pose.
+ *
+ * @return Orientation error.
+ */
+std::array<double, 3> orientationError(const std::array<double, 16>& pose,
+                                       const std::array<double, 16>& desired_pose) noexcept;
+
+}  // namespace franka
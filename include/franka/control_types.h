@@ -191,6 +191,46 @@ class CartesianPose : public Finishable {
    */
   CartesianPose(std::initializer_list<double> cartesian_pose, std::initializer_list<double> elbow);
 
+  /**
+   * Creates a new CartesianPose instance from a position and an orientation.
+   *
+   * The pose is converted to a homogeneous transformation once, without checking the
+   * orthonormality of a matrix.
+   *
+   * @note Pass std::array values. Braced initializer lists select the constructors taking a
+   * vectorized homogeneous transformation.
+   *
+   * @param[in] position Desired end effector position in base frame in \f$[m]\f$.
+   * @param[in] orientation Desired end effector orientation in base frame as unit quaternion
+   * \f$(x, y, z, w)\f$.
+   *
+   * @throw std::invalid_argument if orientation is not a unit quaternion.
+   * @throw std::invalid_argument if the given values are NaN or infinity.
+   */
+  CartesianPose(const std::array<double, 3>& position, const std::array<double, 4>& orientation);
+
+  /**
+   * Creates a new CartesianPose instance from a position and an orientation.
+   *
+   * The pose is converted to a homogeneous transformation once, without checking the
+   * orthonormality of a matrix.
+   *
+   * @note Pass std::array values. Braced initializer lists select the constructors taking a
+   * vectorized homogeneous transformation.
+   *
+   * @param[in] position Desired end effector position in base frame in \f$[m]\f$.
+   * @param[in] orientation Desired end effector orientation in base frame as unit quaternion
+   * \f$(x, y, z, w)\f$.
+   * @param[in] elbow Elbow configuration (see @ref elbow member for more details).
+   *
+   * @throw std::invalid_argument if orientation is not a unit quaternion.
+   * @throw std::invalid_argument if the given values are NaN or infinity.
+   * @throw std::invalid_argument if the given elbow configuration is invalid.
+   */
+  CartesianPose(const std::array<double, 3>& position,
+                const std::array<double, 4>& orientation,
+                const std::array<double, 2>& elbow);
+
   /**
    * Homogeneous transformation \f$^O{\mathbf{T}_{EE}}_{d}\f$, column major, that transforms from
    * the end effector frame \f$EE\f$ to base frame \f$O\f$.
@@ -0,0 +1,122 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <franka/duration.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file energy_accounting.h
+ * Contains types for accounting the mechanical power and energy of the joints.
+ */
+
+namespace franka {
+
+/**
+ * Mechanical energy and power of the joints, accumulated over a period of time.
+ *
+ * The mechanical power of a joint is \f$P = \tau_J \dot{q}\f$. It is positive while the joint
+ * drives the motion and negative while it brakes.
+ */
+struct EnergyCounters {
+  /**
+   * Net mechanical energy per joint, i.e. the integral of \f$P\f$, in \f$[J]\f$.
+   */
+  std::array<double, 7> energy{};
+
+  /**
+   * Mechanical energy delivered by each joint, i.e. the integral of the positive part of
+   * \f$P\f$, in \f$[J]\f$.
+   */
+  std::array<double, 7> positive_energy{};
+
+  /**
+   * Peak absolute power per joint in \f$[W]\f$.
+   */
+  std::array<double, 7> peak_power{};
+
+  /**
+   * Peak absolute sum of the power of all joints in \f$[W]\f$.
+   */
+  double peak_total_power{};
+
+  /**
+   * Number of robot states that were taken into account.
+   */
+  uint64_t samples{};
+
+  /**
+   * Time over which the energy has been integrated.
+   */
+  Duration duration{};
+};
+
+/**
+ * Snapshot of the energy accounting.
+ *
+ * @see Robot::energySnapshot
+ */
+struct EnergySnapshot {
+  /**
+   * Mechanical power per joint of the latest robot state in \f$[W]\f$.
+   */
+  std::array<double, 7> joint_power{};
+
+  /**
+   * Counters of the current motion, or of the last motion if no motion is running.
+   */
+  EnergyCounters motion{};
+
+  /**
+   * Counters of all robot states since accounting has been enabled.
+   */
+  EnergyCounters lifetime{};
+};
+
+/**
+ * Accumulates the mechanical power and energy of the joints from a stream of robot states.
+ *
+ * The accumulator uses constant memory and neither allocates memory nor blocks, so it can be
+ * fed from within a control loop.
+ */
+class EnergyAccumulator {
+ public:
+  /**
+   * Adds a robot state.
+   *
+   * The power of the given state is integrated over the time since the previous state, so that
+   * lost robot states are accounted for.
+   *
+   * @param[in] robot_state Robot state.
+   * @param[in] in_motion True if the robot state belongs to a motion, in which case it is also
+   * added to the motion counters.
+   */
+  void update(const RobotState& robot_state, bool in_motion) noexcept;
+
+  /**
+   * Resets the motion counters for a new motion.
+   */
+  void startMotion() noexcept;
+
+  /**
+   * Returns the current counters.
+   *
+   * @return Energy snapshot.
+   */
+  EnergySnapshot snapshot() const noexcept;
+
+  /**
+   * Resets all counters.
+   */
+  void reset() noexcept;
+
+ private:
+  EnergySnapshot snapshot_{};
+  Duration last_time_{};
+  bool has_last_time_{false};
+};
+
+}  // namespace franka
@@ -55,6 +55,14 @@ struct Errors {
    */
   explicit operator bool() const noexcept;
 
+  /**
+   * Returns the error flags as an array, in the order expected by Errors(const std::array<bool,
+   * 37>&).
+   *
+   * @return Array of error flags.
+   */
+  explicit operator std::array<bool, 37>() const noexcept;
+
   /**
    * Creates a string with names of active errors:
    * "[active_error_name2, active_error_name_2, ... active_error_name_n]"
@@ -106,4 +106,12 @@ struct InvalidOperationException : public Exception {
   using Exception::Exception;
 };
 
+/**
+ * LogFileException is thrown if a log file, trajectory cache file or reachability map file cannot
+ * be read or written.
+ */
+struct LogFileException : public Exception {
+  using Exception::Exception;
+};
+
 }  // namespace franka
@@ -0,0 +1,488 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <franka/control_types.h>
+#include <franka/errors.h>
+#include <franka/gripper_state.h>
+#include <franka/log.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file field_descriptors.h
+ * Contains compile-time descriptions of the fields of the state and command types.
+ */
+
+namespace franka {
+
+/**
+ * Provides the element type and the number of elements of a field type. Arrays have one element
+ * per entry, all other types consist of a single element.
+ *
+ * @tparam T Field type.
+ */
+template <typename T>
+struct FieldExtent : std::integral_constant<size_t, 1> {
+  /**
+   * Element type.
+   */
+  using Element = T;
+};
+
+/**
+ * Provides the element type and the number of elements of an array field.
+ *
+ * @tparam T Element type.
+ * @tparam N Number of elements.
+ */
+template <typename T, size_t N>
+struct FieldExtent<std::array<T, N>> : std::integral_constant<size_t, N> {
+  /**
+   * Element type.
+   */
+  using Element = T;
+};
+
+/**
+ * Describes a data member of a class.
+ *
+ * @tparam Class Class the member belongs to.
+ * @tparam T Type of the member.
+ */
+template <typename Class, typename T>
+struct FieldDescriptor {
+  /**
+   * Class the member belongs to.
+   */
+  using ClassType = Class;
+
+  /**
+   * Type of the member.
+   */
+  using Type = T;
+
+  /**
+   * Element type of the member, see FieldExtent.
+   */
+  using Element = typename FieldExtent<T>::Element;
+
+  /**
+   * Number of elements of the member, see FieldExtent.
+   */
+  static constexpr size_t kExtent = FieldExtent<T>::value;
+
+  /**
+   * Name of the member.
+   */
+  const char* name;
+
+  /**
+   * Pointer to the member.
+   */
+  T Class::*member;
+
+  /**
+   * Accesses the member of the given object.
+   *
+   * @param[in] object Object to access.
+   *
+   * @return Member of the object.
+   */
+  constexpr const T& get(const Class& object) const noexcept { return object.*member; }
+
+  /**
+   * Accesses the member of the given object.
+   *
+   * @param[in] object Object to access.
+   *
+   * @return Member of the object.
+   */
+  constexpr T& get(Class& object) const noexcept { return object.*member; }
+
+  /**
+   * Calculates the offset of the member in bytes from the beginning of the object.
+   *
+   * @return Offset in bytes.
+   */
+  size_t offset() const noexcept {
+    static const Class kObject{};
+    return static_cast<size_t>(reinterpret_cast<const char*>(&get(kObject)) -
+                               reinterpret_cast<const char*>(&kObject));
+  }
+};
+
+template <typename Class, typename T>
+constexpr size_t FieldDescriptor<Class, T>::kExtent;
+
+/**
+ * Creates a FieldDescriptor.
+ *
+ * @param[in] name Name of the member.
+ * @param[in] member Pointer to the member.
+ *
+ * @return Descriptor of the member.
+ */
+template <typename Class, typename T>
+constexpr FieldDescriptor<Class, T> makeField(const char* name, T Class::*member) noexcept {
+  return {name, member};
+}
+
+/**
+ * Lists the fields of a type.
+ *
+ * Specializations provide a `static constexpr auto fields() noexcept` function returning a
+ * `std::tuple` of @ref FieldDescriptor "FieldDescriptors" in declaration order.
+ *
+ * @tparam T Described type.
+ */
+template <typename T>
+struct FieldTable;
+
+/**
+ * Checks whether a FieldTable exists for a type.
+ *
+ * @tparam T Type to check.
+ */
+template <typename T, typename = void>
+struct HasFieldTable : std::false_type {};
+
+/**
+ * Checks whether a FieldTable exists for a type.
+ *
+ * @tparam T Type to check.
+ */
+template <typename T>
+struct HasFieldTable<T, decltype(static_cast<void>(FieldTable<T>::fields()))> : std::true_type {
+};
+
+/**
+ * Returns the number of fields of a type.
+ *
+ * @tparam T Described type.
+ *
+ * @return Number of fields.
+ */
+template <typename T>
+constexpr size_t fieldCount() noexcept {
+  return std::tuple_size<decltype(FieldTable<T>::fields())>::value;
+}
+
+/**
+ * Selects fields of a type. Bit `i` corresponds to the `i`-th field of the FieldTable.
+ *
+ * @tparam T Described type.
+ */
+template <typename T>
+using FieldMask = std::bitset<fieldCount<T>()>;
+
+namespace detail {
+
+constexpr bool equalNames(const char* lhs, const char* rhs) noexcept {
+  return *lhs == *rhs && (*lhs == '\0' || equalNames(lhs + 1, rhs + 1));
+}
+
+template <typename T, typename Visitor, size_t... I>
+void forEachField(Visitor&& visitor, std::index_sequence<I...> /* indices */) {
+  constexpr auto fields = FieldTable<T>::fields();
+  static_cast<void>(fields);
+  static_cast<void>(std::initializer_list<int>{(visitor(std::get<I>(fields)), 0)...});
+}
+
+}  // namespace detail
+
+/**
+ * Calls a visitor with the FieldDescriptor of every field of a type, in declaration order.
+ *
+ * The loop is unrolled at compile time, so the visitor is instantiated with the concrete type of
+ * every descriptor.
+ *
+ * @param[in] visitor Visitor, e.g. a generic lambda taking a `const auto&` descriptor.
+ *
+ * @tparam T Described type.
+ */
+template <typename T, typename Visitor>
+void forEachField(Visitor&& visitor) {
+  detail::forEachField<T>(std::forward<Visitor>(visitor),
+                          std::make_index_sequence<fieldCount<T>()>());
+}
+
+/**
+ * Looks up the index of a field at compile time.
+ *
+ * @param[in] name Name of the field.
+ *
+ * @return Index of the field, or fieldCount() if there is no field with the given name.
+ *
+ * @tparam T Described type.
+ */
+template <typename T, size_t I = 0>
+constexpr std::enable_if_t<(I == fieldCount<T>()), size_t> fieldIndex(
+    const char* /* name */) noexcept {
+  return I;
+}
+
+/**
+ * Looks up the index of a field at compile time.
+ *
+ * @param[in] name Name of the field.
+ *
+ * @return Index of the field, or fieldCount() if there is no field with the given name.
+ *
+ * @tparam T Described type.
+ */
+template <typename T, size_t I = 0>
+constexpr std::enable_if_t<(I < fieldCount<T>()), size_t> fieldIndex(const char* name) noexcept {
+  return detail::equalNames(std::get<I>(FieldTable<T>::fields()).name, name)
+             ? I
+             : fieldIndex<T, I + 1>(name);
+}
+
+/**
+ * Creates a FieldMask selecting the fields with the given names.
+ *
+ * @param[in] names Names of the fields to select.
+ *
+ * @return Field mask.
+ *
+ * @throw std::invalid_argument if a name does not belong to a field of T.
+ *
+ * @tparam T Described type.
+ */
+template <typename T>
+FieldMask<T> makeFieldMask(std::initializer_list<const char*> names) {
+  FieldMask<T> mask;
+  for (const char* name : names) {
+    size_t index = 0;
+    size_t found = fieldCount<T>();
+    forEachField<T>([&](const auto& field) {
+      if (std::strcmp(field.name, name) == 0) {
+        found = index;
+      }
+      index++;
+    });
+    if (found == fieldCount<T>()) {
+      throw std::invalid_argument(std::string("libfranka: Unknown field ") + name);
+    }
+    mask.set(found);
+  }
+  return mask;
+}
+
+template <typename T>
+FieldMask<T> differingFields(const T& lhs, const T& rhs);
+
+namespace detail {
+
+inline bool fieldsEqual(const Errors& lhs, const Errors& rhs) noexcept {
+  return static_cast<std::array<bool, 37>>(lhs) == static_cast<std::array<bool, 37>>(rhs);
+}
+
+template <typename T>
+bool fieldsEqual(const T& lhs, const T& rhs, std::false_type /* has_field_table */) {
+  return lhs == rhs;
+}
+
+template <typename T>
+bool fieldsEqual(const T& lhs, const T& rhs, std::true_type /* has_field_table */) {
+  return differingFields(lhs, rhs).none();
+}
+
+template <typename T>
+bool fieldsEqual(const T& lhs, const T& rhs) {
+  return fieldsEqual(lhs, rhs, HasFieldTable<T>());
+}
+
+}  // namespace detail
+
+/**
+ * Compares two objects field by field. Nested types with a FieldTable are compared recursively.
+ *
+ * @param[in] lhs First object.
+ * @param[in] rhs Second object.
+ *
+ * @return Mask of the fields that differ.
+ *
+ * @tparam T Described type.
+ */
+template <typename T>
+FieldMask<T> differingFields(const T& lhs, const T& rhs) {
+  FieldMask<T> mask;
+  size_t index = 0;
+  forEachField<T>([&](const auto& field) {
+    mask[index] = !detail::fieldsEqual(field.get(lhs), field.get(rhs));
+    index++;
+  });
+  return mask;
+}
+
+/**
+ * Describes the fields of RobotState.
+ */
+template <>
+struct FieldTable<RobotState> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(
+        makeField("O_T_EE", &RobotState::O_T_EE), makeField("O_T_EE_d", &RobotState::O_T_EE_d),
+        makeField("F_T_EE", &RobotState::F_T_EE), makeField("EE_T_K", &RobotState::EE_T_K),
+        makeField("m_ee", &RobotState::m_ee), makeField("I_ee", &RobotState::I_ee),
+        makeField("F_x_Cee", &RobotState::F_x_Cee), makeField("m_load", &RobotState::m_load),
+        makeField("I_load", &RobotState::I_load), makeField("F_x_Cload", &RobotState::F_x_Cload),
+        makeField("m_total", &RobotState::m_total), makeField("I_total", &RobotState::I_total),
+        makeField("F_x_Ctotal", &RobotState::F_x_Ctotal), makeField("elbow", &RobotState::elbow),
+        makeField("elbow_d", &RobotState::elbow_d), makeField("elbow_c", &RobotState::elbow_c),
+        makeField("delbow_c", &RobotState::delbow_c),
+        makeField("ddelbow_c", &RobotState::ddelbow_c), makeField("tau_J", &RobotState::tau_J),
+        makeField("tau_J_d", &RobotState::tau_J_d), makeField("dtau_J", &RobotState::dtau_J),
+        makeField("q", &RobotState::q), makeField("q_d", &RobotState::q_d),
+        makeField("dq", &RobotState::dq), makeField("dq_d", &RobotState::dq_d),
+        makeField("ddq_d", &RobotState::ddq_d),
+        makeField("joint_contact", &RobotState::joint_contact),
+        makeField("cartesian_contact", &RobotState::cartesian_contact),
+        makeField("joint_collision", &RobotState::joint_collision),
+        makeField("cartesian_collision", &RobotState::cartesian_collision),
+        makeField("tau_ext_hat_filtered", &RobotState::tau_ext_hat_filtered),
+        makeField("O_F_ext_hat_K", &RobotState::O_F_ext_hat_K),
+        makeField("K_F_ext_hat_K", &RobotState::K_F_ext_hat_K),
+        makeField("O_dP_EE_d", &RobotState::O_dP_EE_d),
+        makeField("O_T_EE_c", &RobotState::O_T_EE_c),
+        makeField("O_dP_EE_c", &RobotState::O_dP_EE_c),
+        makeField("O_ddP_EE_c", &RobotState::O_ddP_EE_c), makeField("theta", &RobotState::theta),
+        makeField("dtheta", &RobotState::dtheta),
+        makeField("current_errors", &RobotState::current_errors),
+        makeField("last_motion_errors", &RobotState::last_motion_errors),
+        makeField("control_command_success_rate", &RobotState::control_command_success_rate),
+        makeField("robot_mode", &RobotState::robot_mode), makeField("time", &RobotState::time));
+  }
+};
+
+/**
+ * Describes the fields of JointPositions.
+ */
+template <>
+struct FieldTable<JointPositions> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("q", &JointPositions::q));
+  }
+};
+
+/**
+ * Describes the fields of JointVelocities.
+ */
+template <>
+struct FieldTable<JointVelocities> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("dq", &JointVelocities::dq));
+  }
+};
+
+/**
+ * Describes the fields of CartesianPose.
+ */
+template <>
+struct FieldTable<CartesianPose> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("O_T_EE", &CartesianPose::O_T_EE),
+                           makeField("elbow", &CartesianPose::elbow));
+  }
+};
+
+/**
+ * Describes the fields of CartesianVelocities.
+ */
+template <>
+struct FieldTable<CartesianVelocities> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("O_dP_EE", &CartesianVelocities::O_dP_EE),
+                           makeField("elbow", &CartesianVelocities::elbow));
+  }
+};
+
+/**
+ * Describes the fields of Torques.
+ */
+template <>
+struct FieldTable<Torques> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("tau_J", &Torques::tau_J));
+  }
+};
+
+/**
+ * Describes the fields of RobotCommand.
+ */
+template <>
+struct FieldTable<RobotCommand> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("joint_positions", &RobotCommand::joint_positions),
+                           makeField("joint_velocities", &RobotCommand::joint_velocities),
+                           makeField("cartesian_pose", &RobotCommand::cartesian_pose),
+                           makeField("cartesian_velocities", &RobotCommand::cartesian_velocities),
+                           makeField("torques", &RobotCommand::torques));
+  }
+};
+
+/**
+ * Describes the fields of Record.
+ */
+template <>
+struct FieldTable<Record> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("state", &Record::state),
+                           makeField("command", &Record::command),
+                           makeField("joint_power", &Record::joint_power));
+  }
+};
+
+/**
+ * Describes the fields of GripperState.
+ */
+template <>
+struct FieldTable<GripperState> {
+  /**
+   * @return Descriptors of the fields.
+   */
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("width", &GripperState::width),
+                           makeField("max_width", &GripperState::max_width),
+                           makeField("is_grasped", &GripperState::is_grasped),
+                           makeField("temperature", &GripperState::temperature),
+                           makeField("time", &GripperState::time));
+  }
+};
+
+}  // namespace franka
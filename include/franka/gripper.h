@@ -15,8 +15,46 @@
 
 namespace franka {
 
+class GripperStreamer;
 class Network;
 
+/**
+ * Setpoint for streaming gripper control.
+ *
+ * @see Gripper::startStreaming
+ */
+struct GripperSetpoint {
+  /**
+   * Intended opening width, or size of the object to grasp. [m]
+   */
+  double width{0.0};
+
+  /**
+   * Speed of the fingers. [m/s]
+   */
+  double speed{0.1};
+
+  /**
+   * Grasping force. [N]
+   *
+   * If zero, the fingers are moved to the given width. Otherwise, an object of the given width is
+   * grasped.
+   */
+  double force{0.0};
+
+  /**
+   * Maximum tolerated deviation when the actual grasped width is smaller than the commanded grasp
+   * width.
+   */
+  double epsilon_inner{0.005};
+
+  /**
+   * Maximum tolerated deviation when the actual grasped width is larger than the commanded grasp
+   * width.
+   */
+  double epsilon_outer{0.005};
+};
+
 /**
  * Maintains a network connection to the gripper, provides the current gripper state,
  * and allows the execution of commands.
@@ -72,6 +110,7 @@ class Gripper {
    *
    * @throw CommandException if an error occurred.
    * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw InvalidOperationException if streaming gripper control is active.
    *
    * @see GripperState for the maximum grasping width.
    */
@@ -95,6 +134,7 @@ class Gripper {
    *
    * @throw CommandException if an error occurred.
    * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw InvalidOperationException if streaming gripper control is active.
    */
   bool grasp(double width,
              double speed,
@@ -112,6 +152,7 @@ class Gripper {
    *
    * @throw CommandException if an error occurred.
    * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw InvalidOperationException if streaming gripper control is active.
    */
   bool move(double width, double speed) const;
 
@@ -122,19 +163,64 @@ class Gripper {
    *
    * @throw CommandException if an error occurred.
    * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw InvalidOperationException if streaming gripper control is active.
    */
   bool stop() const;
 
   /**
    * Waits for a gripper state update and returns it.
    *
+   * If streaming gripper control is active, the latest received gripper state is returned
+   * immediately instead.
+   *
    * @return Current gripper state.
    *
    * @throw NetworkException if the connection is lost, e.g. after a timeout.
    * @throw InvalidOperationException if another readOnce is already running.
+   * @throw CommandException if a streamed command failed.
    */
   GripperState readOnce() const;
 
+  /**
+   * Starts streaming gripper control.
+   *
+   * In streaming mode, setpoints given with setStreamingSetpoint() are executed by a background
+   * thread. Only the latest setpoint is kept, and a move or grasp is only commanded if it differs
+   * from the one which is currently executed. A running move or grasp is stopped before a new
+   * setpoint is commanded.
+   *
+   * While streaming, readOnce() returns the latest received gripper state without waiting, and
+   * homing(), grasp(), move() and stop() must not be called.
+   *
+   * @throw InvalidOperationException if streaming has already been started.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   */
+  void startStreaming();
+
+  /**
+   * Sets the setpoint for streaming gripper control.
+   *
+   * Does not block or allocate memory, so it can be called at a high rate, e.g. from a control
+   * loop. Must not be called from several threads at the same time.
+   *
+   * Errors occurring while executing setpoints are reported by readOnce() and stopStreaming().
+   *
+   * @param[in] setpoint New setpoint.
+   *
+   * @throw InvalidOperationException if streaming has not been started.
+   */
+  void setStreamingSetpoint(const GripperSetpoint& setpoint) const;
+
+  /**
+   * Stops streaming gripper control and stops a running move or grasp.
+   *
+   * Blocks until the gripper has answered all commands sent while streaming.
+   *
+   * @throw CommandException if a streamed command failed.
+   * @throw NetworkException if the connection was lost while streaming, e.g. after a timeout.
+   */
+  void stopStreaming();
+
   /**
    * Returns the software version reported by the connected server.
    *
@@ -146,9 +232,13 @@ class Gripper {
   Gripper& operator=(const Gripper&) = delete;
 
  private:
+  void throwIfStreaming() const;
+
   std::unique_ptr<Network> network_;
 
   uint16_t ri_version_;
+
+  std::unique_ptr<GripperStreamer> streamer_;
 };
 
 }  // namespace franka
@@ -0,0 +1,148 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+
+#include <franka/control_types.h>
+#include <franka/duration.h>
+#include <franka/model.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file hybrid_force_motion_controller.h
+ * Contains a hybrid force/motion controller for contact tasks.
+ */
+
+namespace franka {
+
+/**
+ * Parameters of a HybridForceMotionController.
+ *
+ * Arrays with six elements are ordered as \f$(x, y, z, R, P, Y)\f$ and expressed in the base
+ * frame.
+ */
+struct HybridForceMotionParameters {
+  /**
+   * Selects the force controlled axes. All other axes are motion controlled.
+   */
+  std::array<bool, 6> force_controlled{{false, false, true, false, false, false}};
+
+  /**
+   * Stiffness of the motion controlled axes in \f$[\frac{N}{m}]\f$ and \f$[\frac{Nm}{rad}]\f$.
+   */
+  std::array<double, 6> stiffness{{1000.0, 1000.0, 1000.0, 50.0, 50.0, 50.0}};
+
+  /**
+   * Damping of all axes in \f$[\frac{Ns}{m}]\f$ and \f$[\frac{Nms}{rad}]\f$.
+   */
+  std::array<double, 6> damping{{63.0, 63.0, 63.0, 14.0, 14.0, 14.0}};
+
+  /**
+   * Proportional gain of the force controller on the wrench error.
+   */
+  std::array<double, 6> force_proportional_gain{{0.5, 0.5, 0.5, 0.5, 0.5, 0.5}};
+
+  /**
+   * Integral gain of the force controller on the wrench error in \f$[\frac{1}{s}]\f$.
+   */
+  std::array<double, 6> force_integral_gain{{5.0, 5.0, 5.0, 5.0, 5.0, 5.0}};
+
+  /**
+   * Bound of the integral term of the force controller in \f$[N]\f$ and \f$[Nm]\f$. The integrator
+   * stops accumulating once the bound is reached.
+   */
+  std::array<double, 6> maximum_integral_wrench{{20.0, 20.0, 20.0, 2.0, 2.0, 2.0}};
+
+  /**
+   * Adds the Coriolis torques to the commanded torques if true.
+   */
+  bool coriolis_compensation{true};
+};
+
+/**
+ * Hybrid force/motion controller for torque control.
+ *
+ * Each Cartesian axis is either force or motion controlled. On force controlled axes, the
+ * estimated external wrench \f$^O\hat{F}_{K,\text{ext}}\f$ is regulated to the desired wrench
+ * with a feedforward and PI controller. On motion controlled axes, the end effector is held at the
+ * desired pose with a Cartesian impedance. The desired wrench uses the convention of
+ * \f$^O\hat{F}_{K,\text{ext}}\f$, i.e. it is the wrench applied by the robot to its environment.
+ *
+ * The controller does not allocate memory and does not query the model itself. The model
+ * quantities are passed in, so that several controllers can share them in one control cycle:
+ *
+ * @code{.cpp}
+ * franka::ModelQuantities quantities;
+ * robot.control([&](const franka::RobotState& robot_state, franka::Duration period) {
+ *   model.computeQuantities(robot_state, &quantities);
+ *   return controller(robot_state, period, quantities);
+ * });
+ * @endcode
+ */
+class HybridForceMotionController {
+ public:
+  /**
+   * Creates a new HybridForceMotionController instance.
+   *
+   * @param[in] parameters Controller parameters.
+   *
+   * @throw std::invalid_argument if a parameter is out of range.
+   */
+  explicit HybridForceMotionController(const HybridForceMotionParameters& parameters = {});
+
+  /**
+   * Computes the commanded torques for the next control cycle.
+   *
+   * If no desired pose has been set, the end effector pose of the first robot state after
+   * construction or reset is used.
+   *
+   * @param[in] robot_state Current robot state.
+   * @param[in] period Time since the last call.
+   * @param[in] quantities Model quantities of robot_state, e.g. from Model::computeQuantities.
+   *
+   * @return Commanded joint torques.
+   */
+  Torques operator()(const RobotState& robot_state,
+                     Duration period,
+                     const ModelQuantities& quantities) noexcept;
+
+  /**
+   * Sets the desired end effector pose for the motion controlled axes.
+   *
+   * @param[in] O_T_EE_d Desired end effector pose in base frame, in column-major format.
+   */
+  void setDesiredPose(
+      const std::array<double, 16>& O_T_EE_d)  // NOLINT(readability-identifier-naming)
+      noexcept;
+
+  /**
+   * Sets the desired wrench for the force controlled axes.
+   *
+   * @param[in] O_F_d Desired wrench in base frame. Unit: \f$[N,N,N,Nm,Nm,Nm]\f$.
+   */
+  void setDesiredWrench(
+      const std::array<double, 6>& O_F_d)  // NOLINT(readability-identifier-naming)
+      noexcept;
+
+  /**
+   * Returns the controller parameters.
+   *
+   * @return Controller parameters.
+   */
+  const HybridForceMotionParameters& parameters() const noexcept;
+
+  /**
+   * Clears the force integrators and the desired pose.
+   */
+  void reset() noexcept;
+
+ private:
+  HybridForceMotionParameters parameters_;
+  bool has_desired_pose_;
+  std::array<double, 16> desired_pose_;
+  std::array<double, 6> desired_wrench_;
+  std::array<double, 6> integral_wrench_;
+};
+
+}  // namespace franka
@@ -0,0 +1,114 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file inverse_kinematics.h
+ * Contains a closed-form inverse kinematics solver for the nominal kinematics of the robot.
+ */
+
+namespace franka {
+
+/**
+ * Calculates all joint positions that reach a given end effector pose.
+ *
+ * The robot has seven joints, so a pose is reached by a one-dimensional set of joint positions.
+ * The solver resolves this redundancy by fixing the position of the 7th joint. For a given
+ * \f$q_7\f$, a pose is reached by up to eight joint positions: the elbow can be bent to either
+ * side of the stretched arm, the wrist has two branches of the 6th joint, and the shoulder two
+ * branches of the 1st and 2nd joint. All of them are returned as long as they are within the
+ * joint limits of franka::PandaTraits.
+ *
+ * The solver uses the nominal kinematic parameters, i.e. its solutions reproduce the poses of
+ * franka::Model and of franka::Kinematics without calibration. It does not allocate memory except
+ * for the batched solve() and is suitable for the realtime thread.
+ *
+ * @note The elbow of franka::CartesianPose is parameterized by \f$q_3\f$ and the sign of
+ * \f$q_4\f$ instead; both can be read from the solutions.
+ */
+class InverseKinematics {
+ public:
+  /**
+   * Maximum number of solutions for one position of the 7th joint.
+   */
+  static constexpr size_t kMaxSolutions = 8;
+
+  /**
+   * Joint positions reaching a pose.
+   */
+  using Solutions = std::array<std::array<double, 7>, kMaxSolutions>;
+
+  /**
+   * Creates a new solver for poses of the flange.
+   */
+  InverseKinematics() noexcept;
+
+  /**
+   * Creates a new solver for poses of the given end effector.
+   *
+   * @param[in] F_T_EE End effector in flange frame, e.g. franka::RobotState::F_T_EE.
+   */
+  explicit InverseKinematics(
+      const std::array<double, 16>& F_T_EE) noexcept;  // NOLINT(readability-identifier-naming)
+
+  /**
+   * Calculates the joint positions reaching a pose for a given position of the 7th joint.
+   *
+   * If the 2nd joint is at zero, only the sum of \f$q_1\f$ and \f$q_3\f$ is determined. In this
+   * case a single solution with the given \f$q_1\f$ is returned.
+   *
+   * @param[in] O_T_EE End effector pose in base frame, column-major.
+   * @param[in] q7 Position of the 7th joint in \f$[rad]\f$.
+   * @param[out] solutions Joint positions. Only the first solutions, up to the returned number,
+   * are set.
+   * @param[in] q1 Position of the 1st joint in \f$[rad]\f$ used if the 2nd joint is at zero.
+   *
+   * @return Number of solutions, or zero if the pose cannot be reached within the joint limits.
+   */
+  size_t solve(const std::array<double, 16>& O_T_EE,  // NOLINT(readability-identifier-naming)
+               double q7,
+               Solutions* solutions,
+               double q1 = 0.0) const noexcept;
+
+  /**
+   * Calculates the joint positions reaching a pose for several positions of the 7th joint.
+   *
+   * The parts of the solution that do not depend on \f$q_7\f$ are calculated once, and the
+   * samples are processed in blocks whose arithmetic is vectorized by the compiler.
+   *
+   * @param[in] O_T_EE End effector pose in base frame, column-major.
+   * @param[in] q7 Positions of the 7th joint in \f$[rad]\f$.
+   * @param[out] solutions Joint positions of all samples, in the order of the samples. Cleared
+   * before solving; its capacity is reused.
+   * @param[in] q1 Position of the 1st joint in \f$[rad]\f$ used if the 2nd joint is at zero.
+   *
+   * @return Number of solutions.
+   */
+  size_t solve(const std::array<double, 16>& O_T_EE,  // NOLINT(readability-identifier-naming)
+               const std::vector<double>& q7,
+               std::vector<std::array<double, 7>>* solutions,
+               double q1 = 0.0) const;
+
+  /**
+   * Calculates the joint positions reaching a pose that are closest to the given joint positions
+   * while keeping their 7th joint.
+   *
+   * @param[in] O_T_EE End effector pose in base frame, column-major.
+   * @param[in] q Current joint positions.
+   * @param[out] solution Closest joint positions.
+   *
+   * @return False if the pose cannot be reached within the joint limits.
+   */
+  bool solveClosest(const std::array<double, 16>& O_T_EE,  // NOLINT(readability-identifier-naming)
+                    const std::array<double, 7>& q,
+                    std::array<double, 7>* solution) const noexcept;
+
+ private:
+  std::array<double, 16> EE_T_F_;  // NOLINT(readability-identifier-naming)
+};
+
+}  // namespace franka
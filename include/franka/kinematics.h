@@ -0,0 +1,179 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <istream>
+
+#include <franka/model.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file kinematics.h
+ * Contains a native forward kinematics implementation supporting kinematic calibration.
+ */
+
+namespace franka {
+
+/**
+ * Corrections of the modified Denavit-Hartenberg parameters of one link.
+ *
+ * All values are added to the nominal parameters.
+ */
+struct LinkCalibration {
+  /**
+   * Correction of the link length \f$a_{i-1}\f$ in \f$[m]\f$.
+   */
+  double a{0.0};
+
+  /**
+   * Correction of the link offset \f$d_i\f$ in \f$[m]\f$.
+   */
+  double d{0.0};
+
+  /**
+   * Correction of the link twist \f$\alpha_{i-1}\f$ in \f$[rad]\f$.
+   */
+  double alpha{0.0};
+
+  /**
+   * Correction of the joint angle offset \f$\theta_i\f$ in \f$[rad]\f$.
+   */
+  double theta{0.0};
+};
+
+/**
+ * Kinematic calibration of a robot, e.g. identified with an external measurement system.
+ */
+struct KinematicCalibration {
+  /**
+   * Corrections of the links from the base to joint 1 up to joint 6 to joint 7, followed by the
+   * correction of the transformation from joint 7 to the flange.
+   */
+  std::array<LinkCalibration, 8> links{};
+};
+
+/**
+ * Reads a kinematic calibration.
+ *
+ * Each line contains the name of a link followed by the corrections of \f$a\f$, \f$d\f$,
+ * \f$\alpha\f$ and \f$\theta\f$, e.g. `joint2 0.0 0.0 0.0012 -0.0004`. Links are named
+ * `joint1` to `joint7` and `flange`. Links which are not listed are not corrected. Text after `#`
+ * is ignored.
+ *
+ * @param[in] input Stream to read from.
+ *
+ * @return Kinematic calibration.
+ *
+ * @throw ModelException if the input is malformed.
+ */
+KinematicCalibration readKinematicCalibration(std::istream& input);
+
+/**
+ * Calculates poses and Jacobians of the robot from its kinematic parameters.
+ *
+ * In contrast to franka::Model, which uses the nominal kinematics of the model library, a
+ * kinematic calibration can be applied. The constant part of each link transformation, including
+ * its corrections, is calculated once on construction, so that a calibration does not add cost to
+ * a query.
+ */
+class Kinematics {
+ public:
+  /**
+   * Creates a new Kinematics instance with the nominal kinematic parameters.
+   */
+  Kinematics() noexcept;
+
+  /**
+   * Creates a new Kinematics instance with calibrated kinematic parameters.
+   *
+   * @param[in] calibration Corrections of the nominal kinematic parameters.
+   */
+  explicit Kinematics(const KinematicCalibration& calibration) noexcept;
+
+  /**
+   * Gets the 4x4 pose matrix for the given frame in base frame.
+   *
+   * @param[in] frame The desired frame.
+   * @param[in] robot_state State from which the pose should be calculated.
+   *
+   * @return Vectorized 4x4 pose matrix, column-major.
+   */
+  std::array<double, 16> pose(Frame frame, const franka::RobotState& robot_state) const;
+
+  /**
+   * Gets the 4x4 pose matrix for the given frame in base frame.
+   *
+   * @param[in] frame The desired frame.
+   * @param[in] q Joint position.
+   * @param[in] F_T_EE End effector in flange frame.
+   * @param[in] EE_T_K Stiffness frame K in the end effector frame.
+   *
+   * @return Vectorized 4x4 pose matrix, column-major.
+   */
+  std::array<double, 16> pose(
+      Frame frame,
+      const std::array<double, 7>& q,
+      const std::array<double, 16>& F_T_EE,  // NOLINT(readability-identifier-naming)
+      const std::array<double, 16>& EE_T_K)  // NOLINT(readability-identifier-naming)
+      const;
+
+  /**
+   * Gets the 6x7 Jacobian for the given frame, relative to that frame.
+   *
+   * @param[in] frame The desired frame.
+   * @param[in] robot_state State from which the Jacobian should be calculated.
+   *
+   * @return Vectorized 6x7 Jacobian, column-major.
+   */
+  std::array<double, 42> bodyJacobian(Frame frame, const franka::RobotState& robot_state) const;
+
+  /**
+   * Gets the 6x7 Jacobian for the given frame, relative to that frame.
+   *
+   * @param[in] frame The desired frame.
+   * @param[in] q Joint position.
+   * @param[in] F_T_EE End effector in flange frame.
+   * @param[in] EE_T_K Stiffness frame K in the end effector frame.
+   *
+   * @return Vectorized 6x7 Jacobian, column-major.
+   */
+  std::array<double, 42> bodyJacobian(
+      Frame frame,
+      const std::array<double, 7>& q,
+      const std::array<double, 16>& F_T_EE,  // NOLINT(readability-identifier-naming)
+      const std::array<double, 16>& EE_T_K)  // NOLINT(readability-identifier-naming)
+      const;
+
+  /**
+   * Gets the 6x7 Jacobian for the given frame, relative to the base frame.
+   *
+   * @param[in] frame The desired frame.
+   * @param[in] robot_state State from which the Jacobian should be calculated.
+   *
+   * @return Vectorized 6x7 Jacobian, column-major.
+   */
+  std::array<double, 42> zeroJacobian(Frame frame, const franka::RobotState& robot_state) const;
+
+  /**
+   * Gets the 6x7 Jacobian for the given frame, relative to the base frame.
+   *
+   * @param[in] frame The desired frame.
+   * @param[in] q Joint position.
+   * @param[in] F_T_EE End effector in flange frame.
+   * @param[in] EE_T_K Stiffness frame K in the end effector frame.
+   *
+   * @return Vectorized 6x7 Jacobian, column-major.
+   */
+  std::array<double, 42> zeroJacobian(
+      Frame frame,
+      const std::array<double, 7>& q,
+      const std::array<double, 16>& F_T_EE,  // NOLINT(readability-identifier-naming)
+      const std::array<double, 16>& EE_T_K)  // NOLINT(readability-identifier-naming)
+      const;
+
+ private:
+  std::array<std::array<double, 16>, 8> link_transforms_;
+};
+
+}  // namespace franka
@@ -2,6 +2,7 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include <franka/control_types.h>
@@ -54,6 +55,13 @@ struct Record {
    * Robot command of timestamp n, after rate limiting (if activated).
    */
   RobotCommand command;
+  /**
+   * Mechanical joint power \f$\tau_J \dot{q}\f$ of the robot state in \f$[W]\f$. Only set if
+   * energy accounting is enabled, zero otherwise.
+   *
+   * @see Robot::setEnergyAccounting
+   */
+  std::array<double, 7> joint_power{};
 };
 
 /**
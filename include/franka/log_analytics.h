@@ -0,0 +1,373 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <franka/duration.h>
+#include <franka/log.h>
+#include <franka/model.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file log_analytics.h
+ * Contains types for the parallel analysis of log files.
+ */
+
+namespace franka {
+
+/**
+ * Selects records of a LogDataset.
+ *
+ * All conditions are checked on the stored data before a record is decoded, so that records which
+ * are not selected are skipped at little cost.
+ */
+class LogQuery {
+ public:
+  /**
+   * Only selects records with a robot time in the given range.
+   *
+   * @param[in] start First selected robot time.
+   * @param[in] end Last selected robot time.
+   *
+   * @return This query.
+   */
+  LogQuery& robotTime(Duration start, Duration end) noexcept;
+
+  /**
+   * Only selects records with a host time in the given range.
+   *
+   * Records of log files without host time have a host time of zero.
+   *
+   * @param[in] start First selected host time.
+   * @param[in] end Last selected host time.
+   *
+   * @return This query.
+   */
+  LogQuery& hostTime(std::chrono::nanoseconds start, std::chrono::nanoseconds end) noexcept;
+
+  /**
+   * Only selects records in which an element of a robot state field is in the given range.
+   *
+   * Example for selecting joint configurations close to a pose `q_0`:
+   * @code
+   * for (size_t i = 0; i < 7; i++) {
+   *   query.range(&RobotState::q, i, q_0[i] - 0.1, q_0[i] + 0.1);
+   * }
+   * @endcode
+   *
+   * @param[in] field Robot state field.
+   * @param[in] index Element of the field.
+   * @param[in] min Smallest selected value.
+   * @param[in] max Largest selected value.
+   *
+   * @return This query.
+   *
+   * @throw std::invalid_argument if the index is out of range.
+   */
+  template <size_t N>
+  LogQuery& range(std::array<double, N> RobotState::*field, size_t index, double min, double max);
+
+  /**
+   * Only selects records in which a robot state field is in the given range.
+   *
+   * @param[in] field Robot state field.
+   * @param[in] min Smallest selected value.
+   * @param[in] max Largest selected value.
+   *
+   * @return This query.
+   */
+  LogQuery& range(double RobotState::*field, double min, double max);
+
+ private:
+  friend class LogDataset;
+
+  struct FieldRange {
+    size_t state_offset;
+    double min;
+    double max;
+  };
+
+  LogQuery& addRange(size_t state_offset, double min, double max);
+
+  Duration robot_time_start_{};
+  Duration robot_time_end_{std::numeric_limits<uint64_t>::max()};
+  std::chrono::nanoseconds host_time_start_{std::chrono::nanoseconds::min()};
+  std::chrono::nanoseconds host_time_end_{std::chrono::nanoseconds::max()};
+  std::vector<FieldRange> ranges_;
+};
+
+/**
+ * Provides parallel read access to the records of a set of log files.
+ *
+ * Log files written with LogFileWriter are memory-mapped and split into chunks of records, which
+ * are processed by several threads.
+ */
+class LogDataset {
+ public:
+  /**
+   * Callback for selected records.
+   *
+   * Receives the index of the worker thread, which is smaller than the number of threads, the
+   * record and its host time.
+   */
+  using Callback = std::function<void(size_t, const Record&, std::chrono::nanoseconds)>;
+
+  /**
+   * Opens the given log files.
+   *
+   * @param[in] paths Paths of the log files.
+   *
+   * @throw LogFileException if a file cannot be opened or has an invalid format.
+   */
+  explicit LogDataset(const std::vector<std::string>& paths);
+
+  /**
+   * Move-constructs a new LogDataset instance.
+   *
+   * @param[in] dataset Other LogDataset instance.
+   */
+  LogDataset(LogDataset&& dataset) noexcept;
+
+  /**
+   * Move-assigns this LogDataset from another LogDataset instance.
+   *
+   * @param[in] dataset Other LogDataset instance.
+   *
+   * @return LogDataset instance.
+   */
+  LogDataset& operator=(LogDataset&& dataset) noexcept;
+
+  /**
+   * Unmaps the log files.
+   */
+  ~LogDataset() noexcept;
+
+  /**
+   * Returns the total number of records.
+   *
+   * @return Number of records in all log files.
+   */
+  size_t size() const noexcept;
+
+  /**
+   * Returns the number of worker threads used for the given requested number.
+   *
+   * @param[in] threads Requested number of threads, or zero to use one thread per core.
+   *
+   * @return Number of worker threads.
+   */
+  static size_t workerCount(size_t threads) noexcept;
+
+  /**
+   * Calls the callback for each selected record.
+   *
+   * The callback is called concurrently from several worker threads, but never concurrently with
+   * the same worker index. The order of the records is unspecified.
+   *
+   * @param[in] query Selects the records.
+   * @param[in] callback Callback for each selected record.
+   * @param[in] threads Number of worker threads, or zero to use one thread per core.
+   *
+   * @throw Any exception thrown by the callback.
+   */
+  void forEach(const LogQuery& query, const Callback& callback, size_t threads = 0) const;
+
+  /**
+   * Maps each selected record into one partial result per worker thread and reduces the partial
+   * results.
+   *
+   * @param[in] query Selects the records.
+   * @param[in] initial Initial value of each partial result.
+   * @param[in] map Adds a record and its host time to a partial result.
+   * @param[in] reduce Adds the second partial result to the first one.
+   * @param[in] threads Number of worker threads, or zero to use one thread per core.
+   *
+   * @return Reduced result.
+   *
+   * @throw Any exception thrown by map or reduce.
+   */
+  template <typename T>
+  T mapReduce(const LogQuery& query,
+              const T& initial,
+              std::function<void(T&, const Record&, std::chrono::nanoseconds)> map,
+              std::function<void(T&, const T&)> reduce,
+              size_t threads = 0) const;
+
+  LogDataset(const LogDataset&) = delete;
+  LogDataset& operator=(const LogDataset&) = delete;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * Summary of a residual signal per joint.
+ */
+struct JointResidualStatistics {
+  /**
+   * Mean residual.
+   */
+  std::array<double, 7> mean{};
+
+  /**
+   * Root mean square of the residual.
+   */
+  std::array<double, 7> rms{};
+
+  /**
+   * Maximum absolute residual.
+   */
+  std::array<double, 7> max{};
+};
+
+/**
+ * Residuals between logged values and values re-evaluated with a franka::Model.
+ *
+ * @see computeModelResiduals
+ */
+struct ModelResiduals {
+  /**
+   * Difference between \f$\tau_J\f$ and the gravity torque \f$g(q)\f$ in \f$[Nm]\f$.
+   */
+  JointResidualStatistics gravity;
+
+  /**
+   * Difference between \f$\tau_J\f$ and the rigid body torque
+   * \f$M(q)\ddot{q}_d + c(q, \dot{q}) + g(q)\f$ in \f$[Nm]\f$.
+   *
+   * The robot state does not contain a measured joint acceleration, so the inertial torque is
+   * calculated from the desired acceleration. The residual therefore also contains the effect of
+   * the tracking error of the controller.
+   */
+  JointResidualStatistics dynamics;
+
+  /**
+   * Root mean square of the distance between the logged \f$^OT_{EE}\f$ and the end effector pose
+   * calculated from \f$q\f$ in \f$[m]\f$.
+   */
+  double translational_rms{};
+
+  /**
+   * Maximum distance between the logged \f$^OT_{EE}\f$ and the end effector pose calculated from
+   * \f$q\f$ in \f$[m]\f$.
+   */
+  double translational_max{};
+
+  /**
+   * Number of evaluated records.
+   */
+  uint64_t samples{};
+};
+
+/**
+ * Re-evaluates the gravity torque, mass matrix, Coriolis torque and end effector pose for all
+ * selected records and compares them to the logged values.
+ *
+ * The dynamics residual uses the desired instead of a measured joint acceleration, see
+ * ModelResiduals::dynamics.
+ *
+ * @param[in] dataset Log files.
+ * @param[in] model Model of the robot the logs have been recorded with.
+ * @param[in] query Selects the records, e.g. within a region of the joint space.
+ * @param[in] threads Number of worker threads, or zero to use one thread per core.
+ *
+ * @return Residual statistics.
+ */
+ModelResiduals computeModelResiduals(const LogDataset& dataset,
+                                     const Model& model,
+                                     const LogQuery& query = LogQuery(),
+                                     size_t threads = 0);
+
+/**
+ * Statistics of the control command success rate within a period of time.
+ *
+ * @see computeSuccessRates
+ */
+struct SuccessRateBucket {
+  /**
+   * Start of the period.
+   */
+  std::chrono::nanoseconds start{};
+
+  /**
+   * Mean control command success rate.
+   */
+  double mean{};
+
+  /**
+   * Minimum control command success rate.
+   */
+  double min{};
+
+  /**
+   * Number of records in the period.
+   */
+  uint64_t samples{};
+};
+
+/**
+ * Computes statistics of the control command success rate per period of time, e.g. per hour.
+ *
+ * Records are assigned to periods by their host time. Records without host time are assigned by
+ * their robot time instead.
+ *
+ * @param[in] dataset Log files.
+ * @param[in] period Length of each period.
+ * @param[in] query Selects the records.
+ * @param[in] threads Number of worker threads, or zero to use one thread per core.
+ *
+ * @return Statistics of all periods containing selected records, ordered by time.
+ *
+ * @throw std::invalid_argument if the period is not positive.
+ */
+std::vector<SuccessRateBucket> computeSuccessRates(const LogDataset& dataset,
+                                                   std::chrono::nanoseconds period,
+                                                   const LogQuery& query = LogQuery(),
+                                                   size_t threads = 0);
+
+template <size_t N>
+LogQuery& LogQuery::range(std::array<double, N> RobotState::*field,
+                          size_t index,
+                          double min,
+                          double max) {
+  if (index >= N) {
+    throw std::invalid_argument("libfranka: Invalid field index.");
+  }
+  RobotState state;
+  size_t state_offset = static_cast<size_t>(reinterpret_cast<const char*>(&(state.*field)[index]) -
+                                            reinterpret_cast<const char*>(&state));
+  return addRange(state_offset, min, max);
+}
+
+template <typename T>
+T LogDataset::mapReduce(const LogQuery& query,
+                        const T& initial,
+                        std::function<void(T&, const Record&, std::chrono::nanoseconds)> map,
+                        std::function<void(T&, const T&)> reduce,
+                        size_t threads) const {
+  std::vector<T> partial_results(workerCount(threads), initial);
+  forEach(query,
+          [&](size_t worker, const Record& record, std::chrono::nanoseconds host_time) {
+            map(partial_results[worker], record, host_time);
+          },
+          partial_results.size());
+
+  T result = initial;
+  for (const T& partial_result : partial_results) {
+    reduce(result, partial_result);
+  }
+  return result;
+}
+
+}  // namespace franka
@@ -0,0 +1,132 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <franka/log.h>
+
+/**
+ * @file log_file.h
+ * Contains types for storing logs in a compact binary format.
+ *
+ * A log file starts with a header containing a magic string, the format version and the size of a
+ * record. It is followed by fixed-size records, each holding the complete robot state, the robot
+ * command, the joint power and the host time at which the state was received, in host byte order.
+ */
+
+namespace franka {
+
+/**
+ * Version of the log file format written by LogFileWriter.
+ */
+constexpr uint32_t kLogFileVersion = 3;
+
+/**
+ * Writes records to a binary log file.
+ */
+class LogFileWriter {
+ public:
+  /**
+   * Creates a new LogFileWriter instance and writes the file header.
+   *
+   * @param[in] stream Binary output stream. Must outlive the writer.
+   *
+   * @throw LogFileException if the header cannot be written.
+   */
+  explicit LogFileWriter(std::ostream& stream);
+
+  /**
+   * Appends a record without host receive time.
+   *
+   * @param[in] record Record to write.
+   *
+   * @throw LogFileException if the record cannot be written.
+   */
+  void write(const Record& record);
+
+  /**
+   * Appends a record.
+   *
+   * @param[in] record Record to write.
+   * @param[in] host_time Host time at which the robot state was received, e.g. taken from
+   * std::chrono::steady_clock at the beginning of a control callback. Zero if unknown.
+   *
+   * @throw LogFileException if the record cannot be written.
+   */
+  void write(const Record& record, std::chrono::nanoseconds host_time);
+
+  /**
+   * Appends all records of a log.
+   *
+   * @param[in] log Records to write, e.g. provided by the ControlException.
+   *
+   * @throw LogFileException if a record cannot be written.
+   */
+  void write(const std::vector<Record>& log);
+
+ private:
+  std::ostream& stream_;
+  std::vector<char> buffer_;
+};
+
+/**
+ * Reads records from a binary log file written by LogFileWriter.
+ */
+class LogFileReader {
+ public:
+  /**
+   * Creates a new LogFileReader instance and validates the file header.
+   *
+   * Files of format versions 1 and 2 can be read as well. Their records have no joint power, and
+   * records of version 1 files have no host receive time either.
+   *
+   * @param[in] stream Binary input stream. Must outlive the reader.
+   *
+   * @throw LogFileException if the stream does not contain a supported log file.
+   */
+  explicit LogFileReader(std::istream& stream);
+
+  /**
+   * Reads the next record.
+   *
+   * @param[out] record Filled with the next record.
+   *
+   * @return True if a record was read, false at the end of the file.
+   *
+   * @throw LogFileException if the file ends within a record.
+   */
+  bool read(Record* record);
+
+  /**
+   * Reads the next record together with its host receive time.
+   *
+   * @param[out] record Filled with the next record.
+   * @param[out] host_time Filled with the host receive time, or zero if unknown.
+   *
+   * @return True if a record was read, false at the end of the file.
+   *
+   * @throw LogFileException if the file ends within a record.
+   */
+  bool read(Record* record, std::chrono::nanoseconds* host_time);
+
+  /**
+   * Reads all remaining records.
+   *
+   * @return Remaining records.
+   *
+   * @throw LogFileException if the file ends within a record.
+   */
+  std::vector<Record> readAll();
+
+ private:
+  std::istream& stream_;
+  uint32_t version_;
+  std::vector<char> buffer_;
+};
+
+}  // namespace franka
@@ -0,0 +1,188 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <franka/duration.h>
+#include <franka/gripper_state.h>
+#include <franka/log_file.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file log_merge.h
+ * Contains types for merging robot and gripper logs onto a common host timeline.
+ */
+
+namespace franka {
+
+/**
+ * Maps device timestamps, such as RobotState::time, to the host timebase.
+ *
+ * The offset between both clocks is estimated from pairs of device timestamps and host receive
+ * times. Since receiving a message can only be delayed, the smallest observed difference is the
+ * best estimate of the offset. Clock drift over a recording is assumed to be negligible.
+ */
+class ClockAlignment {
+ public:
+  /**
+   * Adds an observation.
+   *
+   * @param[in] device_time Timestamp of a message in the device timebase.
+   * @param[in] host_time Host time at which the message was received.
+   */
+  void update(Duration device_time, std::chrono::nanoseconds host_time) noexcept;
+
+  /**
+   * Checks whether an offset has been estimated.
+   *
+   * @return True after the first call to update.
+   */
+  bool valid() const noexcept;
+
+  /**
+   * Converts a device timestamp to the host timebase.
+   *
+   * @param[in] device_time Timestamp in the device timebase.
+   *
+   * @return Timestamp in the host timebase, or the device timestamp itself if no offset has been
+   * estimated yet.
+   */
+  std::chrono::nanoseconds toHostTime(Duration device_time) const noexcept;
+
+  /**
+   * Discards all observations.
+   */
+  void reset() noexcept;
+
+ private:
+  bool valid_{false};
+  std::chrono::nanoseconds offset_{0};
+};
+
+/**
+ * Source of timestamped samples for mergeLogs.
+ */
+class LogSource {
+ public:
+  virtual ~LogSource() noexcept = default;
+
+  /**
+   * Returns the names of the columns provided by this source.
+   *
+   * @return Column names.
+   */
+  virtual const std::vector<std::string>& columns() const noexcept = 0;
+
+  /**
+   * Reads the next sample.
+   *
+   * Host times of consecutive samples must not decrease.
+   *
+   * @param[out] host_time Filled with the time of the sample in the host timebase.
+   * @param[out] values Filled with one value per column.
+   *
+   * @return True if a sample was read, false if the source is exhausted.
+   */
+  virtual bool next(std::chrono::nanoseconds* host_time, std::vector<double>* values) = 0;
+};
+
+/**
+ * Provides robot states from a recording or a live stream.
+ *
+ * The columns are the robot time in \f$[ms]\f$, the control command success rate, \f$q\f$,
+ * \f$q_d\f$, \f$\dot{q}\f$, \f$\dot{q}_d\f$, \f$\tau_J\f$, \f$\hat{\tau}_{\text{ext}}\f$,
+ * \f$^O T_{EE}\f$ and \f$^O\hat{F}_{K,\text{ext}}\f$, prefixed with the source name.
+ */
+class RobotStateSource : public LogSource {
+ public:
+  /**
+   * Reads the next robot state and its host receive time, or returns false if there are no more
+   * states. The host receive time is zero if unknown.
+   */
+  using ReadFunction = std::function<bool(RobotState*, std::chrono::nanoseconds*)>;
+
+  /**
+   * Creates a new RobotStateSource instance.
+   *
+   * @param[in] name Prefix for the column names.
+   * @param[in] read Function providing the robot states.
+   */
+  RobotStateSource(const std::string& name, ReadFunction read);
+
+  /**
+   * Creates a new RobotStateSource instance reading from a log file.
+   *
+   * @param[in] name Prefix for the column names.
+   * @param[in] reader Log file reader. Must outlive the source.
+   */
+  RobotStateSource(const std::string& name, LogFileReader& reader);
+
+  const std::vector<std::string>& columns() const noexcept override;
+  bool next(std::chrono::nanoseconds* host_time, std::vector<double>* values) override;
+
+ private:
+  ReadFunction read_;
+  std::vector<std::string> columns_;
+  ClockAlignment alignment_;
+  std::chrono::nanoseconds last_host_time_;
+  RobotState state_;
+};
+
+/**
+ * Provides gripper states from a recording or a live stream.
+ *
+ * The columns are the gripper time in \f$[ms]\f$, the width, the maximum width, the grasp flag and
+ * the temperature, prefixed with the source name.
+ */
+class GripperStateSource : public LogSource {
+ public:
+  /**
+   * Reads the next gripper state and its host receive time, or returns false if there are no
+   * more states. The host receive time is zero if unknown.
+   */
+  using ReadFunction = std::function<bool(GripperState*, std::chrono::nanoseconds*)>;
+
+  /**
+   * Creates a new GripperStateSource instance.
+   *
+   * @param[in] name Prefix for the column names.
+   * @param[in] read Function providing the gripper states, e.g. calling Gripper::readOnce.
+   */
+  GripperStateSource(const std::string& name, ReadFunction read);
+
+  const std::vector<std::string>& columns() const noexcept override;
+  bool next(std::chrono::nanoseconds* host_time, std::vector<double>* values) override;
+
+ private:
+  ReadFunction read_;
+  std::vector<std::string> columns_;
+  ClockAlignment alignment_;
+  std::chrono::nanoseconds last_host_time_;
+  GripperState state_;
+};
+
+/**
+ * Merges several sources into one CSV table ordered by host time.
+ *
+ * The sources are merged in a streaming fashion, holding only the most recent sample of each
+ * source in memory. Each row contains the host time in \f$[ns]\f$ and the columns of all sources.
+ * The source that produced the row provides new values, all other sources repeat their most
+ * recent values, or leave the cells empty before their first sample. Samples with equal host
+ * time are ordered by source index.
+ *
+ * @param[in] sources Sources to merge. Must not be null.
+ * @param[out] output Stream for the CSV table.
+ *
+ * @return Number of written rows.
+ *
+ * @throw LogFileException if the output cannot be written.
+ */
+size_t mergeLogs(const std::vector<LogSource*>& sources, std::ostream& output);
+
+}  // namespace franka
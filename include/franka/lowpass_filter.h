@@ -2,7 +2,9 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #pragma once
 
+#include <array>
 #include <cmath>
+#include <cstddef>
 
 /**
  * @file lowpass_filter.h
@@ -33,4 +35,47 @@ inline double lowpassFilter(double sample_time, double y, double y_last, double
   return gain * y + (1 - gain) * y_last;
 }
 
+/**
+ * Applies a first-order low-pass filter to each element of a vector.
+ *
+ * @tparam N Number of elements, e.g. RobotTraits::kDof.
+ *
+ * @param[in] sample_time Sample time constant
+ * @param[in] y Current values of the signal to be filtered
+ * @param[in] y_last Values of the signal to be filtered in the previous time step
+ * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter
+ *
+ * @return Filtered values.
+ */
+template <size_t N>
+inline std::array<double, N> lowpassFilter(double sample_time,
+                                           const std::array<double, N>& y,
+                                           const std::array<double, N>& y_last,
+                                           double cutoff_frequency) {
+  double gain = sample_time / (sample_time + (1.0 / (2.0 * M_PI * cutoff_frequency)));
+  std::array<double, N> filtered{};
+  for (size_t i = 0; i < N; i++) {
+    filtered[i] = gain * y[i] + (1 - gain) * y_last[i];
+  }
+  return filtered;
+}
+
+/**
+ * Applies a first-order low-pass filter to a homogeneous transformation.
+ *
+ * The translation is filtered element-wise. The rotation is interpolated on the unit sphere of
+ * quaternions with the same gain, so that the filtered rotation stays orthonormal.
+ *
+ * @param[in] sample_time Sample time constant
+ * @param[in] y Current homogeneous transformation, column major
+ * @param[in] y_last Homogeneous transformation in the previous time step, column major
+ * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter
+ *
+ * @return Filtered homogeneous transformation, column major.
+ */
+std::array<double, 16> cartesianLowpassFilter(double sample_time,
+                                              const std::array<double, 16>& y,
+                                              const std::array<double, 16>& y_last,
+                                              double cutoff_frequency);
+
 }  // namespace franka
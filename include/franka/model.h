@@ -4,6 +4,7 @@
 
 #include <array>
 #include <memory>
+#include <string>
 
 #include <franka/robot.h>
 #include <franka/robot_state.h>
@@ -42,6 +43,28 @@ enum class Frame {
  */
 Frame operator++(Frame& frame, int /* dummy */) noexcept;
 
+/**
+ * Model quantities of a robot state that are commonly needed by torque controllers.
+ *
+ * @see Model::computeQuantities
+ */
+struct ModelQuantities {
+  /**
+   * \f$6 \times 7\f$ zero Jacobian of the end effector frame, in column-major format.
+   */
+  std::array<double, 42> zero_jacobian{};
+
+  /**
+   * \f$7 \times 7\f$ mass matrix, in column-major format. Unit: \f$[kg \times m^2]\f$.
+   */
+  std::array<double, 49> mass{};
+
+  /**
+   * Coriolis force vector. Unit: \f$[Nm]\f$.
+   */
+  std::array<double, 7> coriolis{};
+};
+
 class ModelLibrary;
 class Network;
 
@@ -63,6 +86,18 @@ class Model {
    */
   explicit Model(franka::Network& network);
 
+  /**
+   * Creates a new Model instance from a model library file.
+   *
+   * Allows to evaluate the model without a connection to the robot, e.g. to analyze recorded
+   * logs. The model library has to belong to the robot the logs have been recorded with.
+   *
+   * @param[in] model_library_path Path to the model library.
+   *
+   * @throw ModelException if the model library cannot be loaded.
+   */
+  explicit Model(const std::string& model_library_path);
+
   /**
    * Move-constructs a new Model instance.
    *
@@ -271,6 +306,19 @@ class Model {
                                 const std::array<double, 3>& gravity_earth = {
                                     {0., 0., -9.81}}) const noexcept;
 
+  /**
+   * Calculates the zero Jacobian of the end effector, the mass matrix and the Coriolis force vector
+   * from the given robot state in a single call.
+   *
+   * The results are written into preallocated storage, so that several controllers can share
+   * the model queries of one control cycle.
+   *
+   * @param[in] robot_state State from which the quantities should be calculated.
+   * @param[out] quantities Storage for the calculated quantities.
+   */
+  void computeQuantities(const franka::RobotState& robot_state, ModelQuantities* quantities) const
+      noexcept;
+
   Model(const Model&) = delete;
   Model& operator=(const Model&) = delete;
 
@@ -0,0 +1,206 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <franka/duration.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file motion_statistics.h
+ * Contains types for computing motion quality statistics while a motion is running.
+ */
+
+namespace franka {
+
+/**
+ * Summary of the absolute value of a tracking error signal.
+ */
+struct ErrorStatistics {
+  /**
+   * Maximum absolute error.
+   */
+  double max{};
+
+  /**
+   * Root mean square of the error.
+   */
+  double rms{};
+
+  /**
+   * Estimated median of the absolute error.
+   */
+  double p50{};
+
+  /**
+   * Estimated 95th percentile of the absolute error.
+   */
+  double p95{};
+
+  /**
+   * Estimated 99th percentile of the absolute error.
+   */
+  double p99{};
+};
+
+/**
+ * Quality summary of a single motion.
+ *
+ * @see Robot::setMotionStatisticsCallback
+ */
+struct MotionStatistics {
+  /**
+   * Per-joint tracking error \f$q_d - q\f$ in \f$[rad]\f$.
+   */
+  std::array<ErrorStatistics, 7> joint_position_error{};
+
+  /**
+   * Translational tracking error between \f${^OT_{EE}}_{d}\f$ and \f$^OT_{EE}\f$ in \f$[m]\f$.
+   */
+  ErrorStatistics translational_error{};
+
+  /**
+   * Rotational tracking error between \f${^OT_{EE}}_{d}\f$ and \f$^OT_{EE}\f$ in \f$[rad]\f$.
+   */
+  ErrorStatistics rotational_error{};
+
+  /**
+   * Peak absolute jerk of \f$\ddot{q}_d\f$ per joint in \f$[\frac{rad}{s^3}]\f$.
+   */
+  std::array<double, 7> peak_joint_jerk{};
+
+  /**
+   * Peak translational jerk of \f$^O\ddot{P}_{EE,c}\f$ in \f$[\frac{m}{s^3}]\f$.
+   */
+  double peak_translational_jerk{};
+
+  /**
+   * Peak rotational jerk of \f$^O\ddot{P}_{EE,c}\f$ in \f$[\frac{rad}{s^3}]\f$.
+   */
+  double peak_rotational_jerk{};
+
+  /**
+   * Number of robot states that were taken into account.
+   */
+  uint64_t samples{};
+
+  /**
+   * Number of control cycles for which no robot state was received.
+   */
+  uint64_t lost_cycles{};
+
+  /**
+   * Time between the first and the last robot state of the motion.
+   */
+  Duration duration{};
+};
+
+/**
+ * Estimates a single quantile of a data stream in constant memory.
+ *
+ * Implements the P² algorithm from: Raj Jain and Imrich Chlamtac. 1985. The P² algorithm for
+ * dynamic calculation of quantiles and histograms without storing observations.
+ */
+class StreamingQuantile {
+ public:
+  /**
+   * Creates a new StreamingQuantile instance.
+   *
+   * @param[in] quantile Quantile to estimate, in range (0, 1).
+   */
+  explicit StreamingQuantile(double quantile) noexcept;
+
+  /**
+   * Adds an observation.
+   *
+   * @param[in] value Observed value.
+   */
+  void add(double value) noexcept;
+
+  /**
+   * Returns the current estimate.
+   *
+   * @return Estimated quantile, or zero if no value has been observed.
+   */
+  double value() const noexcept;
+
+  /**
+   * Discards all observations.
+   */
+  void reset() noexcept;
+
+ private:
+  double quantile_;
+  uint64_t count_{0};
+  std::array<double, 5> heights_{};
+  std::array<double, 5> positions_{};
+  std::array<double, 5> desired_positions_{};
+};
+
+/**
+ * Accumulates MotionStatistics from a stream of robot states in constant memory.
+ *
+ * The accumulator can be fed from within a control loop, as it neither allocates memory nor
+ * blocks.
+ */
+class MotionStatisticsAccumulator {
+ public:
+  /**
+   * Creates a new, empty MotionStatisticsAccumulator instance.
+   */
+  MotionStatisticsAccumulator() noexcept;
+
+  /**
+   * Adds a robot state to the statistics.
+   *
+   * @param[in] robot_state Robot state received during the motion.
+   */
+  void update(const RobotState& robot_state) noexcept;
+
+  /**
+   * Returns the statistics of all robot states added since the last reset.
+   *
+   * @return Motion statistics.
+   */
+  MotionStatistics statistics() const noexcept;
+
+  /**
+   * Discards all added robot states.
+   */
+  void reset() noexcept;
+
+ private:
+  struct ErrorAccumulator {
+    ErrorAccumulator() noexcept;
+
+    void add(double error) noexcept;
+    ErrorStatistics statistics(uint64_t samples) const noexcept;
+    void reset() noexcept;
+
+    double max;
+    double sum_of_squares;
+    StreamingQuantile p50;
+    StreamingQuantile p95;
+    StreamingQuantile p99;
+  };
+
+  std::array<ErrorAccumulator, 7> joint_position_error_;
+  ErrorAccumulator translational_error_;
+  ErrorAccumulator rotational_error_;
+
+  std::array<double, 7> peak_joint_jerk_{};
+  double peak_translational_jerk_{};
+  double peak_rotational_jerk_{};
+
+  std::array<double, 7> last_ddq_d_{};
+  std::array<double, 6> last_O_ddP_EE_c_{};  // NOLINT(readability-identifier-naming)
+
+  uint64_t samples_{0};
+  uint64_t lost_cycles_{0};
+  Duration first_time_{};
+  Duration last_time_{};
+};
+
+}  // namespace franka
@@ -2,7 +2,10 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstddef>
 #include <limits>
 
 /**
@@ -62,6 +65,18 @@ constexpr std::array<double, 7> kMaxJointVelocity{
      2.6100 - kLimitEps - kTolNumberPacketsLost* kDeltaT* kMaxJointAcceleration[4],
      2.6100 - kLimitEps - kTolNumberPacketsLost* kDeltaT* kMaxJointAcceleration[5],
      2.6100 - kLimitEps - kTolNumberPacketsLost* kDeltaT* kMaxJointAcceleration[6]}};
+/**
+ * Minimum joint position
+ */
+constexpr std::array<double, 7> kMinJointPosition{
+    {-2.8973 + kLimitEps, -1.7628 + kLimitEps, -2.8973 + kLimitEps, -3.0718 + kLimitEps,
+     -2.8973 + kLimitEps, -0.0175 + kLimitEps, -2.8973 + kLimitEps}};
+/**
+ * Maximum joint position
+ */
+constexpr std::array<double, 7> kMaxJointPosition{
+    {2.8973 - kLimitEps, 1.7628 - kLimitEps, 2.8973 - kLimitEps, -0.0698 - kLimitEps,
+     2.8973 - kLimitEps, 3.7525 - kLimitEps, 2.8973 - kLimitEps}};
 /**
  * Maximum translational jerk
  */
@@ -211,6 +226,226 @@ std::array<double, 7> limitRate(const std::array<double, 7>& max_velocity,
                                 const std::array<double, 7>& last_commanded_velocities,
                                 const std::array<double, 7>& last_commanded_accelerations);
 
+/**
+ * Limits the rate of an input vector of commands of arbitrary size considering the maximum
+ * allowed time derivatives.
+ *
+ * The loop bound is known at compile time, so that the compiler can unroll and vectorize it.
+ *
+ * @note
+ * FCI filters must be deactivated to work properly.
+ *
+ * @tparam N Number of elements, e.g. RobotTraits::kDof.
+ *
+ * @param[in] max_derivatives Maximum allowed time derivative per element.
+ * @param[in] commanded_values Commanded values of the current time step.
+ * @param[in] last_commanded_values Commanded values of the previous time step.
+ *
+ * @return Rate-limited vector of desired values.
+ */
+template <size_t N>
+inline std::array<double, N> limitRate(const std::array<double, N>& max_derivatives,
+                                       const std::array<double, N>& commanded_values,
+                                       const std::array<double, N>& last_commanded_values) {
+  std::array<double, N> limited_values{};
+  for (size_t i = 0; i < N; i++) {
+    double commanded_derivative = (commanded_values[i] - last_commanded_values[i]) / kDeltaT;
+    limited_values[i] =
+        last_commanded_values[i] +
+        std::max(std::min(commanded_derivative, max_derivatives[i]), -max_derivatives[i]) * kDeltaT;
+  }
+  return limited_values;
+}
+
+/**
+ * Limits the rate of desired joint velocities of a robot with an arbitrary number of joints
+ * considering the limits provided.
+ *
+ * @note
+ * FCI filters must be deactivated to work properly.
+ *
+ * @tparam N Number of joints, e.g. RobotTraits::kDof.
+ *
+ * @param[in] max_velocity Per-joint maximum allowed velocity.
+ * @param[in] max_acceleration Per-joint maximum allowed acceleration.
+ * @param[in] max_jerk Per-joint maximum allowed jerk.
+ * @param[in] commanded_velocities Commanded joint velocity of the current time step.
+ * @param[in] last_commanded_velocities Commanded joint velocities of the previous time step.
+ * @param[in] last_commanded_accelerations Commanded joint accelerations of the previous time step.
+ *
+ * @return Rate-limited vector of desired joint velocities.
+ */
+template <size_t N>
+inline std::array<double, N> limitRate(const std::array<double, N>& max_velocity,
+                                       const std::array<double, N>& max_acceleration,
+                                       const std::array<double, N>& max_jerk,
+                                       const std::array<double, N>& commanded_velocities,
+                                       const std::array<double, N>& last_commanded_velocities,
+                                       const std::array<double, N>& last_commanded_accelerations) {
+  std::array<double, N> limited_commanded_velocities{};
+  for (size_t i = 0; i < N; i++) {
+    limited_commanded_velocities[i] =
+        limitRate(max_velocity[i], max_acceleration[i], max_jerk[i], commanded_velocities[i],
+                  last_commanded_velocities[i], last_commanded_accelerations[i]);
+  }
+  return limited_commanded_velocities;
+}
+
+/**
+ * Limits the rate of desired joint positions of a robot with an arbitrary number of joints
+ * considering the limits provided.
+ *
+ * @note
+ * FCI filters must be deactivated to work properly.
+ *
+ * @tparam N Number of joints, e.g. RobotTraits::kDof.
+ *
+ * @param[in] max_velocity Per-joint maximum allowed velocity.
+ * @param[in] max_acceleration Per-joint maximum allowed acceleration.
+ * @param[in] max_jerk Per-joint maximum allowed jerk.
+ * @param[in] commanded_positions Commanded joint positions of the current time step.
+ * @param[in] last_commanded_positions Commanded joint positions of the previous time step.
+ * @param[in] last_commanded_velocities Commanded joint velocities of the previous time step.
+ * @param[in] last_commanded_accelerations Commanded joint accelerations of the previous time step.
+ *
+ * @return Rate-limited vector of desired joint positions.
+ */
+template <size_t N>
+inline std::array<double, N> limitRate(const std::array<double, N>& max_velocity,
+                                       const std::array<double, N>& max_acceleration,
+                                       const std::array<double, N>& max_jerk,
+                                       const std::array<double, N>& commanded_positions,
+                                       const std::array<double, N>& last_commanded_positions,
+                                       const std::array<double, N>& last_commanded_velocities,
+                                       const std::array<double, N>& last_commanded_accelerations) {
+  std::array<double, N> limited_commanded_positions{};
+  for (size_t i = 0; i < N; i++) {
+    limited_commanded_positions[i] = limitRate(
+        max_velocity[i], max_acceleration[i], max_jerk[i], commanded_positions[i],
+        last_commanded_positions[i], last_commanded_velocities[i], last_commanded_accelerations[i]);
+  }
+  return limited_commanded_positions;
+}
+
+/**
+ * Calculates the largest velocity from which a joint can still stop within the given distance.
+ *
+ * The braking starts at zero acceleration and respects the given acceleration and jerk bounds, so
+ * that the result is given in closed form: \f$\sqrt[3]{j d^2}\f$ if the maximum acceleration is
+ * not reached, and \f$\sqrt{\frac{a^4}{4 j^2} + 2 a d} - \frac{a^2}{2 j}\f$ otherwise.
+ *
+ * @param[in] distance Distance to the position limit. Negative distances are treated as zero.
+ * @param[in] max_acceleration Maximum allowed acceleration.
+ * @param[in] max_jerk Maximum allowed jerk.
+ *
+ * @return Largest velocity towards the position limit.
+ */
+inline double maxStoppingVelocity(double distance,
+                                  double max_acceleration,
+                                  double max_jerk) noexcept {
+  distance = std::max(distance, 0.0);
+  double ramp_velocity = max_acceleration * max_acceleration / max_jerk;
+  double jerk_limited = std::cbrt(max_jerk * distance * distance);
+  double acceleration_limited =
+      std::sqrt(ramp_velocity * ramp_velocity / 4.0 + 2.0 * max_acceleration * distance) -
+      ramp_velocity / 2.0;
+  // The maximum acceleration is reached if the distance exceeds the distance needed to ramp the
+  // acceleration up and down again.
+  return distance < max_acceleration * ramp_velocity / max_jerk ? jerk_limited
+                                                                 : acceleration_limited;
+}
+
+/**
+ * Shapes desired joint velocities so that the joints can still stop before their position limits.
+ *
+ * The velocity of each joint towards a limit is saturated smoothly: it is not changed below 80% of
+ * the largest velocity from which the joint can stop in time, given by maxStoppingVelocity and by
+ * reaching the limit within one time step, and approaches this velocity asymptotically above.
+ * Velocities away from the limits are not changed.
+ *
+ * @tparam N Number of joints, e.g. RobotTraits::kDof.
+ *
+ * @param[in] min_position Per-joint minimum position.
+ * @param[in] max_position Per-joint maximum position.
+ * @param[in] max_acceleration Per-joint maximum allowed acceleration.
+ * @param[in] max_jerk Per-joint maximum allowed jerk.
+ * @param[in] commanded_velocities Commanded joint velocities of the current time step.
+ * @param[in] last_commanded_positions Commanded joint positions of the previous time step.
+ *
+ * @return Shaped joint velocities.
+ */
+template <size_t N>
+inline std::array<double, N> shapeJointVelocities(
+    const std::array<double, N>& min_position,
+    const std::array<double, N>& max_position,
+    const std::array<double, N>& max_acceleration,
+    const std::array<double, N>& max_jerk,
+    const std::array<double, N>& commanded_velocities,
+    const std::array<double, N>& last_commanded_positions) noexcept {
+  constexpr double kKnee = 0.8;
+  auto saturate = [](double velocity, double max_velocity) {
+    double knee = kKnee * max_velocity;
+    double width = max_velocity - knee;
+    if (velocity <= knee) {
+      return velocity;
+    }
+    return width > 0.0 ? knee + width * std::tanh((velocity - knee) / width) : max_velocity;
+  };
+
+  std::array<double, N> shaped_velocities{};
+  for (size_t i = 0; i < N; i++) {
+    double upper_distance = max_position[i] - last_commanded_positions[i];
+    double lower_distance = last_commanded_positions[i] - min_position[i];
+    double max_upward_velocity =
+        std::min(maxStoppingVelocity(upper_distance, max_acceleration[i], max_jerk[i]),
+                 std::max(upper_distance, 0.0) / kDeltaT);
+    double max_downward_velocity =
+        std::min(maxStoppingVelocity(lower_distance, max_acceleration[i], max_jerk[i]),
+                 std::max(lower_distance, 0.0) / kDeltaT);
+    double velocity = saturate(commanded_velocities[i], max_upward_velocity);
+    shaped_velocities[i] = -saturate(-velocity, max_downward_velocity);
+  }
+  return shaped_velocities;
+}
+
+/**
+ * Shapes desired joint positions so that the joints can still stop before their position limits.
+ *
+ * The commanded positions are converted to velocities and shaped as described for
+ * shapeJointVelocities.
+ *
+ * @tparam N Number of joints, e.g. RobotTraits::kDof.
+ *
+ * @param[in] min_position Per-joint minimum position.
+ * @param[in] max_position Per-joint maximum position.
+ * @param[in] max_acceleration Per-joint maximum allowed acceleration.
+ * @param[in] max_jerk Per-joint maximum allowed jerk.
+ * @param[in] commanded_positions Commanded joint positions of the current time step.
+ * @param[in] last_commanded_positions Commanded joint positions of the previous time step.
+ *
+ * @return Shaped joint positions.
+ */
+template <size_t N>
+inline std::array<double, N> shapeJointPositions(
+    const std::array<double, N>& min_position,
+    const std::array<double, N>& max_position,
+    const std::array<double, N>& max_acceleration,
+    const std::array<double, N>& max_jerk,
+    const std::array<double, N>& commanded_positions,
+    const std::array<double, N>& last_commanded_positions) noexcept {
+  std::array<double, N> velocities{};
+  for (size_t i = 0; i < N; i++) {
+    velocities[i] = (commanded_positions[i] - last_commanded_positions[i]) / kDeltaT;
+  }
+  velocities = shapeJointVelocities(min_position, max_position, max_acceleration, max_jerk,
+                                    velocities, last_commanded_positions);
+  std::array<double, N> shaped_positions{};
+  for (size_t i = 0; i < N; i++) {
+    shaped_positions[i] = last_commanded_positions[i] + velocities[i] * kDeltaT;
+  }
+  return shaped_positions;
+}
+
 /**
  * Limits the rate of a desired Cartesian velocity considering the limits provided.
  *
@@ -0,0 +1,208 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * @file reachability_map.h
+ * Contains a precomputed map of reachable end effector poses and their manipulability.
+ */
+
+namespace franka {
+
+/**
+ * Parameters of a ReachabilityMap.
+ *
+ * The workspace is divided into cubic voxels. The orientations of the end effector are divided
+ * into bins of its approach direction, i.e. its z axis, and of its rotation about the approach
+ * direction. The approach direction is binned by the cosine of its angle to the z axis of the base
+ * frame and by its azimuth, so that all bins cover the same solid angle.
+ */
+struct ReachabilityMapParameters {
+  /**
+   * Minimum corner of the workspace in base frame in \f$[m]\f$.
+   */
+  std::array<double, 3> workspace_minimum{{-0.9, -0.9, -0.4}};
+
+  /**
+   * Maximum corner of the workspace in base frame in \f$[m]\f$.
+   */
+  std::array<double, 3> workspace_maximum{{0.9, 0.9, 1.3}};
+
+  /**
+   * Edge length of a voxel in \f$[m]\f$.
+   */
+  double resolution{0.05};
+
+  /**
+   * Number of bins of the polar angle of the approach direction.
+   */
+  size_t polar_bins{6};
+
+  /**
+   * Number of bins of the azimuth of the approach direction.
+   */
+  size_t azimuth_bins{12};
+
+  /**
+   * Number of bins of the rotation about the approach direction.
+   */
+  size_t roll_bins{4};
+
+  /**
+   * Number of positions of the 7th joint at which the inverse kinematics is solved for each pose.
+   */
+  size_t q7_samples{8};
+
+  /**
+   * End effector in flange frame.
+   */
+  std::array<double, 16> F_T_EE{  // NOLINT(readability-identifier-naming)
+      {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+};
+
+/**
+ * Answers whether and how well end effector poses can be reached, from a map that is computed
+ * once for the whole workspace.
+ *
+ * For each voxel and orientation bin, the pose at their centers is solved with
+ * franka::InverseKinematics for several positions of the 7th joint. The map stores whether any
+ * solution exists within the joint limits and the best manipulability
+ * \f$\sqrt{\det(J J^T)}\f$ of all solutions, calculated with the zero Jacobian of
+ * franka::Kinematics. Per voxel, it additionally stores the fraction of reachable orientation bins
+ * and their best manipulability. Manipulabilities are quantized to one byte, relative to the best
+ * manipulability in the map.
+ *
+ * Maps are saved to files, which are memory-mapped when opened, so that large maps are loaded
+ * instantly and shared between processes. Queries look up the voxel and orientation bin of the
+ * given position or pose, do not allocate memory and can be called concurrently.
+ */
+class ReachabilityMap {
+ public:
+  /**
+   * Computes a new map.
+   *
+   * The voxels are distributed over several threads.
+   *
+   * @param[in] parameters Map parameters.
+   * @param[in] threads Number of threads, or zero to use one thread per core.
+   *
+   * @return Computed map.
+   *
+   * @throw std::invalid_argument if the parameters are invalid.
+   */
+  static ReachabilityMap generate(const ReachabilityMapParameters& parameters, size_t threads = 0);
+
+  /**
+   * Opens a map saved with save().
+   *
+   * @param[in] path Path of the map file.
+   *
+   * @throw LogFileException if the file cannot be opened or has an invalid format.
+   */
+  explicit ReachabilityMap(const std::string& path);
+
+  /**
+   * Move-constructs a new ReachabilityMap instance.
+   *
+   * @param[in] map Other ReachabilityMap instance.
+   */
+  ReachabilityMap(ReachabilityMap&& map) noexcept;
+
+  /**
+   * Move-assigns this ReachabilityMap from another ReachabilityMap instance.
+   *
+   * @param[in] map Other ReachabilityMap instance.
+   *
+   * @return ReachabilityMap instance.
+   */
+  ReachabilityMap& operator=(ReachabilityMap&& map) noexcept;
+
+  /**
+   * Unmaps the map file.
+   */
+  ~ReachabilityMap() noexcept;
+
+  /**
+   * Saves the map.
+   *
+   * @param[in] path Path of the map file.
+   *
+   * @throw LogFileException if the file cannot be written.
+   */
+  void save(const std::string& path) const;
+
+  /**
+   * Returns the parameters of the map.
+   *
+   * The workspace maximum is rounded up to a whole number of voxels.
+   *
+   * @return Map parameters.
+   */
+  ReachabilityMapParameters parameters() const noexcept;
+
+  /**
+   * Returns the best manipulability in the map, which is the upper end of the quantization.
+   *
+   * @return Best manipulability.
+   */
+  double maximumManipulability() const noexcept;
+
+  /**
+   * Returns the fraction of reachable orientations at a position.
+   *
+   * @param[in] position Position in base frame in \f$[m]\f$.
+   *
+   * @return Fraction of reachable orientation bins in the voxel of the position, or zero outside
+   * of the workspace.
+   */
+  double reachability(const std::array<double, 3>& position) const noexcept;
+
+  /**
+   * Returns the best manipulability of all orientations at a position.
+   *
+   * @param[in] position Position in base frame in \f$[m]\f$.
+   *
+   * @return Best manipulability in the voxel of the position, or zero if it is not reachable.
+   */
+  double manipulability(const std::array<double, 3>& position) const noexcept;
+
+  /**
+   * Returns whether an end effector pose is reachable.
+   *
+   * @param[in] O_T_EE End effector pose in base frame, column-major.
+   *
+   * @return True if the center of the voxel and orientation bin of the pose is reachable.
+   */
+  bool reachable(
+      const std::array<double, 16>& O_T_EE)  // NOLINT(readability-identifier-naming)
+      const noexcept;
+
+  /**
+   * Returns the manipulability of an end effector pose.
+   *
+   * @param[in] O_T_EE End effector pose in base frame, column-major.
+   *
+   * @return Best manipulability at the center of the voxel and orientation bin of the pose, or
+   * zero if it is not reachable.
+   */
+  double manipulability(
+      const std::array<double, 16>& O_T_EE)  // NOLINT(readability-identifier-naming)
+      const noexcept;
+
+  ReachabilityMap(const ReachabilityMap&) = delete;
+  ReachabilityMap& operator=(const ReachabilityMap&) = delete;
+
+ private:
+  struct Impl;
+
+  ReachabilityMap();
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace franka
@@ -2,16 +2,24 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
+#include <franka/anomaly_detection.h>
 #include <franka/command_types.h>
 #include <franka/control_types.h>
 #include <franka/duration.h>
+#include <franka/energy_accounting.h>
 #include <franka/lowpass_filter.h>
+#include <franka/motion_statistics.h>
 #include <franka/robot_state.h>
+#include <franka/virtual_wall_shield.h>
+#include <franka/worker_pool.h>
 
 /**
  * @file robot.h
@@ -53,7 +61,8 @@ class Robot {
    * @param[in] realtime_config if set to Enforce, an exception will be thrown if realtime priority
    * cannot be set when required. Setting realtime_config to Ignore disables this behavior.
    * @param[in] log_size sets how many last states should be kept for logging purposes.
-   * The log is provided when a ControlException is thrown.
+   * The log is provided when a ControlException is thrown. Its memory is reserved when a motion
+   * starts, so that aborting a motion does not allocate memory for the log.
    *
    * @throw NetworkException if the connection is unsuccessful.
    * @throw IncompatibleVersionException if this version of `libfranka` is not supported.
@@ -393,6 +402,51 @@ class Robot {
    */
   void read(std::function<bool(const RobotState&)> read_callback);
 
+  /**
+   * Starts a loop for reading robot states in batches.
+   *
+   * In contrast to Robot::read, every received robot state is delivered, and the callback is
+   * invoked once per batch instead of once per state. This allows consumers with a high overhead
+   * per call, e.g. for I/O, to keep up with the robot. A batch is delivered when the buffer is
+   * full or, if a time window is given, as soon as the states in the buffer span the time window.
+   * States that were lost on the network are reported with the following batch.
+   *
+   * Cannot be executed while a control or motion generator loop is running.
+   *
+   * This minimal example will write the joint positions in batches of up to 100 states:
+   * @code{.cpp}
+   * franka::Robot robot("robot.franka.de");
+   * std::vector<franka::RobotState> buffer(100);
+   * robot.readBatched(
+   *     [](const franka::RobotState* states, size_t count, uint64_t dropped_states) {
+   *       for (size_t i = 0; i < count; i++) {
+   *         std::cout << states[i].q << std::endl;
+   *       }
+   *       return dropped_states == 0;
+   *     },
+   *     buffer.data(), buffer.size());
+   * @endcode
+   *
+   * @param[in] read_callback Callback function receiving the states of a batch, the number of
+   * states in the batch and the number of states lost since the previous batch. Returning false
+   * stops the loop.
+   * @param[in] buffer Preallocated storage for one batch. No memory is allocated while reading.
+   * @param[in] capacity Number of states fitting into the buffer, i.e. the maximum batch size.
+   * @param[in] time_window Maximum time in robot time spanned by a batch. Disabled if zero.
+   *
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   * @throw std::invalid_argument if buffer is null or capacity is zero.
+   *
+   * @see Robot::read for a way to receive only the most recent robot state.
+   */
+  void readBatched(
+      std::function<bool(const RobotState* states, size_t count, uint64_t dropped_states)>
+          read_callback,
+      RobotState* buffer,
+      size_t capacity,
+      Duration time_window = Duration());
+
   /**
    * Waits for a robot state update and returns it.
    *
@@ -407,6 +461,154 @@ class Robot {
    */
   RobotState readOnce();
 
+  /**
+   * Sets a callback that receives quality statistics after each motion.
+   *
+   * While a callback is set, tracking errors, commanded jerk and lost cycles are accumulated in
+   * constant memory during every control or motion generator loop. The callback is invoked once
+   * when the motion has finished or has been aborted, before the control call returns or throws.
+   *
+   * Cannot be executed while a control or read operation is running.
+   *
+   * @param[in] motion_statistics_callback Callback function receiving the statistics. Pass an
+   * empty function to disable the statistics.
+   *
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   *
+   * @see MotionStatistics for the collected values.
+   */
+  void setMotionStatisticsCallback(
+      std::function<void(const MotionStatistics&)> motion_statistics_callback);
+
+  /**
+   * Enables online anomaly detection on the estimated external torques and forces.
+   *
+   * Every robot state received during Robot::read and during control or motion generator loops is
+   * compared to baselines learned online for the current joint configuration. The callback is
+   * invoked in the calling thread as soon as \f$\hat{\tau}_{\text{ext}}\f$ or
+   * \f$^O\hat{F}_{K,\text{ext}}\f$ start to deviate from their baselines, which can precede the
+   * contact and collision flags of the robot. The callback must therefore return quickly.
+   *
+   * Previously learned baselines are discarded. Enable the detection again after changing the
+   * load or end effector, since this changes the external torque estimates.
+   *
+   * Cannot be executed while a control or read operation is running.
+   *
+   * @param[in] parameters Detection parameters.
+   * @param[in] anomaly_callback Callback function receiving anomaly events. Pass an empty
+   * function to disable the detection.
+   *
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw std::invalid_argument if a parameter is out of range.
+   *
+   * @see AnomalyDetector for details on the detection.
+   */
+  void setAnomalyDetection(const AnomalyDetectionParameters& parameters,
+                           std::function<void(const AnomalyEvent&)> anomaly_callback);
+
+  /**
+   * Enables or disables accounting of the mechanical power and energy of the joints.
+   *
+   * While enabled, the power \f$\tau_J \dot{q}\f$ of every robot state received during
+   * Robot::read and during control or motion generator loops is integrated in constant memory.
+   * Counters are kept for the current motion and for the whole time since the accounting has been
+   * enabled, and the power is added to the Record entries of the log. Enabling the accounting again
+   * resets all counters.
+   *
+   * Cannot be executed while a control or read operation is running.
+   *
+   * @param[in] enabled True to enable the accounting, false to disable it.
+   *
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   *
+   * @see Robot::energySnapshot to get the counters.
+   */
+  void setEnergyAccounting(bool enabled);
+
+  /**
+   * Returns the current energy accounting counters.
+   *
+   * Can be called from any thread, including while a control or read operation is running. The
+   * call does not block the control loop.
+   *
+   * @return Snapshot of the counters, or an empty snapshot if the accounting is disabled.
+   *
+   * @see Robot::setEnergyAccounting to enable the accounting.
+   */
+  EnergySnapshot energySnapshot() const;
+
+  /**
+   * Enables a client-side shield against the given virtual walls.
+   *
+   * While enabled, the commands of Cartesian pose and Cartesian velocity motion generators are
+   * limited before they are sent, so that the end effector decelerates in front of the walls
+   * instead of being stopped by a `cartesian_position_limits_violation` reflex. The shield is
+   * applied before low-pass filtering and rate limiting. Joint motion generators are not affected.
+   *
+   * Cannot be executed while a control or read operation is running.
+   *
+   * @param[in] walls Virtual walls, e.g. fetched with Robot::getVirtualWalls. Pass an empty vector
+   * to disable the shield.
+   * @param[in] parameters Shield parameters.
+   *
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw std::invalid_argument if a parameter or wall size is out of range.
+   *
+   * @see VirtualWallShield for details on the limitation.
+   */
+  void setVirtualWallShield(const std::vector<VirtualWallCuboid>& walls,
+                            const VirtualWallShieldParameters& parameters = {});
+
+  /**
+   * Enables or disables shaping of joint motion generator commands at the joint position limits.
+   *
+   * While enabled, joint position and joint velocity commands are saturated smoothly, so that each
+   * joint can still stop before its position limit under the acceleration and jerk limits, instead
+   * of the robot aborting the motion with a `joint_motion_generator_position_limits_violation`
+   * reflex. The shaping is applied before low-pass filtering and rate limiting.
+   *
+   * Cannot be executed while a control or read operation is running.
+   *
+   * @param[in] enabled True to enable the shaping, false to disable it.
+   *
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   *
+   * @see franka::shapeJointVelocities for details on the shaping.
+   */
+  void setJointLimitShaping(bool enabled);
+
+  /**
+   * Creates a pool of worker threads for parallel work inside of control and motion generator
+   * callbacks.
+   *
+   * The workers are scheduled according to the realtime configuration of the robot. Workers pinned
+   * to CPUs spin while a control or motion generator loop is running and block otherwise.
+   *
+   * Cannot be executed while a control or read operation is running.
+   *
+   * @param[in] worker_count Number of worker threads. Pass zero to stop the workers.
+   * @param[in] cpus CPU to pin each worker thread to. Either empty or one CPU per worker.
+   *
+   * @throw InvalidOperationException if a conflicting operation is already running.
+   * @throw RealtimeException if realtime priority or pinning cannot be set when required.
+   * @throw std::invalid_argument if the number of CPUs does not match the number of workers.
+   *
+   * @see Robot::controlWorkers to access the pool.
+   * @see WorkerPool for details on running task sets.
+   */
+  void setControlWorkers(size_t worker_count, const std::vector<int>& cpus = {});
+
+  /**
+   * Returns the worker pool created by Robot::setControlWorkers.
+   *
+   * The reference stays valid until the next call to Robot::setControlWorkers.
+   *
+   * @return Worker pool.
+   *
+   * @throw InvalidOperationException if no worker pool has been created.
+   */
+  WorkerPool& controlWorkers();
+
   /**
    * @name Commands
    *
@@ -427,6 +629,21 @@ class Robot {
    */
   VirtualWallCuboid getVirtualWall(int32_t id);
 
+  /**
+   * Returns the parameters of several virtual walls.
+   *
+   * All requests are sent before the first response is awaited, so that fetching several walls
+   * takes about one round trip instead of one per wall.
+   *
+   * @param[in] ids IDs of the virtual walls.
+   *
+   * @return Parameters of the virtual walls, in the order of the given IDs.
+   *
+   * @throw CommandException if the Control reports an error.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   */
+  std::vector<VirtualWallCuboid> getVirtualWalls(const std::vector<int32_t>& ids);
+
   /**
    * Changes the collision behavior.
    *
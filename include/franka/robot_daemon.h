@@ -0,0 +1,465 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <franka/control_types.h>
+#include <franka/duration.h>
+#include <franka/lowpass_filter.h>
+#include <franka/model.h>
+#include <franka/robot.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file robot_daemon.h
+ * Contains a daemon that shares one robot connection with several local processes, and its client.
+ */
+
+namespace franka {
+
+/**
+ * Default path of the Unix socket of a RobotDaemon.
+ */
+constexpr const char* kDefaultDaemonSocketPath = "/tmp/franka_daemon.sock";
+
+/**
+ * Default name of the shared memory object of a RobotDaemon.
+ */
+constexpr const char* kDefaultDaemonSharedMemoryName = "/franka_daemon";
+
+/**
+ * Default time that a RobotDaemon waits for the command of the leaseholder in each control cycle.
+ */
+constexpr std::chrono::microseconds kDefaultDaemonCommandTimeout{300};
+
+/**
+ * Robot state published by a RobotDaemon, together with commonly needed model quantities.
+ *
+ * The model quantities are only calculated while a connected DaemonClient requested them, and are
+ * zero otherwise.
+ */
+struct DaemonState {
+  /**
+   * Robot state.
+   */
+  RobotState robot_state;
+
+  /**
+   * Time since the previously published robot state.
+   */
+  Duration period;
+
+  /**
+   * Zero Jacobian of the end effector frame, mass matrix and Coriolis force vector for the robot
+   * state.
+   */
+  ModelQuantities model;
+
+  /**
+   * Gravity torque vector for the robot state, in \f$[Nm]\f$.
+   */
+  std::array<double, 7> gravity{};
+
+  /**
+   * Number of robot states published by the daemon up to and including this one.
+   */
+  uint64_t count{};
+};
+
+/**
+ * Batch of configuration changes that a DaemonClient sends to a RobotDaemon.
+ *
+ * The changes are applied in the given order with the corresponding Robot methods.
+ */
+class RobotConfiguration {
+ public:
+  /**
+   * Adds a change of the collision behavior.
+   *
+   * @see Robot::setCollisionBehavior for a description of the parameters.
+   *
+   * @return This batch.
+   */
+  RobotConfiguration& setCollisionBehavior(
+      const std::array<double, 7>& lower_torque_thresholds_acceleration,
+      const std::array<double, 7>& upper_torque_thresholds_acceleration,
+      const std::array<double, 7>& lower_torque_thresholds_nominal,
+      const std::array<double, 7>& upper_torque_thresholds_nominal,
+      const std::array<double, 6>& lower_force_thresholds_acceleration,
+      const std::array<double, 6>& upper_force_thresholds_acceleration,
+      const std::array<double, 6>& lower_force_thresholds_nominal,
+      const std::array<double, 6>& upper_force_thresholds_nominal);
+
+  /**
+   * Adds a change of the joint impedance.
+   *
+   * @see Robot::setJointImpedance for a description of the parameters.
+   *
+   * @return This batch.
+   */
+  RobotConfiguration& setJointImpedance(
+      const std::array<double, 7>& K_theta);  // NOLINT(readability-identifier-naming)
+
+  /**
+   * Adds a change of the Cartesian impedance.
+   *
+   * @see Robot::setCartesianImpedance for a description of the parameters.
+   *
+   * @return This batch.
+   */
+  RobotConfiguration& setCartesianImpedance(
+      const std::array<double, 6>& K_x);  // NOLINT(readability-identifier-naming)
+
+  /**
+   * Adds a change of the guiding mode.
+   *
+   * @see Robot::setGuidingMode for a description of the parameters.
+   *
+   * @return This batch.
+   */
+  RobotConfiguration& setGuidingMode(const std::array<bool, 6>& guiding_mode, bool elbow);
+
+  /**
+   * Adds a change of the stiffness frame.
+   *
+   * @see Robot::setK for a description of the parameters.
+   *
+   * @return This batch.
+   */
+  RobotConfiguration& setK(
+      const std::array<double, 16>& EE_T_K);  // NOLINT(readability-identifier-naming)
+
+  /**
+   * Adds a change of the end effector frame.
+   *
+   * @see Robot::setEE for a description of the parameters.
+   *
+   * @return This batch.
+   */
+  RobotConfiguration& setEE(
+      const std::array<double, 16>& F_T_EE);  // NOLINT(readability-identifier-naming)
+
+  /**
+   * Adds a change of the payload.
+   *
+   * @see Robot::setLoad for a description of the parameters.
+   *
+   * @return This batch.
+   */
+  RobotConfiguration& setLoad(
+      double load_mass,
+      const std::array<double, 3>& F_x_Cload,  // NOLINT(readability-identifier-naming)
+      const std::array<double, 9>& load_inertia);
+
+  /**
+   * Adds an automatic error recovery.
+   *
+   * @see Robot::automaticErrorRecovery
+   *
+   * @return This batch.
+   */
+  RobotConfiguration& automaticErrorRecovery();
+
+  /**
+   * Applies all changes to the given robot.
+   *
+   * @param[in] robot Robot to configure.
+   *
+   * @throw CommandException if the Control reports an error.
+   * @throw NetworkException if the connection is lost, e.g. after a timeout.
+   */
+  void apply(Robot& robot) const;
+
+  /**
+   * Returns the number of changes.
+   *
+   * @return Number of changes.
+   */
+  size_t size() const noexcept;
+
+  /**
+   * Maximum number of values of a change.
+   */
+  static constexpr size_t kMaxValues = 4 * 7 + 4 * 6;
+
+  /**
+   * Single change, as sent to the daemon.
+   */
+  struct Change {
+    /**
+     * Kind of change.
+     */
+    uint32_t type;
+
+    /**
+     * Parameters of the change, in the order of the corresponding Robot method.
+     */
+    std::array<double, kMaxValues> values;
+  };
+
+  /**
+   * Returns the changes.
+   *
+   * @return Changes in the order they were added.
+   */
+  const std::vector<Change>& changes() const noexcept;
+
+  /**
+   * Adds changes, e.g. received by a daemon.
+   *
+   * @param[in] changes Changes to append.
+   *
+   * @throw std::invalid_argument if a change has an unknown type.
+   */
+  void append(const std::vector<Change>& changes);
+
+ private:
+  std::vector<Change> changes_;
+};
+
+/**
+ * Owns the connection to a robot and shares it with several processes on the same host.
+ *
+ * The daemon runs the realtime loop of the robot and publishes every robot state in a shared
+ * memory object. While a client requested them, it also publishes the model quantities that
+ * controllers commonly need, so that clients do not have to load the Model themselves. Clients
+ * connect to the daemon through a Unix socket using DaemonClient:
+ *
+ * - Any number of clients can read robot states at the same time.
+ * - One client at a time can lease the control loop and send commands through the shared memory
+ *   object. Lease requests of other clients are rejected until the motion is finished.
+ * - Clients can send batches of configuration changes. They are applied while no motion is
+ *   running, in the order they were received.
+ *
+ * In each control cycle, the daemon publishes the robot state and waits busily for the command of
+ * the leaseholder for up to the command timeout. Commands that arrive later are applied in the next
+ * control cycle. If the leaseholder disconnects or misses too many control cycles, the motion is
+ * aborted.
+ */
+class RobotDaemon {
+ public:
+  /**
+   * Maximum number of consecutive control cycles without a command from the leaseholder before
+   * the motion is aborted. In between, the previous command is repeated.
+   */
+  static constexpr size_t kMaxMissedCommands = 20;
+
+  /**
+   * Creates a new RobotDaemon instance, loads the model and starts listening for clients.
+   *
+   * @param[in] robot Connected robot. Must outlive the daemon and must not be used otherwise while
+   * the daemon exists.
+   * @param[in] socket_path Path of the Unix socket. A stale socket file is replaced.
+   * @param[in] shared_memory_name Name of the shared memory object, starting with a slash.
+   * @param[in] command_timeout Time that each control cycle waits for the command of the
+   * leaseholder. It is spent in the realtime loop and has to leave enough of the 1 ms control cycle
+   * for the model quantities and the communication with the robot. With zero, commands are always
+   * applied one control cycle after they were calculated.
+   *
+   * @throw std::invalid_argument if command_timeout is not shorter than a control cycle.
+   * @throw ModelException if the model library cannot be loaded.
+   * @throw NetworkException if the socket or the shared memory object cannot be created.
+   */
+  explicit RobotDaemon(Robot& robot,
+                       const std::string& socket_path = kDefaultDaemonSocketPath,
+                       const std::string& shared_memory_name = kDefaultDaemonSharedMemoryName,
+                       std::chrono::microseconds command_timeout = kDefaultDaemonCommandTimeout);
+
+  /**
+   * Stops serving clients and removes the socket and the shared memory object.
+   */
+  ~RobotDaemon() noexcept;
+
+  RobotDaemon(const RobotDaemon&) = delete;
+  RobotDaemon& operator=(const RobotDaemon&) = delete;
+
+  /**
+   * Runs the realtime loop of the robot in the calling thread.
+   *
+   * Reads robot states while no client controls the robot, and executes control loops and
+   * configuration changes requested by clients.
+   *
+   * @param[in] running The loop returns after the current motion if set to false.
+   *
+   * @throw NetworkException if the connection to the robot is lost, e.g. after a timeout.
+   * @throw RealtimeException if realtime priority cannot be set for the current thread.
+   */
+  void run(const std::atomic<bool>& running);
+
+ private:
+  class Impl;
+
+  std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * Connects to a RobotDaemon to read robot states, control the robot and change its
+ * configuration.
+ */
+class DaemonClient {
+ public:
+  /**
+   * Creates a new DaemonClient instance and connects to a daemon.
+   *
+   * @param[in] socket_path Path of the Unix socket of the daemon.
+   * @param[in] model_quantities True if the daemon should calculate the model quantities of
+   * DaemonState while this client is connected.
+   *
+   * @throw NetworkException if the daemon cannot be reached.
+   * @throw IncompatibleVersionException if the daemon uses another protocol version.
+   */
+  explicit DaemonClient(const std::string& socket_path = kDefaultDaemonSocketPath,
+                        bool model_quantities = false);
+
+  /**
+   * Disconnects from the daemon.
+   */
+  ~DaemonClient() noexcept;
+
+  DaemonClient(const DaemonClient&) = delete;
+  DaemonClient& operator=(const DaemonClient&) = delete;
+
+  /**
+   * Waits for a robot state that is newer than the previously read one.
+   *
+   * @return Robot state and model quantities.
+   *
+   * @throw NetworkException if the daemon does not publish robot states anymore.
+   */
+  DaemonState readOnce();
+
+  /**
+   * Reads robot states until the callback returns false.
+   *
+   * @param[in] read_callback Called for each new robot state. Robot states published while the
+   * callback runs are skipped.
+   *
+   * @throw NetworkException if the daemon does not publish robot states anymore.
+   */
+  void read(std::function<bool(const DaemonState&)> read_callback);
+
+  /**
+   * Sends a batch of configuration changes and waits until the daemon applied it.
+   *
+   * @param[in] configuration Changes to apply.
+   *
+   * @throw CommandException if a change could not be applied. Changes before it were applied.
+   * @throw NetworkException if the connection to the daemon is lost.
+   */
+  void configure(const RobotConfiguration& configuration);
+
+  /**
+   * Leases the control loop of the daemon and runs a torque control loop.
+   *
+   * Commands that are not returned within the command timeout of the daemon after the robot state
+   * was published are applied one control cycle later.
+   *
+   * @param[in] control_callback Callback function providing joint-level torque commands.
+   * @param[in] limit_rate True if rate limiting should be activated.
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter applied by the daemon.
+   *
+   * @throw ControlException if the motion was aborted.
+   * @throw InvalidOperationException if another client controls the robot.
+   * @throw NetworkException if the connection to the daemon is lost.
+   *
+   * @see Robot::control
+   */
+  void control(std::function<Torques(const RobotState&, franka::Duration)> control_callback,
+               bool limit_rate = true,
+               double cutoff_frequency = kDefaultCutoffFrequency);
+
+  /**
+   * Leases the control loop of the daemon and runs a joint position motion generator.
+   *
+   * @param[in] motion_generator_callback Callback function for motion generation.
+   * @param[in] controller_mode Controller to use to execute the motion.
+   * @param[in] limit_rate True if rate limiting should be activated.
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter applied by the daemon.
+   *
+   * @throw ControlException if the motion was aborted.
+   * @throw InvalidOperationException if another client controls the robot.
+   * @throw NetworkException if the connection to the daemon is lost.
+   *
+   * @see Robot::control
+   */
+  void control(
+      std::function<JointPositions(const RobotState&, franka::Duration)> motion_generator_callback,
+      ControllerMode controller_mode = ControllerMode::kJointImpedance,
+      bool limit_rate = true,
+      double cutoff_frequency = kDefaultCutoffFrequency);
+
+  /**
+   * Leases the control loop of the daemon and runs a joint velocity motion generator.
+   *
+   * @param[in] motion_generator_callback Callback function for motion generation.
+   * @param[in] controller_mode Controller to use to execute the motion.
+   * @param[in] limit_rate True if rate limiting should be activated.
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter applied by the daemon.
+   *
+   * @throw ControlException if the motion was aborted.
+   * @throw InvalidOperationException if another client controls the robot.
+   * @throw NetworkException if the connection to the daemon is lost.
+   *
+   * @see Robot::control
+   */
+  void control(
+      std::function<JointVelocities(const RobotState&, franka::Duration)> motion_generator_callback,
+      ControllerMode controller_mode = ControllerMode::kJointImpedance,
+      bool limit_rate = true,
+      double cutoff_frequency = kDefaultCutoffFrequency);
+
+  /**
+   * Leases the control loop of the daemon and runs a Cartesian pose motion generator.
+   *
+   * @param[in] motion_generator_callback Callback function for motion generation.
+   * @param[in] controller_mode Controller to use to execute the motion.
+   * @param[in] limit_rate True if rate limiting should be activated.
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter applied by the daemon.
+   *
+   * @throw ControlException if the motion was aborted.
+   * @throw InvalidOperationException if another client controls the robot.
+   * @throw NetworkException if the connection to the daemon is lost.
+   *
+   * @see Robot::control
+   */
+  void control(
+      std::function<CartesianPose(const RobotState&, franka::Duration)> motion_generator_callback,
+      ControllerMode controller_mode = ControllerMode::kJointImpedance,
+      bool limit_rate = true,
+      double cutoff_frequency = kDefaultCutoffFrequency);
+
+  /**
+   * Leases the control loop of the daemon and runs a Cartesian velocity motion generator.
+   *
+   * @param[in] motion_generator_callback Callback function for motion generation.
+   * @param[in] controller_mode Controller to use to execute the motion.
+   * @param[in] limit_rate True if rate limiting should be activated.
+   * @param[in] cutoff_frequency Cutoff frequency of the low-pass filter applied by the daemon.
+   *
+   * @throw ControlException if the motion was aborted.
+   * @throw InvalidOperationException if another client controls the robot.
+   * @throw NetworkException if the connection to the daemon is lost.
+   *
+   * @see Robot::control
+   */
+  void control(std::function<CartesianVelocities(const RobotState&, franka::Duration)>
+                   motion_generator_callback,
+               ControllerMode controller_mode = ControllerMode::kJointImpedance,
+               bool limit_rate = true,
+               double cutoff_frequency = kDefaultCutoffFrequency);
+
+ private:
+  class Impl;
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace franka
@@ -0,0 +1,112 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <franka/rate_limiting.h>
+
+/**
+ * @file robot_traits.h
+ * Contains compile-time descriptions of robot kinematic dimensions and limits.
+ */
+
+namespace franka {
+
+/**
+ * Compile-time dimensions of a serial robot with the given number of joints.
+ *
+ * Generic algorithms such as franka::limitRate and franka::lowpassFilter are templates over the
+ * array size, so that loops over these dimensions have compile-time bounds.
+ *
+ * @tparam Dof Number of joints.
+ */
+template <size_t Dof>
+struct RobotTraits {
+  /**
+   * Number of joints.
+   */
+  static constexpr size_t kDof = Dof;
+
+  /**
+   * Number of Cartesian degrees of freedom of the end effector.
+   */
+  static constexpr size_t kCartesianDof = 6;
+
+  /**
+   * Number of elements of a homogeneous transformation in column-major format.
+   */
+  static constexpr size_t kPoseSize = 16;
+
+  /**
+   * Per-joint values.
+   */
+  using JointArray = std::array<double, kDof>;
+
+  /**
+   * Per-axis Cartesian values, ordered as \f$(x, y, z, R, P, Y)\f$.
+   */
+  using CartesianArray = std::array<double, kCartesianDof>;
+
+  /**
+   * Homogeneous transformation in column-major format.
+   */
+  using PoseArray = std::array<double, kPoseSize>;
+};
+
+template <size_t Dof>
+constexpr size_t RobotTraits<Dof>::kDof;
+template <size_t Dof>
+constexpr size_t RobotTraits<Dof>::kCartesianDof;
+template <size_t Dof>
+constexpr size_t RobotTraits<Dof>::kPoseSize;
+
+/**
+ * Compile-time description of the Panda robot.
+ */
+struct PandaTraits : RobotTraits<7> {
+  /**
+   * Returns the maximum torque rates.
+   *
+   * @return Maximum torque rates in \f$[\frac{Nm}{s}]\f$.
+   */
+  static constexpr JointArray maxTorqueRate() noexcept { return kMaxTorqueRate; }
+
+  /**
+   * Returns the maximum joint velocities.
+   *
+   * @return Maximum joint velocities in \f$[\frac{rad}{s}]\f$.
+   */
+  static constexpr JointArray maxJointVelocity() noexcept { return kMaxJointVelocity; }
+
+  /**
+   * Returns the maximum joint accelerations.
+   *
+   * @return Maximum joint accelerations in \f$[\frac{rad}{s^2}]\f$.
+   */
+  static constexpr JointArray maxJointAcceleration() noexcept { return kMaxJointAcceleration; }
+
+  /**
+   * Returns the maximum joint jerks.
+   *
+   * @return Maximum joint jerks in \f$[\frac{rad}{s^3}]\f$.
+   */
+  static constexpr JointArray maxJointJerk() noexcept { return kMaxJointJerk; }
+
+  /**
+   * Returns the minimum joint positions.
+   *
+   * @return Minimum joint positions in \f$[rad]\f$.
+   */
+  static constexpr JointArray minJointPosition() noexcept { return kMinJointPosition; }
+
+  /**
+   * Returns the maximum joint positions.
+   *
+   * @return Maximum joint positions in \f$[rad]\f$.
+   */
+  static constexpr JointArray maxJointPosition() noexcept { return kMaxJointPosition; }
+};
+
+}  // namespace franka
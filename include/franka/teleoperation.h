@@ -0,0 +1,261 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+#include <franka/control_types.h>
+#include <franka/duration.h>
+#include <franka/robot_state.h>
+
+/**
+ * @file teleoperation.h
+ * Contains a bridge from a teleoperation input device to a Cartesian pose motion generator.
+ */
+
+namespace franka {
+
+/**
+ * Pose of a teleoperation input device, e.g. of the handle of a master device.
+ */
+struct TeleoperationTarget {
+  /**
+   * Time at which the pose was measured.
+   */
+  std::chrono::steady_clock::time_point time{};
+
+  /**
+   * Position in \f$[m]\f$ in the frame of the input device.
+   */
+  std::array<double, 3> position{};
+
+  /**
+   * Orientation as unit quaternion \f$(x, y, z, w)\f$ in the frame of the input device.
+   */
+  std::array<double, 4> orientation{{0.0, 0.0, 0.0, 1.0}};
+};
+
+/**
+ * Parameters of a TeleoperationBridge.
+ *
+ * The frame of the input device is assumed to be aligned with the base frame of the robot.
+ */
+struct TeleoperationParameters {
+  /**
+   * Delay in \f$[s]\f$ of the resampled input behind the current time.
+   *
+   * Inputs are interpolated as long as the input device delivers a new target within this delay,
+   * so larger values trade latency for smoothness. Should be at least the largest expected
+   * interval between two targets.
+   */
+  double interpolation_delay{0.005};
+
+  /**
+   * Time in \f$[s]\f$ for which the input is extrapolated beyond the latest target.
+   *
+   * Afterwards the last extrapolated pose is held until a new target arrives.
+   */
+  double maximum_extrapolation{0.02};
+
+  /**
+   * Scaling of input translations.
+   *
+   * The end effector moves by this factor times the translation of the input device since the
+   * first target. Rotations are not scaled.
+   */
+  double translation_scale{1.0};
+
+  /**
+   * Minimum commanded end effector position in base frame in \f$[m]\f$.
+   */
+  std::array<double, 3> workspace_minimum{{-std::numeric_limits<double>::infinity(),
+                                           -std::numeric_limits<double>::infinity(),
+                                           -std::numeric_limits<double>::infinity()}};
+
+  /**
+   * Maximum commanded end effector position in base frame in \f$[m]\f$.
+   */
+  std::array<double, 3> workspace_maximum{{std::numeric_limits<double>::infinity(),
+                                           std::numeric_limits<double>::infinity(),
+                                           std::numeric_limits<double>::infinity()}};
+
+  /**
+   * Maximum translational velocity of the commanded pose in \f$[\frac{m}{s}]\f$.
+   */
+  double maximum_translational_velocity{0.5};
+
+  /**
+   * Maximum rotational velocity of the commanded pose in \f$[\frac{rad}{s}]\f$.
+   */
+  double maximum_rotational_velocity{1.0};
+};
+
+/**
+ * Statistics of a TeleoperationBridge.
+ *
+ * Latencies are measured from the time of the latest target used for a command to the time the
+ * command is returned to the control loop.
+ */
+struct TeleoperationStatistics {
+  /**
+   * Number of commands calculated from targets.
+   */
+  uint64_t commands{0};
+
+  /**
+   * Number of commands for which the input was extrapolated.
+   */
+  uint64_t extrapolated{0};
+
+  /**
+   * Number of commands that held the pose because no recent target was available.
+   */
+  uint64_t held{0};
+
+  /**
+   * Number of targets dropped because the input buffer was full or they were older than the
+   * latest target.
+   */
+  uint64_t dropped{0};
+
+  /**
+   * Latency of the last command in \f$[s]\f$.
+   */
+  double latency{0.0};
+
+  /**
+   * Mean latency in \f$[s]\f$.
+   */
+  double mean_latency{0.0};
+
+  /**
+   * Maximum latency in \f$[s]\f$.
+   */
+  double maximum_latency{0.0};
+};
+
+/**
+ * Resamples teleoperation targets onto the control loop of the robot.
+ *
+ * An input thread pushes timestamped targets, usually at a lower rate and out of phase with the
+ * control loop, into a lock-free single-producer single-consumer buffer. The bridge is used as
+ * motion generator callback for Robot::control and resamples the targets at the current time
+ * minus TeleoperationParameters::interpolation_delay. Between targets, positions are interpolated
+ * linearly and orientations spherically. If no newer target is available, the last two targets
+ * are extrapolated for up to TeleoperationParameters::maximum_extrapolation.
+ *
+ * The first target and the robot pose at the first command define the reference poses: the end
+ * effector follows the scaled motion of the input device relative to them. Commanded positions
+ * are limited to the workspace, and the commanded velocities to the given maximum velocities.
+ *
+ * @note The control loop reads the clock of the host, so targets must be stamped with
+ * std::chrono::steady_clock.
+ */
+class TeleoperationBridge {
+ public:
+  /**
+   * Number of targets that can be buffered between two control loop cycles.
+   */
+  static constexpr size_t kCapacity = 64;
+
+  /**
+   * Creates a new teleoperation bridge.
+   *
+   * @param[in] parameters Teleoperation parameters.
+   *
+   * @throw std::invalid_argument if the parameters are invalid.
+   */
+  explicit TeleoperationBridge(const TeleoperationParameters& parameters = {});
+
+  /**
+   * Adds a target. Must only be called from a single input thread.
+   *
+   * Does not block and does not allocate memory.
+   *
+   * @param[in] target Pose of the input device.
+   *
+   * @return False if the target was dropped because the buffer is full.
+   */
+  bool push(const TeleoperationTarget& target) noexcept;
+
+  /**
+   * Calculates the next commanded pose at the current time.
+   *
+   * @param[in] robot_state Current robot state.
+   * @param[in] period Time since the last call.
+   *
+   * @return Commanded end effector pose.
+   */
+  CartesianPose operator()(const RobotState& robot_state, Duration period);
+
+  /**
+   * Calculates the next commanded pose at the given time.
+   *
+   * @param[in] robot_state Current robot state.
+   * @param[in] period Time since the last call.
+   * @param[in] now Current time.
+   *
+   * @return Commanded end effector pose.
+   */
+  CartesianPose operator()(const RobotState& robot_state,
+                           Duration period,
+                           std::chrono::steady_clock::time_point now);
+
+  /**
+   * Returns the statistics since the last reset.
+   *
+   * Can be called from any thread. The statistics are updated by the control loop without
+   * blocking, so they can be one command behind.
+   *
+   * @return Teleoperation statistics.
+   */
+  TeleoperationStatistics statistics() const;
+
+  /**
+   * Resets the reference poses, buffered targets and statistics before starting a new motion.
+   *
+   * Must not be called while the bridge is used by a control loop or an input thread.
+   */
+  void reset();
+
+ private:
+  static constexpr size_t kHistory = 16;
+
+  // Resamples the target history at the given time. Returns false if no target is available.
+  bool resample(std::chrono::steady_clock::time_point time,
+                TeleoperationTarget* target,
+                bool* extrapolated,
+                bool* held) const;
+  void updateStatistics(double latency, bool extrapolated, bool held) noexcept;
+
+  TeleoperationParameters parameters_;
+
+  // Input buffer, written by the input thread and read by the control loop.
+  std::array<TeleoperationTarget, kCapacity> buffer_;
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+  std::atomic<uint64_t> dropped_;
+
+  // Latest targets in chronological order.
+  std::array<TeleoperationTarget, kHistory> history_;
+  size_t history_size_;
+
+  bool initialized_;
+  bool has_reference_;
+  TeleoperationTarget input_reference_;
+  std::array<double, 16> robot_reference_;
+  std::array<double, 16> last_command_;
+
+  TeleoperationStatistics current_statistics_;
+  double latency_sum_;
+  mutable std::mutex statistics_mutex_;
+  TeleoperationStatistics statistics_;
+};
+
+}  // namespace franka
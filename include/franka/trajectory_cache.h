@@ -0,0 +1,303 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include <franka/duration.h>
+
+/**
+ * @file trajectory_cache.h
+ * Contains a cache for time-parameterized joint trajectories of repeated point-to-point motions.
+ */
+
+namespace franka {
+
+/**
+ * Least recently used cache of time-parameterized joint trajectories.
+ *
+ * Profiles are identified by their start and goal configuration, quantized to a given resolution,
+ * and by the limit parameters they were planned with. The samples of all profiles are kept in a
+ * single preallocated arena, so that finding a profile neither allocates memory nor searches, and
+ * can be done from within a motion generator callback.
+ *
+ * Each sample of a profile belongs to one control cycle, i.e. samples are 1 ms apart. What a sample
+ * holds is up to the planner, e.g. joint positions or offsets from the start configuration.
+ */
+class TrajectoryCache {
+ public:
+  /**
+   * Sample of a profile.
+   */
+  using Sample = std::array<double, 7>;
+
+  /**
+   * Identifies a profile. Created with TrajectoryCache::makeKey.
+   */
+  struct Key {
+    /**
+     * Quantized start configuration.
+     */
+    std::array<int64_t, 7> q_start{};
+
+    /**
+     * Quantized goal configuration.
+     */
+    std::array<int64_t, 7> q_goal{};
+
+    /**
+     * Hash of the quantized limit parameters.
+     */
+    uint64_t parameters{};
+
+    /**
+     * Compares two keys.
+     *
+     * @param[in] other Key to compare with.
+     *
+     * @return True if both keys are equal.
+     */
+    bool operator==(const Key& other) const noexcept;
+  };
+
+  /**
+   * Read-only view of a cached profile.
+   *
+   * Becomes invalid with the next call to TrajectoryCache::insert, TrajectoryCache::load or
+   * TrajectoryCache::clear.
+   */
+  class Profile {
+   public:
+    /**
+     * Creates an empty profile.
+     */
+    Profile() noexcept = default;
+
+    /**
+     * Checks whether the profile is empty, i.e. whether the key was not found.
+     *
+     * @return True if the profile has no samples.
+     */
+    bool empty() const noexcept;
+
+    /**
+     * Returns the number of samples.
+     *
+     * @return Number of samples.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * Returns the time from the first to the last sample.
+     *
+     * @return Duration of the profile.
+     */
+    Duration duration() const noexcept;
+
+    /**
+     * Returns a sample.
+     *
+     * @param[in] index Index of the sample. Must be smaller than size().
+     *
+     * @return Sample.
+     */
+    const Sample& operator[](size_t index) const noexcept;
+
+    /**
+     * Returns the sample for the given time since the start of the profile.
+     *
+     * @param[in] time Time since the first sample. Times after the end of the profile give the last
+     * sample.
+     *
+     * @return Sample. Must not be called on an empty profile.
+     */
+    const Sample& at(Duration time) const noexcept;
+
+   private:
+    friend class TrajectoryCache;
+
+    Profile(const Sample* samples, size_t size) noexcept;
+
+    const Sample* samples_ = nullptr;
+    size_t size_ = 0;
+  };
+
+  /**
+   * Usage statistics of a cache.
+   */
+  struct Statistics {
+    /**
+     * Number of lookups that found a profile.
+     */
+    uint64_t hits{};
+
+    /**
+     * Number of lookups that did not find a profile.
+     */
+    uint64_t misses{};
+
+    /**
+     * Number of inserted profiles.
+     */
+    uint64_t insertions{};
+
+    /**
+     * Number of profiles that were evicted to make room for new ones.
+     */
+    uint64_t evictions{};
+
+    /**
+     * Returns the share of lookups that found a profile.
+     *
+     * @return Hit rate in range [0, 1], or 0 if there were no lookups.
+     */
+    double hitRate() const noexcept;
+  };
+
+  /**
+   * Creates a new TrajectoryCache instance and allocates its memory.
+   *
+   * @param[in] max_profiles Maximum number of cached profiles.
+   * @param[in] max_samples Maximum total number of samples of all cached profiles.
+   * @param[in] resolution Resolution in \f$[rad]\f$ to which configurations and limit parameters
+   * are quantized.
+   *
+   * @throw std::invalid_argument if a capacity is zero or the resolution is not positive.
+   */
+  TrajectoryCache(size_t max_profiles, size_t max_samples, double resolution = 1e-4);
+
+  /**
+   * Creates the key of a profile.
+   *
+   * @param[in] q_start Start configuration.
+   * @param[in] q_goal Goal configuration.
+   * @param[in] parameters Limit parameters the profile depends on, e.g. a speed factor or the
+   * velocity and acceleration limits.
+   *
+   * @return Key of the profile.
+   */
+  Key makeKey(const std::array<double, 7>& q_start,
+              const std::array<double, 7>& q_goal,
+              std::initializer_list<double> parameters) const noexcept;
+
+  /**
+   * Looks up a profile and marks it as most recently used.
+   *
+   * Does not allocate memory.
+   *
+   * @param[in] key Key of the profile.
+   *
+   * @return Profile, or an empty profile if the key is not cached.
+   */
+  Profile find(const Key& key) noexcept;
+
+  /**
+   * Inserts or replaces a profile.
+   *
+   * Least recently used profiles are evicted until the new profile fits.
+   *
+   * @param[in] key Key of the profile.
+   * @param[in] samples Samples of the profile.
+   *
+   * @return Inserted profile.
+   *
+   * @throw std::invalid_argument if there are no samples or more samples than the cache can hold.
+   */
+  Profile insert(const Key& key, const std::vector<Sample>& samples);
+
+  /**
+   * Removes all profiles. Does not reset the statistics.
+   */
+  void clear() noexcept;
+
+  /**
+   * Returns the number of cached profiles.
+   *
+   * @return Number of profiles.
+   */
+  size_t size() const noexcept;
+
+  /**
+   * Returns the total number of samples of all cached profiles.
+   *
+   * @return Number of samples.
+   */
+  size_t sampleCount() const noexcept;
+
+  /**
+   * Returns the usage statistics since creation or the last call to resetStatistics().
+   *
+   * @return Statistics.
+   */
+  const Statistics& statistics() const noexcept;
+
+  /**
+   * Resets the usage statistics.
+   */
+  void resetStatistics() noexcept;
+
+  /**
+   * Writes all profiles in a binary format, e.g. to restore them after a restart.
+   *
+   * @param[in] stream Binary output stream.
+   *
+   * @throw LogFileException if the profiles cannot be written.
+   */
+  void save(std::ostream& stream) const;
+
+  /**
+   * Replaces all profiles with the ones written by save().
+   *
+   * Profiles that do not fit into the cache are evicted in order of their last use. The statistics
+   * are not changed.
+   *
+   * @param[in] stream Binary input stream.
+   *
+   * @throw LogFileException if the profiles cannot be read or were saved with a different
+   * resolution. The cache is empty afterwards.
+   */
+  void load(std::istream& stream);
+
+ private:
+  struct KeyHash {
+    size_t operator()(const Key& key) const noexcept;
+  };
+
+  struct Entry {
+    Key key;
+    size_t offset;
+    size_t size;
+    size_t previous;
+    size_t next;
+  };
+
+  void erase(size_t entry) noexcept;
+  void unlink(size_t entry) noexcept;
+  void pushFront(size_t entry) noexcept;
+  void compact() noexcept;
+
+  const size_t max_profiles_;  // NOLINT(readability-identifier-naming)
+  const double resolution_;    // NOLINT(readability-identifier-naming)
+
+  std::vector<Sample> arena_;
+  size_t arena_end_ = 0;
+  size_t sample_count_ = 0;
+
+  std::vector<Entry> entries_;
+  std::vector<size_t> free_entries_;
+  std::vector<size_t> compaction_order_;
+  size_t head_;
+  size_t tail_;
+  std::unordered_map<Key, size_t, KeyHash> index_;
+
+  Statistics statistics_;
+};
+
+}  // namespace franka
@@ -0,0 +1,121 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <franka/command_types.h>
+
+/**
+ * @file virtual_wall_shield.h
+ * Contains a client-side shield that keeps Cartesian motions within the virtual walls.
+ */
+
+namespace franka {
+
+/**
+ * Parameters of a VirtualWallShield.
+ */
+struct VirtualWallShieldParameters {
+  /**
+   * Distance to the walls at which the end effector is stopped in \f$[m]\f$.
+   */
+  double margin{0.02};
+
+  /**
+   * Deceleration used to approach the walls in \f$[\frac{m}{s^2}]\f$. Should be clearly below the
+   * maximum translational acceleration, so that rate limiting can follow the braking.
+   */
+  double deceleration{5.0};
+};
+
+/**
+ * Limits Cartesian end effector motions so that they stop in front of the virtual walls.
+ *
+ * The end effector has to stay within every active virtual wall cuboid. A cuboid is centered at the
+ * origin of VirtualWallCuboid::p_frame and has the edge lengths given by
+ * VirtualWallCuboid::object_world_size along the axes of this frame. Velocities towards a face are
+ * limited to \f$\sqrt{2 a d}\f$, where \f$a\f$ is the deceleration and \f$d\f$ is the distance to
+ * the face reduced by the margin. The end effector thereby decelerates before the robot aborts the
+ * motion with a `cartesian_position_limits_violation` reflex. Motions away from a face and
+ * orientations are not changed.
+ *
+ * @see Robot::getVirtualWalls to fetch the walls configured on the robot.
+ * @see Robot::setVirtualWallShield to apply the shield to Cartesian motion generators.
+ */
+class VirtualWallShield {
+ public:
+  /**
+   * Creates a new VirtualWallShield instance.
+   *
+   * @param[in] walls Virtual walls. Inactive walls are ignored.
+   * @param[in] parameters Shield parameters.
+   *
+   * @throw std::invalid_argument if a parameter or wall size is out of range.
+   */
+  explicit VirtualWallShield(const std::vector<VirtualWallCuboid>& walls,
+                             const VirtualWallShieldParameters& parameters = {});
+
+  /**
+   * Calculates the distance of a position to the nearest face of the active walls.
+   *
+   * @param[in] position Position in base frame in \f$[m]\f$.
+   *
+   * @return Distance in \f$[m]\f$, negative if the position is outside of a wall cuboid.
+   */
+  double distance(const std::array<double, 3>& position) const noexcept;
+
+  /**
+   * Limits a translational velocity at the given position.
+   *
+   * @param[in] position Position in base frame in \f$[m]\f$.
+   * @param[in] velocity Translational velocity in base frame in \f$[\frac{m}{s}]\f$.
+   * @param[in] time_step Time until the next command in \f$[s]\f$.
+   *
+   * @return Limited velocity.
+   */
+  std::array<double, 3> limitVelocity(const std::array<double, 3>& position,
+                                      const std::array<double, 3>& velocity,
+                                      double time_step) const noexcept;
+
+  /**
+   * Limits a commanded end effector pose.
+   *
+   * @param[in] O_T_EE_c Commanded pose, column major.
+   * @param[in] last_O_T_EE_c Last commanded pose, column major.
+   * @param[in] time_step Time since the last command in \f$[s]\f$.
+   *
+   * @return Commanded pose with limited translation.
+   */
+  std::array<double, 16> limitPose(
+      const std::array<double, 16>& O_T_EE_c,       // NOLINT(readability-identifier-naming)
+      const std::array<double, 16>& last_O_T_EE_c,  // NOLINT(readability-identifier-naming)
+      double time_step) const noexcept;
+
+  /**
+   * Limits a commanded end effector twist.
+   *
+   * @param[in] O_dP_EE_c Commanded twist.
+   * @param[in] O_T_EE_c Last commanded pose, column major.
+   * @param[in] time_step Time until the next command in \f$[s]\f$.
+   *
+   * @return Commanded twist with limited translational velocity.
+   */
+  std::array<double, 6> limitTwist(
+      const std::array<double, 6>& O_dP_EE_c,  // NOLINT(readability-identifier-naming)
+      const std::array<double, 16>& O_T_EE_c,  // NOLINT(readability-identifier-naming)
+      double time_step) const noexcept;
+
+ private:
+  struct Cuboid {
+    std::array<double, 9> rotation;
+    std::array<double, 3> center;
+    std::array<double, 3> half_size;
+  };
+
+  std::vector<Cuboid> cuboids_;
+  VirtualWallShieldParameters parameters_;
+};
+
+}  // namespace franka
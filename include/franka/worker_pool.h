@@ -0,0 +1,123 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <franka/control_types.h>
+
+/**
+ * @file worker_pool.h
+ * Contains a fork-join worker pool for parallel work inside of control loops.
+ */
+
+namespace franka {
+
+/**
+ * Fork-join pool that executes a fixed set of tasks in parallel and returns when all of them are
+ * done.
+ *
+ * The calling thread takes part in executing the tasks. Running a task set does not allocate
+ * memory, so tasks can be run from within control and motion generator callbacks. Create the task
+ * set once before starting the control loop, e.g. as lambdas capturing the data shared with the
+ * callback.
+ *
+ * Workers that are pinned to CPUs spin while a control loop is running, so that no wake-up latency
+ * is added to the control cycle. They block otherwise. Unpinned workers always block, because a
+ * spinning realtime thread could starve the control loop thread on the same CPU. The control loop
+ * thread should therefore not run on the CPUs of the workers.
+ *
+ * @see Robot::setControlWorkers to create a pool that is tied to the control loops of a robot.
+ */
+class WorkerPool {
+ public:
+  /**
+   * Task of a task set.
+   */
+  using Task = std::function<void()>;
+
+  /**
+   * Creates a new WorkerPool instance and starts the worker threads.
+   *
+   * Worker threads get realtime scheduling with a priority just below the control loop thread.
+   *
+   * @param[in] worker_count Number of worker threads, not including the calling thread.
+   * @param[in] cpus CPU to pin each worker thread to. Either empty or one CPU per worker.
+   * @param[in] realtime_config if set to Enforce, an exception will be thrown if realtime
+   * scheduling or pinning cannot be enforced when starting the workers.
+   *
+   * @throw std::invalid_argument if the number of CPUs does not match the number of workers.
+   * @throw RealtimeException if realtime scheduling or pinning was requested and could not be set.
+   */
+  explicit WorkerPool(size_t worker_count,
+                      const std::vector<int>& cpus = {},
+                      RealtimeConfig realtime_config = RealtimeConfig::kEnforce);
+
+  /**
+   * Stops and joins the worker threads.
+   */
+  ~WorkerPool() noexcept;
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * Returns the number of worker threads.
+   *
+   * @return Number of worker threads.
+   */
+  size_t workerCount() const noexcept;
+
+  /**
+   * Executes the given tasks in parallel and waits until all of them are done.
+   *
+   * Must not be called concurrently from several threads.
+   *
+   * @param[in] tasks Task set. Each task is executed exactly once, in any order.
+   *
+   * @throw Any exception thrown by a task. If several tasks throw, the first exception is rethrown
+   * after all tasks are done.
+   */
+  void run(const std::vector<Task>& tasks);
+
+  /**
+   * Lets pinned workers spin instead of blocking while waiting for tasks.
+   *
+   * Called by the control loops of a robot when they start and finish.
+   *
+   * @param[in] spinning True to let the workers spin, false to let them block.
+   */
+  void setSpinning(bool spinning);
+
+ private:
+  void work() noexcept;
+  void executeTasks() noexcept;
+  void stop() noexcept;
+
+  const bool pinned_;  // NOLINT(readability-identifier-naming)
+  std::vector<std::thread> workers_;
+
+  const std::vector<Task>* tasks_ = nullptr;
+  size_t task_count_ = 0;
+  std::atomic<size_t> next_task_{0};
+  std::atomic<size_t> finished_workers_{0};
+  std::atomic<uint64_t> generation_{0};
+  std::atomic<bool> spinning_{false};
+  std::atomic<bool> stopped_{false};
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+
+  std::mutex exception_mutex_;
+  std::exception_ptr exception_;
+};
+
+}  // namespace franka
@@ -0,0 +1,202 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/admittance_controller.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <Eigen/Dense>
+
+#include <franka/control_math.h>
+
+namespace franka {
+
+namespace {
+
+void checkParameters(const AdmittanceParameters& parameters) {
+  for (size_t i = 0; i < 6; i++) {
+    if (!(parameters.mass[i] > 0.0)) {
+      throw std::invalid_argument("libfranka: Admittance mass must be positive.");
+    }
+    if (!(parameters.damping[i] >= 0.0) || !(parameters.stiffness[i] >= 0.0) ||
+        !(parameters.deadband[i] >= 0.0)) {
+      throw std::invalid_argument(
+          "libfranka: Admittance damping, stiffness and deadband must not be negative.");
+    }
+    if (!(parameters.maximum_velocity[i] > 0.0)) {
+      throw std::invalid_argument("libfranka: Admittance maximum velocity must be positive.");
+    }
+  }
+  for (size_t i = 0; i < 3; i++) {
+    if (!(parameters.workspace_minimum[i] <= parameters.workspace_maximum[i])) {
+      throw std::invalid_argument("libfranka: Admittance workspace is empty.");
+    }
+  }
+  if (!(parameters.wrench_cutoff_frequency > 0.0)) {
+    throw std::invalid_argument("libfranka: Admittance cutoff frequency must be positive.");
+  }
+  if (parameters.snap_point_count > AdmittanceParameters::kMaxSnapPoints ||
+      !(parameters.snap_radius >= 0.0) || !(parameters.snap_stiffness >= 0.0)) {
+    throw std::invalid_argument("libfranka: Invalid admittance snap point parameters.");
+  }
+  if (!(parameters.jacobian_damping >= 0.0)) {
+    throw std::invalid_argument("libfranka: Admittance Jacobian damping must not be negative.");
+  }
+}
+
+// Below this, the 7x7 matrix of the damped pseudoinverse is too close to singular.
+constexpr double kMinimumSquaredDamping = 1e-8;
+
+inline double applyDeadband(double value, double deadband) noexcept {
+  return std::copysign(std::max(std::abs(value) - deadband, 0.0), value);
+}
+
+}  // anonymous namespace
+
+constexpr size_t AdmittanceParameters::kMaxSnapPoints;
+
+AdmittanceController::AdmittanceController(const AdmittanceParameters& parameters)
+    : pending_parameters_(parameters), parameters_updated_(false), parameters_(parameters) {
+  checkParameters(parameters);
+  reset();
+}
+
+CartesianVelocities AdmittanceController::operator()(const RobotState& robot_state,
+                                                     Duration period) {
+  return step(robot_state, period);
+}
+
+JointVelocities AdmittanceController::operator()(const RobotState& robot_state,
+                                                 Duration period,
+                                                 const std::array<double, 42>& zero_jacobian) {
+  std::array<double, 6> velocity = step(robot_state, period);
+
+  Eigen::Map<const Eigen::Matrix<double, 6, 7>> jacobian(zero_jacobian.data());
+  Eigen::Map<const Eigen::Matrix<double, 6, 1>> twist(velocity.data());
+  const double squared_damping = parameters_.jacobian_damping * parameters_.jacobian_damping;
+
+  // J^T (J J^T + lambda^2 I)^-1 equals (J^T J + lambda^2 I)^-1 J^T, whose 7x7 matrix is positive
+  // definite for any damping.
+  std::array<double, 49> normal_matrix;
+  Eigen::Map<Eigen::Matrix<double, 7, 7>>(normal_matrix.data()) =
+      jacobian.transpose() * jacobian +
+      squared_damping * Eigen::Matrix<double, 7, 7>::Identity();
+  std::array<double, 7> joint_twist;
+  Eigen::Map<Eigen::Matrix<double, 7, 1>>(joint_twist.data()) = jacobian.transpose() * twist;
+  JointMatrixLDLT ldlt;
+  if (squared_damping >= kMinimumSquaredDamping && ldlt.compute(normal_matrix)) {
+    return ldlt.solve(joint_twist);
+  }
+
+  // Without damping, J^T J is singular and the 6x6 system has to be solved instead.
+  std::array<double, 7> joint_velocities{};
+  Eigen::Map<Eigen::Matrix<double, 7, 1>>(joint_velocities.data()) =
+      jacobian.transpose() *
+      (jacobian * jacobian.transpose() + squared_damping * Eigen::Matrix<double, 6, 6>::Identity())
+          .ldlt()
+          .solve(twist);
+  return joint_velocities;
+}
+
+void AdmittanceController::setParameters(const AdmittanceParameters& parameters) {
+  checkParameters(parameters);
+  std::lock_guard<std::mutex> _(parameters_mutex_);
+  pending_parameters_ = parameters;
+  parameters_updated_ = true;
+}
+
+AdmittanceParameters AdmittanceController::parameters() const {
+  std::lock_guard<std::mutex> _(parameters_mutex_);
+  return pending_parameters_;
+}
+
+void AdmittanceController::reset() noexcept {
+  initialized_ = false;
+  rest_pose_ = {};
+  wrench_ = {};
+  velocity_ = {};
+}
+
+std::array<double, 6> AdmittanceController::step(const RobotState& robot_state,
+                                                 Duration period) {
+  {
+    // Never block the control loop; if the parameters are being written right now, they are
+    // picked up in the next cycle.
+    std::unique_lock<std::mutex> l(parameters_mutex_, std::try_to_lock);
+    if (l.owns_lock() && parameters_updated_) {
+      parameters_ = pending_parameters_;
+      parameters_updated_ = false;
+    }
+  }
+
+  // O_F_ext_hat_K is positive for forces applied by the robot, so the wrench applied to the robot
+  // has the opposite sign.
+  std::array<double, 6> applied_wrench{};
+  for (size_t i = 0; i < 6; i++) {
+    applied_wrench[i] = -robot_state.O_F_ext_hat_K[i];
+  }
+
+  if (!initialized_) {
+    rest_pose_ = robot_state.O_T_EE;
+    wrench_ = applied_wrench;
+    velocity_ = {};
+    initialized_ = true;
+  }
+
+  const double dt = period.toSec();
+  if (dt <= 0.0) {
+    return velocity_;
+  }
+
+  for (size_t i = 0; i < 6; i++) {
+    wrench_[i] = parameters_.wrench_cutoff_frequency < kMaxCutoffFrequency
+                     ? lowpassFilter(dt, applied_wrench[i], wrench_[i],
+                                     parameters_.wrench_cutoff_frequency)
+                     : applied_wrench[i];
+  }
+
+  Eigen::Map<const Eigen::Matrix4d> pose(robot_state.O_T_EE.data());
+  Eigen::Map<const Eigen::Matrix4d> rest_pose(rest_pose_.data());
+  Eigen::Vector3d position(pose.topRightCorner<3, 1>());
+
+  Eigen::Matrix<double, 6, 1> displacement;
+  displacement.head<3>() = position - rest_pose.topRightCorner<3, 1>();
+  Eigen::AngleAxisd rotation(Eigen::Matrix3d(pose.topLeftCorner<3, 3>() *
+                                             rest_pose.topLeftCorner<3, 3>().transpose()));
+  displacement.tail<3>() = rotation.angle() * rotation.axis();
+
+  std::array<double, 6> force{};
+  for (size_t i = 0; i < 6; i++) {
+    force[i] = applyDeadband(wrench_[i], parameters_.deadband[i]) -
+               parameters_.stiffness[i] * displacement[i];
+  }
+  for (size_t k = 0; k < parameters_.snap_point_count; k++) {
+    Eigen::Vector3d offset = Eigen::Vector3d(parameters_.snap_points[k].data()) - position;
+    if (offset.norm() < parameters_.snap_radius) {
+      for (size_t i = 0; i < 3; i++) {
+        force[i] += parameters_.snap_stiffness * offset[i];
+      }
+    }
+  }
+
+  // Integrate the damping implicitly, so that the discretization is stable for any damping.
+  for (size_t i = 0; i < 6; i++) {
+    double velocity = (velocity_[i] + dt * force[i] / parameters_.mass[i]) /
+                      (1.0 + dt * parameters_.damping[i] / parameters_.mass[i]);
+    velocity_[i] = std::max(std::min(velocity, parameters_.maximum_velocity[i]),
+                            -parameters_.maximum_velocity[i]);
+  }
+
+  // Do not move further out of the workspace.
+  for (size_t i = 0; i < 3; i++) {
+    if ((position[i] <= parameters_.workspace_minimum[i] && velocity_[i] < 0.0) ||
+        (position[i] >= parameters_.workspace_maximum[i] && velocity_[i] > 0.0)) {
+      velocity_[i] = 0.0;
+    }
+  }
+
+  return velocity_;
+}
+
+}  // namespace franka
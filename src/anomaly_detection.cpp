@@ -0,0 +1,122 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/anomaly_detection.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace franka {
+
+AnomalyDetector::AnomalyDetector(const AnomalyDetectionParameters& parameters)
+    : parameters_(parameters) {
+  if (parameters_.configuration_bins == 0) {
+    throw std::invalid_argument("libfranka: At least one configuration bin is required.");
+  }
+  if (!(parameters_.baseline_weight > 0.0 && parameters_.baseline_weight <= 1.0)) {
+    throw std::invalid_argument("libfranka: Baseline weight must be in range (0, 1].");
+  }
+  if (!(parameters_.z_score_threshold > 0.0) || !(parameters_.cusum_threshold > 0.0) ||
+      !(parameters_.cusum_drift >= 0.0)) {
+    throw std::invalid_argument("libfranka: Invalid anomaly detection thresholds.");
+  }
+  if (!(parameters_.minimum_torque_deviation > 0.0) ||
+      !(parameters_.minimum_wrench_deviation > 0.0)) {
+    throw std::invalid_argument("libfranka: Minimum deviations must be positive.");
+  }
+
+  joint_baselines_.resize(parameters_.configuration_bins * 7);
+  cartesian_baselines_.resize(parameters_.configuration_bins * parameters_.configuration_bins * 6);
+  reset();
+}
+
+bool AnomalyDetector::update(const RobotState& robot_state, AnomalyEvent* event) noexcept {
+  std::array<size_t, 7> joint_bins{};
+  for (size_t i = 0; i < 7; i++) {
+    joint_bins[i] = configurationBin(robot_state.q[i]);
+  }
+  std::array<size_t, 6> cartesian_bins{};
+  cartesian_bins.fill(configurationBin(robot_state.q[1]) * parameters_.configuration_bins +
+                      configurationBin(robot_state.q[3]));
+
+  bool joint_anomaly =
+      detect(robot_state.tau_ext_hat_filtered, joint_bins, parameters_.minimum_torque_deviation,
+             &joint_baselines_, &joint_channels_);
+  bool cartesian_anomaly =
+      detect(robot_state.O_F_ext_hat_K, cartesian_bins, parameters_.minimum_wrench_deviation,
+             &cartesian_baselines_, &cartesian_channels_);
+
+  bool anomaly_active = joint_anomaly || cartesian_anomaly;
+  bool anomaly_started = anomaly_active && !anomaly_active_;
+  anomaly_active_ = anomaly_active;
+
+  if (anomaly_started && event != nullptr) {
+    event->time = robot_state.time;
+    event->joint_anomaly = joint_channels_.flagged;
+    event->cartesian_anomaly = cartesian_channels_.flagged;
+    event->joint_z_score = joint_channels_.z_score;
+    event->cartesian_z_score = cartesian_channels_.z_score;
+  }
+  return anomaly_started;
+}
+
+void AnomalyDetector::reset() noexcept {
+  std::fill(joint_baselines_.begin(), joint_baselines_.end(), Baseline{0.0, 0.0, 0});
+  std::fill(cartesian_baselines_.begin(), cartesian_baselines_.end(), Baseline{0.0, 0.0, 0});
+  joint_channels_ = {};
+  cartesian_channels_ = {};
+  anomaly_active_ = false;
+}
+
+const AnomalyDetectionParameters& AnomalyDetector::parameters() const noexcept {
+  return parameters_;
+}
+
+template <size_t N>
+bool AnomalyDetector::detect(const std::array<double, N>& values,
+                             const std::array<size_t, N>& bins,
+                             double minimum_deviation,
+                             std::vector<Baseline>* baselines,
+                             Channels<N>* channels) noexcept {
+  bool any_flagged = false;
+  for (size_t i = 0; i < N; i++) {
+    Baseline& baseline = (*baselines)[bins[i] * N + i];
+
+    double z_score = 0.0;
+    bool flagged = false;
+    if (baseline.samples >= parameters_.warmup_samples) {
+      z_score = (values[i] - baseline.mean) /
+                std::max(std::sqrt(baseline.variance), minimum_deviation);
+      channels->cusum_high[i] =
+          std::max(0.0, channels->cusum_high[i] + z_score - parameters_.cusum_drift);
+      channels->cusum_low[i] =
+          std::max(0.0, channels->cusum_low[i] - z_score - parameters_.cusum_drift);
+      flagged = std::abs(z_score) > parameters_.z_score_threshold ||
+                channels->cusum_high[i] > parameters_.cusum_threshold ||
+                channels->cusum_low[i] > parameters_.cusum_threshold;
+    }
+    channels->z_score[i] = z_score;
+    channels->flagged[i] = flagged;
+    any_flagged = any_flagged || flagged;
+
+    if (!flagged) {
+      // Use the cumulative mean while warming up, so that the baseline does not depend on the
+      // first sample of a bin.
+      double weight = std::max(parameters_.baseline_weight, 1.0 / (baseline.samples + 1));
+      double difference = values[i] - baseline.mean;
+      baseline.mean += weight * difference;
+      baseline.variance = (1.0 - weight) * (baseline.variance + weight * difference * difference);
+      baseline.samples++;
+    }
+  }
+  return any_flagged;
+}
+
+size_t AnomalyDetector::configurationBin(double joint_angle) const noexcept {
+  double normalized = (joint_angle + M_PI) / (2.0 * M_PI);
+  double bin = std::floor(normalized * parameters_.configuration_bins);
+  return static_cast<size_t>(
+      std::max(0.0, std::min(bin, static_cast<double>(parameters_.configuration_bins - 1))));
+}
+
+}  // namespace franka
@@ -0,0 +1,181 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/collision_thresholds.h>
+
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+#include <franka/exception.h>
+#include <franka/log_file.h>
+
+#include "parallel_for.h"
+
+namespace franka {
+
+namespace {
+
+constexpr size_t kBins = 10000;
+constexpr double kTorqueBinWidth = 0.01;
+constexpr double kForceBinWidth = 0.02;
+
+inline size_t binIndex(double value, double bin_width) noexcept {
+  double bin = std::abs(value) / bin_width;
+  return bin < kBins - 1 ? static_cast<size_t>(bin) : kBins - 1;
+}
+
+// Returns the upper edge of the bin containing the given quantile of a channel.
+double quantile(const std::vector<uint64_t>& bins,
+                size_t channel,
+                uint64_t samples,
+                double quantile,
+                double bin_width) noexcept {
+  auto rank = static_cast<uint64_t>(std::ceil(quantile * samples));
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < kBins; i++) {
+    cumulative += bins[channel * kBins + i];
+    if (cumulative >= rank) {
+      return (i + 1) * bin_width;
+    }
+  }
+  return kBins * bin_width;
+}
+
+void checkParameters(double false_trigger_rate, double safety_factor) {
+  if (!(false_trigger_rate > 0.0 && false_trigger_rate < 1.0)) {
+    throw std::invalid_argument("libfranka: False-trigger rate must be in range (0, 1).");
+  }
+  if (!(safety_factor >= 1.0)) {
+    throw std::invalid_argument("libfranka: Safety factor must be at least 1.");
+  }
+}
+
+}  // anonymous namespace
+
+constexpr double CollisionThresholdRecommender::kDefaultAccelerationThreshold;
+
+CollisionThresholdRecommender::Histograms::Histograms()
+    : samples(0), torque_bins(7 * kBins), force_bins(6 * kBins) {}
+
+void CollisionThresholdRecommender::Histograms::merge(const Histograms& other) noexcept {
+  samples += other.samples;
+  for (size_t i = 0; i < torque_bins.size(); i++) {
+    torque_bins[i] += other.torque_bins[i];
+  }
+  for (size_t i = 0; i < force_bins.size(); i++) {
+    force_bins[i] += other.force_bins[i];
+  }
+}
+
+CollisionThresholdRecommender::CollisionThresholdRecommender(double acceleration_threshold)
+    : acceleration_threshold_(acceleration_threshold) {
+  if (!(acceleration_threshold >= 0.0)) {
+    throw std::invalid_argument("libfranka: Acceleration threshold must not be negative.");
+  }
+}
+
+void CollisionThresholdRecommender::add(const RobotState& robot_state) noexcept {
+  double acceleration_squared = 0.0;
+  for (double ddq_d : robot_state.ddq_d) {
+    acceleration_squared += ddq_d * ddq_d;
+  }
+  Histograms& histograms = acceleration_squared > acceleration_threshold_ * acceleration_threshold_
+                               ? acceleration_
+                               : nominal_;
+
+  for (size_t i = 0; i < 7; i++) {
+    histograms
+        .torque_bins[i * kBins + binIndex(robot_state.tau_ext_hat_filtered[i], kTorqueBinWidth)]++;
+  }
+  for (size_t i = 0; i < 6; i++) {
+    histograms.force_bins[i * kBins + binIndex(robot_state.O_F_ext_hat_K[i], kForceBinWidth)]++;
+  }
+  histograms.samples++;
+}
+
+void CollisionThresholdRecommender::add(const std::vector<Record>& log) noexcept {
+  for (const Record& record : log) {
+    add(record.state);
+  }
+}
+
+void CollisionThresholdRecommender::merge(const CollisionThresholdRecommender& other) {
+  if (acceleration_threshold_ != other.acceleration_threshold_) {
+    throw std::invalid_argument(
+        "libfranka: Cannot merge recommenders with different acceleration thresholds.");
+  }
+  acceleration_.merge(other.acceleration_);
+  nominal_.merge(other.nominal_);
+}
+
+uint64_t CollisionThresholdRecommender::accelerationSamples() const noexcept {
+  return acceleration_.samples;
+}
+
+uint64_t CollisionThresholdRecommender::nominalSamples() const noexcept {
+  return nominal_.samples;
+}
+
+CollisionThresholds CollisionThresholdRecommender::recommend(double false_trigger_rate,
+                                                             double safety_factor) const {
+  checkParameters(false_trigger_rate, safety_factor);
+  if (acceleration_.samples == 0 && nominal_.samples == 0) {
+    throw InvalidOperationException(
+        "libfranka: Cannot recommend collision thresholds without samples.");
+  }
+
+  const Histograms& acceleration = acceleration_.samples > 0 ? acceleration_ : nominal_;
+  const Histograms& nominal = nominal_.samples > 0 ? nominal_ : acceleration_;
+  const double q = 1.0 - false_trigger_rate;
+
+  CollisionThresholds thresholds;
+  for (size_t i = 0; i < 7; i++) {
+    thresholds.lower_torque_thresholds_acceleration[i] =
+        quantile(acceleration.torque_bins, i, acceleration.samples, q, kTorqueBinWidth);
+    thresholds.upper_torque_thresholds_acceleration[i] =
+        safety_factor * thresholds.lower_torque_thresholds_acceleration[i];
+    thresholds.lower_torque_thresholds_nominal[i] =
+        quantile(nominal.torque_bins, i, nominal.samples, q, kTorqueBinWidth);
+    thresholds.upper_torque_thresholds_nominal[i] =
+        safety_factor * thresholds.lower_torque_thresholds_nominal[i];
+  }
+  for (size_t i = 0; i < 6; i++) {
+    thresholds.lower_force_thresholds_acceleration[i] =
+        quantile(acceleration.force_bins, i, acceleration.samples, q, kForceBinWidth);
+    thresholds.upper_force_thresholds_acceleration[i] =
+        safety_factor * thresholds.lower_force_thresholds_acceleration[i];
+    thresholds.lower_force_thresholds_nominal[i] =
+        quantile(nominal.force_bins, i, nominal.samples, q, kForceBinWidth);
+    thresholds.upper_force_thresholds_nominal[i] =
+        safety_factor * thresholds.lower_force_thresholds_nominal[i];
+  }
+  return thresholds;
+}
+
+CollisionThresholds recommendCollisionThresholds(const std::vector<std::string>& log_files,
+                                                 double false_trigger_rate,
+                                                 double safety_factor,
+                                                 size_t threads) {
+  checkParameters(false_trigger_rate, safety_factor);
+
+  std::vector<CollisionThresholdRecommender> recommenders(
+      parallelWorkerCount(threads, log_files.size()));
+  parallelFor(log_files.size(), threads, [&](size_t worker, size_t index) {
+    std::ifstream stream(log_files[index], std::ios::binary);
+    if (!stream) {
+      throw LogFileException("libfranka: Could not open log file " + log_files[index] + ".");
+    }
+    LogFileReader reader(stream);
+    Record record;
+    while (reader.read(&record)) {
+      recommenders[worker].add(record.state);
+    }
+  });
+
+  for (size_t i = 1; i < recommenders.size(); i++) {
+    recommenders[0].merge(recommenders[i]);
+  }
+  return recommenders[0].recommend(false_trigger_rate, safety_factor);
+}
+
+}  // namespace franka
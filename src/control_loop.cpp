@@ -12,6 +12,7 @@
 #include <franka/exception.h>
 #include <franka/lowpass_filter.h>
 #include <franka/rate_limiting.h>
+#include <franka/robot_traits.h>
 
 #include "motion_generator_traits.h"
 
@@ -22,6 +23,32 @@ using namespace std::string_literals;  // NOLINT(google-build-using-namespace)
 
 namespace franka {
 
+namespace {
+
+// Lets pinned control workers spin while a loop is running.
+class SpinningWorkers {
+ public:
+  explicit SpinningWorkers(WorkerPool* worker_pool) : worker_pool_(worker_pool) {
+    if (worker_pool_ != nullptr) {
+      worker_pool_->setSpinning(true);
+    }
+  }
+
+  ~SpinningWorkers() {
+    if (worker_pool_ != nullptr) {
+      worker_pool_->setSpinning(false);
+    }
+  }
+
+  SpinningWorkers(const SpinningWorkers&) = delete;
+  SpinningWorkers& operator=(const SpinningWorkers&) = delete;
+
+ private:
+  WorkerPool* worker_pool_;
+};
+
+}  // anonymous namespace
+
 template <typename T>
 constexpr research_interface::robot::Move::Deviation ControlLoop<T>::kDefaultDeviation;
 
@@ -93,6 +120,7 @@ ControlLoop<T>::ControlLoop(RobotControl& robot,
 
 template <typename T>
 void ControlLoop<T>::operator()() try {
+  SpinningWorkers spinning_workers(robot_.workerPool());
   RobotState robot_state = robot_.update(nullptr, nullptr);
   robot_.throwOnMotionError(robot_state, motion_id_);
 
@@ -130,13 +158,12 @@ bool ControlLoop<T>::spinControl(const RobotState& robot_state,
                                  research_interface::robot::ControllerCommand* command) {
   Torques control_output = control_callback_(robot_state, time_step);
   if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    for (size_t i = 0; i < 7; i++) {
-      control_output.tau_J[i] = lowpassFilter(kDeltaT, control_output.tau_J[i],
-                                              robot_state.tau_J_d[i], cutoff_frequency_);
-    }
+    control_output.tau_J =
+        lowpassFilter(kDeltaT, control_output.tau_J, robot_state.tau_J_d, cutoff_frequency_);
   }
   if (limit_rate_) {
-    control_output.tau_J = limitRate(kMaxTorqueRate, control_output.tau_J, robot_state.tau_J_d);
+    control_output.tau_J = limitRate<PandaTraits::kDof>(
+        PandaTraits::maxTorqueRate(), control_output.tau_J, robot_state.tau_J_d);
   }
   command->tau_J_d = control_output.tau_J;
   return !control_output.motion_finished;
@@ -157,15 +184,20 @@ void ControlLoop<JointPositions>::convertMotion(
     const RobotState& robot_state,
     research_interface::robot::MotionGeneratorCommand* command) {
   command->q_c = motion.q;
+  if (robot_.jointLimitShaping()) {
+    command->q_c = shapeJointPositions<PandaTraits::kDof>(
+        PandaTraits::minJointPosition(), PandaTraits::maxJointPosition(),
+        PandaTraits::maxJointAcceleration(), PandaTraits::maxJointJerk(), command->q_c,
+        robot_state.q_d);
+  }
   if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    for (size_t i = 0; i < 7; i++) {
-      command->q_c[i] =
-          lowpassFilter(kDeltaT, command->q_c[i], robot_state.q_d[i], cutoff_frequency_);
-    }
+    command->q_c = lowpassFilter(kDeltaT, command->q_c, robot_state.q_d, cutoff_frequency_);
   }
   if (limit_rate_) {
-    command->q_c = limitRate(kMaxJointVelocity, kMaxJointAcceleration, kMaxJointJerk, command->q_c,
-                             robot_state.q_d, robot_state.dq_d, robot_state.ddq_d);
+    command->q_c = limitRate<PandaTraits::kDof>(
+        PandaTraits::maxJointVelocity(), PandaTraits::maxJointAcceleration(),
+        PandaTraits::maxJointJerk(), command->q_c, robot_state.q_d, robot_state.dq_d,
+        robot_state.ddq_d);
   }
 }
 
@@ -175,15 +207,19 @@ void ControlLoop<JointVelocities>::convertMotion(
     const RobotState& robot_state,
     research_interface::robot::MotionGeneratorCommand* command) {
   command->dq_c = motion.dq;
+  if (robot_.jointLimitShaping()) {
+    command->dq_c = shapeJointVelocities<PandaTraits::kDof>(
+        PandaTraits::minJointPosition(), PandaTraits::maxJointPosition(),
+        PandaTraits::maxJointAcceleration(), PandaTraits::maxJointJerk(), command->dq_c,
+        robot_state.q_d);
+  }
   if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    for (size_t i = 0; i < 7; i++) {
-      command->dq_c[i] =
-          lowpassFilter(kDeltaT, command->dq_c[i], robot_state.dq_d[i], cutoff_frequency_);
-    }
+    command->dq_c = lowpassFilter(kDeltaT, command->dq_c, robot_state.dq_d, cutoff_frequency_);
   }
   if (limit_rate_) {
-    command->dq_c = limitRate(kMaxJointVelocity, kMaxJointAcceleration, kMaxJointJerk,
-                              command->dq_c, robot_state.dq_d, robot_state.ddq_d);
+    command->dq_c = limitRate<PandaTraits::kDof>(
+        PandaTraits::maxJointVelocity(), PandaTraits::maxJointAcceleration(),
+        PandaTraits::maxJointJerk(), command->dq_c, robot_state.dq_d, robot_state.ddq_d);
   }
 }
 
@@ -193,11 +229,12 @@ void ControlLoop<CartesianPose>::convertMotion(
     const RobotState& robot_state,
     research_interface::robot::MotionGeneratorCommand* command) {
   command->O_T_EE_c = motion.O_T_EE;
+  if (const VirtualWallShield* shield = robot_.virtualWallShield()) {
+    command->O_T_EE_c = shield->limitPose(command->O_T_EE_c, robot_state.O_T_EE_c, kDeltaT);
+  }
   if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    for (size_t i = 0; i < 16; i++) {
-      command->O_T_EE_c[i] =
-          lowpassFilter(kDeltaT, command->O_T_EE_c[i], robot_state.O_T_EE_c[i], cutoff_frequency_);
-    }
+    command->O_T_EE_c = cartesianLowpassFilter(kDeltaT, command->O_T_EE_c, robot_state.O_T_EE_c,
+                                               cutoff_frequency_);
   }
   if (limit_rate_) {
     command->O_T_EE_c = limitRate(
@@ -230,11 +267,12 @@ void ControlLoop<CartesianVelocities>::convertMotion(
     const RobotState& robot_state,
     research_interface::robot::MotionGeneratorCommand* command) {
   command->O_dP_EE_c = motion.O_dP_EE;
+  if (const VirtualWallShield* shield = robot_.virtualWallShield()) {
+    command->O_dP_EE_c = shield->limitTwist(command->O_dP_EE_c, robot_state.O_T_EE_c, kDeltaT);
+  }
   if (cutoff_frequency_ < kMaxCutoffFrequency) {
-    for (size_t i = 0; i < 6; i++) {
-      command->O_dP_EE_c[i] = lowpassFilter(kDeltaT, command->O_dP_EE_c[i],
-                                            robot_state.O_dP_EE_c[i], cutoff_frequency_);
-    }
+    command->O_dP_EE_c =
+        lowpassFilter(kDeltaT, command->O_dP_EE_c, robot_state.O_dP_EE_c, cutoff_frequency_);
   }
   if (limit_rate_) {
     command->O_dP_EE_c =
@@ -0,0 +1,232 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/control_math.h>
+
+#include <cmath>
+#include <cstddef>
+
+// All inner loops have compile-time bounds and run over contiguous memory, so that the compiler
+// can unroll and vectorize them.
+
+namespace franka {
+
+namespace {
+
+constexpr size_t kJoints = 7;
+constexpr size_t kCartesian = 6;
+
+}  // anonymous namespace
+
+JointMatrixLDLT::JointMatrixLDLT(const std::array<double, 49>& matrix) noexcept {
+  compute(matrix);
+}
+
+bool JointMatrixLDLT::compute(const std::array<double, 49>& matrix) noexcept {
+  positive_definite_ = false;
+  lower_ = matrix;
+  std::array<double, kJoints> scaled;
+  for (size_t j = 0; j < kJoints; j++) {
+    double* column = &lower_[j * kJoints];
+    // scaled[k] = L(j, k) * D(k)
+    for (size_t k = 0; k < j; k++) {
+      scaled[k] = lower_[k * kJoints + j] / inverse_diagonal_[k];
+    }
+    // Updates the whole column, the upper part is cleared below.
+    for (size_t k = 0; k < j; k++) {
+      const double* previous = &lower_[k * kJoints];
+      for (size_t i = 0; i < kJoints; i++) {
+        column[i] -= previous[i] * scaled[k];
+      }
+    }
+    const double pivot = column[j];
+    if (!(pivot > 0.0)) {
+      return false;
+    }
+    inverse_diagonal_[j] = 1.0 / pivot;
+    for (size_t i = 0; i < kJoints; i++) {
+      column[i] = i > j ? column[i] * inverse_diagonal_[j] : 0.0;
+    }
+  }
+  positive_definite_ = true;
+  return true;
+}
+
+bool JointMatrixLDLT::positiveDefinite() const noexcept {
+  return positive_definite_;
+}
+
+std::array<double, 7> JointMatrixLDLT::solve(const std::array<double, 7>& b) const noexcept {
+  std::array<double, 7> x = b;
+  // The diagonal and upper part of lower_ are zero, so all loops can run over whole columns.
+  for (size_t k = 0; k < kJoints; k++) {
+    const double* column = &lower_[k * kJoints];
+    const double x_k = x[k];
+    for (size_t i = 0; i < kJoints; i++) {
+      x[i] -= column[i] * x_k;
+    }
+  }
+  for (size_t i = 0; i < kJoints; i++) {
+    x[i] *= inverse_diagonal_[i];
+  }
+  for (size_t k = kJoints; k-- > 0;) {
+    const double* column = &lower_[k * kJoints];
+    double sum = 0.0;
+    for (size_t i = 0; i < kJoints; i++) {
+      sum += column[i] * x[i];
+    }
+    x[k] -= sum;
+  }
+  return x;
+}
+
+std::array<double, 42> JointMatrixLDLT::solveRight(
+    const std::array<double, 42>& matrix) const noexcept {
+  // A column-major 6x7 matrix is the row-major 7x6 matrix A^T, so the rows of A^T, i.e. the
+  // right-hand sides of M X = A^T, are contiguous. Solves for all six of them at once.
+  std::array<double, 42> x = matrix;
+  for (size_t k = 0; k < kJoints; k++) {
+    const double* x_k = &x[k * kCartesian];
+    for (size_t i = k + 1; i < kJoints; i++) {
+      const double factor = lower_[k * kJoints + i];
+      double* x_i = &x[i * kCartesian];
+      for (size_t c = 0; c < kCartesian; c++) {
+        x_i[c] -= factor * x_k[c];
+      }
+    }
+  }
+  for (size_t i = 0; i < kJoints; i++) {
+    double* x_i = &x[i * kCartesian];
+    for (size_t c = 0; c < kCartesian; c++) {
+      x_i[c] *= inverse_diagonal_[i];
+    }
+  }
+  for (size_t k = kJoints; k-- > 0;) {
+    double* x_k = &x[k * kCartesian];
+    for (size_t i = k + 1; i < kJoints; i++) {
+      const double factor = lower_[k * kJoints + i];
+      const double* x_i = &x[i * kCartesian];
+      for (size_t c = 0; c < kCartesian; c++) {
+        x_k[c] -= factor * x_i[c];
+      }
+    }
+  }
+  return x;
+}
+
+bool inverseCartesianInertia(const std::array<double, 42>& jacobian,
+                             const std::array<double, 49>& mass_matrix,
+                             std::array<double, 36>* result) noexcept {
+  JointMatrixLDLT ldlt;
+  if (!ldlt.compute(mass_matrix)) {
+    return false;
+  }
+  std::array<double, 42> solved = ldlt.solveRight(jacobian);
+
+  // (J M^-1) J^T, accumulated column by column.
+  std::array<double, 36> product{};
+  for (size_t c = 0; c < kCartesian; c++) {
+    double* column = &product[c * kCartesian];
+    for (size_t k = 0; k < kJoints; k++) {
+      const double factor = jacobian[k * kCartesian + c];
+      const double* solved_column = &solved[k * kCartesian];
+      for (size_t r = 0; r < kCartesian; r++) {
+        column[r] += solved_column[r] * factor;
+      }
+    }
+  }
+  // Mirror the lower triangle, so that the result is exactly symmetric.
+  for (size_t c = 0; c < kCartesian; c++) {
+    for (size_t r = 0; r < c; r++) {
+      product[c * kCartesian + r] = product[r * kCartesian + c];
+    }
+  }
+  *result = product;
+  return true;
+}
+
+std::array<double, 16> multiplyTransforms(const std::array<double, 16>& a,
+                                          const std::array<double, 16>& b) noexcept {
+  // A full product, since the last row of b is (0, 0, 0, 1) the last row of the result is as
+  // well.
+  std::array<double, 16> result;
+  for (size_t c = 0; c < 4; c++) {
+    double* column = &result[c * 4];
+    for (size_t r = 0; r < 4; r++) {
+      column[r] = a[r] * b[c * 4];
+    }
+    for (size_t k = 1; k < 4; k++) {
+      const double factor = b[c * 4 + k];
+      for (size_t r = 0; r < 4; r++) {
+        column[r] += a[k * 4 + r] * factor;
+      }
+    }
+  }
+  return result;
+}
+
+std::array<double, 16> invertTransform(const std::array<double, 16>& transform) noexcept {
+  std::array<double, 16> result{};
+  for (size_t c = 0; c < 3; c++) {
+    for (size_t r = 0; r < 3; r++) {
+      result[c * 4 + r] = transform[r * 4 + c];
+    }
+  }
+  for (size_t r = 0; r < 3; r++) {
+    const double* column = &transform[r * 4];
+    result[12 + r] = -(column[0] * transform[12] + column[1] * transform[13] +
+                       column[2] * transform[14]);
+  }
+  result[15] = 1.0;
+  return result;
+}
+
+std::array<double, 3> orientationError(const std::array<double, 16>& pose,
+                                       const std::array<double, 16>& desired_pose) noexcept {
+  // Rotation between the poses, R * R_d^T, corresponds to q * q_d^-1.
+  std::array<double, 9> error{};
+  for (size_t c = 0; c < 3; c++) {
+    for (size_t k = 0; k < 3; k++) {
+      const double factor = desired_pose[k * 4 + c];
+      for (size_t r = 0; r < 3; r++) {
+        error[c * 3 + r] += pose[k * 4 + r] * factor;
+      }
+    }
+  }
+  auto at = [&error](size_t row, size_t column) { return error[column * 3 + row]; };
+
+  // Conversion to a quaternion following Shepperd's method, which picks the largest of the four
+  // components to divide by.
+  const double trace = at(0, 0) + at(1, 1) + at(2, 2);
+  double w, x, y, z;
+  if (trace > at(0, 0) && trace > at(1, 1) && trace > at(2, 2)) {
+    double s = 2.0 * std::sqrt(1.0 + trace);
+    w = 0.25 * s;
+    x = (at(2, 1) - at(1, 2)) / s;
+    y = (at(0, 2) - at(2, 0)) / s;
+    z = (at(1, 0) - at(0, 1)) / s;
+  } else if (at(0, 0) > at(1, 1) && at(0, 0) > at(2, 2)) {
+    double s = 2.0 * std::sqrt(1.0 + at(0, 0) - at(1, 1) - at(2, 2));
+    w = (at(2, 1) - at(1, 2)) / s;
+    x = 0.25 * s;
+    y = (at(0, 1) + at(1, 0)) / s;
+    z = (at(0, 2) + at(2, 0)) / s;
+  } else if (at(1, 1) > at(2, 2)) {
+    double s = 2.0 * std::sqrt(1.0 + at(1, 1) - at(0, 0) - at(2, 2));
+    w = (at(0, 2) - at(2, 0)) / s;
+    x = (at(0, 1) + at(1, 0)) / s;
+    y = 0.25 * s;
+    z = (at(1, 2) + at(2, 1)) / s;
+  } else {
+    double s = 2.0 * std::sqrt(1.0 + at(2, 2) - at(0, 0) - at(1, 1));
+    w = (at(1, 0) - at(0, 1)) / s;
+    x = (at(0, 2) + at(2, 0)) / s;
+    y = (at(1, 2) + at(2, 1)) / s;
+    z = 0.25 * s;
+  }
+  if (w < 0.0) {
+    return {{-x, -y, -z}};
+  }
+  return {{x, y, z}};
+}
+
+}  // namespace franka
@@ -15,29 +15,59 @@ inline bool isValidElbow(const std::array<double, 2>& elbow) noexcept {
   return elbow[1] == -1.0 || elbow[1] == 1.0;
 }
 
-inline bool isHomogeneousTransformation(const std::array<double, 16>& transform) noexcept {
-  constexpr double kOrthonormalThreshold = 1e-5;
+constexpr double kOrthonormalThreshold = 1e-5;
+
+// Compares squared norms, which is equivalent to comparing the norms with kOrthonormalThreshold.
+inline bool isUnitSquaredNorm(double squared_norm) noexcept {
+  constexpr double kMinSquaredNorm = (1.0 - kOrthonormalThreshold) * (1.0 - kOrthonormalThreshold);
+  constexpr double kMaxSquaredNorm = (1.0 + kOrthonormalThreshold) * (1.0 + kOrthonormalThreshold);
+  return squared_norm >= kMinSquaredNorm && squared_norm <= kMaxSquaredNorm;
+}
 
+inline bool isHomogeneousTransformation(const std::array<double, 16>& transform) noexcept {
   if (transform[3] != 0.0 || transform[7] != 0.0 || transform[11] != 0.0 || transform[15] != 1.0) {
     return false;
   }
   for (size_t j = 0; j < 3; ++j) {  // i..column
-    if (std::abs(std::sqrt(std::pow(transform[j * 4 + 0], 2) + std::pow(transform[j * 4 + 1], 2) +
-                           std::pow(transform[j * 4 + 2], 2)) -
-                 1.0) > kOrthonormalThreshold) {
+    if (!isUnitSquaredNorm(transform[j * 4 + 0] * transform[j * 4 + 0] +
+                           transform[j * 4 + 1] * transform[j * 4 + 1] +
+                           transform[j * 4 + 2] * transform[j * 4 + 2])) {
       return false;
     }
   }
   for (size_t i = 0; i < 3; ++i) {  // j..row
-    if (std::abs(std::sqrt(std::pow(transform[0 * 4 + i], 2) + std::pow(transform[1 * 4 + i], 2) +
-                           std::pow(transform[2 * 4 + i], 2)) -
-                 1.0) > kOrthonormalThreshold) {
+    if (!isUnitSquaredNorm(transform[0 * 4 + i] * transform[0 * 4 + i] +
+                           transform[1 * 4 + i] * transform[1 * 4 + i] +
+                           transform[2 * 4 + i] * transform[2 * 4 + i])) {
       return false;
     }
   }
   return true;
 }
 
+// Orientation is given as unit quaternion {x, y, z, w}.
+std::array<double, 16> toMatrix(const std::array<double, 3>& position,
+                                const std::array<double, 4>& orientation) {
+  double squared_norm = orientation[0] * orientation[0] + orientation[1] * orientation[1] +
+                        orientation[2] * orientation[2] + orientation[3] * orientation[3];
+  if (!isUnitSquaredNorm(squared_norm)) {
+    throw std::invalid_argument(
+        "libfranka: Attempt to set invalid orientation in motion generator. Has to be a unit "
+        "quaternion!");
+  }
+
+  // Scaling by 2 / |q|^2 removes the remaining deviation from the unit norm.
+  const double s = 2.0 / squared_norm;
+  const double x = orientation[0];
+  const double y = orientation[1];
+  const double z = orientation[2];
+  const double w = orientation[3];
+  return {{1.0 - s * (y * y + z * z), s * (x * y + z * w), s * (x * z - y * w), 0.0,
+           s * (x * y - z * w), 1.0 - s * (x * x + z * z), s * (y * z + x * w), 0.0,
+           s * (x * z + y * w), s * (y * z - x * w), 1.0 - s * (x * x + y * y), 0.0,
+           position[0], position[1], position[2], 1.0}};
+}
+
 template <typename T, size_t N>
 inline void checkFinite(const std::array<T, N>& array) {
   if (!std::all_of(array.begin(), array.end(), [](double d) { return std::isfinite(d); })) {
@@ -154,6 +184,24 @@ CartesianPose::CartesianPose(const std::array<double, 16>& cartesian_pose,
   checkMatrix(O_T_EE);
 }
 
+CartesianPose::CartesianPose(const std::array<double, 3>& position,
+                             const std::array<double, 4>& orientation) {
+  checkFinite(position);
+  checkFinite(orientation);
+  O_T_EE = toMatrix(position, orientation);
+}
+
+CartesianPose::CartesianPose(const std::array<double, 3>& position,
+                             const std::array<double, 4>& orientation,
+                             // NOLINTNEXTLINE(modernize-pass-by-value)
+                             const std::array<double, 2>& elbow)
+    : elbow(elbow) {
+  checkElbow(elbow);
+  checkFinite(position);
+  checkFinite(orientation);
+  O_T_EE = toMatrix(position, orientation);
+}
+
 CartesianPose::CartesianPose(std::initializer_list<double> cartesian_pose) {
   if (cartesian_pose.size() != O_T_EE.size()) {
     throw std::invalid_argument("Invalid number of elements in cartesian_pose.");
@@ -0,0 +1,231 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/robot_daemon.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <franka/exception.h>
+
+#include "daemon_protocol.h"
+
+namespace franka {
+
+namespace {
+
+// The daemon publishes a robot state every millisecond while it is connected to the robot.
+constexpr std::chrono::seconds kStateTimeout(1);
+
+}  // anonymous namespace
+
+class DaemonClient::Impl {
+ public:
+  Impl(const std::string& socket_path, bool model_quantities);
+  ~Impl() noexcept;
+
+  DaemonState readOnce();
+  void configure(const RobotConfiguration& configuration);
+
+  template <typename T>
+  void control(std::function<T(const RobotState&, franka::Duration)> callback,
+               ControllerMode controller_mode,
+               bool limit_rate,
+               double cutoff_frequency);
+
+ private:
+  DaemonResponse request(DaemonRequestType type,
+                         uint32_t size,
+                         const void* payload,
+                         size_t payload_size);
+  // Waits for a robot state that is newer than the previously read one.
+  DaemonState waitForState();
+
+  const int socket_;  // NOLINT(readability-identifier-naming)
+  std::unique_ptr<SharedMemory> shared_memory_;
+  DaemonSegment* segment_;
+  uint64_t last_count_ = 0;
+  std::vector<char> buffer_;
+};
+
+DaemonClient::Impl::Impl(const std::string& socket_path, bool model_quantities)
+    : socket_(connectToDaemonSocket(socket_path)) {
+  try {
+    DaemonConnectRequest parameters{model_quantities ? 1u : 0u};
+    DaemonResponse response =
+        request(DaemonRequestType::kConnect, 0, &parameters, sizeof(parameters));
+    if (response.version != kDaemonProtocolVersion) {
+      throw IncompatibleVersionException(static_cast<uint16_t>(response.version),
+                                         static_cast<uint16_t>(kDaemonProtocolVersion));
+    }
+    shared_memory_.reset(
+        new SharedMemory(SharedMemory::open(response.shared_memory_name.data())));
+    segment_ = shared_memory_->segment();
+  } catch (...) {
+    close(socket_);
+    throw;
+  }
+}
+
+DaemonClient::Impl::~Impl() noexcept {
+  close(socket_);
+}
+
+DaemonState DaemonClient::Impl::readOnce() {
+  return waitForState();
+}
+
+void DaemonClient::Impl::configure(const RobotConfiguration& configuration) {
+  const std::vector<RobotConfiguration::Change>& changes = configuration.changes();
+  size_t size = changes.size() * sizeof(RobotConfiguration::Change);
+  if (size + sizeof(DaemonRequestHeader) > kMaxDaemonMessageSize) {
+    throw std::invalid_argument("libfranka daemon: Too many configuration changes.");
+  }
+  DaemonResponse response = request(DaemonRequestType::kConfigure,
+                                    static_cast<uint32_t>(changes.size()), changes.data(), size);
+  if (response.status != DaemonStatus::kSuccess) {
+    throw CommandException(response.message.data());
+  }
+}
+
+template <typename T>
+void DaemonClient::Impl::control(std::function<T(const RobotState&, franka::Duration)> callback,
+                                 ControllerMode controller_mode,
+                                 bool limit_rate,
+                                 double cutoff_frequency) {
+  DaemonControlRequest parameters{DaemonCommandTraits<T>::mode(), controller_mode,
+                                  limit_rate ? 1u : 0u, cutoff_frequency};
+  DaemonResponse response =
+      request(DaemonRequestType::kControl, 0, &parameters, sizeof(parameters));
+  if (response.status != DaemonStatus::kSuccess) {
+    throw InvalidOperationException(response.message.data());
+  }
+
+  const uint64_t lease = response.lease;
+  RobotCommand command;
+  bool motion_finished = false;
+  auto deadline = std::chrono::steady_clock::now() + kStateTimeout;
+  while (segment_->control.finished_lease.load(std::memory_order_acquire) != lease) {
+    uint64_t state_lease = 0;
+    DaemonState state;
+    if (!readState(*segment_, last_count_, &state, &state_lease)) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        throw NetworkException("libfranka daemon: No robot state received.");
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    last_count_ = state.count;
+    deadline = std::chrono::steady_clock::now() + kStateTimeout;
+    // States read before the motion started or after it finished are skipped.
+    if (state_lease != lease || motion_finished) {
+      continue;
+    }
+    DaemonCommandTraits<T>::get(command) = callback(state.robot_state, state.period);
+    motion_finished = DaemonCommandTraits<T>::get(command).motion_finished;
+    writeCommand(segment_, lease, state.count, command);
+  }
+
+  if (segment_->control.result != DaemonStatus::kSuccess) {
+    throw ControlException(segment_->control.message.data());
+  }
+}
+
+DaemonResponse DaemonClient::Impl::request(DaemonRequestType type,
+                                           uint32_t size,
+                                           const void* payload,
+                                           size_t payload_size) {
+  DaemonRequestHeader header{type, size};
+  if (payload_size == 0) {
+    sendDaemonMessage(socket_, {{&header, sizeof(header)}});
+  } else {
+    sendDaemonMessage(socket_, {{&header, sizeof(header)}, {payload, payload_size}});
+  }
+
+  if (receiveDaemonMessage(socket_, &buffer_) == 0) {
+    throw NetworkException("libfranka daemon: Daemon closed the connection.");
+  }
+  DaemonResponse response{};
+  if (buffer_.size() != sizeof(response)) {
+    throw ProtocolException("libfranka daemon: Invalid response.");
+  }
+  std::memcpy(&response, buffer_.data(), sizeof(response));
+  response.message.back() = '\0';
+  response.shared_memory_name.back() = '\0';
+  return response;
+}
+
+DaemonState DaemonClient::Impl::waitForState() {
+  DaemonState state;
+  auto deadline = std::chrono::steady_clock::now() + kStateTimeout;
+  while (!readState(*segment_, last_count_, &state)) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      throw NetworkException("libfranka daemon: No robot state received.");
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  last_count_ = state.count;
+  return state;
+}
+
+DaemonClient::DaemonClient(const std::string& socket_path, bool model_quantities)
+    : impl_(new Impl(socket_path, model_quantities)) {}
+
+DaemonClient::~DaemonClient() noexcept = default;
+
+DaemonState DaemonClient::readOnce() {
+  return impl_->readOnce();
+}
+
+void DaemonClient::read(std::function<bool(const DaemonState&)> read_callback) {
+  while (read_callback(impl_->readOnce())) {
+  }
+}
+
+void DaemonClient::configure(const RobotConfiguration& configuration) {
+  impl_->configure(configuration);
+}
+
+void DaemonClient::control(
+    std::function<Torques(const RobotState&, franka::Duration)> control_callback,
+    bool limit_rate,
+    double cutoff_frequency) {
+  impl_->control(control_callback, ControllerMode::kJointImpedance, limit_rate, cutoff_frequency);
+}
+
+void DaemonClient::control(
+    std::function<JointPositions(const RobotState&, franka::Duration)> motion_generator_callback,
+    ControllerMode controller_mode,
+    bool limit_rate,
+    double cutoff_frequency) {
+  impl_->control(motion_generator_callback, controller_mode, limit_rate, cutoff_frequency);
+}
+
+void DaemonClient::control(
+    std::function<JointVelocities(const RobotState&, franka::Duration)> motion_generator_callback,
+    ControllerMode controller_mode,
+    bool limit_rate,
+    double cutoff_frequency) {
+  impl_->control(motion_generator_callback, controller_mode, limit_rate, cutoff_frequency);
+}
+
+void DaemonClient::control(
+    std::function<CartesianPose(const RobotState&, franka::Duration)> motion_generator_callback,
+    ControllerMode controller_mode,
+    bool limit_rate,
+    double cutoff_frequency) {
+  impl_->control(motion_generator_callback, controller_mode, limit_rate, cutoff_frequency);
+}
+
+void DaemonClient::control(std::function<CartesianVelocities(const RobotState&, franka::Duration)>
+                               motion_generator_callback,
+                           ControllerMode controller_mode,
+                           bool limit_rate,
+                           double cutoff_frequency) {
+  impl_->control(motion_generator_callback, controller_mode, limit_rate, cutoff_frequency);
+}
+
+}  // namespace franka
@@ -0,0 +1,322 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "daemon_protocol.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#include <franka/exception.h>
+#include <franka/log_file.h>
+
+#include "log_file_format.h"
+
+// `using std::string_literals::operator""s` produces a GCC warning that cannot be disabled, so we
+// have to use `using namespace ...`.
+// See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=65923#c0
+using namespace std::string_literals;  // NOLINT(google-build-using-namespace)
+
+namespace franka {
+
+namespace {
+
+[[noreturn]] void throwError(const std::string& what) {
+  throw NetworkException("libfranka daemon: "s + what + ": " + std::strerror(errno));
+}
+
+sockaddr_un makeAddress(const std::string& path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    throw NetworkException("libfranka daemon: Invalid socket path " + path + ".");
+  }
+  std::copy(path.cbegin(), path.cend(), address.sun_path);
+  return address;
+}
+
+// The writer makes the sequence odd while it changes a slot.
+void beginWrite(std::atomic<uint64_t>& sequence) noexcept {
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void endWrite(std::atomic<uint64_t>& sequence) noexcept {
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Returns false if no consistent copy was made before the deadline, e.g. because the writer died
+// while changing the slot. Makes at least one attempt.
+template <typename TSlot, typename TCopy>
+bool readConsistent(const TSlot& slot,
+                    TCopy copy,
+                    std::chrono::steady_clock::time_point deadline) {
+  while (true) {
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 == 0) {
+      copy(slot);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+        return true;
+      }
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+  }
+}
+
+}  // anonymous namespace
+
+SharedMemory::SharedMemory(std::string name, DaemonSegment* segment, bool owner) noexcept
+    : name_(std::move(name)), segment_(segment), owner_(owner) {}
+
+SharedMemory::SharedMemory(SharedMemory&& other) noexcept
+    : name_(std::move(other.name_)), segment_(other.segment_), owner_(other.owner_) {
+  other.segment_ = nullptr;
+  other.owner_ = false;
+}
+
+SharedMemory::~SharedMemory() noexcept {
+  if (segment_ != nullptr) {
+    munmap(segment_, sizeof(DaemonSegment));
+  }
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+SharedMemory SharedMemory::create(const std::string& name) {
+  if (logRecordSize(kLogFileVersion) > kDaemonRecordCapacity) {
+    throw NetworkException("libfranka daemon: Robot state does not fit into shared memory.");
+  }
+
+  shm_unlink(name.c_str());
+  int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (descriptor == -1) {
+    throwError("Could not create shared memory " + name);
+  }
+  if (ftruncate(descriptor, sizeof(DaemonSegment)) == -1) {
+    close(descriptor);
+    shm_unlink(name.c_str());
+    throwError("Could not resize shared memory " + name);
+  }
+  void* data =
+      mmap(nullptr, sizeof(DaemonSegment), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+  close(descriptor);
+  if (data == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throwError("Could not map shared memory " + name);
+  }
+
+  DaemonSegment* segment = new (data) DaemonSegment();
+  segment->magic = kDaemonSegmentMagic;
+  segment->version = kDaemonProtocolVersion;
+  return SharedMemory(name, segment, true);
+}
+
+SharedMemory SharedMemory::open(const std::string& name) {
+  int descriptor = shm_open(name.c_str(), O_RDWR, 0);
+  if (descriptor == -1) {
+    throwError("Could not open shared memory " + name);
+  }
+  struct stat status {};
+  if (fstat(descriptor, &status) == -1 ||
+      static_cast<size_t>(status.st_size) < sizeof(DaemonSegment)) {
+    close(descriptor);
+    throw NetworkException("libfranka daemon: Invalid shared memory " + name + ".");
+  }
+  void* data =
+      mmap(nullptr, sizeof(DaemonSegment), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+  close(descriptor);
+  if (data == MAP_FAILED) {
+    throwError("Could not map shared memory " + name);
+  }
+
+  SharedMemory shared_memory(name, static_cast<DaemonSegment*>(data), false);
+  if (shared_memory.segment()->magic != kDaemonSegmentMagic ||
+      shared_memory.segment()->version != kDaemonProtocolVersion) {
+    throw NetworkException("libfranka daemon: Invalid shared memory " + name + ".");
+  }
+  return shared_memory;
+}
+
+DaemonSegment* SharedMemory::segment() const noexcept {
+  return segment_;
+}
+
+int listenOnDaemonSocket(const std::string& path) {
+  sockaddr_un address = makeAddress(path);
+  int socket = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (socket == -1) {
+    throwError("Could not create socket");
+  }
+  unlink(path.c_str());
+  if (bind(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+      listen(socket, SOMAXCONN) == -1) {
+    close(socket);
+    throwError("Could not listen on " + path);
+  }
+  return socket;
+}
+
+int connectToDaemonSocket(const std::string& path) {
+  sockaddr_un address = makeAddress(path);
+  int socket = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (socket == -1) {
+    throwError("Could not create socket");
+  }
+  if (connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+    close(socket);
+    throwError("Could not connect to " + path);
+  }
+  return socket;
+}
+
+void sendDaemonMessage(int socket, const std::vector<std::pair<const void*, size_t>>& parts) {
+  std::vector<iovec> buffers;
+  buffers.reserve(parts.size());
+  for (const auto& part : parts) {
+    buffers.push_back(iovec{const_cast<void*>(part.first), part.second});
+  }
+  msghdr message{};
+  message.msg_iov = buffers.data();
+  message.msg_iovlen = buffers.size();
+  if (sendmsg(socket, &message, MSG_NOSIGNAL) == -1) {
+    throwError("Could not send message");
+  }
+}
+
+size_t receiveDaemonMessage(int socket, std::vector<char>* buffer) {
+  buffer->resize(kMaxDaemonMessageSize);
+  ssize_t size;
+  do {
+    size = recv(socket, buffer->data(), buffer->size(), 0);
+  } while (size == -1 && errno == EINTR);
+  if (size == -1) {
+    throwError("Could not receive message");
+  }
+  buffer->resize(static_cast<size_t>(size));
+  return buffer->size();
+}
+
+void sendDaemonResponse(int socket,
+                        DaemonStatus status,
+                        const std::string& message,
+                        uint64_t lease,
+                        const std::string& shared_memory_name) {
+  DaemonResponse response{};
+  response.status = status;
+  response.version = kDaemonProtocolVersion;
+  response.lease = lease;
+  copyString(shared_memory_name, &response.shared_memory_name);
+  copyString(message, &response.message);
+  sendDaemonMessage(socket, {{&response, sizeof(response)}});
+}
+
+void publishState(DaemonSegment* segment,
+                  const RobotState& robot_state,
+                  Duration period,
+                  uint64_t lease,
+                  const ModelQuantities& model,
+                  const std::array<double, 7>& gravity) noexcept {
+  Record record;
+  record.state = robot_state;
+
+  DaemonStateSlot& slot = segment->state;
+  beginWrite(slot.sequence);
+  slot.count++;
+  slot.lease = lease;
+  slot.period = period.toMSec();
+  slot.model = model;
+  slot.gravity = gravity;
+  encodeLogRecord(record, std::chrono::nanoseconds(0), slot.record.data());
+  endWrite(slot.sequence);
+}
+
+bool readState(const DaemonSegment& segment,
+               uint64_t last_count,
+               DaemonState* state,
+               uint64_t* lease) {
+  // Copy the raw record first, decoding it while the daemon may write is not safe.
+  std::array<char, kDaemonRecordCapacity> record_data;
+  bool updated = false;
+  auto copy = [&](const DaemonStateSlot& slot) {
+    updated = slot.count > last_count;
+    if (!updated) {
+      return;
+    }
+    state->count = slot.count;
+    if (lease != nullptr) {
+      *lease = slot.lease;
+    }
+    state->period = Duration(slot.period);
+    state->model = slot.model;
+    state->gravity = slot.gravity;
+    std::memcpy(record_data.data(), slot.record.data(), record_data.size());
+  };
+  if (!readConsistent(segment.state, copy,
+                      std::chrono::steady_clock::now() + kSequenceLockTimeout)) {
+    throw NetworkException("libfranka daemon: Connection lost.");
+  }
+  if (!updated) {
+    return false;
+  }
+
+  Record record;
+  std::chrono::nanoseconds host_time;
+  decodeLogRecord(record_data.data(), kLogFileVersion, &record, &host_time);
+  state->robot_state = record.state;
+  return true;
+}
+
+void writeCommand(DaemonSegment* segment,
+                  uint64_t lease,
+                  uint64_t state_count,
+                  const RobotCommand& command) noexcept {
+  DaemonCommandSlot& slot = segment->command;
+  beginWrite(slot.sequence);
+  slot.lease = lease;
+  slot.state_count = state_count;
+  slot.command = command;
+  endWrite(slot.sequence);
+}
+
+bool readCommand(const DaemonSegment& segment,
+                 uint64_t lease,
+                 uint64_t state_count,
+                 RobotCommand* command) noexcept {
+  bool found = false;
+  // A single attempt, the caller retries until its own deadline.
+  bool consistent = readConsistent(
+      segment.command,
+      [&](const DaemonCommandSlot& slot) {
+        found = slot.lease == lease && slot.state_count == state_count;
+        if (found) {
+          *command = slot.command;
+        }
+      },
+      std::chrono::steady_clock::time_point::min());
+  return consistent && found;
+}
+
+void finishControl(DaemonSegment* segment,
+                   uint64_t lease,
+                   DaemonStatus result,
+                   const std::string& message) noexcept {
+  DaemonControlSlot& slot = segment->control;
+  slot.result = result;
+  copyString(message, &slot.message);
+  slot.finished_lease.store(lease, std::memory_order_release);
+  uint64_t active_lease = lease;
+  slot.lease.compare_exchange_strong(active_lease, 0);
+}
+
+}  // namespace franka
@@ -0,0 +1,233 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <franka/control_types.h>
+#include <franka/duration.h>
+#include <franka/log.h>
+#include <franka/model.h>
+#include <franka/robot_daemon.h>
+#include <franka/robot_state.h>
+
+// Protocol between RobotDaemon and DaemonClient.
+//
+// Clients send requests over a Unix socket of type SOCK_SEQPACKET, so that each message arrives
+// as a whole. Each request starts with a DaemonRequestHeader and is answered with a
+// DaemonResponse. Robot states and commands are exchanged through a shared memory segment. Both
+// slots of the segment are protected by sequence locks: the writer makes the sequence odd while
+// writing, and readers retry until they copied the slot with the same even sequence before and
+// after, or until kSequenceLockTimeout passed.
+namespace franka {
+
+constexpr uint32_t kDaemonProtocolVersion = 1;
+constexpr std::array<char, 8> kDaemonSegmentMagic{{'F', 'R', 'A', 'N', 'K', 'S', 'H', 'M'}};
+
+// Well below the default socket buffer size.
+constexpr size_t kMaxDaemonMessageSize = 64 * 1024;
+
+// How long readers retry a slot whose sequence stays odd or changes. The writer holds a slot for a
+// few microseconds, so a longer odd sequence means that it died while writing.
+constexpr std::chrono::milliseconds kSequenceLockTimeout(100);
+
+// Robot states are stored in the log file record format.
+constexpr size_t kDaemonRecordCapacity = 4096;
+
+enum class DaemonRequestType : uint32_t { kConnect, kConfigure, kControl };
+
+enum class DaemonStatus : uint32_t { kSuccess, kRejected, kFailed };
+
+enum class DaemonControlMode : uint32_t {
+  kTorques,
+  kJointPositions,
+  kJointVelocities,
+  kCartesianPose,
+  kCartesianVelocities
+};
+
+struct DaemonRequestHeader {
+  DaemonRequestType type;
+  // Number of configuration requests that follow a kConfigure header.
+  uint32_t size;
+};
+
+// Follows a kConnect header.
+struct DaemonConnectRequest {
+  // Non-zero if the daemon should calculate model quantities while the client is connected.
+  uint32_t model_quantities;
+};
+
+// Follows a kControl header.
+struct DaemonControlRequest {
+  DaemonControlMode mode;
+  ControllerMode controller_mode;
+  uint32_t limit_rate;
+  double cutoff_frequency;
+};
+
+struct DaemonResponse {
+  DaemonStatus status;
+  uint32_t version;
+  uint64_t lease;
+  std::array<char, 64> shared_memory_name;
+  std::array<char, 256> message;
+};
+
+struct DaemonStateSlot {
+  std::atomic<uint64_t> sequence{0};
+  uint64_t count;
+  // Lease of the control loop that received the state, 0 if no control loop is running.
+  uint64_t lease;
+  uint64_t period;
+  ModelQuantities model;
+  std::array<double, 7> gravity;
+  std::array<char, kDaemonRecordCapacity> record;
+};
+
+struct DaemonCommandSlot {
+  std::atomic<uint64_t> sequence{0};
+  uint64_t lease;
+  // Count of the robot state the command was calculated for.
+  uint64_t state_count;
+  RobotCommand command;
+};
+
+struct DaemonControlSlot {
+  // Lease of the client whose commands are executed, 0 if there is none.
+  std::atomic<uint64_t> lease{0};
+  // Set after result and message of the lease were written.
+  std::atomic<uint64_t> finished_lease{0};
+  DaemonStatus result;
+  std::array<char, 256> message;
+};
+
+struct DaemonSegment {
+  std::array<char, 8> magic;
+  uint32_t version;
+  DaemonStateSlot state;
+  DaemonCommandSlot command;
+  DaemonControlSlot control;
+};
+
+template <typename T>
+struct DaemonCommandTraits;
+
+template <>
+struct DaemonCommandTraits<Torques> {
+  static DaemonControlMode mode() noexcept { return DaemonControlMode::kTorques; }
+  static Torques& get(RobotCommand& command) noexcept { return command.torques; }
+};
+
+template <>
+struct DaemonCommandTraits<JointPositions> {
+  static DaemonControlMode mode() noexcept { return DaemonControlMode::kJointPositions; }
+  static JointPositions& get(RobotCommand& command) noexcept { return command.joint_positions; }
+};
+
+template <>
+struct DaemonCommandTraits<JointVelocities> {
+  static DaemonControlMode mode() noexcept { return DaemonControlMode::kJointVelocities; }
+  static JointVelocities& get(RobotCommand& command) noexcept { return command.joint_velocities; }
+};
+
+template <>
+struct DaemonCommandTraits<CartesianPose> {
+  static DaemonControlMode mode() noexcept { return DaemonControlMode::kCartesianPose; }
+  static CartesianPose& get(RobotCommand& command) noexcept { return command.cartesian_pose; }
+};
+
+template <>
+struct DaemonCommandTraits<CartesianVelocities> {
+  static DaemonControlMode mode() noexcept { return DaemonControlMode::kCartesianVelocities; }
+  static CartesianVelocities& get(RobotCommand& command) noexcept {
+    return command.cartesian_velocities;
+  }
+};
+
+// Maps a POSIX shared memory object. Throws NetworkException on errors.
+class SharedMemory {
+ public:
+  // Creates the object, replacing a stale one with the same name, and constructs the segment.
+  static SharedMemory create(const std::string& name);
+  // Opens an object created by another process and checks the segment.
+  static SharedMemory open(const std::string& name);
+
+  SharedMemory(SharedMemory&& other) noexcept;
+  SharedMemory& operator=(SharedMemory&& other) = delete;
+  SharedMemory(const SharedMemory&) = delete;
+  SharedMemory& operator=(const SharedMemory&) = delete;
+  ~SharedMemory() noexcept;
+
+  DaemonSegment* segment() const noexcept;
+
+ private:
+  SharedMemory(std::string name, DaemonSegment* segment, bool owner) noexcept;
+
+  std::string name_;
+  DaemonSegment* segment_;
+  bool owner_;
+};
+
+// Creates a listening socket at the given path, replacing a stale one. Throws NetworkException.
+int listenOnDaemonSocket(const std::string& path);
+// Connects to a daemon socket. Throws NetworkException.
+int connectToDaemonSocket(const std::string& path);
+
+// Sends one message consisting of the given parts. Throws NetworkException.
+void sendDaemonMessage(int socket, const std::vector<std::pair<const void*, size_t>>& parts);
+// Receives one message. Returns its size, or 0 if the peer closed the connection. Throws
+// NetworkException.
+size_t receiveDaemonMessage(int socket, std::vector<char>* buffer);
+
+void sendDaemonResponse(int socket,
+                        DaemonStatus status,
+                        const std::string& message,
+                        uint64_t lease = 0,
+                        const std::string& shared_memory_name = "");
+
+void publishState(DaemonSegment* segment,
+                  const RobotState& robot_state,
+                  Duration period,
+                  uint64_t lease,
+                  const ModelQuantities& model,
+                  const std::array<double, 7>& gravity) noexcept;
+// Copies the state if it is newer than last_count. Throws NetworkException if the slot stays
+// locked for kSequenceLockTimeout.
+bool readState(const DaemonSegment& segment,
+               uint64_t last_count,
+               DaemonState* state,
+               uint64_t* lease = nullptr);
+
+void writeCommand(DaemonSegment* segment,
+                  uint64_t lease,
+                  uint64_t state_count,
+                  const RobotCommand& command) noexcept;
+// Copies the command if it was written by the given lease for the given state. Returns false
+// without waiting if the slot is being written.
+bool readCommand(const DaemonSegment& segment,
+                 uint64_t lease,
+                 uint64_t state_count,
+                 RobotCommand* command) noexcept;
+
+void finishControl(DaemonSegment* segment,
+                   uint64_t lease,
+                   DaemonStatus result,
+                   const std::string& message) noexcept;
+
+// Copies a string into a fixed-size, zero-terminated buffer, truncating it if necessary.
+template <size_t N>
+void copyString(const std::string& source, std::array<char, N>* target) noexcept {
+  size_t size = std::min(source.size(), N - 1);
+  std::copy(source.cbegin(), source.cbegin() + size, target->begin());
+  (*target)[size] = '\0';
+}
+
+}  // namespace franka
@@ -0,0 +1,71 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/energy_accounting.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace franka {
+
+namespace {
+
+// The per-joint loops are kept free of branches so that they can be vectorized.
+void accumulate(const std::array<double, 7>& power,
+                double total_power,
+                double time_step,
+                EnergyCounters* counters) noexcept {
+  for (size_t i = 0; i < power.size(); i++) {
+    counters->energy[i] += power[i] * time_step;
+    counters->positive_energy[i] += std::max(power[i], 0.0) * time_step;
+    counters->peak_power[i] = std::max(counters->peak_power[i], std::abs(power[i]));
+  }
+  counters->peak_total_power = std::max(counters->peak_total_power, std::abs(total_power));
+  counters->samples++;
+}
+
+}  // anonymous namespace
+
+void EnergyAccumulator::update(const RobotState& robot_state, bool in_motion) noexcept {
+  std::array<double, 7>& power = snapshot_.joint_power;
+  for (size_t i = 0; i < power.size(); i++) {
+    power[i] = robot_state.tau_J[i] * robot_state.dq[i];
+  }
+  double total_power = 0.0;
+  for (double joint_power : power) {
+    total_power += joint_power;
+  }
+
+  Duration time_step;
+  if (has_last_time_ && robot_state.time > last_time_) {
+    time_step = robot_state.time - last_time_;
+  }
+  last_time_ = robot_state.time;
+  has_last_time_ = true;
+
+  accumulate(power, total_power, time_step.toSec(), &snapshot_.lifetime);
+  snapshot_.lifetime.duration += time_step;
+  if (in_motion) {
+    // The first state of a motion only starts the integration.
+    if (snapshot_.motion.samples == 0) {
+      time_step = Duration();
+    }
+    accumulate(power, total_power, time_step.toSec(), &snapshot_.motion);
+    snapshot_.motion.duration += time_step;
+  }
+}
+
+void EnergyAccumulator::startMotion() noexcept {
+  snapshot_.motion = EnergyCounters();
+}
+
+EnergySnapshot EnergyAccumulator::snapshot() const noexcept {
+  return snapshot_;
+}
+
+void EnergyAccumulator::reset() noexcept {
+  snapshot_ = EnergySnapshot();
+  last_time_ = Duration();
+  has_last_time_ = false;
+}
+
+}  // namespace franka
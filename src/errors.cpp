@@ -96,6 +96,10 @@ Errors::operator bool() const noexcept {
   return std::any_of(errors_.cbegin(), errors_.cend(), [](bool x) { return x; });
 }
 
+Errors::operator std::array<bool, 37>() const noexcept {
+  return errors_;
+}
+
 Errors::operator std::string() const {
   std::string error_string = "[";
 
@@ -0,0 +1,217 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <franka/duration.h>
+#include <franka/errors.h>
+#include <franka/field_descriptors.h>
+#include <franka/robot_state.h>
+
+// Serializers and converters generated from the FieldTable specializations.
+namespace franka {
+
+// Defined in robot_state.cpp.
+void writeJsonValue(std::ostream& ostream, RobotMode robot_mode);
+
+inline void writeJsonValue(std::ostream& ostream, const Errors& errors) {
+  ostream << errors;
+}
+
+inline void writeJsonValue(std::ostream& ostream, const Duration& duration) {
+  ostream << duration.toMSec();
+}
+
+template <typename T>
+std::enable_if_t<std::is_arithmetic<T>::value> writeJsonValue(std::ostream& ostream, T value) {
+  ostream << value;
+}
+
+template <typename T, size_t N>
+void writeJsonValue(std::ostream& ostream, const std::array<T, N>& array) {
+  ostream << "[";
+  for (size_t i = 0; i < N; i++) {
+    ostream << (i == 0 ? "" : ",") << array[i];
+  }
+  ostream << "]";
+}
+
+// Writes {"field_name_1": value_1, "field_name_2": value_2, ...}.
+template <typename T>
+std::enable_if_t<HasFieldTable<T>::value> writeJsonValue(std::ostream& ostream, const T& object) {
+  const char* separator = "{";
+  forEachField<T>([&](const auto& field) {
+    ostream << separator << "\"" << field.name << "\": ";
+    writeJsonValue(ostream, field.get(object));
+    separator = ", ";
+  });
+  ostream << "}";
+}
+
+// Writes comma-separated columns, with one column per array element.
+class CsvWriter {
+ public:
+  explicit CsvWriter(std::ostream& ostream) : ostream_(ostream) {}
+
+  template <typename T>
+  void writeHeader(const FieldMask<T>& mask = FieldMask<T>().set()) {
+    size_t index = 0;
+    forEachField<T>([&](const auto& field) {
+      if (mask[index++]) {
+        this->writeNames(field.name, fieldType(field));
+      }
+    });
+  }
+
+  template <typename T>
+  void writeLine(const T& object, const FieldMask<T>& mask = FieldMask<T>().set()) {
+    size_t index = 0;
+    forEachField<T>([&](const auto& field) {
+      if (mask[index++]) {
+        this->writeValue(field.get(object));
+      }
+    });
+  }
+
+ private:
+  void separate() {
+    if (!first_) {
+      ostream_ << ",";
+    }
+    first_ = false;
+  }
+
+  template <typename Class, typename T>
+  static const T* fieldType(const FieldDescriptor<Class, T>& /* field */) {
+    return nullptr;
+  }
+
+  template <typename T>
+  std::enable_if_t<!HasFieldTable<T>::value> writeNames(const std::string& name,
+                                                        const T* /* type */) {
+    separate();
+    ostream_ << name;
+  }
+
+  template <typename T, size_t N>
+  void writeNames(const std::string& name, const std::array<T, N>* /* type */) {
+    for (size_t i = 0; i < N; i++) {
+      separate();
+      ostream_ << name << "[" << i << "]";
+    }
+  }
+
+  void writeNames(const std::string& name, const Errors* /* type */) {
+    writeNames(name, static_cast<const std::array<bool, 37>*>(nullptr));
+  }
+
+  template <typename T>
+  std::enable_if_t<HasFieldTable<T>::value> writeNames(const std::string& name,
+                                                       const T* /* type */) {
+    forEachField<T>([&](const auto& field) {
+      this->writeNames(name + "." + field.name, fieldType(field));
+    });
+  }
+
+  template <typename T>
+  std::enable_if_t<std::is_arithmetic<T>::value> writeValue(T value) {
+    separate();
+    ostream_ << value;
+  }
+
+  template <typename T>
+  std::enable_if_t<std::is_enum<T>::value> writeValue(T value) {
+    writeValue(static_cast<std::underlying_type_t<T>>(value));
+  }
+
+  template <typename T, size_t N>
+  void writeValue(const std::array<T, N>& array) {
+    for (const T& element : array) {
+      writeValue(element);
+    }
+  }
+
+  void writeValue(const Errors& errors) { writeValue(static_cast<std::array<bool, 37>>(errors)); }
+
+  void writeValue(const Duration& duration) { writeValue(duration.toMSec()); }
+
+  template <typename T>
+  std::enable_if_t<HasFieldTable<T>::value> writeValue(const T& object) {
+    forEachField<T>([&](const auto& field) { this->writeValue(field.get(object)); });
+  }
+
+  std::ostream& ostream_;
+  bool first_ = true;
+};
+
+// Lists the fields that have the same name in From and To, but are converted explicitly by the
+// caller of copyMatchingFields instead of being copied. Specializations provide a
+// `static constexpr auto names() noexcept` function returning a std::array of field names.
+template <typename From, typename To>
+struct ConvertedFields {
+  static constexpr std::array<const char*, 0> names() noexcept { return {}; }
+};
+
+template <typename From, typename To>
+constexpr bool isConvertedField(const char* name) noexcept {
+  constexpr auto names = ConvertedFields<From, To>::names();
+  for (size_t i = 0; i < names.size(); i++) {
+    if (detail::equalNames(names[i], name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+void assignField(T& target, const T& source) {
+  target = source;
+}
+
+template <typename T, typename U>
+void assignField(T& /* target */, const U& /* source */) {
+  static_assert(std::is_same<T, U>::value,
+                "Fields with the same name but a different type must be listed in "
+                "ConvertedFields.");
+}
+
+template <size_t I, size_t J, typename From, typename To>
+void copyField(const From& from, To* to, std::true_type /* copied */) {
+  constexpr auto target = std::get<I>(FieldTable<To>::fields());
+  constexpr auto source = std::get<J>(FieldTable<From>::fields());
+  assignField(target.get(*to), source.get(from));
+}
+
+template <size_t I, size_t J, typename From, typename To>
+void copyField(const From& /* from */, To* /* to */, std::false_type /* copied */) {}
+
+template <size_t I, typename From, typename To>
+void copyField(const From& from, To* to) {
+  constexpr const char* kName = std::get<I>(FieldTable<To>::fields()).name;
+  constexpr size_t kSource = fieldIndex<From>(kName);
+  constexpr bool kCopied = kSource < fieldCount<From>() && !isConvertedField<From, To>(kName);
+  copyField<I, kSource>(from, to, std::integral_constant<bool, kCopied>());
+}
+
+template <typename From, typename To, size_t... I>
+void copyMatchingFields(const From& from, To* to, std::index_sequence<I...> /* indices */) {
+  static_cast<void>(std::initializer_list<int>{(copyField<I>(from, to), 0)...});
+}
+
+// Copies all fields of `from` to the fields of `to` with the same name, except for the
+// ConvertedFields. The fields are matched at compile time, and fields with the same name must have
+// the same type.
+template <typename From, typename To>
+void copyMatchingFields(const From& from, To* to) {
+  copyMatchingFields(from, to, std::make_index_sequence<fieldCount<To>()>());
+}
+
+}  // namespace franka
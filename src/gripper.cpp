@@ -2,12 +2,23 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <franka/gripper.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <franka/exception.h>
 #include <research_interface/gripper/types.h>
 
+#include "fields.h"
+#include "mailbox.h"
 #include "network.h"
+#include "research_interface_fields.h"
 
 namespace franka {
 
@@ -33,16 +44,260 @@ bool executeCommand(Network& network, TArgs&&... args) {
 GripperState convertGripperState(
     const research_interface::gripper::GripperState& gripper_state) noexcept {
   GripperState converted;
-  converted.width = gripper_state.width;
-  converted.max_width = gripper_state.max_width;
-  converted.is_grasped = gripper_state.is_grasped;
-  converted.temperature = gripper_state.temperature;
+  copyMatchingFields(gripper_state, &converted);
   converted.time = Duration(gripper_state.message_id);
   return converted;
 }
 
+constexpr std::chrono::milliseconds kStreamingPollInterval(1);
+constexpr std::chrono::milliseconds kStreamingStateTimeout(1000);
+constexpr double kStreamingWidthTolerance = 1e-4;  // [m]
+constexpr double kStreamingSpeedTolerance = 1e-3;  // [m/s]
+constexpr double kStreamingForceTolerance = 1e-2;  // [N]
+
+bool isSameSetpoint(const GripperSetpoint& a, const GripperSetpoint& b) noexcept {
+  return std::abs(a.width - b.width) < kStreamingWidthTolerance &&
+         std::abs(a.speed - b.speed) < kStreamingSpeedTolerance &&
+         std::abs(a.force - b.force) < kStreamingForceTolerance &&
+         std::abs(a.epsilon_inner - b.epsilon_inner) < kStreamingWidthTolerance &&
+         std::abs(a.epsilon_outer - b.epsilon_outer) < kStreamingWidthTolerance;
+}
+
 }  // anonymous namespace
 
+// Executes streamed setpoints in a background thread. Setpoints and gripper states are exchanged
+// through lock-free mailboxes, so that only the latest ones are processed.
+class GripperStreamer {
+ public:
+  explicit GripperStreamer(Network& network);
+  ~GripperStreamer() noexcept;
+
+  void setSetpoint(const GripperSetpoint& setpoint) noexcept;
+  GripperState state();
+  void stop();
+
+  GripperStreamer(const GripperStreamer&) = delete;
+  GripperStreamer& operator=(const GripperStreamer&) = delete;
+
+ private:
+  enum class CommandType { kMove, kGrasp, kStop };
+
+  struct Command {
+    CommandType type;
+    uint32_t id;
+    bool preempted;
+  };
+
+  void run() noexcept;
+  void step();
+  void receiveStates();
+  void pollResponses();
+  void stopMotion();
+  void drainResponses();
+
+  template <typename T>
+  bool pollResponse(const Command& command);
+
+  Network& network_;
+  Mailbox<GripperSetpoint> setpoints_;
+  Mailbox<GripperState> states_;
+
+  std::atomic_bool running_{true};
+  std::atomic_bool failed_{false};
+  std::exception_ptr error_;
+  std::thread thread_;
+
+  std::mutex state_mutex_;
+  GripperState state_;
+
+  // Only accessed by the background thread.
+  std::vector<Command> commands_;
+  GripperSetpoint target_;
+  GripperSetpoint commanded_;
+  bool has_target_{false};
+  bool has_commanded_{false};
+  std::chrono::steady_clock::time_point last_state_time_;
+};
+
+GripperStreamer::GripperStreamer(Network& network) : network_(network) {
+  state_ = convertGripperState(
+      network_.udpBlockingReceive<research_interface::gripper::GripperState>());
+  last_state_time_ = std::chrono::steady_clock::now();
+
+  commands_.reserve(3);
+  thread_ = std::thread(&GripperStreamer::run, this);
+}
+
+GripperStreamer::~GripperStreamer() noexcept {
+  running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void GripperStreamer::setSetpoint(const GripperSetpoint& setpoint) noexcept {
+  setpoints_.write(setpoint);
+}
+
+GripperState GripperStreamer::state() {
+  if (failed_) {
+    std::rethrow_exception(error_);
+  }
+  std::lock_guard<std::mutex> _(state_mutex_);
+  states_.read(&state_);
+  return state_;
+}
+
+void GripperStreamer::stop() {
+  running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  if (failed_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void GripperStreamer::run() noexcept {
+  try {
+    while (running_) {
+      step();
+      std::this_thread::sleep_for(kStreamingPollInterval);
+    }
+    stopMotion();
+    drainResponses();
+  } catch (...) {
+    error_ = std::current_exception();
+    failed_ = true;
+  }
+}
+
+void GripperStreamer::step() {
+  receiveStates();
+  pollResponses();
+
+  GripperSetpoint setpoint;
+  if (setpoints_.read(&setpoint)) {
+    target_ = setpoint;
+    has_target_ = true;
+  }
+  if (!has_target_ || (has_commanded_ && isSameSetpoint(target_, commanded_))) {
+    return;
+  }
+
+  // A new setpoint can only be commanded after the running move or grasp has been stopped.
+  // Setpoints arriving in the meantime replace the target, so only the latest one is commanded.
+  auto motion = std::find_if(commands_.begin(), commands_.end(), [](const Command& command) {
+    return command.type != CommandType::kStop && !command.preempted;
+  });
+  if (motion != commands_.end()) {
+    motion->preempted = true;
+    commands_.push_back(
+        {CommandType::kStop, network_.tcpSendRequest<research_interface::gripper::Stop>(), false});
+    return;
+  }
+  if (std::any_of(commands_.begin(), commands_.end(),
+                  [](const Command& command) { return command.type == CommandType::kStop; })) {
+    return;
+  }
+
+  if (target_.force > 0.0) {
+    research_interface::gripper::Grasp::GraspEpsilon epsilon(target_.epsilon_inner,
+                                                             target_.epsilon_outer);
+    commands_.push_back({CommandType::kGrasp,
+                         network_.tcpSendRequest<research_interface::gripper::Grasp>(
+                             target_.width, epsilon, target_.speed, target_.force),
+                         false});
+  } else {
+    commands_.push_back({CommandType::kMove,
+                         network_.tcpSendRequest<research_interface::gripper::Move>(
+                             target_.width, target_.speed),
+                         false});
+  }
+  commanded_ = target_;
+  has_commanded_ = true;
+}
+
+void GripperStreamer::receiveStates() {
+  research_interface::gripper::GripperState gripper_state;
+  bool received = false;
+  while (network_.udpReceive<decltype(gripper_state)>(&gripper_state)) {
+    received = true;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  if (received) {
+    states_.write(convertGripperState(gripper_state));
+    last_state_time_ = now;
+  } else if (now - last_state_time_ > kStreamingStateTimeout) {
+    throw NetworkException("libfranka gripper: Timeout while waiting for gripper state.");
+  }
+}
+
+void GripperStreamer::pollResponses() {
+  auto received = [this](const Command& command) {
+    switch (command.type) {
+      case CommandType::kMove:
+        return pollResponse<research_interface::gripper::Move>(command);
+      case CommandType::kGrasp:
+        return pollResponse<research_interface::gripper::Grasp>(command);
+      case CommandType::kStop:
+        return pollResponse<research_interface::gripper::Stop>(command);
+    }
+    return false;
+  };
+  commands_.erase(std::remove_if(commands_.begin(), commands_.end(), received), commands_.end());
+}
+
+template <typename T>
+bool GripperStreamer::pollResponse(const Command& command) {
+  return network_.tcpReceiveResponse<T>(
+      command.id, [&command](const typename T::Response& response) {
+        // Responses of preempted commands report the stop, not an error.
+        if (command.preempted) {
+          return;
+        }
+        switch (response.status) {
+          case T::Status::kSuccess:
+          case T::Status::kUnsuccessful:
+            break;
+          case T::Status::kFail:
+            throw CommandException("libfranka gripper: Command failed!");
+          default:
+            throw ProtocolException(
+                "libfranka gripper: Unexpected response while handling command!");
+        }
+      });
+}
+
+void GripperStreamer::stopMotion() {
+  if (std::none_of(commands_.begin(), commands_.end(), [](const Command& command) {
+        return command.type != CommandType::kStop && !command.preempted;
+      })) {
+    return;
+  }
+  executeCommand<research_interface::gripper::Stop>(network_);
+}
+
+void GripperStreamer::drainResponses() {
+  // After the motion has been stopped, every outstanding command is answered. Wait for these
+  // responses, so that none of them is left behind in the network buffers once streaming ends.
+  for (const Command& command : commands_) {
+    switch (command.type) {
+      case CommandType::kMove:
+        network_.tcpBlockingReceiveResponse<research_interface::gripper::Move>(command.id);
+        break;
+      case CommandType::kGrasp:
+        network_.tcpBlockingReceiveResponse<research_interface::gripper::Grasp>(command.id);
+        break;
+      case CommandType::kStop:
+        network_.tcpBlockingReceiveResponse<research_interface::gripper::Stop>(command.id);
+        break;
+    }
+  }
+  commands_.clear();
+}
+
 Gripper::Gripper(const std::string& franka_address)
     : network_{
           std::make_unique<Network>(franka_address, research_interface::gripper::kCommandPort)} {
@@ -59,6 +314,7 @@ Gripper::ServerVersion Gripper::serverVersion() const noexcept {
 }
 
 bool Gripper::homing() const {
+  throwIfStreaming();
   return executeCommand<research_interface::gripper::Homing>(*network_);
 }
 
@@ -67,20 +323,27 @@ bool Gripper::grasp(double width,
                     double force,
                     double epsilon_inner,
                     double epsilon_outer) const {
+  throwIfStreaming();
   research_interface::gripper::Grasp::GraspEpsilon epsilon(epsilon_inner, epsilon_outer);
   return executeCommand<research_interface::gripper::Grasp>(*network_, width, epsilon, speed,
                                                             force);
 }
 
 bool Gripper::move(double width, double speed) const {
+  throwIfStreaming();
   return executeCommand<research_interface::gripper::Move>(*network_, width, speed);
 }
 
 bool Gripper::stop() const {
+  throwIfStreaming();
   return executeCommand<research_interface::gripper::Stop>(*network_);
 }
 
 GripperState Gripper::readOnce() const {
+  if (streamer_) {
+    return streamer_->state();
+  }
+
   research_interface::gripper::GripperState gripper_state;
   // Delete old data from the UDP buffer.
   while (network_->udpReceive<decltype(gripper_state)>(&gripper_state)) {
@@ -90,4 +353,32 @@ GripperState Gripper::readOnce() const {
   return convertGripperState(gripper_state);
 }
 
+void Gripper::startStreaming() {
+  if (streamer_) {
+    throw InvalidOperationException("libfranka gripper: Streaming has already been started.");
+  }
+  streamer_ = std::make_unique<GripperStreamer>(*network_);
+}
+
+void Gripper::setStreamingSetpoint(const GripperSetpoint& setpoint) const {
+  if (!streamer_) {
+    throw InvalidOperationException("libfranka gripper: Streaming has not been started.");
+  }
+  streamer_->setSetpoint(setpoint);
+}
+
+void Gripper::stopStreaming() {
+  if (streamer_) {
+    std::unique_ptr<GripperStreamer> streamer = std::move(streamer_);
+    streamer->stop();
+  }
+}
+
+void Gripper::throwIfStreaming() const {
+  if (streamer_) {
+    throw InvalidOperationException(
+        "libfranka gripper: Commands cannot be executed while streaming.");
+  }
+}
+
 }  // namespace franka
@@ -0,0 +1,108 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/hybrid_force_motion_controller.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <Eigen/Dense>
+
+#include <franka/control_math.h>
+
+namespace franka {
+
+namespace {
+
+void checkParameters(const HybridForceMotionParameters& parameters) {
+  for (size_t i = 0; i < 6; i++) {
+    if (!(parameters.stiffness[i] >= 0.0) || !(parameters.damping[i] >= 0.0)) {
+      throw std::invalid_argument(
+          "libfranka: Hybrid force/motion stiffness and damping must not be negative.");
+    }
+    if (!(parameters.force_proportional_gain[i] >= 0.0) ||
+        !(parameters.force_integral_gain[i] >= 0.0) ||
+        !(parameters.maximum_integral_wrench[i] >= 0.0)) {
+      throw std::invalid_argument(
+          "libfranka: Hybrid force/motion force controller gains must not be negative.");
+    }
+  }
+}
+
+}  // anonymous namespace
+
+HybridForceMotionController::HybridForceMotionController(
+    const HybridForceMotionParameters& parameters)
+    : parameters_(parameters), desired_wrench_{} {
+  checkParameters(parameters);
+  reset();
+}
+
+Torques HybridForceMotionController::operator()(const RobotState& robot_state,
+                                                Duration period,
+                                                const ModelQuantities& quantities) noexcept {
+  if (!has_desired_pose_) {
+    setDesiredPose(robot_state.O_T_EE);
+  }
+
+  Eigen::Map<const Eigen::Matrix<double, 6, 7>> jacobian(quantities.zero_jacobian.data());
+  Eigen::Map<const Eigen::Matrix<double, 7, 1>> dq(robot_state.dq.data());
+
+  // Pose error, with the orientation error from the quaternion difference as in the Cartesian
+  // impedance example.
+  std::array<double, 6> error;
+  for (size_t i = 0; i < 3; i++) {
+    error[i] = robot_state.O_T_EE[12 + i] - desired_pose_[12 + i];
+  }
+  std::array<double, 3> orientation_error = orientationError(robot_state.O_T_EE, desired_pose_);
+  std::copy(orientation_error.cbegin(), orientation_error.cend(), error.begin() + 3);
+
+  Eigen::Matrix<double, 6, 1> twist = jacobian * dq;
+
+  const double dt = period.toSec();
+  Eigen::Matrix<double, 6, 1> wrench;
+  for (size_t i = 0; i < 6; i++) {
+    if (parameters_.force_controlled[i]) {
+      double wrench_error = desired_wrench_[i] - robot_state.O_F_ext_hat_K[i];
+      integral_wrench_[i] = std::max(
+          std::min(integral_wrench_[i] + parameters_.force_integral_gain[i] * dt * wrench_error,
+                   parameters_.maximum_integral_wrench[i]),
+          -parameters_.maximum_integral_wrench[i]);
+      wrench[i] = desired_wrench_[i] + parameters_.force_proportional_gain[i] * wrench_error +
+                  integral_wrench_[i];
+    } else {
+      wrench[i] = -parameters_.stiffness[i] * error[i];
+    }
+    wrench[i] -= parameters_.damping[i] * twist[i];
+  }
+
+  std::array<double, 7> tau_d{};
+  Eigen::Map<Eigen::Matrix<double, 7, 1>> tau(tau_d.data());
+  tau = jacobian.transpose() * wrench;
+  if (parameters_.coriolis_compensation) {
+    tau += Eigen::Map<const Eigen::Matrix<double, 7, 1>>(quantities.coriolis.data());
+  }
+  return tau_d;
+}
+
+void HybridForceMotionController::setDesiredPose(
+    const std::array<double, 16>& O_T_EE_d) noexcept {  // NOLINT(readability-identifier-naming)
+  desired_pose_ = O_T_EE_d;
+  has_desired_pose_ = true;
+}
+
+void HybridForceMotionController::setDesiredWrench(
+    const std::array<double, 6>& O_F_d) noexcept {  // NOLINT(readability-identifier-naming)
+  desired_wrench_ = O_F_d;
+}
+
+const HybridForceMotionParameters& HybridForceMotionController::parameters() const noexcept {
+  return parameters_;
+}
+
+void HybridForceMotionController::reset() noexcept {
+  has_desired_pose_ = false;
+  desired_pose_ = {};
+  integral_wrench_ = {};
+}
+
+}  // namespace franka
@@ -0,0 +1,339 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/inverse_kinematics.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <franka/control_math.h>
+#include <franka/robot_traits.h>
+
+// The solver follows the geometric construction of Y. He and S. Liu, "Analytical Inverse
+// Kinematics for Franka Emika Panda - a Geometrical Solver for 7-DOF Manipulators with
+// Unconventional Design", 2021, extended by the second elbow branch:
+//  - For a given q7, the flange pose fixes joint 6 and the axis of joint 6.
+//  - The distance from joint 2 to joint 6 determines the two branches of q4. For each of them,
+//    the arm between joint 2 and joint 6 is a rigid planar shape, given in frame 3 below.
+//  - The axis of joint 5 lies in this plane. Its angle to the line from joint 2 to joint 6 is
+//    fixed by the shape, which gives the two branches of q6 around the axis of joint 6.
+//  - The axis of joint 3 follows from the axis of joint 5 and the shape, which gives the two
+//    branches of q1 and q2, then q3 and q5.
+
+namespace franka {
+
+namespace {
+
+constexpr double kD1 = 0.333;
+constexpr double kD3 = 0.316;
+constexpr double kD5 = 0.384;
+constexpr double kD7 = 0.107;
+constexpr double kA4 = 0.0825;
+constexpr double kA7 = 0.088;
+
+// The squared distance from joint 2 to joint 6 is
+// kLengthOffset + kLengthCosine * cos(q4) - kLengthSine * sin(q4)
+//   = kLengthOffset + kLengthAmplitude * cos(q4 + kBeta).
+constexpr double kLengthOffset = 2.0 * kA4 * kA4 + kD3 * kD3 + kD5 * kD5;
+constexpr double kLengthCosine = 2.0 * (kD3 * kD5 - kA4 * kA4);
+constexpr double kLengthSine = 2.0 * kA4 * (kD3 + kD5);
+const double kLengthAmplitude =
+    std::sqrt(kLengthCosine * kLengthCosine + kLengthSine * kLengthSine);
+const double kBeta = std::atan2(kLengthSine, kLengthCosine);
+
+// Horizontal component of the axis of joint 3 below which joint 2 is considered to be at zero.
+constexpr double kSingularityThreshold = 1e-9;
+
+// Number of q7 samples processed together by the batched solve.
+constexpr size_t kBlockSize = 8;
+
+constexpr std::array<double, 7> kMinJointPosition = PandaTraits::minJointPosition();
+constexpr std::array<double, 7> kMaxJointPosition = PandaTraits::maxJointPosition();
+
+bool withinLimits(size_t joint, double q) noexcept {
+  // Also rejects NaN from unreachable poses.
+  return q > kMinJointPosition[joint] && q < kMaxJointPosition[joint];
+}
+
+// Shifts q6 by a full turn if this brings it within the limits, which span more than pi.
+double wrapJoint6(double q6) noexcept {
+  if (q6 <= kMinJointPosition[5]) {
+    return q6 + 2.0 * M_PI;
+  }
+  if (q6 >= kMaxJointPosition[5]) {
+    return q6 - 2.0 * M_PI;
+  }
+  return q6;
+}
+
+double dot(const std::array<double, 3>& a, const std::array<double, 3>& b) noexcept {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Parts of the flange pose that do not depend on q7.
+struct FlangePose {
+  std::array<double, 3> x;
+  std::array<double, 3> y;
+  std::array<double, 3> z;
+  std::array<double, 3> p7;
+};
+
+FlangePose flangePose(
+    const std::array<double, 16>& O_T_EE,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 16>& EE_T_F) noexcept {  // NOLINT(readability-identifier-naming)
+  std::array<double, 16> O_T_F =  // NOLINT(readability-identifier-naming)
+      multiplyTransforms(O_T_EE, EE_T_F);
+  FlangePose pose;
+  for (size_t i = 0; i < 3; i++) {
+    pose.x[i] = O_T_F[i];
+    pose.y[i] = O_T_F[4 + i];
+    pose.z[i] = O_T_F[8 + i];
+    pose.p7[i] = O_T_F[12 + i] - kD7 * O_T_F[8 + i];
+  }
+  return pose;
+}
+
+// Intermediate results of a block of q7 samples, stored as structure of arrays so that the
+// arithmetic of the first stage runs over contiguous lanes.
+template <size_t N>
+struct Block {
+  std::array<double, N> q7;
+  // Axes of frame 6; its y axis is -z7.
+  std::array<std::array<double, N>, 3> x6;
+  std::array<std::array<double, N>, 3> z6;
+  // Vector from joint 2 to joint 6.
+  std::array<std::array<double, N>, 3> v26;
+  // Cosine of q4 + kBeta.
+  std::array<double, N> cos4;
+  // Polar coordinates of the vector from joint 6 to joint 2 in the x-y plane of frame 6.
+  std::array<double, N> r62;
+  std::array<double, N> phi62;
+};
+
+// Calculates the parts of the solution that only depend on q7 for all lanes. The trigonometric
+// functions are evaluated in separate loops, so that the remaining arithmetic is vectorized.
+template <size_t N>
+void solveWrist(const FlangePose& pose, Block<N>* block) noexcept {
+  std::array<double, N> c7;
+  std::array<double, N> s7;
+  for (size_t lane = 0; lane < N; lane++) {
+    c7[lane] = std::cos(block->q7[lane]);
+    s7[lane] = std::sin(block->q7[lane]);
+  }
+
+  std::array<double, N> v0;
+  std::array<double, N> v1;
+  for (size_t lane = 0; lane < N; lane++) {
+    for (size_t i = 0; i < 3; i++) {
+      block->x6[i][lane] = c7[lane] * pose.x[i] - s7[lane] * pose.y[i];
+      // z6 = z7 x x6
+      block->z6[i][lane] = s7[lane] * pose.x[i] + c7[lane] * pose.y[i];
+      block->v26[i][lane] = pose.p7[i] - kA7 * block->x6[i][lane];
+    }
+    block->v26[2][lane] -= kD1;
+
+    double ll26 = block->v26[0][lane] * block->v26[0][lane] +
+                  block->v26[1][lane] * block->v26[1][lane] +
+                  block->v26[2][lane] * block->v26[2][lane];
+    block->cos4[lane] = (ll26 - kLengthOffset) / kLengthAmplitude;
+
+    v0[lane] = -(block->x6[0][lane] * block->v26[0][lane] +
+                 block->x6[1][lane] * block->v26[1][lane] +
+                 block->x6[2][lane] * block->v26[2][lane]);
+    v1[lane] = pose.z[0] * block->v26[0][lane] + pose.z[1] * block->v26[1][lane] +
+               pose.z[2] * block->v26[2][lane];
+    block->r62[lane] = std::sqrt(v0[lane] * v0[lane] + v1[lane] * v1[lane]);
+  }
+
+  for (size_t lane = 0; lane < N; lane++) {
+    block->phi62[lane] = std::atan2(v1[lane], v0[lane]);
+  }
+}
+
+// Calculates q1, q2, q3 and q5 for one lane and branches of q4 and q6 and passes all solutions
+// within the joint limits to the output.
+template <size_t N, typename TOutput>
+void solveArm(const FlangePose& pose,
+              const Block<N>& block,
+              size_t lane,
+              double q4,
+              double q6,
+              double q1_singular,
+              TOutput& output) {
+  std::array<double, 3> x6{{block.x6[0][lane], block.x6[1][lane], block.x6[2][lane]}};
+  std::array<double, 3> z6{{block.z6[0][lane], block.z6[1][lane], block.z6[2][lane]}};
+  std::array<double, 3> v26{{block.v26[0][lane], block.v26[1][lane], block.v26[2][lane]}};
+
+  // Joint 6 and the axis of joint 5 relative to joint 2 in the x-z plane of frame 3.
+  double c4 = std::cos(q4);
+  double s4 = std::sin(q4);
+  double x = kA4 * (1.0 - c4) - kD5 * s4;
+  double z = kD3 + kD5 * c4 - kA4 * s4;
+
+  double c6 = std::cos(q6);
+  double s6 = std::sin(q6);
+  // Axis of joint 5, i.e. -s4 * x3 + c4 * z3.
+  std::array<double, 3> z5;
+  for (size_t i = 0; i < 3; i++) {
+    z5[i] = s6 * x6[i] - c6 * pose.z[i];
+  }
+
+  // The axes of joint 3 and joint 5 intersect at x = 0, which gives the axis of joint 3.
+  double l6p = x / -s4;
+  std::array<double, 3> z3;
+  for (size_t i = 0; i < 3; i++) {
+    z3[i] = v26[i] - l6p * z5[i];
+  }
+  double l2p = std::sqrt(dot(z3, z3)) * (z - x * c4 / -s4 < 0.0 ? -1.0 : 1.0);
+  std::array<double, 3> x3;
+  for (size_t i = 0; i < 3; i++) {
+    z3[i] /= l2p;
+    x3[i] = (v26[i] - z * z3[i]) / x;
+  }
+
+  // q5 from the vector from the axis of joint 5 to joint 4, expressed in frame 6.
+  std::array<double, 3> vh4;
+  for (size_t i = 0; i < 3; i++) {
+    vh4[i] = kD3 * z3[i] + kA4 * x3[i] - v26[i] + kD5 * z5[i];
+  }
+  double w0 = dot(x6, vh4);
+  double w1 = -dot(pose.z, vh4);
+  double w2 = dot(z6, vh4);
+  double q5 = -std::atan2(-w2, c6 * w0 - s6 * w1);
+  if (!withinLimits(4, q5)) {
+    return;
+  }
+
+  std::array<double, 2> q1;
+  std::array<double, 2> q2;
+  size_t branches = 2;
+  if (std::sqrt(z3[0] * z3[0] + z3[1] * z3[1]) <= kSingularityThreshold) {
+    q1[0] = q1_singular;
+    q2[0] = 0.0;
+    branches = 1;
+  } else {
+    q1[0] = std::atan2(z3[1], z3[0]);
+    q2[0] = std::acos(std::max(std::min(z3[2], 1.0), -1.0));
+    q1[1] = q1[0] < 0.0 ? q1[0] + M_PI : q1[0] - M_PI;
+    q2[1] = -q2[0];
+  }
+
+  for (size_t branch = 0; branch < branches; branch++) {
+    if (!withinLimits(0, q1[branch]) || !withinLimits(1, q2[branch])) {
+      continue;
+    }
+    double c1 = std::cos(q1[branch]);
+    double s1 = std::sin(q1[branch]);
+    double c2 = std::cos(q2[branch]);
+    double s2 = std::sin(q2[branch]);
+    // x3 expressed in frame 2.
+    double q3 =
+        std::atan2(-s1 * x3[0] + c1 * x3[1], c1 * c2 * x3[0] + s1 * c2 * x3[1] - s2 * x3[2]);
+    if (!withinLimits(2, q3)) {
+      continue;
+    }
+    output({{q1[branch], q2[branch], q3, q4, q5, q6, block.q7[lane]}});
+  }
+}
+
+template <size_t N, typename TOutput>
+void solveBlock(const FlangePose& pose,
+                const double* q7,
+                size_t samples,
+                double q1_singular,
+                TOutput& output) {
+  Block<N> block;
+  for (size_t lane = 0; lane < N; lane++) {
+    // Unused lanes repeat the first sample and are skipped below.
+    block.q7[lane] = q7[lane < samples ? lane : 0];
+  }
+  solveWrist(pose, &block);
+
+  for (size_t lane = 0; lane < samples; lane++) {
+    if (!withinLimits(6, block.q7[lane]) || !(std::abs(block.cos4[lane]) <= 1.0)) {
+      continue;
+    }
+    double angle4 = std::acos(block.cos4[lane]);
+    for (double q4 : {angle4 - kBeta, -angle4 - kBeta}) {
+      if (!withinLimits(3, q4)) {
+        continue;
+      }
+      // The projection of the vector from joint 6 to joint 2 onto the axis of joint 5.
+      double c4 = std::cos(q4);
+      double s4 = std::sin(q4);
+      double d62 = (kA4 * (1.0 - c4) - kD5 * s4) * s4 - (kD3 + kD5 * c4 - kA4 * s4) * c4;
+      double sin6 = d62 / block.r62[lane];
+      if (!(std::abs(sin6) <= 1.0)) {
+        continue;
+      }
+      double theta6 = std::asin(sin6);
+      for (double q6 : {wrapJoint6(M_PI - theta6 - block.phi62[lane]),
+                        wrapJoint6(theta6 - block.phi62[lane])}) {
+        if (withinLimits(5, q6)) {
+          solveArm(pose, block, lane, q4, q6, q1_singular, output);
+        }
+      }
+    }
+  }
+}
+
+}  // anonymous namespace
+
+constexpr size_t InverseKinematics::kMaxSolutions;
+
+InverseKinematics::InverseKinematics() noexcept
+    : EE_T_F_{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}} {}
+
+InverseKinematics::InverseKinematics(
+    const std::array<double, 16>& F_T_EE) noexcept  // NOLINT(readability-identifier-naming)
+    : EE_T_F_(invertTransform(F_T_EE)) {}
+
+size_t InverseKinematics::solve(
+    const std::array<double, 16>& O_T_EE,  // NOLINT(readability-identifier-naming)
+    double q7,
+    Solutions* solutions,
+    double q1) const noexcept {
+  size_t count = 0;
+  auto output = [&](const std::array<double, 7>& solution) {
+    (*solutions)[count++] = solution;
+  };
+  solveBlock<1>(flangePose(O_T_EE, EE_T_F_), &q7, 1, q1, output);
+  return count;
+}
+
+size_t InverseKinematics::solve(
+    const std::array<double, 16>& O_T_EE,  // NOLINT(readability-identifier-naming)
+    const std::vector<double>& q7,
+    std::vector<std::array<double, 7>>* solutions,
+    double q1) const {
+  solutions->clear();
+  auto output = [&](const std::array<double, 7>& solution) { solutions->push_back(solution); };
+  FlangePose pose = flangePose(O_T_EE, EE_T_F_);
+  for (size_t offset = 0; offset < q7.size(); offset += kBlockSize) {
+    solveBlock<kBlockSize>(pose, &q7[offset], std::min(kBlockSize, q7.size() - offset), q1,
+                           output);
+  }
+  return solutions->size();
+}
+
+bool InverseKinematics::solveClosest(
+    const std::array<double, 16>& O_T_EE,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 7>& q,
+    std::array<double, 7>* solution) const noexcept {
+  Solutions solutions;
+  size_t count = solve(O_T_EE, q[6], &solutions, q[0]);
+  double minimum_distance = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < count; i++) {
+    double distance = 0.0;
+    for (size_t j = 0; j < 7; j++) {
+      distance += (solutions[i][j] - q[j]) * (solutions[i][j] - q[j]);
+    }
+    if (distance < minimum_distance) {
+      minimum_distance = distance;
+      *solution = solutions[i];
+    }
+  }
+  return count > 0;
+}
+
+}  // namespace franka
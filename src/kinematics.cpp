@@ -0,0 +1,209 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/kinematics.h>
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <franka/exception.h>
+
+namespace franka {
+
+namespace {
+
+constexpr size_t kLinks = 8;
+constexpr std::array<const char*, kLinks> kLinkNames{
+    {"joint1", "joint2", "joint3", "joint4", "joint5", "joint6", "joint7", "flange"}};
+
+// Nominal modified Denavit-Hartenberg parameters of the links.
+constexpr std::array<double, kLinks> kA{{0.0, 0.0, 0.0, 0.0825, -0.0825, 0.0, 0.088, 0.0}};
+constexpr std::array<double, kLinks> kD{{0.333, 0.0, 0.316, 0.0, 0.384, 0.0, 0.0, 0.107}};
+constexpr std::array<double, kLinks> kAlpha{
+    {0.0, -M_PI_2, M_PI_2, M_PI_2, -M_PI_2, M_PI_2, M_PI_2, 0.0}};
+
+using Poses = std::array<Eigen::Matrix4d, kLinks>;
+
+// Number of joints moving the given frame.
+size_t jointCount(Frame frame) {
+  switch (frame) {
+    case Frame::kJoint1:
+    case Frame::kJoint2:
+    case Frame::kJoint3:
+    case Frame::kJoint4:
+    case Frame::kJoint5:
+    case Frame::kJoint6:
+    case Frame::kJoint7:
+      return static_cast<size_t>(frame) + 1;
+    case Frame::kFlange:
+    case Frame::kEndEffector:
+    case Frame::kStiffness:
+      return 7;
+    default:
+      throw std::invalid_argument("Invalid frame given.");
+  }
+}
+
+// Returns the pose of the given frame and stores the poses of the joint frames moving it.
+Eigen::Matrix4d forward(
+    const std::array<std::array<double, 16>, kLinks>& link_transforms,
+    const std::array<double, 7>& q,
+    Frame frame,
+    const std::array<double, 16>& F_T_EE,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 16>& EE_T_K,  // NOLINT(readability-identifier-naming)
+    Poses* poses) {
+  size_t count = jointCount(frame);
+  Eigen::Matrix4d pose = Eigen::Matrix4d::Identity();
+  for (size_t i = 0; i < count; i++) {
+    pose = pose * Eigen::Map<const Eigen::Matrix4d>(link_transforms[i].data());
+    // Rotation about the z axis only mixes the first two columns.
+    double cos_q = std::cos(q[i]);
+    double sin_q = std::sin(q[i]);
+    Eigen::Vector4d x = pose.col(0);
+    pose.col(0) = cos_q * x + sin_q * pose.col(1);
+    pose.col(1) = cos_q * pose.col(1) - sin_q * x;
+    (*poses)[i] = pose;
+  }
+
+  switch (frame) {
+    case Frame::kFlange:
+      return pose * Eigen::Map<const Eigen::Matrix4d>(link_transforms[7].data());
+    case Frame::kEndEffector:
+      return pose * Eigen::Map<const Eigen::Matrix4d>(link_transforms[7].data()) *
+             Eigen::Map<const Eigen::Matrix4d>(F_T_EE.data());
+    case Frame::kStiffness:
+      return pose * Eigen::Map<const Eigen::Matrix4d>(link_transforms[7].data()) *
+             Eigen::Map<const Eigen::Matrix4d>(F_T_EE.data()) *
+             Eigen::Map<const Eigen::Matrix4d>(EE_T_K.data());
+    default:
+      return pose;
+  }
+}
+
+Eigen::Matrix<double, 6, 7> zeroJacobianMatrix(
+    const std::array<std::array<double, 16>, kLinks>& link_transforms,
+    const std::array<double, 7>& q,
+    Frame frame,
+    const std::array<double, 16>& F_T_EE,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 16>& EE_T_K,  // NOLINT(readability-identifier-naming)
+    Eigen::Matrix4d* pose) {
+  Poses poses;
+  *pose = forward(link_transforms, q, frame, F_T_EE, EE_T_K, &poses);
+  Eigen::Vector3d position = pose->topRightCorner<3, 1>();
+
+  Eigen::Matrix<double, 6, 7> jacobian = Eigen::Matrix<double, 6, 7>::Zero();
+  for (size_t i = 0; i < jointCount(frame); i++) {
+    Eigen::Vector3d axis = poses[i].block<3, 1>(0, 2);
+    Eigen::Vector3d origin = poses[i].topRightCorner<3, 1>();
+    jacobian.block<3, 1>(0, i) = axis.cross(position - origin);
+    jacobian.block<3, 1>(3, i) = axis;
+  }
+  return jacobian;
+}
+
+}  // anonymous namespace
+
+KinematicCalibration readKinematicCalibration(std::istream& input) {
+  KinematicCalibration calibration;
+  std::string line;
+  for (size_t number = 1; std::getline(input, line); number++) {
+    std::istringstream stream(line.substr(0, line.find('#')));
+    std::string name;
+    if (!(stream >> name)) {
+      continue;
+    }
+    size_t index = 0;
+    while (index < kLinks && name != kLinkNames[index]) {
+      index++;
+    }
+    LinkCalibration link;
+    std::string rest;
+    if (index == kLinks || !(stream >> link.a >> link.d >> link.alpha >> link.theta) ||
+        (stream >> rest)) {
+      throw ModelException("libfranka: Invalid kinematic calibration in line " +
+                           std::to_string(number) + ".");
+    }
+    calibration.links[index] = link;
+  }
+  if (input.bad()) {
+    throw ModelException("libfranka: Could not read kinematic calibration.");
+  }
+  return calibration;
+}
+
+Kinematics::Kinematics() noexcept : Kinematics(KinematicCalibration()) {}
+
+Kinematics::Kinematics(const KinematicCalibration& calibration) noexcept {
+  for (size_t i = 0; i < kLinks; i++) {
+    const LinkCalibration& link = calibration.links[i];
+    // Rot_x(alpha) * Trans_x(a) * Trans_z(d) * Rot_z(theta); the joint rotation is applied last.
+    Eigen::Affine3d transform(Eigen::AngleAxisd(kAlpha[i] + link.alpha, Eigen::Vector3d::UnitX()));
+    transform.translate(Eigen::Vector3d(kA[i] + link.a, 0.0, kD[i] + link.d));
+    transform.rotate(Eigen::AngleAxisd(link.theta, Eigen::Vector3d::UnitZ()));
+    Eigen::Map<Eigen::Matrix4d>(link_transforms_[i].data()) = transform.matrix();
+  }
+}
+
+std::array<double, 16> Kinematics::pose(Frame frame, const franka::RobotState& robot_state) const {
+  return pose(frame, robot_state.q, robot_state.F_T_EE, robot_state.EE_T_K);
+}
+
+std::array<double, 16> Kinematics::pose(
+    Frame frame,
+    const std::array<double, 7>& q,
+    const std::array<double, 16>& F_T_EE,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 16>& EE_T_K)  // NOLINT(readability-identifier-naming)
+    const {
+  Poses poses;
+  std::array<double, 16> output;
+  Eigen::Map<Eigen::Matrix4d>(output.data()) =
+      forward(link_transforms_, q, frame, F_T_EE, EE_T_K, &poses);
+  return output;
+}
+
+std::array<double, 42> Kinematics::bodyJacobian(Frame frame,
+                                                const franka::RobotState& robot_state) const {
+  return bodyJacobian(frame, robot_state.q, robot_state.F_T_EE, robot_state.EE_T_K);
+}
+
+std::array<double, 42> Kinematics::bodyJacobian(
+    Frame frame,
+    const std::array<double, 7>& q,
+    const std::array<double, 16>& F_T_EE,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 16>& EE_T_K)  // NOLINT(readability-identifier-naming)
+    const {
+  Eigen::Matrix4d pose;
+  Eigen::Matrix<double, 6, 7> jacobian =
+      zeroJacobianMatrix(link_transforms_, q, frame, F_T_EE, EE_T_K, &pose);
+  Eigen::Matrix3d rotation_transpose = pose.topLeftCorner<3, 3>().transpose();
+
+  std::array<double, 42> output;
+  Eigen::Map<Eigen::Matrix<double, 6, 7>> body_jacobian(output.data());
+  body_jacobian.topRows<3>() = rotation_transpose * jacobian.topRows<3>();
+  body_jacobian.bottomRows<3>() = rotation_transpose * jacobian.bottomRows<3>();
+  return output;
+}
+
+std::array<double, 42> Kinematics::zeroJacobian(Frame frame,
+                                                const franka::RobotState& robot_state) const {
+  return zeroJacobian(frame, robot_state.q, robot_state.F_T_EE, robot_state.EE_T_K);
+}
+
+std::array<double, 42> Kinematics::zeroJacobian(
+    Frame frame,
+    const std::array<double, 7>& q,
+    const std::array<double, 16>& F_T_EE,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 16>& EE_T_K)  // NOLINT(readability-identifier-naming)
+    const {
+  Eigen::Matrix4d pose;
+  std::array<double, 42> output;
+  Eigen::Map<Eigen::Matrix<double, 6, 7>>(output.data()) =
+      zeroJacobianMatrix(link_transforms_, q, frame, F_T_EE, EE_T_K, &pose);
+  return output;
+}
+
+}  // namespace franka
@@ -0,0 +1,343 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/log_analytics.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+#include <Poco/Exception.h>
+#include <Poco/File.h>
+#include <Poco/SharedMemory.h>
+
+#include <franka/exception.h>
+
+#include "log_file_format.h"
+#include "parallel_for.h"
+
+namespace franka {
+
+namespace {
+
+// Number of records processed by a worker at once.
+constexpr size_t kChunkSize = 1024;
+
+struct FieldBounds {
+  size_t offset;
+  double min;
+  double max;
+};
+
+template <typename T>
+T readValue(const char* data, size_t offset) {
+  T value;
+  std::memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+struct ResidualSums {
+  std::array<double, 7> sum{};
+  std::array<double, 7> sum_of_squares{};
+  std::array<double, 7> max{};
+
+  void add(const std::array<double, 7>& residual) {
+    for (size_t i = 0; i < residual.size(); i++) {
+      sum[i] += residual[i];
+      sum_of_squares[i] += residual[i] * residual[i];
+      max[i] = std::max(max[i], std::abs(residual[i]));
+    }
+  }
+
+  void add(const ResidualSums& other) {
+    for (size_t i = 0; i < sum.size(); i++) {
+      sum[i] += other.sum[i];
+      sum_of_squares[i] += other.sum_of_squares[i];
+      max[i] = std::max(max[i], other.max[i]);
+    }
+  }
+
+  JointResidualStatistics statistics(uint64_t samples) const {
+    JointResidualStatistics statistics;
+    if (samples == 0) {
+      return statistics;
+    }
+    for (size_t i = 0; i < sum.size(); i++) {
+      statistics.mean[i] = sum[i] / samples;
+      statistics.rms[i] = std::sqrt(sum_of_squares[i] / samples);
+      statistics.max[i] = max[i];
+    }
+    return statistics;
+  }
+};
+
+struct ModelResidualSums {
+  ResidualSums gravity;
+  ResidualSums dynamics;
+  double translational_sum_of_squares{};
+  double translational_max{};
+  uint64_t samples{};
+};
+
+struct SuccessRateSums {
+  double sum{};
+  double min{};
+  uint64_t samples{};
+};
+
+int64_t floorDivide(int64_t value, int64_t divisor) {
+  int64_t quotient = value / divisor;
+  if (value % divisor != 0 && value < 0) {
+    quotient--;
+  }
+  return quotient;
+}
+
+}  // anonymous namespace
+
+LogQuery& LogQuery::robotTime(Duration start, Duration end) noexcept {
+  robot_time_start_ = start;
+  robot_time_end_ = end;
+  return *this;
+}
+
+LogQuery& LogQuery::hostTime(std::chrono::nanoseconds start,
+                             std::chrono::nanoseconds end) noexcept {
+  host_time_start_ = start;
+  host_time_end_ = end;
+  return *this;
+}
+
+LogQuery& LogQuery::range(double RobotState::*field, double min, double max) {
+  RobotState state;
+  size_t state_offset = static_cast<size_t>(reinterpret_cast<const char*>(&(state.*field)) -
+                                            reinterpret_cast<const char*>(&state));
+  return addRange(state_offset, min, max);
+}
+
+LogQuery& LogQuery::addRange(size_t state_offset, double min, double max) {
+  ranges_.push_back({state_offset, min, max});
+  return *this;
+}
+
+struct LogDataset::Impl {
+  struct MappedFile {
+    Poco::SharedMemory memory;
+    const char* records;
+    size_t record_size;
+    size_t record_count;
+    size_t time_offset;
+    size_t host_time_offset;
+    uint32_t version;
+  };
+
+  struct Chunk {
+    size_t file;
+    size_t first;
+    size_t count;
+  };
+
+  std::vector<MappedFile> files;
+  std::vector<Chunk> chunks;
+  size_t record_count{};
+};
+
+LogDataset::LogDataset(const std::vector<std::string>& paths) : impl_(new Impl) {
+  for (const std::string& path : paths) {
+    Impl::MappedFile file;
+    size_t size = 0;
+    try {
+      Poco::File poco_file(path);
+      size = static_cast<size_t>(poco_file.getSize());
+      if (size < kLogFileHeaderSize) {
+        throw LogFileException("libfranka: Invalid log file header in " + path + ".");
+      }
+      file.memory = Poco::SharedMemory(poco_file, Poco::SharedMemory::AM_READ);
+    } catch (const Poco::Exception& e) {
+      throw LogFileException("libfranka: Could not open log file " + path + ": " +
+                             e.displayText());
+    }
+
+    const char* data = file.memory.begin();
+    file.version = decodeLogFileHeader(data, size);
+    file.record_size = logRecordSize(file.version);
+    file.time_offset = logRecordTimeOffset(file.version);
+    file.host_time_offset = logRecordHostTimeOffset(file.version);
+    file.records = data + kLogFileHeaderSize;
+    if ((size - kLogFileHeaderSize) % file.record_size != 0) {
+      throw LogFileException("libfranka: Unexpected end of log file " + path + ".");
+    }
+    file.record_count = (size - kLogFileHeaderSize) / file.record_size;
+
+    for (size_t first = 0; first < file.record_count; first += kChunkSize) {
+      impl_->chunks.push_back(
+          {impl_->files.size(), first, std::min(kChunkSize, file.record_count - first)});
+    }
+    impl_->record_count += file.record_count;
+    impl_->files.push_back(std::move(file));
+  }
+}
+
+LogDataset::LogDataset(LogDataset&& dataset) noexcept = default;
+LogDataset& LogDataset::operator=(LogDataset&& dataset) noexcept = default;
+LogDataset::~LogDataset() noexcept = default;
+
+size_t LogDataset::size() const noexcept {
+  return impl_->record_count;
+}
+
+size_t LogDataset::workerCount(size_t threads) noexcept {
+  return parallelWorkerCount(threads);
+}
+
+void LogDataset::forEach(const LogQuery& query, const Callback& callback, size_t threads) const {
+  std::vector<FieldBounds> bounds;
+  bounds.reserve(query.ranges_.size());
+  for (const LogQuery::FieldRange& range : query.ranges_) {
+    bounds.push_back({logRecordFieldOffset(range.state_offset), range.min, range.max});
+  }
+  const uint64_t robot_time_start = query.robot_time_start_.toMSec();
+  const uint64_t robot_time_end = query.robot_time_end_.toMSec();
+
+  // Only looks at the raw bytes of the record, so that skipped records are never decoded.
+  auto selected = [&](const char* data, const Impl::MappedFile& file) {
+    uint64_t time = readValue<uint64_t>(data, file.time_offset);
+    if (time < robot_time_start || time > robot_time_end) {
+      return false;
+    }
+    std::chrono::nanoseconds host_time(
+        file.version >= 2 ? readValue<int64_t>(data, file.host_time_offset) : 0);
+    if (host_time < query.host_time_start_ || host_time > query.host_time_end_) {
+      return false;
+    }
+    for (const FieldBounds& field : bounds) {
+      double value = readValue<double>(data, field.offset);
+      if (!(value >= field.min && value <= field.max)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  parallelFor(impl_->chunks.size(), threads, [&](size_t worker, size_t index) {
+    Record record;
+    std::chrono::nanoseconds host_time;
+    const Impl::Chunk& chunk = impl_->chunks[index];
+    const Impl::MappedFile& file = impl_->files[chunk.file];
+    const char* data = file.records + chunk.first * file.record_size;
+    for (size_t i = 0; i < chunk.count; i++, data += file.record_size) {
+      if (!selected(data, file)) {
+        continue;
+      }
+      decodeLogRecord(data, file.version, &record, &host_time);
+      callback(worker, record, host_time);
+    }
+  });
+}
+
+ModelResiduals computeModelResiduals(const LogDataset& dataset,
+                                     const Model& model,
+                                     const LogQuery& query,
+                                     size_t threads) {
+  ModelResidualSums sums = dataset.mapReduce<ModelResidualSums>(
+      query, ModelResidualSums(),
+      [&](ModelResidualSums& partial, const Record& record, std::chrono::nanoseconds) {
+        const RobotState& state = record.state;
+        std::array<double, 7> gravity = model.gravity(state);
+        std::array<double, 7> coriolis = model.coriolis(state);
+        std::array<double, 49> mass = model.mass(state);
+
+        std::array<double, 7> gravity_residual;
+        std::array<double, 7> dynamics_residual;
+        for (size_t i = 0; i < 7; i++) {
+          double inertial_torque = 0.0;
+          for (size_t j = 0; j < 7; j++) {
+            // Column-major mass matrix.
+            inertial_torque += mass[j * 7 + i] * state.ddq_d[j];
+          }
+          gravity_residual[i] = state.tau_J[i] - gravity[i];
+          dynamics_residual[i] = state.tau_J[i] - (inertial_torque + coriolis[i] + gravity[i]);
+        }
+        partial.gravity.add(gravity_residual);
+        partial.dynamics.add(dynamics_residual);
+
+        std::array<double, 16> pose = model.pose(Frame::kEndEffector, state);
+        double squared_distance = 0.0;
+        for (size_t i = 12; i < 15; i++) {
+          squared_distance += (pose[i] - state.O_T_EE[i]) * (pose[i] - state.O_T_EE[i]);
+        }
+        partial.translational_sum_of_squares += squared_distance;
+        partial.translational_max =
+            std::max(partial.translational_max, std::sqrt(squared_distance));
+        partial.samples++;
+      },
+      [](ModelResidualSums& result, const ModelResidualSums& partial) {
+        result.gravity.add(partial.gravity);
+        result.dynamics.add(partial.dynamics);
+        result.translational_sum_of_squares += partial.translational_sum_of_squares;
+        result.translational_max = std::max(result.translational_max, partial.translational_max);
+        result.samples += partial.samples;
+      },
+      threads);
+
+  ModelResiduals residuals;
+  residuals.gravity = sums.gravity.statistics(sums.samples);
+  residuals.dynamics = sums.dynamics.statistics(sums.samples);
+  if (sums.samples > 0) {
+    residuals.translational_rms = std::sqrt(sums.translational_sum_of_squares / sums.samples);
+  }
+  residuals.translational_max = sums.translational_max;
+  residuals.samples = sums.samples;
+  return residuals;
+}
+
+std::vector<SuccessRateBucket> computeSuccessRates(const LogDataset& dataset,
+                                                   std::chrono::nanoseconds period,
+                                                   const LogQuery& query,
+                                                   size_t threads) {
+  if (period <= std::chrono::nanoseconds::zero()) {
+    throw std::invalid_argument("libfranka: Period must be positive.");
+  }
+
+  using Buckets = std::map<int64_t, SuccessRateSums>;
+  auto merge = [](Buckets& result, int64_t key, const SuccessRateSums& sums) {
+    auto inserted = result.emplace(key, sums);
+    if (!inserted.second) {
+      SuccessRateSums& bucket = inserted.first->second;
+      bucket.sum += sums.sum;
+      bucket.min = std::min(bucket.min, sums.min);
+      bucket.samples += sums.samples;
+    }
+  };
+
+  Buckets buckets = dataset.mapReduce<Buckets>(
+      query, Buckets(),
+      [&](Buckets& partial, const Record& record, std::chrono::nanoseconds host_time) {
+        std::chrono::nanoseconds time = host_time;
+        if (time == std::chrono::nanoseconds::zero()) {
+          time = std::chrono::milliseconds(record.state.time.toMSec());
+        }
+        double rate = record.state.control_command_success_rate;
+        merge(partial, floorDivide(time.count(), period.count()), {rate, rate, 1});
+      },
+      [&](Buckets& result, const Buckets& partial) {
+        for (const auto& bucket : partial) {
+          merge(result, bucket.first, bucket.second);
+        }
+      },
+      threads);
+
+  std::vector<SuccessRateBucket> result;
+  result.reserve(buckets.size());
+  for (const auto& bucket : buckets) {
+    SuccessRateBucket success_rate;
+    success_rate.start = bucket.first * period;
+    success_rate.mean = bucket.second.sum / bucket.second.samples;
+    success_rate.min = bucket.second.min;
+    success_rate.samples = bucket.second.samples;
+    result.push_back(success_rate);
+  }
+  return result;
+}
+
+}  // namespace franka
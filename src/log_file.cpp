@@ -0,0 +1,80 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/log_file.h>
+
+#include <array>
+
+#include <franka/exception.h>
+
+#include "log_file_format.h"
+
+namespace franka {
+
+LogFileWriter::LogFileWriter(std::ostream& stream)
+    : stream_(stream), buffer_(logRecordSize(kLogFileVersion)) {
+  stream_.write(kLogFileMagic.data(), kLogFileMagic.size());
+  uint32_t version = kLogFileVersion;
+  uint32_t record_size = static_cast<uint32_t>(buffer_.size());
+  stream_.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  stream_.write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+  if (!stream_) {
+    throw LogFileException("libfranka: Could not write log file header.");
+  }
+}
+
+void LogFileWriter::write(const Record& record) {
+  write(record, std::chrono::nanoseconds(0));
+}
+
+void LogFileWriter::write(const Record& record, std::chrono::nanoseconds host_time) {
+  encodeLogRecord(record, host_time, buffer_.data());
+  stream_.write(buffer_.data(), buffer_.size());
+  if (!stream_) {
+    throw LogFileException("libfranka: Could not write log file record.");
+  }
+}
+
+void LogFileWriter::write(const std::vector<Record>& log) {
+  for (const Record& record : log) {
+    write(record);
+  }
+}
+
+LogFileReader::LogFileReader(std::istream& stream) : stream_(stream), version_(0) {
+  std::array<char, kLogFileHeaderSize> header{};
+  stream_.read(header.data(), header.size());
+  if (!stream_) {
+    throw LogFileException("libfranka: Invalid log file header.");
+  }
+  version_ = decodeLogFileHeader(header.data(), header.size());
+  buffer_.resize(logRecordSize(version_));
+}
+
+bool LogFileReader::read(Record* record) {
+  std::chrono::nanoseconds host_time;
+  return read(record, &host_time);
+}
+
+bool LogFileReader::read(Record* record, std::chrono::nanoseconds* host_time) {
+  stream_.read(buffer_.data(), buffer_.size());
+  if (stream_.gcount() == 0 && stream_.eof()) {
+    return false;
+  }
+  if (static_cast<size_t>(stream_.gcount()) != buffer_.size()) {
+    throw LogFileException("libfranka: Unexpected end of log file.");
+  }
+
+  decodeLogRecord(buffer_.data(), version_, record, host_time);
+  return true;
+}
+
+std::vector<Record> LogFileReader::readAll() {
+  std::vector<Record> log;
+  Record record;
+  while (read(&record)) {
+    log.push_back(record);
+  }
+  return log;
+}
+
+}  // namespace franka
@@ -0,0 +1,221 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "log_file_format.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <franka/exception.h>
+#include <franka/log_file.h>
+
+namespace franka {
+
+namespace {
+
+template <typename T>
+char* serialize(char* cursor, T value) {
+  std::memcpy(cursor, &value, sizeof(value));
+  return cursor + sizeof(value);
+}
+
+template <typename T>
+const char* deserialize(const char* cursor, T* value) {
+  std::memcpy(value, cursor, sizeof(*value));
+  return cursor + sizeof(*value);
+}
+
+// Encoders and decoders of the stored representation of each field type. Floating point values are
+// stored as they are.
+template <size_t N>
+const std::array<double, N>& encodeValue(const std::array<double, N>& value) {
+  return value;
+}
+
+double encodeValue(double value) {
+  return value;
+}
+
+uint64_t encodeValue(const Errors& errors) {
+  std::array<bool, 37> flags(errors);
+  uint64_t packed = 0;
+  for (size_t i = 0; i < flags.size(); i++) {
+    packed |= static_cast<uint64_t>(flags[i]) << i;
+  }
+  return packed;
+}
+
+uint8_t encodeValue(RobotMode robot_mode) {
+  return static_cast<uint8_t>(robot_mode);
+}
+
+uint64_t encodeValue(const Duration& duration) {
+  return duration.toMSec();
+}
+
+template <size_t N>
+void decodeValue(const std::array<double, N>& stored, std::array<double, N>* value) {
+  *value = stored;
+}
+
+void decodeValue(double stored, double* value) {
+  *value = stored;
+}
+
+void decodeValue(uint64_t stored, Errors* errors) {
+  std::array<bool, 37> flags{};
+  for (size_t i = 0; i < flags.size(); i++) {
+    flags[i] = ((stored >> i) & 1u) != 0;
+  }
+  *errors = Errors(flags);
+}
+
+void decodeValue(uint8_t stored, RobotMode* robot_mode) {
+  *robot_mode = static_cast<RobotMode>(stored);
+}
+
+void decodeValue(uint64_t stored, Duration* duration) {
+  *duration = Duration(stored);
+}
+
+template <typename T>
+using StoredType = std::decay_t<decltype(encodeValue(std::declval<const T&>()))>;
+
+struct SizeCounter {
+  template <typename T>
+  void operator()(const T& /* value */) {
+    size += sizeof(StoredType<T>);
+  }
+
+  size_t size;
+};
+
+// Finds the file offset of the value at the given address. Values of other types than double are
+// only found at their start address, because their stored representation differs.
+struct OffsetFinder {
+  template <typename T>
+  void operator()(const T& value) {
+    if (found) {
+      return;
+    }
+    const char* address = reinterpret_cast<const char*>(&value);
+    size_t size = std::is_same<StoredType<T>, T>::value ? sizeof(value) : 1;
+    if (field >= address && field < address + size) {
+      offset += field - address;
+      found = true;
+    } else {
+      offset += sizeof(StoredType<T>);
+    }
+  }
+
+  const char* field;
+  size_t offset;
+  bool found;
+};
+
+struct Serializer {
+  template <typename T>
+  void operator()(const T& value) {
+    cursor = serialize(cursor, encodeValue(value));
+  }
+
+  char* cursor;
+};
+
+struct Deserializer {
+  template <typename T>
+  void operator()(T& value) {
+    StoredType<T> stored;
+    cursor = deserialize(cursor, &stored);
+    decodeValue(stored, &value);
+  }
+
+  const char* cursor;
+};
+
+size_t fieldsSize(uint32_t version) {
+  Record record;
+  SizeCounter counter{0};
+  visitFields(record, version, counter);
+  return counter.size;
+}
+
+// Returns the file offset of a value within the given record.
+size_t fieldOffset(const Record& record, const void* field, uint32_t version) {
+  OffsetFinder finder{reinterpret_cast<const char*>(field), 0, false};
+  visitFields(record, version, finder);
+  if (!finder.found) {
+    throw std::invalid_argument("libfranka: Field is not stored in log files.");
+  }
+  return finder.offset;
+}
+
+}  // anonymous namespace
+
+size_t logRecordSize(uint32_t version) {
+  size_t size = fieldsSize(version);
+  if (version >= 2) {
+    // Host receive time.
+    size += sizeof(int64_t);
+  }
+  return size;
+}
+
+size_t logRecordTimeOffset(uint32_t version) {
+  Record record;
+  return fieldOffset(record, &record.state.time, version);
+}
+
+size_t logRecordHostTimeOffset(uint32_t version) {
+  return fieldsSize(version);
+}
+
+size_t logRecordFieldOffset(size_t state_offset) {
+  Record record;
+  return fieldOffset(record, reinterpret_cast<const char*>(&record.state) + state_offset,
+                     kLogFileVersion);
+}
+
+uint32_t decodeLogFileHeader(const char* data, size_t size) {
+  std::array<char, kLogFileMagic.size()> magic{};
+  uint32_t version = 0;
+  uint32_t record_size = 0;
+  if (size < kLogFileHeaderSize) {
+    throw LogFileException("libfranka: Invalid log file header.");
+  }
+  const char* cursor = deserialize(data, &magic);
+  cursor = deserialize(cursor, &version);
+  deserialize(cursor, &record_size);
+  if (magic != kLogFileMagic) {
+    throw LogFileException("libfranka: Invalid log file header.");
+  }
+  if (version < 1 || version > kLogFileVersion || record_size != logRecordSize(version)) {
+    throw LogFileException("libfranka: Unsupported log file version " + std::to_string(version) +
+                           ".");
+  }
+  return version;
+}
+
+void encodeLogRecord(const Record& record, std::chrono::nanoseconds host_time, char* data) {
+  Serializer serializer{data};
+  visitFields(record, kLogFileVersion, serializer);
+  serialize(serializer.cursor, static_cast<int64_t>(host_time.count()));
+}
+
+void decodeLogRecord(const char* data,
+                     uint32_t version,
+                     Record* record,
+                     std::chrono::nanoseconds* host_time) {
+  Deserializer deserializer{data};
+  visitFields(*record, version, deserializer);
+  int64_t host_time_count = 0;
+  if (version >= 2) {
+    deserialize(deserializer.cursor, &host_time_count);
+  }
+  *host_time = std::chrono::nanoseconds(host_time_count);
+}
+
+}  // namespace franka
@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <franka/field_descriptors.h>
+#include <franka/log.h>
+
+namespace franka {
+
+constexpr std::array<char, 8> kLogFileMagic{{'F', 'R', 'A', 'N', 'K', 'L', 'O', 'G'}};
+
+// Magic, version and record size.
+constexpr size_t kLogFileHeaderSize = kLogFileMagic.size() + 2 * sizeof(uint32_t);
+
+// Returns the first file version that stores the given field of Record.
+inline uint32_t logFileFieldVersion(const char* name) noexcept {
+  return std::strcmp(name, "joint_power") == 0 ? 3 : 1;
+}
+
+namespace detail {
+
+template <bool kDoubles, typename T, typename TVisitor>
+void visitLogValues(T& value, TVisitor& visitor);
+
+template <typename T, typename TVisitor>
+void visitLogValue(T& value, TVisitor& visitor, std::true_type /* selected */) {
+  visitor(value);
+}
+
+template <typename T, typename TVisitor>
+void visitLogValue(T& /* value */, TVisitor& /* visitor */, std::false_type /* selected */) {}
+
+template <bool kDoubles, typename T, typename TVisitor>
+void visitLogValues(T& object, TVisitor& visitor, std::true_type /* has_field_table */) {
+  franka::forEachField<std::remove_const_t<T>>(
+      [&](const auto& field) { visitLogValues<kDoubles>(field.get(object), visitor); });
+}
+
+template <bool kDoubles, typename T, typename TVisitor>
+void visitLogValues(T& value, TVisitor& visitor, std::false_type /* has_field_table */) {
+  constexpr bool kDouble =
+      std::is_same<typename FieldExtent<std::remove_const_t<T>>::Element, double>::value;
+  visitLogValue(value, visitor, std::integral_constant<bool, kDouble == kDoubles>());
+}
+
+template <bool kDoubles, typename T, typename TVisitor>
+void visitLogValues(T& value, TVisitor& visitor) {
+  visitLogValues<kDoubles>(value, visitor, HasFieldTable<std::remove_const_t<T>>());
+}
+
+template <bool kDoubles, typename TRecord, typename TVisitor>
+void visitLogRecordValues(TRecord& record, uint32_t version, TVisitor& visitor) {
+  franka::forEachField<Record>([&](const auto& field) {
+    if (version >= logFileFieldVersion(field.name)) {
+      visitLogValues<kDoubles>(field.get(record), visitor);
+    }
+  });
+}
+
+}  // namespace detail
+
+// Visits all values of a record that are stored in files of the given version, in file order. The
+// order is generated from the field tables: first all floating point values, then all other
+// values, each in the order of the FieldTable<Record> fields.
+template <typename TRecord, typename TVisitor>
+void visitFields(TRecord& record, uint32_t version, TVisitor& visitor) {
+  detail::visitLogRecordValues<true>(record, version, visitor);
+  detail::visitLogRecordValues<false>(record, version, visitor);
+}
+
+// Size of a record in a log file of the given version.
+size_t logRecordSize(uint32_t version);
+
+// Offsets of the robot time and host time within a record of the given version.
+size_t logRecordTimeOffset(uint32_t version);
+size_t logRecordHostTimeOffset(uint32_t version);
+
+// Offset within a record of the floating point robot state value at the given byte offset within
+// RobotState. The robot state is stored at the same offsets in all versions. Throws
+// std::invalid_argument if the value is not stored.
+size_t logRecordFieldOffset(size_t state_offset);
+
+// Checks the header and returns the file version. Throws LogFileException if the header is
+// invalid or the version is not supported.
+uint32_t decodeLogFileHeader(const char* data, size_t size);
+
+void encodeLogRecord(const Record& record, std::chrono::nanoseconds host_time, char* data);
+void decodeLogRecord(const char* data,
+                     uint32_t version,
+                     Record* record,
+                     std::chrono::nanoseconds* host_time);
+
+}  // namespace franka
@@ -0,0 +1,203 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/log_merge.h>
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <limits>
+#include <queue>
+#include <utility>
+
+#include <franka/exception.h>
+
+namespace franka {
+
+namespace {
+
+template <size_t N>
+void addColumns(const std::string& prefix,
+                const std::string& name,
+                std::vector<std::string>* columns) {
+  for (size_t i = 0; i < N; i++) {
+    columns->push_back(prefix + "." + name + "[" + std::to_string(i) + "]");
+  }
+}
+
+template <size_t N>
+void addValues(const std::array<double, N>& array, std::vector<double>* values) {
+  values->insert(values->end(), array.cbegin(), array.cend());
+}
+
+std::chrono::nanoseconds alignedHostTime(ClockAlignment* alignment,
+                                         Duration device_time,
+                                         std::chrono::nanoseconds received,
+                                         std::chrono::nanoseconds* last_host_time) {
+  if (received.count() != 0) {
+    alignment->update(device_time, received);
+  }
+  // The offset estimate can only decrease, so keep the timeline of a source monotonic.
+  *last_host_time = std::max(alignment->toHostTime(device_time), *last_host_time);
+  return *last_host_time;
+}
+
+struct Head {
+  std::chrono::nanoseconds host_time;
+  size_t source;
+};
+
+struct Later {
+  bool operator()(const Head& lhs, const Head& rhs) const noexcept {
+    return lhs.host_time > rhs.host_time ||
+           (lhs.host_time == rhs.host_time && lhs.source > rhs.source);
+  }
+};
+
+}  // anonymous namespace
+
+void ClockAlignment::update(Duration device_time, std::chrono::nanoseconds host_time) noexcept {
+  std::chrono::nanoseconds offset = host_time - std::chrono::milliseconds(device_time.toMSec());
+  if (!valid_ || offset < offset_) {
+    offset_ = offset;
+    valid_ = true;
+  }
+}
+
+bool ClockAlignment::valid() const noexcept {
+  return valid_;
+}
+
+std::chrono::nanoseconds ClockAlignment::toHostTime(Duration device_time) const noexcept {
+  return std::chrono::milliseconds(device_time.toMSec()) + offset_;
+}
+
+void ClockAlignment::reset() noexcept {
+  valid_ = false;
+  offset_ = std::chrono::nanoseconds(0);
+}
+
+RobotStateSource::RobotStateSource(const std::string& name, ReadFunction read)
+    : read_(std::move(read)), last_host_time_(std::chrono::nanoseconds::min()) {
+  columns_.push_back(name + ".time");
+  columns_.push_back(name + ".control_command_success_rate");
+  addColumns<7>(name, "q", &columns_);
+  addColumns<7>(name, "q_d", &columns_);
+  addColumns<7>(name, "dq", &columns_);
+  addColumns<7>(name, "dq_d", &columns_);
+  addColumns<7>(name, "tau_J", &columns_);
+  addColumns<7>(name, "tau_ext_hat_filtered", &columns_);
+  addColumns<16>(name, "O_T_EE", &columns_);
+  addColumns<6>(name, "O_F_ext_hat_K", &columns_);
+}
+
+RobotStateSource::RobotStateSource(const std::string& name, LogFileReader& reader)
+    : RobotStateSource(name, [&reader](RobotState* state, std::chrono::nanoseconds* host_time) {
+        Record record;
+        if (!reader.read(&record, host_time)) {
+          return false;
+        }
+        *state = record.state;
+        return true;
+      }) {}
+
+const std::vector<std::string>& RobotStateSource::columns() const noexcept {
+  return columns_;
+}
+
+bool RobotStateSource::next(std::chrono::nanoseconds* host_time, std::vector<double>* values) {
+  std::chrono::nanoseconds received(0);
+  if (!read_(&state_, &received)) {
+    return false;
+  }
+  *host_time = alignedHostTime(&alignment_, state_.time, received, &last_host_time_);
+
+  values->clear();
+  values->push_back(static_cast<double>(state_.time.toMSec()));
+  values->push_back(state_.control_command_success_rate);
+  addValues(state_.q, values);
+  addValues(state_.q_d, values);
+  addValues(state_.dq, values);
+  addValues(state_.dq_d, values);
+  addValues(state_.tau_J, values);
+  addValues(state_.tau_ext_hat_filtered, values);
+  addValues(state_.O_T_EE, values);
+  addValues(state_.O_F_ext_hat_K, values);
+  return true;
+}
+
+GripperStateSource::GripperStateSource(const std::string& name, ReadFunction read)
+    : read_(std::move(read)),
+      columns_{name + ".time", name + ".width", name + ".max_width", name + ".is_grasped",
+               name + ".temperature"},
+      last_host_time_(std::chrono::nanoseconds::min()) {}
+
+const std::vector<std::string>& GripperStateSource::columns() const noexcept {
+  return columns_;
+}
+
+bool GripperStateSource::next(std::chrono::nanoseconds* host_time, std::vector<double>* values) {
+  std::chrono::nanoseconds received(0);
+  if (!read_(&state_, &received)) {
+    return false;
+  }
+  *host_time = alignedHostTime(&alignment_, state_.time, received, &last_host_time_);
+
+  values->assign({static_cast<double>(state_.time.toMSec()), state_.width, state_.max_width,
+                  state_.is_grasped ? 1.0 : 0.0, static_cast<double>(state_.temperature)});
+  return true;
+}
+
+size_t mergeLogs(const std::vector<LogSource*>& sources, std::ostream& output) {
+  std::vector<std::vector<double>> current(sources.size());
+  std::vector<std::vector<double>> pending(sources.size());
+  std::vector<bool> has_sample(sources.size(), false);
+  std::priority_queue<Head, std::vector<Head>, Later> heads;
+
+  output << "host_time";
+  for (size_t i = 0; i < sources.size(); i++) {
+    for (const std::string& column : sources[i]->columns()) {
+      output << "," << column;
+    }
+    Head head{std::chrono::nanoseconds(0), i};
+    if (sources[i]->next(&head.host_time, &pending[i])) {
+      heads.push(head);
+    }
+  }
+  output << std::endl;
+  output << std::setprecision(std::numeric_limits<double>::digits10);
+
+  size_t rows = 0;
+  while (!heads.empty()) {
+    Head head = heads.top();
+    heads.pop();
+    std::swap(current[head.source], pending[head.source]);
+    has_sample[head.source] = true;
+
+    output << head.host_time.count();
+    for (size_t i = 0; i < sources.size(); i++) {
+      if (has_sample[i]) {
+        for (double value : current[i]) {
+          output << "," << value;
+        }
+      } else {
+        for (size_t j = 0; j < sources[i]->columns().size(); j++) {
+          output << ",";
+        }
+      }
+    }
+    output << '\n';
+    rows++;
+
+    if (sources[head.source]->next(&head.host_time, &pending[head.source])) {
+      heads.push(head);
+    }
+  }
+
+  output.flush();
+  if (!output) {
+    throw LogFileException("libfranka: Could not write merged log.");
+  }
+  return rows;
+}
+
+}  // namespace franka
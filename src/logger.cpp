@@ -7,6 +7,7 @@ namespace franka {
 Logger::Logger(size_t log_size) : log_size_(log_size) {
   states_.resize(log_size);
   commands_.resize(log_size);
+  records_.reserve(log_size);
 }
 
 void Logger::log(const RobotState& state, const research_interface::robot::RobotCommand& command) {
@@ -22,27 +23,44 @@ void Logger::log(const RobotState& state, const research_interface::robot::Robot
 }
 
 std::vector<Record> Logger::flush() {
-  std::vector<Record> log;
+  // No-op unless the reserved memory has been handed out by a previous flush.
+  records_.reserve(log_size_);
 
   for (size_t i = 0; i < ring_size_; i++) {
     size_t wrapped_index = (ring_front_ + i) % ring_size_;
 
-    RobotCommand command;
-    command.joint_positions = commands_[wrapped_index].motion.q_c;
-    command.joint_velocities = commands_[wrapped_index].motion.dq_c;
+    records_.emplace_back();
+    Record& record = records_.back();
+    record.state = states_[wrapped_index];
+    RobotCommand& command = record.command;
+    command.joint_positions.q = commands_[wrapped_index].motion.q_c;
+    command.joint_velocities.dq = commands_[wrapped_index].motion.dq_c;
     command.cartesian_pose.O_T_EE = commands_[wrapped_index].motion.O_T_EE_c;
     command.cartesian_velocities.O_dP_EE = commands_[wrapped_index].motion.O_dP_EE_c;
     command.torques.tau_J = commands_[wrapped_index].control.tau_J_d;
-
-    Record record;
-    record.state = states_[wrapped_index];
-    record.command = command;
-    log.push_back(record);
+    if (record_joint_power_) {
+      for (size_t j = 0; j < record.joint_power.size(); j++) {
+        record.joint_power[j] = record.state.tau_J[j] * record.state.dq[j];
+      }
+    }
   }
 
   ring_front_ = 0;
   ring_size_ = 0;
+
+  std::vector<Record> log;
+  log.swap(records_);
   return log;
 }
 
+void Logger::setRecordJointPower(bool record_joint_power) noexcept {
+  record_joint_power_ = record_joint_power;
+}
+
+void Logger::clear() {
+  ring_front_ = 0;
+  ring_size_ = 0;
+  records_.reserve(log_size_);
+}
+
 }  // namespace franka
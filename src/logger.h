@@ -18,13 +18,22 @@ class Logger {
 
   void log(const RobotState& state, const research_interface::robot::RobotCommand& command);
 
+  // Does not allocate if clear() has been called since the last flush.
   std::vector<franka::Record> flush();
 
+  // Empties the log and reserves memory for the next flush.
+  void clear();
+
+  // Sets whether flushed records contain the joint power.
+  void setRecordJointPower(bool record_joint_power) noexcept;
+
  private:
+  std::vector<franka::Record> records_;
   std::vector<RobotState> states_;
   std::vector<research_interface::robot::RobotCommand> commands_;
   size_t ring_front_{0};
   size_t ring_size_{0};
+  bool record_joint_power_{false};
 
   const size_t log_size_;  // NOLINT(readability-identifier-naming)
 };
@@ -0,0 +1,32 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/lowpass_filter.h>
+
+#include <Eigen/Dense>
+
+namespace franka {
+
+std::array<double, 16> cartesianLowpassFilter(double sample_time,
+                                              const std::array<double, 16>& y,
+                                              const std::array<double, 16>& y_last,
+                                              double cutoff_frequency) {
+  double gain = sample_time / (sample_time + (1.0 / (2.0 * M_PI * cutoff_frequency)));
+  Eigen::Affine3d transform(Eigen::Matrix4d::Map(y.data()));
+  Eigen::Affine3d transform_last(Eigen::Matrix4d::Map(y_last.data()));
+
+  Eigen::Quaterniond orientation(transform.linear());
+  Eigen::Quaterniond orientation_last(transform_last.linear());
+  orientation.normalize();
+  orientation_last.normalize();
+
+  Eigen::Affine3d filtered_transform = Eigen::Affine3d::Identity();
+  filtered_transform.translation() =
+      gain * transform.translation() + (1.0 - gain) * transform_last.translation();
+  filtered_transform.linear() = orientation_last.slerp(gain, orientation).toRotationMatrix();
+
+  std::array<double, 16> filtered{};
+  Eigen::Map<Eigen::Matrix4d>(filtered.data()) = filtered_transform.matrix();
+  return filtered;
+}
+
+}  // namespace franka
@@ -0,0 +1,41 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace franka {
+
+// Lock-free mailbox holding the latest value written by a single writer thread for a single
+// reader thread. Values which are overwritten before being read are dropped.
+template <typename T>
+class Mailbox {
+ public:
+  void write(const T& value) noexcept {
+    slots_[back_] = value;
+    back_ = middle_.exchange(back_ | kNewData, std::memory_order_acq_rel) & kIndexMask;
+  }
+
+  // Returns false if no value has been written since the last read.
+  bool read(T* value) noexcept {
+    if ((middle_.load(std::memory_order_relaxed) & kNewData) == 0) {
+      return false;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    *value = slots_[front_];
+    return true;
+  }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kNewData = 0x4;
+
+  std::array<T, 3> slots_{};
+  std::atomic<uint8_t> middle_{1};
+  uint8_t back_{0};
+  uint8_t front_{2};
+};
+
+}  // namespace franka
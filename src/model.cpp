@@ -23,6 +23,9 @@ Frame operator++(Frame& frame, int /* dummy */) noexcept {
 
 Model::Model(Network& network) : library_{new ModelLibrary(network)} {}
 
+Model::Model(const std::string& model_library_path)
+    : library_{new ModelLibrary(model_library_path)} {}
+
 // Has to be declared here, as the ModelLibrary type is incomplete in the header
 Model::~Model() noexcept = default;
 Model::Model(Model&&) noexcept = default;
@@ -239,4 +242,15 @@ std::array<double, 7> franka::Model::gravity(
   return output;
 }
 
+void Model::computeQuantities(const franka::RobotState& robot_state,
+                              ModelQuantities* quantities) const noexcept {
+  library_->zero_jacobian_ee(robot_state.q.data(), robot_state.F_T_EE.data(),
+                             quantities->zero_jacobian.data());
+  library_->mass(robot_state.q.data(), robot_state.I_total.data(), robot_state.m_total,
+                 robot_state.F_x_Ctotal.data(), quantities->mass.data());
+  library_->coriolis(robot_state.q.data(), robot_state.dq.data(), robot_state.I_total.data(),
+                     robot_state.m_total, robot_state.F_x_Ctotal.data(),
+                     quantities->coriolis.data());
+}
+
 }  // namespace franka
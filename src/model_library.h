@@ -3,6 +3,7 @@
 #pragma once
 
 #include <functional>
+#include <string>
 
 #include "libfcimodels.h"
 #include "library_loader.h"
@@ -13,6 +14,7 @@ namespace franka {
 class ModelLibrary {
  public:
   ModelLibrary(Network& network);
+  explicit ModelLibrary(const std::string& path);
 
  private:
   LibraryLoader loader_;
@@ -0,0 +1,224 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/motion_statistics.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace franka {
+
+namespace {
+
+inline double rotationAngle(const std::array<double, 16>& a, const std::array<double, 16>& b) {
+  // trace(R_a^T * R_b) is the Frobenius inner product of the two rotation matrices.
+  double trace = 0.0;
+  for (size_t column = 0; column < 3; column++) {
+    for (size_t row = 0; row < 3; row++) {
+      trace += a[column * 4 + row] * b[column * 4 + row];
+    }
+  }
+  return std::acos(std::max(std::min((trace - 1.0) / 2.0, 1.0), -1.0));
+}
+
+}  // anonymous namespace
+
+StreamingQuantile::StreamingQuantile(double quantile) noexcept : quantile_(quantile) {}
+
+void StreamingQuantile::add(double value) noexcept {
+  if (count_ < heights_.size()) {
+    heights_[count_++] = value;
+    if (count_ == heights_.size()) {
+      std::sort(heights_.begin(), heights_.end());
+      positions_ = {{1.0, 2.0, 3.0, 4.0, 5.0}};
+      desired_positions_ = {
+          {1.0, 1.0 + 2.0 * quantile_, 1.0 + 4.0 * quantile_, 3.0 + 2.0 * quantile_, 5.0}};
+    }
+    return;
+  }
+
+  // Find the cell k with heights_[k] <= value < heights_[k + 1] and update the extreme markers.
+  size_t k = 0;
+  if (value < heights_[0]) {
+    heights_[0] = value;
+  } else if (value >= heights_[4]) {
+    heights_[4] = value;
+    k = 3;
+  } else {
+    while (value >= heights_[k + 1]) {
+      k++;
+    }
+  }
+
+  for (size_t i = k + 1; i < positions_.size(); i++) {
+    positions_[i] += 1.0;
+  }
+  const std::array<double, 5> increments{
+      {0.0, quantile_ / 2.0, quantile_, (1.0 + quantile_) / 2.0, 1.0}};
+  for (size_t i = 0; i < desired_positions_.size(); i++) {
+    desired_positions_[i] += increments[i];
+  }
+
+  // Adjust the heights of the middle markers if they are off their desired positions.
+  for (size_t i = 1; i < 4; i++) {
+    double delta = desired_positions_[i] - positions_[i];
+    if ((delta >= 1.0 && positions_[i + 1] - positions_[i] > 1.0) ||
+        (delta <= -1.0 && positions_[i - 1] - positions_[i] < -1.0)) {
+      double sign = delta >= 0.0 ? 1.0 : -1.0;
+      double parabolic =
+          heights_[i] +
+          sign / (positions_[i + 1] - positions_[i - 1]) *
+              ((positions_[i] - positions_[i - 1] + sign) * (heights_[i + 1] - heights_[i]) /
+                   (positions_[i + 1] - positions_[i]) +
+               (positions_[i + 1] - positions_[i] - sign) * (heights_[i] - heights_[i - 1]) /
+                   (positions_[i] - positions_[i - 1]));
+      if (heights_[i - 1] < parabolic && parabolic < heights_[i + 1]) {
+        heights_[i] = parabolic;
+      } else {
+        size_t neighbor = sign > 0.0 ? i + 1 : i - 1;
+        heights_[i] += sign * (heights_[neighbor] - heights_[i]) /
+                       (positions_[neighbor] - positions_[i]);
+      }
+      positions_[i] += sign;
+    }
+  }
+  count_++;
+}
+
+double StreamingQuantile::value() const noexcept {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  if (count_ < heights_.size()) {
+    std::array<double, 5> sorted = heights_;
+    std::sort(sorted.begin(), sorted.begin() + count_);
+    return sorted[static_cast<size_t>(std::round(quantile_ * (count_ - 1)))];
+  }
+  return heights_[2];
+}
+
+void StreamingQuantile::reset() noexcept {
+  count_ = 0;
+}
+
+MotionStatisticsAccumulator::ErrorAccumulator::ErrorAccumulator() noexcept
+    : max(0.0), sum_of_squares(0.0), p50(0.5), p95(0.95), p99(0.99) {}
+
+void MotionStatisticsAccumulator::ErrorAccumulator::add(double error) noexcept {
+  max = std::max(max, error);
+  sum_of_squares += error * error;
+  p50.add(error);
+  p95.add(error);
+  p99.add(error);
+}
+
+ErrorStatistics MotionStatisticsAccumulator::ErrorAccumulator::statistics(uint64_t samples) const
+    noexcept {
+  ErrorStatistics statistics;
+  if (samples > 0) {
+    statistics.max = max;
+    statistics.rms = std::sqrt(sum_of_squares / samples);
+    statistics.p50 = p50.value();
+    statistics.p95 = p95.value();
+    statistics.p99 = p99.value();
+  }
+  return statistics;
+}
+
+void MotionStatisticsAccumulator::ErrorAccumulator::reset() noexcept {
+  max = 0.0;
+  sum_of_squares = 0.0;
+  p50.reset();
+  p95.reset();
+  p99.reset();
+}
+
+MotionStatisticsAccumulator::MotionStatisticsAccumulator() noexcept = default;
+
+void MotionStatisticsAccumulator::update(const RobotState& robot_state) noexcept {
+  if (samples_ > 0 && robot_state.time > last_time_) {
+    uint64_t elapsed_cycles = (robot_state.time - last_time_).toMSec();
+    lost_cycles_ += elapsed_cycles - 1;
+
+    // Differentiate the commanded accelerations; the loops have fixed bounds and no branches,
+    // so that they are vectorized across joints.
+    const double rate = 1.0 / (elapsed_cycles * 1e-3);
+    std::array<double, 7> joint_jerk{};
+    for (size_t i = 0; i < 7; i++) {
+      joint_jerk[i] = std::abs(robot_state.ddq_d[i] - last_ddq_d_[i]) * rate;
+    }
+    for (size_t i = 0; i < 7; i++) {
+      peak_joint_jerk_[i] = std::max(peak_joint_jerk_[i], joint_jerk[i]);
+    }
+
+    std::array<double, 6> cartesian_jerk{};
+    for (size_t i = 0; i < 6; i++) {
+      cartesian_jerk[i] = (robot_state.O_ddP_EE_c[i] - last_O_ddP_EE_c_[i]) * rate;
+    }
+    peak_translational_jerk_ =
+        std::max(peak_translational_jerk_,
+                 std::sqrt(cartesian_jerk[0] * cartesian_jerk[0] +
+                           cartesian_jerk[1] * cartesian_jerk[1] +
+                           cartesian_jerk[2] * cartesian_jerk[2]));
+    peak_rotational_jerk_ =
+        std::max(peak_rotational_jerk_,
+                 std::sqrt(cartesian_jerk[3] * cartesian_jerk[3] +
+                           cartesian_jerk[4] * cartesian_jerk[4] +
+                           cartesian_jerk[5] * cartesian_jerk[5]));
+  } else if (samples_ == 0) {
+    first_time_ = robot_state.time;
+  }
+  last_time_ = robot_state.time;
+  last_ddq_d_ = robot_state.ddq_d;
+  last_O_ddP_EE_c_ = robot_state.O_ddP_EE_c;
+
+  std::array<double, 7> joint_error{};
+  for (size_t i = 0; i < 7; i++) {
+    joint_error[i] = std::abs(robot_state.q_d[i] - robot_state.q[i]);
+  }
+  for (size_t i = 0; i < 7; i++) {
+    joint_position_error_[i].add(joint_error[i]);
+  }
+
+  double dx = robot_state.O_T_EE_d[12] - robot_state.O_T_EE[12];
+  double dy = robot_state.O_T_EE_d[13] - robot_state.O_T_EE[13];
+  double dz = robot_state.O_T_EE_d[14] - robot_state.O_T_EE[14];
+  translational_error_.add(std::sqrt(dx * dx + dy * dy + dz * dz));
+  rotational_error_.add(rotationAngle(robot_state.O_T_EE_d, robot_state.O_T_EE));
+
+  samples_++;
+}
+
+MotionStatistics MotionStatisticsAccumulator::statistics() const noexcept {
+  MotionStatistics statistics;
+  for (size_t i = 0; i < 7; i++) {
+    statistics.joint_position_error[i] = joint_position_error_[i].statistics(samples_);
+  }
+  statistics.translational_error = translational_error_.statistics(samples_);
+  statistics.rotational_error = rotational_error_.statistics(samples_);
+  statistics.peak_joint_jerk = peak_joint_jerk_;
+  statistics.peak_translational_jerk = peak_translational_jerk_;
+  statistics.peak_rotational_jerk = peak_rotational_jerk_;
+  statistics.samples = samples_;
+  statistics.lost_cycles = lost_cycles_;
+  statistics.duration = last_time_ - first_time_;
+  return statistics;
+}
+
+void MotionStatisticsAccumulator::reset() noexcept {
+  for (ErrorAccumulator& accumulator : joint_position_error_) {
+    accumulator.reset();
+  }
+  translational_error_.reset();
+  rotational_error_.reset();
+  peak_joint_jerk_ = {};
+  peak_translational_jerk_ = 0.0;
+  peak_rotational_jerk_ = 0.0;
+  last_ddq_d_ = {};
+  last_O_ddP_EE_c_ = {};
+  samples_ = 0;
+  lost_cycles_ = 0;
+  first_time_ = Duration();
+  last_time_ = Duration();
+}
+
+}  // namespace franka
@@ -0,0 +1,69 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace franka {
+
+// Returns the number of worker threads for the requested number, or one per core if it is zero.
+inline size_t parallelWorkerCount(size_t threads) noexcept {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  return std::max<size_t>(threads, 1);
+}
+
+// Returns the number of worker threads that parallelFor uses for the given number of items.
+inline size_t parallelWorkerCount(size_t threads, size_t count) noexcept {
+  return std::min(parallelWorkerCount(threads), std::max<size_t>(count, 1));
+}
+
+// Calls body(worker, index) for each index in [0, count) from parallelWorkerCount(threads, count)
+// workers, one of them being the calling thread. Workers are numbered from zero and fetch one
+// index at a time, so that items of different cost are balanced. After the first exception, no
+// further items are started, and the exception is rethrown once all workers have finished.
+template <typename TBody>
+void parallelFor(size_t count, size_t threads, const TBody& body) {
+  std::atomic<size_t> next_index{0};
+  std::atomic<bool> failed{false};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  auto work = [&](size_t worker) {
+    try {
+      for (size_t index = next_index++; index < count && !failed; index = next_index++) {
+        body(worker, index);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      failed = true;
+    }
+  };
+
+  size_t worker_count = parallelWorkerCount(threads, count);
+  std::vector<std::thread> workers;
+  workers.reserve(worker_count - 1);
+  for (size_t worker = 1; worker < worker_count; worker++) {
+    workers.emplace_back(work, worker);
+  }
+  work(0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace franka
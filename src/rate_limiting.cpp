@@ -57,14 +57,7 @@ Eigen::Vector3d limitRate(double max_velocity,
 std::array<double, 7> limitRate(const std::array<double, 7>& max_derivatives,
                                 const std::array<double, 7>& commanded_values,
                                 const std::array<double, 7>& last_commanded_values) {
-  std::array<double, 7> limited_values{};
-  for (size_t i = 0; i < 7; i++) {
-    double commanded_derivative = (commanded_values[i] - last_commanded_values[i]) / kDeltaT;
-    limited_values[i] =
-        last_commanded_values[i] +
-        std::max(std::min(commanded_derivative, max_derivatives[i]), -max_derivatives[i]) * kDeltaT;
-  }
-  return limited_values;
+  return limitRate<7>(max_derivatives, commanded_values, last_commanded_values);
 }
 
 double limitRate(double max_velocity,
@@ -114,14 +107,8 @@ std::array<double, 7> limitRate(const std::array<double, 7>& max_velocity,
                                 const std::array<double, 7>& commanded_velocities,
                                 const std::array<double, 7>& last_commanded_velocities,
                                 const std::array<double, 7>& last_commanded_accelerations) {
-  std::array<double, 7> limited_commanded_velocities{};
-
-  for (size_t i = 0; i < 7; i++) {
-    limited_commanded_velocities[i] =
-        limitRate(max_velocity[i], max_acceleration[i], max_jerk[i], commanded_velocities[i],
-                  last_commanded_velocities[i], last_commanded_accelerations[i]);
-  }
-  return limited_commanded_velocities;
+  return limitRate<7>(max_velocity, max_acceleration, max_jerk, commanded_velocities,
+                      last_commanded_velocities, last_commanded_accelerations);
 }
 
 std::array<double, 7> limitRate(const std::array<double, 7>& max_velocity,
@@ -131,13 +118,9 @@ std::array<double, 7> limitRate(const std::array<double, 7>& max_velocity,
                                 const std::array<double, 7>& last_commanded_positions,
                                 const std::array<double, 7>& last_commanded_velocities,
                                 const std::array<double, 7>& last_commanded_accelerations) {
-  std::array<double, 7> limited_commanded_positions{};
-  for (size_t i = 0; i < 7; i++) {
-    limited_commanded_positions[i] = limitRate(
-        max_velocity[i], max_acceleration[i], max_jerk[i], commanded_positions[i],
-        last_commanded_positions[i], last_commanded_velocities[i], last_commanded_accelerations[i]);
-  }
-  return limited_commanded_positions;
+  return limitRate<7>(max_velocity, max_acceleration, max_jerk, commanded_positions,
+                      last_commanded_positions, last_commanded_velocities,
+                      last_commanded_accelerations);
 }
 
 std::array<double, 6> limitRate(
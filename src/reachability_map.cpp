@@ -0,0 +1,401 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/reachability_map.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <Poco/Exception.h>
+#include <Poco/File.h>
+#include <Poco/SharedMemory.h>
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+#include <franka/exception.h>
+#include <franka/inverse_kinematics.h>
+#include <franka/kinematics.h>
+#include <franka/robot_traits.h>
+
+#include "parallel_for.h"
+
+namespace franka {
+
+namespace {
+
+constexpr std::array<char, 4> kReachabilityMapMagic{{'F', 'R', 'R', 'M'}};
+constexpr uint32_t kReachabilityMapVersion = 1;
+
+// Magic, version, workspace minimum, resolution, voxels per axis, bins, q7 samples, end effector
+// and maximum manipulability.
+constexpr size_t kReachabilityMapHeaderSize = kReachabilityMapMagic.size() + sizeof(uint32_t) +
+                                              4 * sizeof(double) + 7 * sizeof(uint32_t) +
+                                              17 * sizeof(double);
+
+// Each cell is stored as one byte: zero if it is not reachable, otherwise one plus its
+// manipulability quantized to kLevels steps of the maximum manipulability.
+constexpr double kLevels = 254.0;
+
+constexpr std::array<double, 16> kIdentity{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+
+void checkParameters(const ReachabilityMapParameters& parameters) {
+  for (size_t i = 0; i < 3; i++) {
+    if (!(parameters.workspace_minimum[i] < parameters.workspace_maximum[i])) {
+      throw std::invalid_argument("libfranka: Reachability map workspace is empty.");
+    }
+  }
+  if (!(parameters.resolution > 0.0) || !std::isfinite(parameters.resolution)) {
+    throw std::invalid_argument("libfranka: Reachability map resolution must be positive.");
+  }
+  if (parameters.polar_bins == 0 || parameters.azimuth_bins == 0 || parameters.roll_bins == 0 ||
+      parameters.q7_samples == 0) {
+    throw std::invalid_argument(
+        "libfranka: Reachability map bins and q7 samples must not be zero.");
+  }
+  for (size_t i = 0; i < 3; i++) {
+    if (!std::isfinite(parameters.workspace_minimum[i]) ||
+        !std::isfinite(parameters.workspace_maximum[i]) ||
+        (parameters.workspace_maximum[i] - parameters.workspace_minimum[i]) /
+                parameters.resolution >
+            std::numeric_limits<uint32_t>::max()) {
+      throw std::invalid_argument("libfranka: Reachability map workspace is too large.");
+    }
+  }
+}
+
+// Index of the bin of a value in [minimum, minimum + range].
+size_t bin(double value, double minimum, double range, size_t bins) noexcept {
+  double index = std::floor((value - minimum) / range * static_cast<double>(bins));
+  return static_cast<size_t>(std::min(std::max(index, 0.0), static_cast<double>(bins - 1)));
+}
+
+// Center of a bin of [minimum, minimum + range].
+double binCenter(size_t index, double minimum, double range, size_t bins) noexcept {
+  return minimum + range * (static_cast<double>(index) + 0.5) / static_cast<double>(bins);
+}
+
+// Tangent directions of increasing polar angle and azimuth at an approach direction, which are
+// the reference for the rotation about it.
+void tangents(double cos_theta,
+              double sin_theta,
+              double phi,
+              std::array<double, 3>* e_theta,
+              std::array<double, 3>* e_phi) noexcept {
+  *e_theta = {{cos_theta * std::cos(phi), cos_theta * std::sin(phi), -sin_theta}};
+  *e_phi = {{-std::sin(phi), std::cos(phi), 0.0}};
+}
+
+}  // anonymous namespace
+
+struct ReachabilityMap::Impl {
+  ReachabilityMapParameters parameters;
+  std::array<size_t, 3> size;
+  size_t voxel_count;
+  size_t orientation_count;
+  double maximum_manipulability;
+
+  // Fraction of reachable orientations and best cell of each voxel, followed by the cells of each
+  // voxel. Point into data or into the memory-mapped file.
+  const uint8_t* voxel_reachability;
+  const uint8_t* voxel_manipulability;
+  const uint8_t* cells;
+
+  std::vector<uint8_t> data;
+  Poco::SharedMemory memory;
+
+  void setSize() noexcept {
+    for (size_t i = 0; i < 3; i++) {
+      size[i] = std::max<size_t>(
+          1, static_cast<size_t>(std::ceil(
+                 (parameters.workspace_maximum[i] - parameters.workspace_minimum[i]) /
+                     parameters.resolution -
+                 1e-9)));
+      parameters.workspace_maximum[i] =
+          parameters.workspace_minimum[i] + static_cast<double>(size[i]) * parameters.resolution;
+    }
+    voxel_count = size[0] * size[1] * size[2];
+    orientation_count = parameters.polar_bins * parameters.azimuth_bins * parameters.roll_bins;
+  }
+
+  void setData(const uint8_t* begin) noexcept {
+    voxel_reachability = begin;
+    voxel_manipulability = begin + voxel_count;
+    cells = begin + 2 * voxel_count;
+  }
+
+  size_t dataSize() const noexcept { return voxel_count * (2 + orientation_count); }
+
+  bool voxel(const std::array<double, 3>& position, size_t* index) const noexcept {
+    std::array<size_t, 3> cell;
+    for (size_t i = 0; i < 3; i++) {
+      double value = std::floor((position[i] - parameters.workspace_minimum[i]) /
+                                parameters.resolution);
+      // Also rejects NaN.
+      if (!(value >= 0.0 && value < static_cast<double>(size[i]))) {
+        return false;
+      }
+      cell[i] = static_cast<size_t>(value);
+    }
+    *index = (cell[2] * size[1] + cell[1]) * size[0] + cell[0];
+    return true;
+  }
+
+  std::array<double, 3> voxelCenter(size_t index) const noexcept {
+    std::array<double, 3> center;
+    for (size_t i = 0; i < 3; i++) {
+      center[i] = binCenter(index % size[i], parameters.workspace_minimum[i],
+                            static_cast<double>(size[i]) * parameters.resolution, size[i]);
+      index /= size[i];
+    }
+    return center;
+  }
+
+  size_t orientation(const std::array<double, 16>& pose) const noexcept {
+    double cos_theta = std::max(std::min(pose[10], 1.0), -1.0);
+    double sin_theta = std::sqrt(1.0 - cos_theta * cos_theta);
+    double phi = std::atan2(pose[9], pose[8]);
+    std::array<double, 3> e_theta;
+    std::array<double, 3> e_phi;
+    tangents(cos_theta, sin_theta, phi, &e_theta, &e_phi);
+    double psi = std::atan2(pose[0] * e_phi[0] + pose[1] * e_phi[1] + pose[2] * e_phi[2],
+                            pose[0] * e_theta[0] + pose[1] * e_theta[1] + pose[2] * e_theta[2]);
+    size_t polar = bin(cos_theta, -1.0, 2.0, parameters.polar_bins);
+    size_t azimuth = bin(phi, -M_PI, 2.0 * M_PI, parameters.azimuth_bins);
+    size_t roll = bin(psi, -M_PI, 2.0 * M_PI, parameters.roll_bins);
+    return (polar * parameters.azimuth_bins + azimuth) * parameters.roll_bins + roll;
+  }
+
+  // Pose at the center of the given voxel and orientation bin.
+  std::array<double, 16> cellPose(size_t voxel, size_t orientation) const noexcept {
+    size_t roll = orientation % parameters.roll_bins;
+    size_t azimuth = (orientation / parameters.roll_bins) % parameters.azimuth_bins;
+    size_t polar = orientation / parameters.roll_bins / parameters.azimuth_bins;
+    double cos_theta = binCenter(polar, -1.0, 2.0, parameters.polar_bins);
+    double sin_theta = std::sqrt(1.0 - cos_theta * cos_theta);
+    double phi = binCenter(azimuth, -M_PI, 2.0 * M_PI, parameters.azimuth_bins);
+    double psi = binCenter(roll, -M_PI, 2.0 * M_PI, parameters.roll_bins);
+    std::array<double, 3> e_theta;
+    std::array<double, 3> e_phi;
+    tangents(cos_theta, sin_theta, phi, &e_theta, &e_phi);
+
+    std::array<double, 3> x;
+    std::array<double, 3> z{{sin_theta * std::cos(phi), sin_theta * std::sin(phi), cos_theta}};
+    for (size_t i = 0; i < 3; i++) {
+      x[i] = std::cos(psi) * e_theta[i] + std::sin(psi) * e_phi[i];
+    }
+    std::array<double, 3> center = voxelCenter(voxel);
+    return {{x[0], x[1], x[2], 0.0, z[1] * x[2] - z[2] * x[1], z[2] * x[0] - z[0] * x[2],
+             z[0] * x[1] - z[1] * x[0], 0.0, z[0], z[1], z[2], 0.0, center[0], center[1],
+             center[2], 1.0}};
+  }
+
+  double decode(uint8_t value) const noexcept {
+    return value == 0 ? 0.0 : (value - 1) / kLevels * maximum_manipulability;
+  }
+};
+
+ReachabilityMap::ReachabilityMap() : impl_(new Impl) {}
+
+ReachabilityMap ReachabilityMap::generate(const ReachabilityMapParameters& parameters,
+                                          size_t threads) {
+  checkParameters(parameters);
+  ReachabilityMap map;
+  Impl& impl = *map.impl_;
+  impl.parameters = parameters;
+  impl.setSize();
+
+  std::vector<double> q7(parameters.q7_samples);
+  for (size_t i = 0; i < q7.size(); i++) {
+    q7[i] = binCenter(i, PandaTraits::minJointPosition()[6],
+                      PandaTraits::maxJointPosition()[6] - PandaTraits::minJointPosition()[6],
+                      q7.size());
+  }
+
+  // Best manipulability of each cell, or -1 if it is not reachable.
+  std::vector<float> manipulability(impl.voxel_count * impl.orientation_count);
+  InverseKinematics inverse_kinematics(parameters.F_T_EE);
+  Kinematics kinematics;
+
+  std::vector<std::vector<std::array<double, 7>>> solutions(
+      parallelWorkerCount(threads, impl.voxel_count));
+  for (std::vector<std::array<double, 7>>& worker_solutions : solutions) {
+    worker_solutions.reserve(q7.size() * InverseKinematics::kMaxSolutions);
+  }
+  parallelFor(impl.voxel_count, threads, [&](size_t worker, size_t voxel) {
+    float* cells = &manipulability[voxel * impl.orientation_count];
+    for (size_t orientation = 0; orientation < impl.orientation_count; orientation++) {
+      inverse_kinematics.solve(impl.cellPose(voxel, orientation), q7, &solutions[worker]);
+      double best = -1.0;
+      for (const std::array<double, 7>& q : solutions[worker]) {
+        std::array<double, 42> jacobian =
+            kinematics.zeroJacobian(Frame::kEndEffector, q, parameters.F_T_EE, kIdentity);
+        Eigen::Map<const Eigen::Matrix<double, 6, 7>> jacobian_matrix(jacobian.data());
+        Eigen::Matrix<double, 6, 6> product = jacobian_matrix * jacobian_matrix.transpose();
+        best = std::max(best, std::sqrt(std::max(product.determinant(), 0.0)));
+      }
+      cells[orientation] = static_cast<float>(best);
+    }
+  });
+
+  float maximum = 0.0f;
+  for (float value : manipulability) {
+    maximum = std::max(maximum, value);
+  }
+  impl.maximum_manipulability = maximum;
+
+  impl.data.resize(impl.dataSize());
+  uint8_t* voxel_reachability = impl.data.data();
+  uint8_t* voxel_manipulability = voxel_reachability + impl.voxel_count;
+  uint8_t* cells = voxel_manipulability + impl.voxel_count;
+  for (size_t voxel = 0; voxel < impl.voxel_count; voxel++) {
+    size_t reachable = 0;
+    uint8_t best = 0;
+    for (size_t orientation = 0; orientation < impl.orientation_count; orientation++) {
+      size_t index = voxel * impl.orientation_count + orientation;
+      uint8_t value = 0;
+      if (manipulability[index] >= 0.0f) {
+        value = static_cast<uint8_t>(
+            1 + (maximum > 0.0f ? std::lround(manipulability[index] / maximum * kLevels) : 0));
+        reachable++;
+      }
+      cells[index] = value;
+      best = std::max(best, value);
+    }
+    voxel_reachability[voxel] = static_cast<uint8_t>(
+        std::lround(255.0 * static_cast<double>(reachable) / impl.orientation_count));
+    voxel_manipulability[voxel] = best;
+  }
+  impl.setData(impl.data.data());
+  return map;
+}
+
+ReachabilityMap::ReachabilityMap(const std::string& path) : impl_(new Impl) {
+  size_t size = 0;
+  try {
+    Poco::File file(path);
+    size = static_cast<size_t>(file.getSize());
+    if (size < kReachabilityMapHeaderSize) {
+      throw LogFileException("libfranka: Invalid reachability map file header in " + path + ".");
+    }
+    impl_->memory = Poco::SharedMemory(file, Poco::SharedMemory::AM_READ);
+  } catch (const Poco::Exception& e) {
+    throw LogFileException("libfranka: Could not open reachability map file " + path + ": " +
+                           e.displayText());
+  }
+
+  const char* data = impl_->memory.begin();
+  auto read = [&data](auto* value) {
+    std::memcpy(value, data, sizeof(*value));
+    data += sizeof(*value);
+  };
+  std::array<char, kReachabilityMapMagic.size()> magic;
+  uint32_t version;
+  std::array<uint32_t, 7> counts;
+  read(&magic);
+  read(&version);
+  if (magic != kReachabilityMapMagic || version != kReachabilityMapVersion) {
+    throw LogFileException("libfranka: Invalid reachability map file header in " + path + ".");
+  }
+  ReachabilityMapParameters& parameters = impl_->parameters;
+  read(&parameters.workspace_minimum);
+  read(&parameters.resolution);
+  read(&counts);
+  read(&parameters.F_T_EE);
+  read(&impl_->maximum_manipulability);
+  for (size_t i = 0; i < 3; i++) {
+    parameters.workspace_maximum[i] =
+        parameters.workspace_minimum[i] + counts[i] * parameters.resolution;
+  }
+  parameters.polar_bins = counts[3];
+  parameters.azimuth_bins = counts[4];
+  parameters.roll_bins = counts[5];
+  parameters.q7_samples = counts[6];
+  try {
+    checkParameters(parameters);
+  } catch (const std::invalid_argument&) {
+    throw LogFileException("libfranka: Invalid reachability map file header in " + path + ".");
+  }
+  impl_->setSize();
+  if (size - kReachabilityMapHeaderSize != impl_->dataSize()) {
+    throw LogFileException("libfranka: Unexpected size of reachability map file " + path + ".");
+  }
+  impl_->setData(reinterpret_cast<const uint8_t*>(data));
+}
+
+ReachabilityMap::ReachabilityMap(ReachabilityMap&& map) noexcept = default;
+ReachabilityMap& ReachabilityMap::operator=(ReachabilityMap&& map) noexcept = default;
+ReachabilityMap::~ReachabilityMap() noexcept = default;
+
+void ReachabilityMap::save(const std::string& path) const {
+  const ReachabilityMapParameters& parameters = impl_->parameters;
+  std::array<uint32_t, 7> counts{
+      {static_cast<uint32_t>(impl_->size[0]), static_cast<uint32_t>(impl_->size[1]),
+       static_cast<uint32_t>(impl_->size[2]), static_cast<uint32_t>(parameters.polar_bins),
+       static_cast<uint32_t>(parameters.azimuth_bins), static_cast<uint32_t>(parameters.roll_bins),
+       static_cast<uint32_t>(parameters.q7_samples)}};
+
+  std::ofstream stream(path, std::ios_base::out | std::ios_base::binary);
+  auto write = [&stream](const auto& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  write(kReachabilityMapMagic);
+  write(kReachabilityMapVersion);
+  write(parameters.workspace_minimum);
+  write(parameters.resolution);
+  write(counts);
+  write(parameters.F_T_EE);
+  write(impl_->maximum_manipulability);
+  // The voxels and cells are contiguous in both the generated and the mapped storage.
+  stream.write(reinterpret_cast<const char*>(impl_->voxel_reachability),
+               static_cast<std::streamsize>(impl_->dataSize()));
+  stream.close();
+  if (!stream) {
+    throw LogFileException("libfranka: Could not write reachability map file " + path + ".");
+  }
+}
+
+ReachabilityMapParameters ReachabilityMap::parameters() const noexcept {
+  return impl_->parameters;
+}
+
+double ReachabilityMap::maximumManipulability() const noexcept {
+  return impl_->maximum_manipulability;
+}
+
+double ReachabilityMap::reachability(const std::array<double, 3>& position) const noexcept {
+  size_t voxel;
+  return impl_->voxel(position, &voxel) ? impl_->voxel_reachability[voxel] / 255.0 : 0.0;
+}
+
+double ReachabilityMap::manipulability(const std::array<double, 3>& position) const noexcept {
+  size_t voxel;
+  return impl_->voxel(position, &voxel) ? impl_->decode(impl_->voxel_manipulability[voxel]) : 0.0;
+}
+
+bool ReachabilityMap::reachable(
+    const std::array<double, 16>& O_T_EE)  // NOLINT(readability-identifier-naming)
+    const noexcept {
+  size_t voxel;
+  if (!impl_->voxel({{O_T_EE[12], O_T_EE[13], O_T_EE[14]}}, &voxel)) {
+    return false;
+  }
+  return impl_->cells[voxel * impl_->orientation_count + impl_->orientation(O_T_EE)] != 0;
+}
+
+double ReachabilityMap::manipulability(
+    const std::array<double, 16>& O_T_EE)  // NOLINT(readability-identifier-naming)
+    const noexcept {
+  size_t voxel;
+  if (!impl_->voxel({{O_T_EE[12], O_T_EE[13], O_T_EE[14]}}, &voxel)) {
+    return 0.0;
+  }
+  return impl_->decode(
+      impl_->cells[voxel * impl_->orientation_count + impl_->orientation(O_T_EE)]);
+}
+
+}  // namespace franka
@@ -0,0 +1,75 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <tuple>
+
+#include <franka/field_descriptors.h>
+#include <franka/robot_state.h>
+#include <research_interface/gripper/types.h>
+#include <research_interface/robot/rbk_types.h>
+
+#include "fields.h"
+
+// Field tables of the raw structs received from the robot and the gripper. Fields with the same
+// name as a field of the converted franka type are copied by copyMatchingFields, unless they are
+// listed in ConvertedFields.
+namespace franka {
+
+template <>
+struct FieldTable<research_interface::robot::RobotState> {
+  using State = research_interface::robot::RobotState;
+
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(
+        makeField("message_id", &State::message_id), makeField("O_T_EE", &State::O_T_EE),
+        makeField("O_T_EE_d", &State::O_T_EE_d), makeField("F_T_EE", &State::F_T_EE),
+        makeField("EE_T_K", &State::EE_T_K), makeField("m_ee", &State::m_ee),
+        makeField("I_ee", &State::I_ee), makeField("F_x_Cee", &State::F_x_Cee),
+        makeField("m_load", &State::m_load), makeField("I_load", &State::I_load),
+        makeField("F_x_Cload", &State::F_x_Cload), makeField("elbow", &State::elbow),
+        makeField("elbow_d", &State::elbow_d), makeField("elbow_c", &State::elbow_c),
+        makeField("delbow_c", &State::delbow_c), makeField("ddelbow_c", &State::ddelbow_c),
+        makeField("tau_J", &State::tau_J), makeField("tau_J_d", &State::tau_J_d),
+        makeField("dtau_J", &State::dtau_J), makeField("q", &State::q),
+        makeField("q_d", &State::q_d), makeField("dq", &State::dq),
+        makeField("dq_d", &State::dq_d), makeField("ddq_d", &State::ddq_d),
+        makeField("joint_contact", &State::joint_contact),
+        makeField("cartesian_contact", &State::cartesian_contact),
+        makeField("joint_collision", &State::joint_collision),
+        makeField("cartesian_collision", &State::cartesian_collision),
+        makeField("tau_ext_hat_filtered", &State::tau_ext_hat_filtered),
+        makeField("O_F_ext_hat_K", &State::O_F_ext_hat_K),
+        makeField("K_F_ext_hat_K", &State::K_F_ext_hat_K),
+        makeField("O_dP_EE_d", &State::O_dP_EE_d), makeField("O_T_EE_c", &State::O_T_EE_c),
+        makeField("O_dP_EE_c", &State::O_dP_EE_c), makeField("O_ddP_EE_c", &State::O_ddP_EE_c),
+        makeField("theta", &State::theta), makeField("dtheta", &State::dtheta),
+        makeField("motion_generator_mode", &State::motion_generator_mode),
+        makeField("controller_mode", &State::controller_mode),
+        makeField("errors", &State::errors), makeField("reflex_reason", &State::reflex_reason),
+        makeField("robot_mode", &State::robot_mode),
+        makeField("control_command_success_rate", &State::control_command_success_rate));
+  }
+};
+
+// The robot mode enumerations differ, so convertRobotState maps them explicitly.
+template <>
+struct ConvertedFields<research_interface::robot::RobotState, RobotState> {
+  static constexpr std::array<const char*, 1> names() noexcept { return {{"robot_mode"}}; }
+};
+
+template <>
+struct FieldTable<research_interface::gripper::GripperState> {
+  using State = research_interface::gripper::GripperState;
+
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("message_id", &State::message_id),
+                           makeField("width", &State::width),
+                           makeField("max_width", &State::max_width),
+                           makeField("is_grasped", &State::is_grasped),
+                           makeField("temperature", &State::temperature));
+  }
+};
+
+}  // namespace franka
@@ -2,6 +2,7 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <franka/robot.h>
 
+#include <stdexcept>
 #include <utility>
 
 #include "control_loop.h"
@@ -213,6 +214,41 @@ void Robot::read(std::function<bool(const RobotState&)> read_callback) {
   }
 }
 
+void Robot::readBatched(
+    std::function<bool(const RobotState* states, size_t count, uint64_t dropped_states)>
+        read_callback,
+    RobotState* buffer,
+    size_t capacity,
+    Duration time_window) {
+  if (buffer == nullptr || capacity == 0) {
+    throw std::invalid_argument("libfranka robot: Batched read requires a non-empty buffer.");
+  }
+  std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
+  if (!l.owns_lock()) {
+    throw InvalidOperationException(
+        "libfranka robot: Cannot perform this operation while another control or read operation "
+        "is running.");
+  }
+
+  // States missed before the loop started do not count as lost.
+  uint64_t dropped_states = 0;
+  size_t count = impl_->readBatch(buffer, 1, &dropped_states);
+  dropped_states = 0;
+  while (true) {
+    if (count == capacity ||
+        (time_window > Duration() && buffer[count - 1].time - buffer[0].time >= time_window)) {
+      if (!read_callback(buffer, count, dropped_states)) {
+        break;
+      }
+      count = 0;
+      dropped_states = 0;
+    }
+    // With a time window, check the window after each state.
+    size_t limit = time_window > Duration() ? 1 : capacity - count;
+    count += impl_->readBatch(buffer + count, limit, &dropped_states);
+  }
+}
+
 RobotState Robot::readOnce() {
   std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
   if (!l.owns_lock()) {
@@ -224,12 +260,97 @@ RobotState Robot::readOnce() {
   return impl_->readOnce();
 }
 
+void Robot::setMotionStatisticsCallback(
+    std::function<void(const MotionStatistics&)> motion_statistics_callback) {
+  std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
+  if (!l.owns_lock()) {
+    throw InvalidOperationException(
+        "libfranka robot: Cannot perform this operation while another control or read operation "
+        "is running.");
+  }
+
+  impl_->setMotionStatisticsCallback(std::move(motion_statistics_callback));
+}
+
+void Robot::setAnomalyDetection(const AnomalyDetectionParameters& parameters,
+                                std::function<void(const AnomalyEvent&)> anomaly_callback) {
+  std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
+  if (!l.owns_lock()) {
+    throw InvalidOperationException(
+        "libfranka robot: Cannot perform this operation while another control or read operation "
+        "is running.");
+  }
+
+  impl_->setAnomalyDetection(parameters, std::move(anomaly_callback));
+}
+
+void Robot::setEnergyAccounting(bool enabled) {
+  std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
+  if (!l.owns_lock()) {
+    throw InvalidOperationException(
+        "libfranka robot: Cannot perform this operation while another control or read operation "
+        "is running.");
+  }
+
+  impl_->setEnergyAccounting(enabled);
+}
+
+EnergySnapshot Robot::energySnapshot() const {
+  return impl_->energySnapshot();
+}
+
+void Robot::setVirtualWallShield(const std::vector<VirtualWallCuboid>& walls,
+                                 const VirtualWallShieldParameters& parameters) {
+  std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
+  if (!l.owns_lock()) {
+    throw InvalidOperationException(
+        "libfranka robot: Cannot perform this operation while another control or read operation "
+        "is running.");
+  }
+
+  impl_->setVirtualWallShield(walls, parameters);
+}
+
+void Robot::setJointLimitShaping(bool enabled) {
+  std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
+  if (!l.owns_lock()) {
+    throw InvalidOperationException(
+        "libfranka robot: Cannot perform this operation while another control or read operation "
+        "is running.");
+  }
+
+  impl_->setJointLimitShaping(enabled);
+}
+
+void Robot::setControlWorkers(size_t worker_count, const std::vector<int>& cpus) {
+  std::unique_lock<std::mutex> l(control_mutex_, std::try_to_lock);
+  if (!l.owns_lock()) {
+    throw InvalidOperationException(
+        "libfranka robot: Cannot perform this operation while another control or read operation "
+        "is running.");
+  }
+
+  impl_->setControlWorkers(worker_count, cpus);
+}
+
+WorkerPool& Robot::controlWorkers() {
+  WorkerPool* worker_pool = impl_->workerPool();
+  if (worker_pool == nullptr) {
+    throw InvalidOperationException("libfranka robot: No control workers have been created.");
+  }
+  return *worker_pool;
+}
+
 VirtualWallCuboid Robot::getVirtualWall(int32_t id) {
   VirtualWallCuboid virtual_wall;
   impl_->executeCommand<research_interface::robot::GetCartesianLimit>(id, &virtual_wall);
   return virtual_wall;
 }
 
+std::vector<VirtualWallCuboid> Robot::getVirtualWalls(const std::vector<int32_t>& ids) {
+  return impl_->getVirtualWalls(ids);
+}
+
 void Robot::setCollisionBehavior(const std::array<double, 7>& lower_torque_thresholds_acceleration,
                                  const std::array<double, 7>& upper_torque_thresholds_acceleration,
                                  const std::array<double, 7>& lower_torque_thresholds_nominal,
@@ -0,0 +1,216 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/robot_daemon.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <franka/robot.h>
+
+namespace franka {
+
+namespace {
+
+enum class ChangeType : uint32_t {
+  kCollisionBehavior,
+  kJointImpedance,
+  kCartesianImpedance,
+  kGuidingMode,
+  kK,
+  kEE,
+  kLoad,
+  kAutomaticErrorRecovery,
+  kCount
+};
+
+class ValueWriter {
+ public:
+  explicit ValueWriter(RobotConfiguration::Change* change) : cursor_(change->values.begin()) {}
+
+  template <size_t N>
+  ValueWriter& operator<<(const std::array<double, N>& values) {
+    cursor_ = std::copy(values.cbegin(), values.cend(), cursor_);
+    return *this;
+  }
+
+  ValueWriter& operator<<(double value) {
+    *cursor_++ = value;
+    return *this;
+  }
+
+ private:
+  double* cursor_;
+};
+
+class ValueReader {
+ public:
+  explicit ValueReader(const RobotConfiguration::Change& change)
+      : cursor_(change.values.cbegin()) {}
+
+  template <size_t N>
+  std::array<double, N> array() {
+    std::array<double, N> values;
+    std::copy(cursor_, cursor_ + N, values.begin());
+    cursor_ += N;
+    return values;
+  }
+
+  double value() { return *cursor_++; }
+
+ private:
+  const double* cursor_;
+};
+
+}  // anonymous namespace
+
+RobotConfiguration& RobotConfiguration::setCollisionBehavior(
+    const std::array<double, 7>& lower_torque_thresholds_acceleration,
+    const std::array<double, 7>& upper_torque_thresholds_acceleration,
+    const std::array<double, 7>& lower_torque_thresholds_nominal,
+    const std::array<double, 7>& upper_torque_thresholds_nominal,
+    const std::array<double, 6>& lower_force_thresholds_acceleration,
+    const std::array<double, 6>& upper_force_thresholds_acceleration,
+    const std::array<double, 6>& lower_force_thresholds_nominal,
+    const std::array<double, 6>& upper_force_thresholds_nominal) {
+  Change change{static_cast<uint32_t>(ChangeType::kCollisionBehavior), {}};
+  ValueWriter(&change) << lower_torque_thresholds_acceleration
+                       << upper_torque_thresholds_acceleration << lower_torque_thresholds_nominal
+                       << upper_torque_thresholds_nominal << lower_force_thresholds_acceleration
+                       << upper_force_thresholds_acceleration << lower_force_thresholds_nominal
+                       << upper_force_thresholds_nominal;
+  changes_.push_back(change);
+  return *this;
+}
+
+RobotConfiguration& RobotConfiguration::setJointImpedance(
+    const std::array<double, 7>& K_theta) {  // NOLINT(readability-identifier-naming)
+  Change change{static_cast<uint32_t>(ChangeType::kJointImpedance), {}};
+  ValueWriter(&change) << K_theta;
+  changes_.push_back(change);
+  return *this;
+}
+
+RobotConfiguration& RobotConfiguration::setCartesianImpedance(
+    const std::array<double, 6>& K_x) {  // NOLINT(readability-identifier-naming)
+  Change change{static_cast<uint32_t>(ChangeType::kCartesianImpedance), {}};
+  ValueWriter(&change) << K_x;
+  changes_.push_back(change);
+  return *this;
+}
+
+RobotConfiguration& RobotConfiguration::setGuidingMode(const std::array<bool, 6>& guiding_mode,
+                                                       bool elbow) {
+  Change change{static_cast<uint32_t>(ChangeType::kGuidingMode), {}};
+  ValueWriter writer(&change);
+  for (bool unlocked : guiding_mode) {
+    writer << (unlocked ? 1.0 : 0.0);
+  }
+  writer << (elbow ? 1.0 : 0.0);
+  changes_.push_back(change);
+  return *this;
+}
+
+RobotConfiguration& RobotConfiguration::setK(
+    const std::array<double, 16>& EE_T_K) {  // NOLINT(readability-identifier-naming)
+  Change change{static_cast<uint32_t>(ChangeType::kK), {}};
+  ValueWriter(&change) << EE_T_K;
+  changes_.push_back(change);
+  return *this;
+}
+
+RobotConfiguration& RobotConfiguration::setEE(
+    const std::array<double, 16>& F_T_EE) {  // NOLINT(readability-identifier-naming)
+  Change change{static_cast<uint32_t>(ChangeType::kEE), {}};
+  ValueWriter(&change) << F_T_EE;
+  changes_.push_back(change);
+  return *this;
+}
+
+RobotConfiguration& RobotConfiguration::setLoad(
+    double load_mass,
+    const std::array<double, 3>& F_x_Cload,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 9>& load_inertia) {
+  Change change{static_cast<uint32_t>(ChangeType::kLoad), {}};
+  ValueWriter(&change) << load_mass << F_x_Cload << load_inertia;
+  changes_.push_back(change);
+  return *this;
+}
+
+RobotConfiguration& RobotConfiguration::automaticErrorRecovery() {
+  changes_.push_back(Change{static_cast<uint32_t>(ChangeType::kAutomaticErrorRecovery), {}});
+  return *this;
+}
+
+void RobotConfiguration::apply(Robot& robot) const {
+  for (const Change& change : changes_) {
+    ValueReader reader(change);
+    switch (static_cast<ChangeType>(change.type)) {
+      case ChangeType::kCollisionBehavior: {
+        auto lower_torque_thresholds_acceleration = reader.array<7>();
+        auto upper_torque_thresholds_acceleration = reader.array<7>();
+        auto lower_torque_thresholds_nominal = reader.array<7>();
+        auto upper_torque_thresholds_nominal = reader.array<7>();
+        auto lower_force_thresholds_acceleration = reader.array<6>();
+        auto upper_force_thresholds_acceleration = reader.array<6>();
+        auto lower_force_thresholds_nominal = reader.array<6>();
+        auto upper_force_thresholds_nominal = reader.array<6>();
+        robot.setCollisionBehavior(
+            lower_torque_thresholds_acceleration, upper_torque_thresholds_acceleration,
+            lower_torque_thresholds_nominal, upper_torque_thresholds_nominal,
+            lower_force_thresholds_acceleration, upper_force_thresholds_acceleration,
+            lower_force_thresholds_nominal, upper_force_thresholds_nominal);
+        break;
+      }
+      case ChangeType::kJointImpedance:
+        robot.setJointImpedance(reader.array<7>());
+        break;
+      case ChangeType::kCartesianImpedance:
+        robot.setCartesianImpedance(reader.array<6>());
+        break;
+      case ChangeType::kGuidingMode: {
+        std::array<bool, 6> guiding_mode;
+        for (bool& unlocked : guiding_mode) {
+          unlocked = reader.value() != 0.0;
+        }
+        robot.setGuidingMode(guiding_mode, reader.value() != 0.0);
+        break;
+      }
+      case ChangeType::kK:
+        robot.setK(reader.array<16>());
+        break;
+      case ChangeType::kEE:
+        robot.setEE(reader.array<16>());
+        break;
+      case ChangeType::kLoad: {
+        double load_mass = reader.value();
+        auto F_x_Cload = reader.array<3>();  // NOLINT(readability-identifier-naming)
+        robot.setLoad(load_mass, F_x_Cload, reader.array<9>());
+        break;
+      }
+      case ChangeType::kAutomaticErrorRecovery:
+        robot.automaticErrorRecovery();
+        break;
+      default:
+        throw std::invalid_argument("libfranka: Unknown configuration change.");
+    }
+  }
+}
+
+size_t RobotConfiguration::size() const noexcept {
+  return changes_.size();
+}
+
+const std::vector<RobotConfiguration::Change>& RobotConfiguration::changes() const noexcept {
+  return changes_;
+}
+
+void RobotConfiguration::append(const std::vector<Change>& changes) {
+  for (const Change& change : changes) {
+    if (change.type >= static_cast<uint32_t>(ChangeType::kCount)) {
+      throw std::invalid_argument("libfranka: Unknown configuration change.");
+    }
+  }
+  changes_.insert(changes_.end(), changes.cbegin(), changes.cend());
+}
+
+}  // namespace franka
@@ -6,6 +6,8 @@
 
 #include <franka/control_types.h>
 #include <franka/robot_state.h>
+#include <franka/virtual_wall_shield.h>
+#include <franka/worker_pool.h>
 #include <research_interface/robot/rbk_types.h>
 #include <research_interface/robot/service_types.h>
 
@@ -33,6 +35,14 @@ class RobotControl {
   virtual void throwOnMotionError(const RobotState& robot_state, uint32_t motion_id) = 0;
 
   virtual RealtimeConfig realtimeConfig() const noexcept = 0;
+
+  // Returns nullptr if Cartesian motions are not shielded.
+  virtual const VirtualWallShield* virtualWallShield() const noexcept = 0;
+
+  virtual bool jointLimitShaping() const noexcept = 0;
+
+  // Returns nullptr if no control workers have been created.
+  virtual WorkerPool* workerPool() const noexcept = 0;
 };
 
 }  // namespace franka
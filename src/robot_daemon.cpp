@@ -0,0 +1,422 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/robot_daemon.h>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <franka/exception.h>
+
+#include "daemon_protocol.h"
+
+namespace franka {
+
+class RobotDaemon::Impl {
+ public:
+  Impl(Robot& robot,
+       const std::string& socket_path,
+       const std::string& shared_memory_name,
+       std::chrono::microseconds command_timeout);
+  ~Impl() noexcept;
+
+  void run(const std::atomic<bool>& running);
+
+ private:
+  struct Client {
+    explicit Client(int socket) : socket(socket) {}
+    ~Client() { close(socket); }
+
+    const int socket;
+    uint64_t lease = 0;
+    bool model_quantities = false;
+  };
+
+  struct ConfigurationRequest {
+    std::shared_ptr<Client> client;
+    RobotConfiguration configuration;
+  };
+
+  struct ControlRequest {
+    uint64_t lease;
+    DaemonControlRequest parameters;
+  };
+
+  void serve() noexcept;
+  void handleMessage(const std::shared_ptr<Client>& client, const std::vector<char>& message);
+  void disconnect(const std::shared_ptr<Client>& client) noexcept;
+
+  void applyConfigurations() noexcept;
+  void runControl(const ControlRequest& request) noexcept;
+  template <typename T>
+  void control(const ControlRequest& request);
+  void execute(std::function<Torques(const RobotState&, Duration)> callback,
+               const DaemonControlRequest& parameters);
+  template <typename T>
+  void execute(std::function<T(const RobotState&, Duration)> callback,
+               const DaemonControlRequest& parameters);
+  RobotCommand holdCommand(const RobotState& robot_state) const;
+  void publish(const RobotState& robot_state, Duration period, uint64_t lease) noexcept;
+
+  Robot& robot_;
+  Model model_;
+  SharedMemory shared_memory_;
+  DaemonSegment* segment_;
+  const std::string shared_memory_name_;             // NOLINT(readability-identifier-naming)
+  const std::string socket_path_;                    // NOLINT(readability-identifier-naming)
+  const int socket_;                                 // NOLINT(readability-identifier-naming)
+  const std::chrono::microseconds command_timeout_;  // NOLINT(readability-identifier-naming)
+
+  std::mutex mutex_;
+  std::deque<ConfigurationRequest> configurations_;
+  std::deque<ControlRequest> controls_;
+  std::atomic<bool> work_pending_{false};
+  uint64_t next_lease_ = 0;
+  // Number of connected clients that requested model quantities.
+  std::atomic<size_t> model_clients_{0};
+
+  ModelQuantities model_quantities_;
+  std::array<double, 7> gravity_{};
+  Duration last_time_;
+  bool has_last_time_ = false;
+
+  std::atomic<bool> stopped_{false};
+  std::thread server_thread_;
+};
+
+RobotDaemon::Impl::Impl(Robot& robot,
+                        const std::string& socket_path,
+                        const std::string& shared_memory_name,
+                        std::chrono::microseconds command_timeout)
+    : robot_(robot),
+      model_(robot.loadModel()),
+      shared_memory_(SharedMemory::create(shared_memory_name)),
+      segment_(shared_memory_.segment()),
+      shared_memory_name_(shared_memory_name),
+      socket_path_(socket_path),
+      socket_(listenOnDaemonSocket(socket_path)),
+      command_timeout_(command_timeout) {
+  server_thread_ = std::thread(&Impl::serve, this);
+}
+
+RobotDaemon::Impl::~Impl() noexcept {
+  stopped_ = true;
+  server_thread_.join();
+  close(socket_);
+  unlink(socket_path_.c_str());
+}
+
+void RobotDaemon::Impl::run(const std::atomic<bool>& running) {
+  while (running) {
+    applyConfigurations();
+
+    ControlRequest request{};
+    bool start_control = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!controls_.empty()) {
+        request = controls_.front();
+        controls_.pop_front();
+        start_control = true;
+      }
+      work_pending_ = !configurations_.empty() || !controls_.empty();
+    }
+    if (start_control) {
+      runControl(request);
+      continue;
+    }
+
+    robot_.read([&](const RobotState& robot_state) {
+      publish(robot_state, has_last_time_ ? robot_state.time - last_time_ : Duration(0), 0);
+      return running && !work_pending_;
+    });
+  }
+}
+
+void RobotDaemon::Impl::serve() noexcept {
+  std::vector<std::shared_ptr<Client>> clients;
+  std::vector<pollfd> descriptors;
+  std::vector<char> message;
+  while (!stopped_) {
+    descriptors.clear();
+    descriptors.push_back(pollfd{socket_, POLLIN, 0});
+    for (const auto& client : clients) {
+      descriptors.push_back(pollfd{client->socket, POLLIN, 0});
+    }
+    if (poll(descriptors.data(), descriptors.size(), 100) <= 0) {
+      continue;
+    }
+
+    if ((descriptors[0].revents & POLLIN) != 0) {
+      int socket = accept4(socket_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (socket != -1) {
+        clients.push_back(std::make_shared<Client>(socket));
+      }
+    }
+    // Iterate backwards over the clients that were polled, so that disconnected ones can be
+    // removed.
+    for (size_t i = descriptors.size() - 1; i > 0; i--) {
+      if (descriptors[i].revents == 0) {
+        continue;
+      }
+      std::shared_ptr<Client> client = clients[i - 1];
+      try {
+        if ((descriptors[i].revents & POLLIN) == 0 ||
+            receiveDaemonMessage(client->socket, &message) == 0) {
+          throw NetworkException("libfranka daemon: Client disconnected.");
+        }
+        handleMessage(client, message);
+      } catch (const std::exception& /* exception */) {
+        disconnect(client);
+        clients.erase(clients.begin() + (i - 1));
+      }
+    }
+  }
+
+  for (const auto& client : clients) {
+    disconnect(client);
+  }
+}
+
+void RobotDaemon::Impl::handleMessage(const std::shared_ptr<Client>& client,
+                                      const std::vector<char>& message) {
+  DaemonRequestHeader header{};
+  if (message.size() < sizeof(header)) {
+    throw ProtocolException("libfranka daemon: Invalid request.");
+  }
+  std::memcpy(&header, message.data(), sizeof(header));
+  const char* payload = message.data() + sizeof(header);
+  size_t payload_size = message.size() - sizeof(header);
+
+  switch (header.type) {
+    case DaemonRequestType::kConnect: {
+      DaemonConnectRequest request{};
+      if (payload_size != sizeof(request)) {
+        throw ProtocolException("libfranka daemon: Invalid connect request.");
+      }
+      std::memcpy(&request, payload, payload_size);
+      if (request.model_quantities != 0 && !client->model_quantities) {
+        client->model_quantities = true;
+        model_clients_++;
+      }
+      sendDaemonResponse(client->socket, DaemonStatus::kSuccess, "", 0, shared_memory_name_);
+      break;
+    }
+    case DaemonRequestType::kConfigure: {
+      if (payload_size != header.size * sizeof(RobotConfiguration::Change)) {
+        throw ProtocolException("libfranka daemon: Invalid configuration request.");
+      }
+      std::vector<RobotConfiguration::Change> changes(header.size);
+      std::memcpy(changes.data(), payload, payload_size);
+      ConfigurationRequest request{client, RobotConfiguration()};
+      try {
+        request.configuration.append(changes);
+      } catch (const std::invalid_argument& exception) {
+        sendDaemonResponse(client->socket, DaemonStatus::kRejected, exception.what());
+        break;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      configurations_.push_back(std::move(request));
+      work_pending_ = true;
+      break;
+    }
+    case DaemonRequestType::kControl: {
+      ControlRequest request{};
+      if (payload_size != sizeof(request.parameters)) {
+        throw ProtocolException("libfranka daemon: Invalid control request.");
+      }
+      std::memcpy(&request.parameters, payload, payload_size);
+      request.lease = ++next_lease_;
+      uint64_t no_lease = 0;
+      if (!segment_->control.lease.compare_exchange_strong(no_lease, request.lease)) {
+        sendDaemonResponse(client->socket, DaemonStatus::kRejected,
+                           "libfranka daemon: Another client controls the robot.");
+        break;
+      }
+      client->lease = request.lease;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        controls_.push_back(request);
+        work_pending_ = true;
+      }
+      sendDaemonResponse(client->socket, DaemonStatus::kSuccess, "", request.lease);
+      break;
+    }
+    default:
+      throw ProtocolException("libfranka daemon: Invalid request.");
+  }
+}
+
+void RobotDaemon::Impl::disconnect(const std::shared_ptr<Client>& client) noexcept {
+  if (client->model_quantities) {
+    client->model_quantities = false;
+    model_clients_--;
+  }
+  // A running motion of the client is aborted by the control callback.
+  if (client->lease != 0) {
+    uint64_t lease = client->lease;
+    segment_->control.lease.compare_exchange_strong(lease, 0);
+  }
+}
+
+void RobotDaemon::Impl::applyConfigurations() noexcept {
+  while (true) {
+    ConfigurationRequest request;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (configurations_.empty()) {
+        return;
+      }
+      request = std::move(configurations_.front());
+      configurations_.pop_front();
+    }
+
+    DaemonStatus status = DaemonStatus::kSuccess;
+    std::string message;
+    try {
+      request.configuration.apply(robot_);
+    } catch (const std::exception& exception) {
+      status = DaemonStatus::kFailed;
+      message = exception.what();
+    }
+    try {
+      sendDaemonResponse(request.client->socket, status, message);
+    } catch (const NetworkException& /* exception */) {
+      // The client disconnected in the meantime.
+    }
+  }
+}
+
+void RobotDaemon::Impl::runControl(const ControlRequest& request) noexcept {
+  DaemonStatus status = DaemonStatus::kSuccess;
+  std::string message;
+  try {
+    if (segment_->control.lease.load() != request.lease) {
+      throw ControlException("libfranka daemon: Client disconnected before the motion started.");
+    }
+    switch (request.parameters.mode) {
+      case DaemonControlMode::kTorques:
+        control<Torques>(request);
+        break;
+      case DaemonControlMode::kJointPositions:
+        control<JointPositions>(request);
+        break;
+      case DaemonControlMode::kJointVelocities:
+        control<JointVelocities>(request);
+        break;
+      case DaemonControlMode::kCartesianPose:
+        control<CartesianPose>(request);
+        break;
+      case DaemonControlMode::kCartesianVelocities:
+        control<CartesianVelocities>(request);
+        break;
+      default:
+        throw ControlException("libfranka daemon: Invalid control mode.");
+    }
+  } catch (const std::exception& exception) {
+    status = DaemonStatus::kFailed;
+    message = exception.what();
+  }
+  finishControl(segment_, request.lease, status, message);
+}
+
+template <typename T>
+void RobotDaemon::Impl::control(const ControlRequest& request) {
+  const uint64_t lease = request.lease;
+  RobotCommand command;
+  bool has_command = false;
+  size_t missed_commands = 0;
+
+  auto callback = [&](const RobotState& robot_state, Duration period) -> T {
+    publish(robot_state, period, lease);
+    if (segment_->control.lease.load(std::memory_order_relaxed) != lease) {
+      throw ControlException("libfranka daemon: Client lost control of the robot.");
+    }
+
+    uint64_t state_count = segment_->state.count;
+    bool received = readCommand(*segment_, lease, state_count, &command);
+    if (!received && command_timeout_.count() > 0) {
+      auto deadline = std::chrono::steady_clock::now() + command_timeout_;
+      while (!(received = readCommand(*segment_, lease, state_count, &command)) &&
+             std::chrono::steady_clock::now() < deadline) {
+      }
+    }
+    if (received) {
+      has_command = true;
+      missed_commands = 0;
+    } else if (++missed_commands > kMaxMissedCommands) {
+      throw ControlException("libfranka daemon: Client stopped sending commands.");
+    } else if (!has_command) {
+      command = holdCommand(robot_state);
+    }
+    return DaemonCommandTraits<T>::get(command);
+  };
+
+  execute(std::function<T(const RobotState&, Duration)>(callback), request.parameters);
+}
+
+void RobotDaemon::Impl::execute(std::function<Torques(const RobotState&, Duration)> callback,
+                                const DaemonControlRequest& parameters) {
+  robot_.control(callback, parameters.limit_rate != 0, parameters.cutoff_frequency);
+}
+
+template <typename T>
+void RobotDaemon::Impl::execute(std::function<T(const RobotState&, Duration)> callback,
+                                const DaemonControlRequest& parameters) {
+  robot_.control(callback, parameters.controller_mode, parameters.limit_rate != 0,
+                 parameters.cutoff_frequency);
+}
+
+// Throws std::invalid_argument for invalid desired values, which aborts the motion like an invalid
+// command of the client.
+RobotCommand RobotDaemon::Impl::holdCommand(const RobotState& robot_state) const {
+  RobotCommand command;
+  command.joint_positions = JointPositions(robot_state.q_d);
+  command.cartesian_pose = CartesianPose(robot_state.O_T_EE_d);
+  return command;
+}
+
+void RobotDaemon::Impl::publish(const RobotState& robot_state,
+                                Duration period,
+                                uint64_t lease) noexcept {
+  last_time_ = robot_state.time;
+  has_last_time_ = true;
+
+  if (model_clients_.load(std::memory_order_relaxed) > 0) {
+    model_.computeQuantities(robot_state, &model_quantities_);
+    gravity_ = model_.gravity(robot_state);
+  } else {
+    model_quantities_ = ModelQuantities();
+    gravity_ = {};
+  }
+  publishState(segment_, robot_state, period, lease, model_quantities_, gravity_);
+}
+
+RobotDaemon::RobotDaemon(Robot& robot,
+                         const std::string& socket_path,
+                         const std::string& shared_memory_name,
+                         std::chrono::microseconds command_timeout) {
+  if (command_timeout < std::chrono::microseconds(0) ||
+      command_timeout >= std::chrono::milliseconds(1)) {
+    throw std::invalid_argument(
+        "libfranka daemon: Command timeout has to be shorter than a control cycle.");
+  }
+  impl_.reset(new Impl(robot, socket_path, shared_memory_name, command_timeout));
+}
+
+RobotDaemon::~RobotDaemon() noexcept = default;
+
+void RobotDaemon::run(const std::atomic<bool>& running) {
+  impl_->run(running);
+}
+
+}  // namespace franka
@@ -3,8 +3,11 @@
 #include "robot_impl.h"
 
 #include <sstream>
+#include <utility>
 
+#include "fields.h"
 #include "load_calculations.h"
+#include "research_interface_fields.h"
 
 namespace franka {
 
@@ -13,7 +16,7 @@ namespace {
 inline ControlException createControlException(const char* message,
                                                research_interface::robot::Move::Status move_status,
                                                const Errors& reflex_errors,
-                                               const std::vector<Record>& log) {
+                                               std::vector<Record> log) {
   std::ostringstream message_stream;
   message_stream << message;
   if (move_status == decltype(move_status)::kReflexAborted) {
@@ -35,7 +38,7 @@ inline ControlException createControlException(const char* message,
       }
     }
   }
-  return ControlException(message_stream.str(), log);
+  return ControlException(message_stream.str(), std::move(log));
 }
 
 }  // anonymous namespace
@@ -60,11 +63,30 @@ RobotState Robot::Impl::update(
       sendRobotCommand(motion_command, control_command);
 
   RobotState state = convertRobotState(receiveRobotState());
-  logger_.log(state, robot_command);
-
+  processState(state, robot_command);
   return state;
 }
 
+void Robot::Impl::processState(const RobotState& state,
+                               const research_interface::robot::RobotCommand& robot_command) {
+  logger_.log(state, robot_command);
+  if (motion_statistics_callback_ && current_move_motion_generator_mode_ !=
+                                         research_interface::robot::MotionGeneratorMode::kIdle) {
+    motion_statistics_.update(state);
+  }
+  if (energy_accumulator_) {
+    energy_accumulator_->update(state, current_move_motion_generator_mode_ !=
+                                           research_interface::robot::MotionGeneratorMode::kIdle);
+    energy_snapshots_.write(energy_accumulator_->snapshot());
+  }
+  if (anomaly_detector_) {
+    AnomalyEvent event;
+    if (anomaly_detector_->update(state, &event)) {
+      anomaly_callback_(event);
+    }
+  }
+}
+
 void Robot::Impl::throwOnMotionError(const RobotState& robot_state, uint32_t motion_id) {
   if (robot_state.robot_mode != RobotMode::kMove ||
       motion_generator_mode_ != current_move_motion_generator_mode_ ||
@@ -92,6 +114,32 @@ RobotState Robot::Impl::readOnce() {
   return convertRobotState(receiveRobotState());
 }
 
+size_t Robot::Impl::readBatch(RobotState* states, size_t capacity, uint64_t* dropped_states) {
+  network_->tcpThrowIfConnectionClosed();
+
+  size_t count = 0;
+  auto accept = [&](const research_interface::robot::RobotState& robot_state) {
+    // Older states can arrive out of order and are ignored.
+    if (robot_state.message_id <= message_id_) {
+      return;
+    }
+    *dropped_states += robot_state.message_id - message_id_ - 1;
+    updateState(robot_state);
+    states[count] = convertRobotState(robot_state);
+    processState(states[count], research_interface::robot::RobotCommand{});
+    count++;
+  };
+
+  research_interface::robot::RobotState received_state{};
+  while (count < capacity && network_->udpReceive(&received_state)) {
+    accept(received_state);
+  }
+  while (count == 0) {
+    accept(network_->udpBlockingReceive<decltype(received_state)>());
+  }
+  return count;
+}
+
 research_interface::robot::RobotCommand Robot::Impl::sendRobotCommand(
     const research_interface::robot::MotionGeneratorCommand* motion_command,
     const research_interface::robot::ControllerCommand* control_command) const {
@@ -175,6 +223,18 @@ RealtimeConfig Robot::Impl::realtimeConfig() const noexcept {
   return realtime_config_;
 }
 
+const VirtualWallShield* Robot::Impl::virtualWallShield() const noexcept {
+  return virtual_wall_shield_.get();
+}
+
+bool Robot::Impl::jointLimitShaping() const noexcept {
+  return joint_limit_shaping_;
+}
+
+WorkerPool* Robot::Impl::workerPool() const noexcept {
+  return worker_pool_.get();
+}
+
 uint32_t Robot::Impl::startMotion(
     research_interface::robot::Move::ControllerMode controller_mode,
     research_interface::robot::Move::MotionGeneratorMode motion_generator_mode,
@@ -239,7 +299,12 @@ uint32_t Robot::Impl::startMotion(
     robot_state = update(nullptr, nullptr);
   }
 
-  logger_.flush();
+  // Reserve the log memory now instead of when a motion is aborted.
+  logger_.clear();
+  motion_statistics_.reset();
+  if (energy_accumulator_) {
+    energy_accumulator_->startMotion();
+  }
 
   return move_command_id;
 }
@@ -251,6 +316,7 @@ void Robot::Impl::finishMotion(
   if (!motionGeneratorRunning() && !controllerRunning()) {
     current_move_motion_generator_mode_ = research_interface::robot::MotionGeneratorMode::kIdle;
     current_move_controller_mode_ = research_interface::robot::ControllerMode::kOther;
+    reportMotionStatistics();
     return;
   }
 
@@ -281,9 +347,12 @@ void Robot::Impl::finishMotion(
   }
   current_move_motion_generator_mode_ = research_interface::robot::MotionGeneratorMode::kIdle;
   current_move_controller_mode_ = research_interface::robot::ControllerMode::kOther;
+  reportMotionStatistics();
 }
 
 void Robot::Impl::cancelMotion(uint32_t motion_id) {
+  reportMotionStatistics();
+
   try {
     executeCommand<research_interface::robot::StopMove>();
   } catch (const CommandException& e) {
@@ -306,53 +375,110 @@ Model Robot::Impl::loadModel() const {
   return Model(*network_);
 }
 
+void Robot::Impl::setMotionStatisticsCallback(
+    std::function<void(const MotionStatistics&)> motion_statistics_callback) noexcept {
+  motion_statistics_callback_ = std::move(motion_statistics_callback);
+  motion_statistics_.reset();
+}
+
+void Robot::Impl::setAnomalyDetection(const AnomalyDetectionParameters& parameters,
+                                      std::function<void(const AnomalyEvent&)> anomaly_callback) {
+  if (!anomaly_callback) {
+    anomaly_detector_.reset();
+    anomaly_callback_ = nullptr;
+    return;
+  }
+  anomaly_detector_ = std::make_unique<AnomalyDetector>(parameters);
+  anomaly_callback_ = std::move(anomaly_callback);
+}
+
+void Robot::Impl::setEnergyAccounting(bool enabled) {
+  logger_.setRecordJointPower(enabled);
+  if (!enabled) {
+    energy_accumulator_.reset();
+    energy_snapshots_.write(EnergySnapshot());
+    return;
+  }
+  energy_accumulator_ = std::make_unique<EnergyAccumulator>();
+  energy_snapshots_.write(EnergySnapshot());
+}
+
+EnergySnapshot Robot::Impl::energySnapshot() const {
+  std::lock_guard<std::mutex> _(energy_snapshot_mutex_);
+  energy_snapshots_.read(&energy_snapshot_);
+  return energy_snapshot_;
+}
+
+void Robot::Impl::setVirtualWallShield(const std::vector<VirtualWallCuboid>& walls,
+                                       const VirtualWallShieldParameters& parameters) {
+  if (walls.empty()) {
+    virtual_wall_shield_.reset();
+    return;
+  }
+  virtual_wall_shield_ = std::make_unique<VirtualWallShield>(walls, parameters);
+}
+
+void Robot::Impl::setJointLimitShaping(bool enabled) noexcept {
+  joint_limit_shaping_ = enabled;
+}
+
+void Robot::Impl::setControlWorkers(size_t worker_count, const std::vector<int>& cpus) {
+  // Stop the old workers first, so that they can be pinned to the same CPUs again.
+  worker_pool_.reset();
+  if (worker_count > 0) {
+    worker_pool_ = std::make_unique<WorkerPool>(worker_count, cpus, realtime_config_);
+  }
+}
+
+std::vector<VirtualWallCuboid> Robot::Impl::getVirtualWalls(const std::vector<int32_t>& ids) {
+  using research_interface::robot::GetCartesianLimit;
+
+  // Send all requests first, so that the round trips overlap. Responses are matched by command ID.
+  std::vector<uint32_t> command_ids;
+  command_ids.reserve(ids.size());
+  for (int32_t id : ids) {
+    command_ids.push_back(network_->tcpSendRequest<GetCartesianLimit>(id));
+  }
+
+  // Receive all responses before handling errors, so that no response is left behind.
+  std::vector<GetCartesianLimit::Response> responses;
+  responses.reserve(ids.size());
+  for (uint32_t command_id : command_ids) {
+    responses.push_back(network_->tcpBlockingReceiveResponse<GetCartesianLimit>(command_id));
+  }
+
+  std::vector<VirtualWallCuboid> virtual_walls(ids.size());
+  for (size_t i = 0; i < ids.size(); i++) {
+    handleCommandResponse<GetCartesianLimit>(responses[i]);
+    virtual_walls[i].id = ids[i];
+    virtual_walls[i].object_world_size = responses[i].object_world_size;
+    virtual_walls[i].p_frame = responses[i].object_frame;
+    virtual_walls[i].active = responses[i].object_activation;
+  }
+  return virtual_walls;
+}
+
+void Robot::Impl::reportMotionStatistics() {
+  // Statistics are reset after reporting, so that an aborted motion is only reported once, even if
+  // it is cancelled after finishMotion has thrown.
+  MotionStatistics statistics = motion_statistics_.statistics();
+  motion_statistics_.reset();
+  if (motion_statistics_callback_ && statistics.samples > 0) {
+    motion_statistics_callback_(statistics);
+  }
+}
+
 RobotState convertRobotState(const research_interface::robot::RobotState& robot_state) noexcept {
   RobotState converted;
-  converted.O_T_EE = robot_state.O_T_EE;
-  converted.O_T_EE_d = robot_state.O_T_EE_d;
-  converted.F_T_EE = robot_state.F_T_EE;
-  converted.EE_T_K = robot_state.EE_T_K;
-  converted.m_ee = robot_state.m_ee;
-  converted.F_x_Cee = robot_state.F_x_Cee;
-  converted.I_ee = robot_state.I_ee;
-  converted.m_load = robot_state.m_load;
-  converted.F_x_Cload = robot_state.F_x_Cload;
-  converted.I_load = robot_state.I_load;
+  copyMatchingFields(robot_state, &converted);
   converted.m_total = robot_state.m_ee + robot_state.m_load;
   converted.F_x_Ctotal = combineCenterOfMass(robot_state.m_ee, robot_state.F_x_Cee,
                                              robot_state.m_load, robot_state.F_x_Cload);
   converted.I_total = combineInertiaTensor(
       robot_state.m_ee, robot_state.F_x_Cee, robot_state.I_ee, robot_state.m_load,
       robot_state.F_x_Cload, robot_state.I_load, converted.m_total, converted.F_x_Ctotal);
-  converted.elbow = robot_state.elbow;
-  converted.elbow_d = robot_state.elbow_d;
-  converted.elbow_c = robot_state.elbow_c;
-  converted.delbow_c = robot_state.delbow_c;
-  converted.ddelbow_c = robot_state.ddelbow_c;
-  converted.tau_J = robot_state.tau_J;
-  converted.tau_J_d = robot_state.tau_J_d;
-  converted.dtau_J = robot_state.dtau_J;
-  converted.q = robot_state.q;
-  converted.dq = robot_state.dq;
-  converted.q_d = robot_state.q_d;
-  converted.dq_d = robot_state.dq_d;
-  converted.ddq_d = robot_state.ddq_d;
-  converted.joint_contact = robot_state.joint_contact;
-  converted.cartesian_contact = robot_state.cartesian_contact;
-  converted.joint_collision = robot_state.joint_collision;
-  converted.cartesian_collision = robot_state.cartesian_collision;
-  converted.tau_ext_hat_filtered = robot_state.tau_ext_hat_filtered;
-  converted.O_F_ext_hat_K = robot_state.O_F_ext_hat_K;
-  converted.K_F_ext_hat_K = robot_state.K_F_ext_hat_K;
-  converted.O_dP_EE_d = robot_state.O_dP_EE_d;
-  converted.O_T_EE_c = robot_state.O_T_EE_c;
-  converted.O_dP_EE_c = robot_state.O_dP_EE_c;
-  converted.O_ddP_EE_c = robot_state.O_ddP_EE_c;
-  converted.theta = robot_state.theta;
-  converted.dtheta = robot_state.dtheta;
   converted.current_errors = robot_state.errors;
   converted.last_motion_errors = robot_state.reflex_reason;
-  converted.control_command_success_rate = robot_state.control_command_success_rate;
   converted.time = Duration(robot_state.message_id);
 
   converted.robot_mode = RobotMode::kOther;
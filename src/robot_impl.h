@@ -3,16 +3,23 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <type_traits>
+#include <vector>
 
+#include <franka/anomaly_detection.h>
+#include <franka/energy_accounting.h>
 #include <franka/model.h>
+#include <franka/motion_statistics.h>
 #include <franka/robot.h>
 #include <research_interface/robot/rbk_types.h>
 #include <research_interface/robot/service_traits.h>
 #include <research_interface/robot/service_types.h>
 
 #include "logger.h"
+#include "mailbox.h"
 #include "network.h"
 #include "robot_control.h"
 
@@ -33,8 +40,15 @@ class Robot::Impl : public RobotControl {
 
   RobotState readOnce();
 
+  // Receives pending robot states in order, waiting for at least one new state. Returns the number
+  // of states written to states and adds the number of skipped message IDs to dropped_states.
+  size_t readBatch(RobotState* states, size_t capacity, uint64_t* dropped_states);
+
   ServerVersion serverVersion() const noexcept;
   RealtimeConfig realtimeConfig() const noexcept override;
+  const VirtualWallShield* virtualWallShield() const noexcept override;
+  bool jointLimitShaping() const noexcept override;
+  WorkerPool* workerPool() const noexcept override;
 
   uint32_t startMotion(
       research_interface::robot::Move::ControllerMode controller_mode,
@@ -51,6 +65,19 @@ class Robot::Impl : public RobotControl {
 
   Model loadModel() const;
 
+  void setMotionStatisticsCallback(
+      std::function<void(const MotionStatistics&)> motion_statistics_callback) noexcept;
+  void setAnomalyDetection(const AnomalyDetectionParameters& parameters,
+                           std::function<void(const AnomalyEvent&)> anomaly_callback);
+  void setEnergyAccounting(bool enabled);
+  EnergySnapshot energySnapshot() const;
+  void setVirtualWallShield(const std::vector<VirtualWallCuboid>& walls,
+                            const VirtualWallShieldParameters& parameters);
+  void setJointLimitShaping(bool enabled) noexcept;
+  void setControlWorkers(size_t worker_count, const std::vector<int>& cpus);
+
+  std::vector<VirtualWallCuboid> getVirtualWalls(const std::vector<int32_t>& ids);
+
  protected:
   bool motionGeneratorRunning() const noexcept;
   bool controllerRunning() const noexcept;
@@ -71,12 +98,32 @@ class Robot::Impl : public RobotControl {
       const research_interface::robot::MotionGeneratorCommand* motion_command,
       const research_interface::robot::ControllerCommand* control_command) const;
   research_interface::robot::RobotState receiveRobotState();
+  void processState(const RobotState& state,
+                    const research_interface::robot::RobotCommand& robot_command);
   void updateState(const research_interface::robot::RobotState& robot_state);
+  void reportMotionStatistics();
 
   std::unique_ptr<Network> network_;
 
   Logger logger_;
 
+  MotionStatisticsAccumulator motion_statistics_;
+  std::function<void(const MotionStatistics&)> motion_statistics_callback_;
+
+  std::unique_ptr<AnomalyDetector> anomaly_detector_;
+  std::function<void(const AnomalyEvent&)> anomaly_callback_;
+
+  // Snapshots are published through a mailbox, so that they can be read by other threads without
+  // blocking the control loop.
+  std::unique_ptr<EnergyAccumulator> energy_accumulator_;
+  mutable Mailbox<EnergySnapshot> energy_snapshots_;
+  mutable std::mutex energy_snapshot_mutex_;
+  mutable EnergySnapshot energy_snapshot_;
+
+  std::unique_ptr<VirtualWallShield> virtual_wall_shield_;
+  bool joint_limit_shaping_ = false;
+  std::unique_ptr<WorkerPool> worker_pool_;
+
   const RealtimeConfig realtime_config_;  // NOLINT(readability-identifier-naming)
   uint16_t ri_version_;
 
@@ -0,0 +1,252 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/teleoperation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+namespace franka {
+
+namespace {
+
+void checkParameters(const TeleoperationParameters& parameters) {
+  if (!(parameters.interpolation_delay >= 0.0) || !(parameters.maximum_extrapolation >= 0.0)) {
+    throw std::invalid_argument(
+        "libfranka: Teleoperation interpolation delay and extrapolation must not be negative.");
+  }
+  if (!(parameters.translation_scale > 0.0) || !std::isfinite(parameters.translation_scale)) {
+    throw std::invalid_argument("libfranka: Teleoperation translation scale must be positive.");
+  }
+  for (size_t i = 0; i < 3; i++) {
+    if (!(parameters.workspace_minimum[i] <= parameters.workspace_maximum[i])) {
+      throw std::invalid_argument("libfranka: Teleoperation workspace is empty.");
+    }
+  }
+  if (!(parameters.maximum_translational_velocity > 0.0) ||
+      !(parameters.maximum_rotational_velocity > 0.0)) {
+    throw std::invalid_argument("libfranka: Teleoperation maximum velocities must be positive.");
+  }
+}
+
+double toSec(std::chrono::steady_clock::duration duration) noexcept {
+  return std::chrono::duration<double>(duration).count();
+}
+
+Eigen::Quaterniond toQuaternion(const std::array<double, 4>& orientation) noexcept {
+  return Eigen::Quaterniond(orientation[3], orientation[0], orientation[1], orientation[2])
+      .normalized();
+}
+
+// Moves from a towards b by the given fraction of the rotation between them. Fractions above 1
+// extrapolate the rotation.
+Eigen::Quaterniond rotate(const Eigen::Quaterniond& a,
+                          Eigen::Quaterniond b,
+                          double fraction) noexcept {
+  if (a.coeffs().dot(b.coeffs()) < 0.0) {
+    b.coeffs() = -b.coeffs();
+  }
+  Eigen::AngleAxisd rotation(b * a.inverse());
+  rotation.angle() *= fraction;
+  return (Eigen::Quaterniond(rotation) * a).normalized();
+}
+
+// Interpolates or extrapolates between two targets at the given fraction of the time between
+// them.
+TeleoperationTarget interpolate(const TeleoperationTarget& a,
+                                const TeleoperationTarget& b,
+                                double fraction) noexcept {
+  TeleoperationTarget target;
+  for (size_t i = 0; i < 3; i++) {
+    target.position[i] = a.position[i] + fraction * (b.position[i] - a.position[i]);
+  }
+  Eigen::Map<Eigen::Vector4d>(target.orientation.data()) =
+      rotate(toQuaternion(a.orientation), toQuaternion(b.orientation), fraction).coeffs();
+  return target;
+}
+
+}  // anonymous namespace
+
+constexpr size_t TeleoperationBridge::kCapacity;
+constexpr size_t TeleoperationBridge::kHistory;
+
+TeleoperationBridge::TeleoperationBridge(const TeleoperationParameters& parameters)
+    : parameters_(parameters), head_(0), tail_(0), dropped_(0) {
+  checkParameters(parameters);
+  reset();
+}
+
+bool TeleoperationBridge::push(const TeleoperationTarget& target) noexcept {
+  size_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) >= kCapacity) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  buffer_[head % kCapacity] = target;
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+CartesianPose TeleoperationBridge::operator()(const RobotState& robot_state, Duration period) {
+  return (*this)(robot_state, period, std::chrono::steady_clock::now());
+}
+
+CartesianPose TeleoperationBridge::operator()(const RobotState& robot_state,
+                                              Duration period,
+                                              std::chrono::steady_clock::time_point now) {
+  if (!initialized_) {
+    last_command_ = robot_state.O_T_EE_c;
+    initialized_ = true;
+  }
+
+  // Move new targets from the input buffer to the history. Targets that are not newer than the
+  // latest one cannot be interpolated and are dropped.
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  size_t head = head_.load(std::memory_order_acquire);
+  for (; tail != head; tail++) {
+    const TeleoperationTarget& target = buffer_[tail % kCapacity];
+    if (history_size_ > 0 && target.time <= history_[history_size_ - 1].time) {
+      current_statistics_.dropped++;
+      continue;
+    }
+    if (history_size_ == kHistory) {
+      std::move(history_.begin() + 1, history_.end(), history_.begin());
+      history_size_--;
+    }
+    history_[history_size_++] = target;
+  }
+  tail_.store(tail, std::memory_order_release);
+
+  TeleoperationTarget target;
+  bool extrapolated = false;
+  bool held = false;
+  if (!resample(now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                          std::chrono::duration<double>(parameters_.interpolation_delay)),
+                &target, &extrapolated, &held)) {
+    return CartesianPose(last_command_);
+  }
+  if (!has_reference_) {
+    input_reference_ = target;
+    robot_reference_ = last_command_;
+    has_reference_ = true;
+  }
+
+  // Map the target relative to the reference poses.
+  Eigen::Map<const Eigen::Matrix4d> robot_reference(robot_reference_.data());
+  Eigen::Map<const Eigen::Matrix4d> last_command(last_command_.data());
+  Eigen::Vector3d position = robot_reference.topRightCorner<3, 1>();
+  for (size_t i = 0; i < 3; i++) {
+    position[i] += parameters_.translation_scale *
+                   (target.position[i] - input_reference_.position[i]);
+    position[i] = std::max(std::min(position[i], parameters_.workspace_maximum[i]),
+                           parameters_.workspace_minimum[i]);
+  }
+  Eigen::Quaterniond orientation = toQuaternion(target.orientation) *
+                                   toQuaternion(input_reference_.orientation).inverse() *
+                                   Eigen::Quaterniond(robot_reference.topLeftCorner<3, 3>());
+
+  // Limit the velocities with respect to the last command.
+  const double dt = period.toSec();
+  Eigen::Vector3d last_position = last_command.topRightCorner<3, 1>();
+  Eigen::Vector3d translation = position - last_position;
+  double max_translation = parameters_.maximum_translational_velocity * dt;
+  if (translation.norm() > max_translation) {
+    position = last_position + translation.normalized() * max_translation;
+  }
+  Eigen::Quaterniond last_orientation(last_command.topLeftCorner<3, 3>());
+  double angle = last_orientation.angularDistance(orientation);
+  double max_angle = parameters_.maximum_rotational_velocity * dt;
+  if (angle > max_angle) {
+    orientation = rotate(last_orientation, orientation, max_angle / angle);
+  }
+
+  std::array<double, 3> command_position;
+  std::array<double, 4> command_orientation;
+  Eigen::Map<Eigen::Vector3d>(command_position.data()) = position;
+  Eigen::Map<Eigen::Vector4d>(command_orientation.data()) = orientation.normalized().coeffs();
+  CartesianPose command(command_position, command_orientation);
+  last_command_ = command.O_T_EE;
+
+  updateStatistics(toSec(now - history_[history_size_ - 1].time), extrapolated, held);
+  return command;
+}
+
+bool TeleoperationBridge::resample(std::chrono::steady_clock::time_point time,
+                                   TeleoperationTarget* target,
+                                   bool* extrapolated,
+                                   bool* held) const {
+  if (history_size_ == 0) {
+    return false;
+  }
+
+  const TeleoperationTarget& latest = history_[history_size_ - 1];
+  if (time >= latest.time) {
+    double age = toSec(time - latest.time);
+    *extrapolated = age > 0.0 && history_size_ > 1;
+    *held = age > parameters_.maximum_extrapolation;
+    if (!*extrapolated) {
+      *target = latest;
+      return true;
+    }
+    const TeleoperationTarget& previous = history_[history_size_ - 2];
+    double horizon = std::min(age, parameters_.maximum_extrapolation);
+    *target = interpolate(previous, latest, 1.0 + horizon / toSec(latest.time - previous.time));
+    return true;
+  }
+
+  if (time <= history_[0].time) {
+    *target = history_[0];
+    return true;
+  }
+  size_t next = 1;
+  while (history_[next].time <= time) {
+    next++;
+  }
+  const TeleoperationTarget& previous = history_[next - 1];
+  *target = interpolate(previous, history_[next],
+                        toSec(time - previous.time) / toSec(history_[next].time - previous.time));
+  return true;
+}
+
+void TeleoperationBridge::updateStatistics(double latency, bool extrapolated, bool held) noexcept {
+  TeleoperationStatistics& statistics = current_statistics_;
+  statistics.commands++;
+  statistics.extrapolated += extrapolated ? 1 : 0;
+  statistics.held += held ? 1 : 0;
+  statistics.latency = latency;
+  latency_sum_ += latency;
+  statistics.mean_latency = latency_sum_ / static_cast<double>(statistics.commands);
+  statistics.maximum_latency = std::max(statistics.maximum_latency, latency);
+
+  // Never block the control loop; if the statistics are being read right now, they are
+  // published with the next command.
+  std::unique_lock<std::mutex> l(statistics_mutex_, std::try_to_lock);
+  if (l.owns_lock()) {
+    statistics_ = statistics;
+  }
+}
+
+TeleoperationStatistics TeleoperationBridge::statistics() const {
+  std::lock_guard<std::mutex> _(statistics_mutex_);
+  TeleoperationStatistics statistics = statistics_;
+  statistics.dropped += dropped_.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+void TeleoperationBridge::reset() {
+  head_ = 0;
+  tail_ = 0;
+  dropped_ = 0;
+  history_size_ = 0;
+  initialized_ = false;
+  has_reference_ = false;
+  current_statistics_ = TeleoperationStatistics();
+  latency_sum_ = 0.0;
+  std::lock_guard<std::mutex> _(statistics_mutex_);
+  statistics_ = TeleoperationStatistics();
+}
+
+}  // namespace franka
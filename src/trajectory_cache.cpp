@@ -0,0 +1,330 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/trajectory_cache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <franka/exception.h>
+
+namespace franka {
+
+namespace {
+
+constexpr size_t kNone = std::numeric_limits<size_t>::max();
+constexpr std::array<char, 4> kTrajectoryCacheMagic{{'F', 'R', 'T', 'C'}};
+constexpr uint32_t kTrajectoryCacheVersion = 1;
+
+// FNV-1a
+constexpr uint64_t kHashOffset = 14695981039346656037ull;
+constexpr uint64_t kHashPrime = 1099511628211ull;
+
+uint64_t hashCombine(uint64_t hash, uint64_t value) noexcept {
+  for (size_t i = 0; i < sizeof(value); i++) {
+    hash ^= (value >> (8 * i)) & 0xff;
+    hash *= kHashPrime;
+  }
+  return hash;
+}
+
+int64_t quantize(double value, double resolution) noexcept {
+  return static_cast<int64_t>(std::llround(value / resolution));
+}
+
+template <typename T>
+void writeValue(std::ostream& stream, const T& value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+void readValue(std::istream& stream, T* value) {
+  stream.read(reinterpret_cast<char*>(value), sizeof(*value));
+  if (!stream) {
+    throw LogFileException("libfranka: Unexpected end of trajectory cache file.");
+  }
+}
+
+}  // anonymous namespace
+
+bool TrajectoryCache::Key::operator==(const Key& other) const noexcept {
+  return q_start == other.q_start && q_goal == other.q_goal && parameters == other.parameters;
+}
+
+size_t TrajectoryCache::KeyHash::operator()(const Key& key) const noexcept {
+  uint64_t hash = kHashOffset;
+  for (int64_t value : key.q_start) {
+    hash = hashCombine(hash, static_cast<uint64_t>(value));
+  }
+  for (int64_t value : key.q_goal) {
+    hash = hashCombine(hash, static_cast<uint64_t>(value));
+  }
+  return static_cast<size_t>(hashCombine(hash, key.parameters));
+}
+
+TrajectoryCache::Profile::Profile(const Sample* samples, size_t size) noexcept
+    : samples_(samples), size_(size) {}
+
+bool TrajectoryCache::Profile::empty() const noexcept {
+  return size_ == 0;
+}
+
+size_t TrajectoryCache::Profile::size() const noexcept {
+  return size_;
+}
+
+Duration TrajectoryCache::Profile::duration() const noexcept {
+  return Duration(size_ == 0 ? 0 : size_ - 1);
+}
+
+const TrajectoryCache::Sample& TrajectoryCache::Profile::operator[](size_t index) const noexcept {
+  return samples_[index];
+}
+
+const TrajectoryCache::Sample& TrajectoryCache::Profile::at(Duration time) const noexcept {
+  return samples_[std::min(static_cast<size_t>(time.toMSec()), size_ - 1)];
+}
+
+double TrajectoryCache::Statistics::hitRate() const noexcept {
+  uint64_t lookups = hits + misses;
+  return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+}
+
+TrajectoryCache::TrajectoryCache(size_t max_profiles, size_t max_samples, double resolution)
+    : max_profiles_(max_profiles), resolution_(resolution), head_(kNone), tail_(kNone) {
+  if (max_profiles == 0 || max_samples == 0) {
+    throw std::invalid_argument("libfranka: Trajectory cache capacity must be positive.");
+  }
+  if (!(resolution > 0.0)) {
+    throw std::invalid_argument("libfranka: Trajectory cache resolution must be positive.");
+  }
+  arena_.resize(max_samples);
+  entries_.reserve(max_profiles);
+  free_entries_.reserve(max_profiles);
+  compaction_order_.reserve(max_profiles);
+  index_.reserve(max_profiles);
+}
+
+TrajectoryCache::Key TrajectoryCache::makeKey(const std::array<double, 7>& q_start,
+                                              const std::array<double, 7>& q_goal,
+                                              std::initializer_list<double> parameters) const
+    noexcept {
+  Key key;
+  for (size_t i = 0; i < 7; i++) {
+    key.q_start[i] = quantize(q_start[i], resolution_);
+    key.q_goal[i] = quantize(q_goal[i], resolution_);
+  }
+  key.parameters = kHashOffset;
+  for (double parameter : parameters) {
+    key.parameters =
+        hashCombine(key.parameters, static_cast<uint64_t>(quantize(parameter, resolution_)));
+  }
+  return key;
+}
+
+TrajectoryCache::Profile TrajectoryCache::find(const Key& key) noexcept {
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    statistics_.misses++;
+    return Profile();
+  }
+  statistics_.hits++;
+  size_t entry = it->second;
+  unlink(entry);
+  pushFront(entry);
+  return Profile(&arena_[entries_[entry].offset], entries_[entry].size);
+}
+
+TrajectoryCache::Profile TrajectoryCache::insert(const Key& key,
+                                                 const std::vector<Sample>& samples) {
+  if (samples.empty()) {
+    throw std::invalid_argument("libfranka: Trajectory profile has no samples.");
+  }
+  if (samples.size() > arena_.size()) {
+    throw std::invalid_argument("libfranka: Trajectory profile exceeds trajectory cache capacity.");
+  }
+
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    erase(it->second);
+  }
+  while (index_.size() >= max_profiles_ || sample_count_ + samples.size() > arena_.size()) {
+    erase(tail_);
+    statistics_.evictions++;
+  }
+  if (arena_end_ + samples.size() > arena_.size()) {
+    compact();
+  }
+
+  size_t entry;
+  if (free_entries_.empty()) {
+    entry = entries_.size();
+    entries_.emplace_back();
+  } else {
+    entry = free_entries_.back();
+    free_entries_.pop_back();
+  }
+  entries_[entry].key = key;
+  entries_[entry].offset = arena_end_;
+  entries_[entry].size = samples.size();
+  std::copy(samples.cbegin(), samples.cend(), arena_.begin() + arena_end_);
+  arena_end_ += samples.size();
+  sample_count_ += samples.size();
+  pushFront(entry);
+  index_.emplace(key, entry);
+  statistics_.insertions++;
+
+  return Profile(&arena_[entries_[entry].offset], entries_[entry].size);
+}
+
+void TrajectoryCache::clear() noexcept {
+  index_.clear();
+  entries_.clear();
+  free_entries_.clear();
+  head_ = kNone;
+  tail_ = kNone;
+  arena_end_ = 0;
+  sample_count_ = 0;
+}
+
+size_t TrajectoryCache::size() const noexcept {
+  return index_.size();
+}
+
+size_t TrajectoryCache::sampleCount() const noexcept {
+  return sample_count_;
+}
+
+const TrajectoryCache::Statistics& TrajectoryCache::statistics() const noexcept {
+  return statistics_;
+}
+
+void TrajectoryCache::resetStatistics() noexcept {
+  statistics_ = Statistics();
+}
+
+void TrajectoryCache::save(std::ostream& stream) const {
+  stream.write(kTrajectoryCacheMagic.data(), kTrajectoryCacheMagic.size());
+  writeValue(stream, kTrajectoryCacheVersion);
+  writeValue(stream, resolution_);
+  writeValue(stream, static_cast<uint64_t>(index_.size()));
+  // Least recently used first, so that loading restores the order of use.
+  for (size_t entry = tail_; entry != kNone; entry = entries_[entry].previous) {
+    const Entry& current = entries_[entry];
+    writeValue(stream, current.key.q_start);
+    writeValue(stream, current.key.q_goal);
+    writeValue(stream, current.key.parameters);
+    writeValue(stream, static_cast<uint64_t>(current.size));
+    stream.write(reinterpret_cast<const char*>(&arena_[current.offset]),
+                 current.size * sizeof(Sample));
+  }
+  if (!stream) {
+    throw LogFileException("libfranka: Could not write trajectory cache file.");
+  }
+}
+
+void TrajectoryCache::load(std::istream& stream) {
+  clear();
+  try {
+    std::array<char, kTrajectoryCacheMagic.size()> magic{};
+    uint32_t version = 0;
+    double resolution = 0.0;
+    stream.read(magic.data(), magic.size());
+    if (!stream || magic != kTrajectoryCacheMagic) {
+      throw LogFileException("libfranka: Invalid trajectory cache file header.");
+    }
+    readValue(stream, &version);
+    if (version != kTrajectoryCacheVersion) {
+      throw LogFileException("libfranka: Unsupported trajectory cache file version.");
+    }
+    readValue(stream, &resolution);
+    if (resolution != resolution_) {
+      throw LogFileException("libfranka: Trajectory cache file was saved with another resolution.");
+    }
+
+    uint64_t profile_count = 0;
+    readValue(stream, &profile_count);
+    std::vector<Sample> samples;
+    for (uint64_t i = 0; i < profile_count; i++) {
+      Key key;
+      uint64_t sample_count = 0;
+      readValue(stream, &key.q_start);
+      readValue(stream, &key.q_goal);
+      readValue(stream, &key.parameters);
+      readValue(stream, &sample_count);
+      if (sample_count == 0 || sample_count > arena_.size()) {
+        throw LogFileException("libfranka: Invalid trajectory profile in trajectory cache file.");
+      }
+      samples.resize(sample_count);
+      stream.read(reinterpret_cast<char*>(samples.data()), sample_count * sizeof(Sample));
+      if (!stream) {
+        throw LogFileException("libfranka: Unexpected end of trajectory cache file.");
+      }
+      uint64_t evictions = statistics_.evictions;
+      uint64_t insertions = statistics_.insertions;
+      insert(key, samples);
+      statistics_.evictions = evictions;
+      statistics_.insertions = insertions;
+    }
+  } catch (...) {
+    clear();
+    throw;
+  }
+}
+
+void TrajectoryCache::erase(size_t entry) noexcept {
+  unlink(entry);
+  index_.erase(entries_[entry].key);
+  sample_count_ -= entries_[entry].size;
+  if (entries_[entry].offset + entries_[entry].size == arena_end_) {
+    arena_end_ = entries_[entry].offset;
+  }
+  free_entries_.push_back(entry);
+}
+
+void TrajectoryCache::unlink(size_t entry) noexcept {
+  Entry& current = entries_[entry];
+  if (current.previous == kNone) {
+    head_ = current.next;
+  } else {
+    entries_[current.previous].next = current.next;
+  }
+  if (current.next == kNone) {
+    tail_ = current.previous;
+  } else {
+    entries_[current.next].previous = current.previous;
+  }
+}
+
+void TrajectoryCache::pushFront(size_t entry) noexcept {
+  entries_[entry].previous = kNone;
+  entries_[entry].next = head_;
+  if (head_ == kNone) {
+    tail_ = entry;
+  } else {
+    entries_[head_].previous = entry;
+  }
+  head_ = entry;
+}
+
+void TrajectoryCache::compact() noexcept {
+  compaction_order_.clear();
+  for (size_t entry = head_; entry != kNone; entry = entries_[entry].next) {
+    compaction_order_.push_back(entry);
+  }
+  std::sort(compaction_order_.begin(), compaction_order_.end(),
+            [this](size_t lhs, size_t rhs) { return entries_[lhs].offset < entries_[rhs].offset; });
+
+  // Profiles only move towards the beginning of the arena, so they never overwrite each other.
+  arena_end_ = 0;
+  for (size_t entry : compaction_order_) {
+    Entry& current = entries_[entry];
+    std::copy(arena_.begin() + current.offset, arena_.begin() + current.offset + current.size,
+              arena_.begin() + arena_end_);
+    current.offset = arena_end_;
+    arena_end_ += current.size;
+  }
+}
+
+}  // namespace franka
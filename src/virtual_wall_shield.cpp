@@ -0,0 +1,122 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/virtual_wall_shield.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace franka {
+
+VirtualWallShield::VirtualWallShield(const std::vector<VirtualWallCuboid>& walls,
+                                     const VirtualWallShieldParameters& parameters)
+    : parameters_(parameters) {
+  if (!(parameters_.margin >= 0.0)) {
+    throw std::invalid_argument("libfranka: Virtual wall shield margin must not be negative.");
+  }
+  if (!(parameters_.deceleration > 0.0)) {
+    throw std::invalid_argument("libfranka: Virtual wall shield deceleration must be positive.");
+  }
+
+  for (const VirtualWallCuboid& wall : walls) {
+    if (!wall.active) {
+      continue;
+    }
+    Cuboid cuboid;
+    for (size_t i = 0; i < 3; i++) {
+      if (!(wall.object_world_size[i] > 0.0)) {
+        throw std::invalid_argument("libfranka: Invalid virtual wall size.");
+      }
+      cuboid.half_size[i] = wall.object_world_size[i] / 2.0;
+      cuboid.center[i] = wall.p_frame[12 + i];
+      for (size_t j = 0; j < 3; j++) {
+        cuboid.rotation[3 * j + i] = wall.p_frame[4 * j + i];
+      }
+    }
+    cuboids_.push_back(cuboid);
+  }
+}
+
+double VirtualWallShield::distance(const std::array<double, 3>& position) const noexcept {
+  double distance = std::numeric_limits<double>::infinity();
+  for (const Cuboid& cuboid : cuboids_) {
+    for (size_t j = 0; j < 3; j++) {
+      // Coordinate along the j-th axis of the cuboid.
+      double local = 0.0;
+      for (size_t i = 0; i < 3; i++) {
+        local += cuboid.rotation[3 * j + i] * (position[i] - cuboid.center[i]);
+      }
+      distance = std::min(distance, cuboid.half_size[j] - std::abs(local));
+    }
+  }
+  return distance;
+}
+
+std::array<double, 3> VirtualWallShield::limitVelocity(const std::array<double, 3>& position,
+                                                       const std::array<double, 3>& velocity,
+                                                       double time_step) const noexcept {
+  std::array<double, 3> limited = velocity;
+  for (const Cuboid& cuboid : cuboids_) {
+    for (size_t j = 0; j < 3; j++) {
+      double local_position = 0.0;
+      double local_velocity = 0.0;
+      for (size_t i = 0; i < 3; i++) {
+        local_position += cuboid.rotation[3 * j + i] * (position[i] - cuboid.center[i]);
+        local_velocity += cuboid.rotation[3 * j + i] * limited[i];
+      }
+
+      double distance = cuboid.half_size[j] - parameters_.margin -
+                        std::copysign(1.0, local_velocity) * local_position;
+      double max_velocity = 0.0;
+      if (distance > 0.0) {
+        max_velocity = std::sqrt(2.0 * parameters_.deceleration * distance);
+        if (time_step > 0.0) {
+          max_velocity = std::min(max_velocity, distance / time_step);
+        }
+      }
+      if (std::abs(local_velocity) > max_velocity) {
+        double correction = std::copysign(max_velocity, local_velocity) - local_velocity;
+        for (size_t i = 0; i < 3; i++) {
+          limited[i] += cuboid.rotation[3 * j + i] * correction;
+        }
+      }
+    }
+  }
+  return limited;
+}
+
+std::array<double, 16> VirtualWallShield::limitPose(
+    const std::array<double, 16>& O_T_EE_c,       // NOLINT(readability-identifier-naming)
+    const std::array<double, 16>& last_O_T_EE_c,  // NOLINT(readability-identifier-naming)
+    double time_step) const noexcept {
+  if (cuboids_.empty() || !(time_step > 0.0)) {
+    return O_T_EE_c;
+  }
+  std::array<double, 3> position{{last_O_T_EE_c[12], last_O_T_EE_c[13], last_O_T_EE_c[14]}};
+  std::array<double, 3> velocity;
+  for (size_t i = 0; i < 3; i++) {
+    velocity[i] = (O_T_EE_c[12 + i] - position[i]) / time_step;
+  }
+  velocity = limitVelocity(position, velocity, time_step);
+
+  std::array<double, 16> limited = O_T_EE_c;
+  for (size_t i = 0; i < 3; i++) {
+    limited[12 + i] = position[i] + velocity[i] * time_step;
+  }
+  return limited;
+}
+
+std::array<double, 6> VirtualWallShield::limitTwist(
+    const std::array<double, 6>& O_dP_EE_c,  // NOLINT(readability-identifier-naming)
+    const std::array<double, 16>& O_T_EE_c,  // NOLINT(readability-identifier-naming)
+    double time_step) const noexcept {
+  std::array<double, 3> velocity = limitVelocity({{O_T_EE_c[12], O_T_EE_c[13], O_T_EE_c[14]}},
+                                                 {{O_dP_EE_c[0], O_dP_EE_c[1], O_dP_EE_c[2]}},
+                                                 time_step);
+  std::array<double, 6> limited = O_dP_EE_c;
+  std::copy(velocity.begin(), velocity.end(), limited.begin());
+  return limited;
+}
+
+}  // namespace franka
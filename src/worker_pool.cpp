@@ -0,0 +1,188 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <franka/worker_pool.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <franka/exception.h>
+
+// `using std::string_literals::operator""s` produces a GCC warning that cannot be disabled, so we
+// have to use `using namespace ...`.
+// See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=65923#c0
+using namespace std::string_literals;  // NOLINT(google-build-using-namespace)
+
+namespace franka {
+
+namespace {
+
+inline void relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+void setRealtime(std::thread& thread, RealtimeConfig realtime_config) {
+  // Keep the control loop thread, which runs with the maximum priority, in front of the workers.
+  const int thread_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+  sched_param thread_param{};
+  thread_param.sched_priority = thread_priority;
+  int error = pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &thread_param);
+  if (error != 0 && realtime_config == RealtimeConfig::kEnforce) {
+    throw RealtimeException("libfranka: unable to set realtime scheduling for worker: "s +
+                            std::strerror(error));
+  }
+}
+
+void pin(std::thread& thread, int cpu, RealtimeConfig realtime_config) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  int error = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+  if (error != 0 && realtime_config == RealtimeConfig::kEnforce) {
+    throw RealtimeException("libfranka: unable to pin worker to CPU "s + std::to_string(cpu) +
+                            ": " + std::strerror(error));
+  }
+}
+
+}  // anonymous namespace
+
+WorkerPool::WorkerPool(size_t worker_count,
+                       const std::vector<int>& cpus,
+                       RealtimeConfig realtime_config)
+    : pinned_(!cpus.empty()) {
+  if (pinned_ && cpus.size() != worker_count) {
+    throw std::invalid_argument("libfranka: Number of CPUs does not match number of workers.");
+  }
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      throw std::invalid_argument("libfranka: Invalid CPU given for worker.");
+    }
+  }
+
+  workers_.reserve(worker_count);
+  try {
+    for (size_t i = 0; i < worker_count; i++) {
+      workers_.emplace_back(&WorkerPool::work, this);
+      setRealtime(workers_.back(), realtime_config);
+      if (pinned_) {
+        pin(workers_.back(), cpus[i], realtime_config);
+      }
+    }
+  } catch (...) {
+    stop();
+    throw;
+  }
+}
+
+WorkerPool::~WorkerPool() noexcept {
+  stop();
+}
+
+size_t WorkerPool::workerCount() const noexcept {
+  return workers_.size();
+}
+
+void WorkerPool::run(const std::vector<Task>& tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  tasks_ = &tasks;
+  task_count_ = tasks.size();
+  next_task_.store(0, std::memory_order_relaxed);
+  finished_workers_.store(0, std::memory_order_relaxed);
+  generation_.fetch_add(1, std::memory_order_release);
+  if (!spinning_.load(std::memory_order_relaxed)) {
+    // Taking the mutex ensures that no blocking worker misses the new generation.
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    condition_.notify_all();
+  }
+
+  executeTasks();
+
+  // All workers have to leave the task set before it can be replaced by the next call.
+  while (finished_workers_.load(std::memory_order_acquire) < workers_.size()) {
+    relax();
+  }
+  tasks_ = nullptr;
+
+  if (exception_) {
+    std::exception_ptr exception;
+    std::swap(exception, exception_);
+    std::rethrow_exception(exception);
+  }
+}
+
+void WorkerPool::setSpinning(bool spinning) {
+  if (!pinned_) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    spinning_.store(spinning, std::memory_order_relaxed);
+  }
+  condition_.notify_all();
+}
+
+void WorkerPool::work() noexcept {
+  uint64_t generation = 0;
+  while (true) {
+    while (generation_.load(std::memory_order_acquire) == generation &&
+           spinning_.load(std::memory_order_relaxed) &&
+           !stopped_.load(std::memory_order_relaxed)) {
+      relax();
+    }
+    if (generation_.load(std::memory_order_acquire) == generation) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [&] {
+        return generation_.load(std::memory_order_relaxed) != generation ||
+               spinning_.load(std::memory_order_relaxed) ||
+               stopped_.load(std::memory_order_relaxed);
+      });
+    }
+    if (stopped_.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    uint64_t current_generation = generation_.load(std::memory_order_acquire);
+    if (current_generation != generation) {
+      generation = current_generation;
+      executeTasks();
+      finished_workers_.fetch_add(1, std::memory_order_release);
+    }
+  }
+}
+
+void WorkerPool::executeTasks() noexcept {
+  for (size_t i = next_task_.fetch_add(1, std::memory_order_relaxed); i < task_count_;
+       i = next_task_.fetch_add(1, std::memory_order_relaxed)) {
+    try {
+      (*tasks_)[i]();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(exception_mutex_);
+      if (!exception_) {
+        exception_ = std::current_exception();
+      }
+    }
+  }
+}
+
+void WorkerPool::stop() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_.store(true, std::memory_order_relaxed);
+  }
+  condition_.notify_all();
+  for (std::thread& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+}  // namespace franka
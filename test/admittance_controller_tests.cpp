@@ -0,0 +1,206 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+
+#include <franka/admittance_controller.h>
+
+using namespace franka;
+
+namespace {
+
+// Creates a robot state for the given wrench applied to the robot.
+RobotState createState(const std::array<double, 6>& wrench) {
+  RobotState robot_state;
+  robot_state.O_T_EE = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.3, 0, 0.5, 1}};
+  for (size_t i = 0; i < 6; i++) {
+    robot_state.O_F_ext_hat_K[i] = -wrench[i];
+  }
+  return robot_state;
+}
+
+AdmittanceParameters unfilteredParameters() {
+  AdmittanceParameters parameters;
+  parameters.wrench_cutoff_frequency = kMaxCutoffFrequency;
+  parameters.deadband = {};
+  return parameters;
+}
+
+std::array<double, 6> run(AdmittanceController& controller,
+                          const RobotState& robot_state,
+                          size_t cycles) {
+  std::array<double, 6> velocity = controller(robot_state, Duration(0)).O_dP_EE;
+  for (size_t i = 0; i < cycles; i++) {
+    velocity = controller(robot_state, Duration(1)).O_dP_EE;
+  }
+  return velocity;
+}
+
+}  // anonymous namespace
+
+TEST(AdmittanceController, ThrowsOnInvalidParameters) {
+  AdmittanceParameters parameters;
+  parameters.mass[3] = 0.0;
+  EXPECT_THROW(AdmittanceController{parameters}, std::invalid_argument);
+
+  parameters = AdmittanceParameters();
+  parameters.damping[0] = -1.0;
+  EXPECT_THROW(AdmittanceController{parameters}, std::invalid_argument);
+
+  parameters = AdmittanceParameters();
+  parameters.workspace_minimum[1] = 1.0;
+  parameters.workspace_maximum[1] = 0.0;
+  EXPECT_THROW(AdmittanceController{parameters}, std::invalid_argument);
+
+  parameters = AdmittanceParameters();
+  parameters.snap_point_count = AdmittanceParameters::kMaxSnapPoints + 1;
+  EXPECT_THROW(AdmittanceController{parameters}, std::invalid_argument);
+
+  AdmittanceController controller;
+  EXPECT_THROW(controller.setParameters(parameters), std::invalid_argument);
+}
+
+TEST(AdmittanceController, StaysAtRestWithoutExternalWrench) {
+  AdmittanceController controller;
+  for (double velocity : run(controller, createState({}), 100)) {
+    EXPECT_EQ(0.0, velocity);
+  }
+}
+
+TEST(AdmittanceController, IgnoresWrenchWithinDeadband) {
+  AdmittanceController controller;
+  for (double velocity : run(controller, createState({{2.0, -2.0, 1.0, 0.2, 0.0, -0.4}}), 100)) {
+    EXPECT_EQ(0.0, velocity);
+  }
+}
+
+TEST(AdmittanceController, ReachesSteadyStateVelocity) {
+  AdmittanceParameters parameters = unfilteredParameters();
+  AdmittanceController controller(parameters);
+
+  std::array<double, 6> wrench{{6.0, -3.0, 0.0, 0.5, 0.0, 0.0}};
+  std::array<double, 6> velocity = run(controller, createState(wrench), 5000);
+  for (size_t i = 0; i < 6; i++) {
+    EXPECT_NEAR(wrench[i] / parameters.damping[i], velocity[i], 1e-6);
+  }
+}
+
+TEST(AdmittanceController, LimitsVelocity) {
+  AdmittanceParameters parameters = unfilteredParameters();
+  parameters.maximum_velocity[0] = 0.1;
+  AdmittanceController controller(parameters);
+
+  std::array<double, 6> velocity = run(controller, createState({{100.0, 0, 0, 0, 0, 0}}), 1000);
+  EXPECT_DOUBLE_EQ(0.1, velocity[0]);
+}
+
+TEST(AdmittanceController, StopsAtWorkspaceBoundary) {
+  AdmittanceParameters parameters = unfilteredParameters();
+  parameters.workspace_maximum[0] = 0.3;
+  parameters.workspace_minimum[2] = 0.0;
+  AdmittanceController controller(parameters);
+
+  std::array<double, 6> velocity = run(controller, createState({{10.0, 0, 10.0, 0, 0, 0}}), 100);
+  EXPECT_EQ(0.0, velocity[0]);
+  EXPECT_GT(velocity[2], 0.0);
+
+  controller.reset();
+  velocity = run(controller, createState({{-10.0, 0, 0, 0, 0, 0}}), 100);
+  EXPECT_LT(velocity[0], 0.0);
+}
+
+TEST(AdmittanceController, IsPulledTowardsSnapPoint) {
+  AdmittanceParameters parameters = unfilteredParameters();
+  parameters.snap_points[0] = {{0.31, 0.0, 0.5}};
+  parameters.snap_points[1] = {{0.0, 0.0, 0.0}};
+  parameters.snap_point_count = 2;
+  AdmittanceController controller(parameters);
+
+  std::array<double, 6> velocity = run(controller, createState({}), 100);
+  EXPECT_GT(velocity[0], 0.0);
+  EXPECT_EQ(0.0, velocity[1]);
+  EXPECT_EQ(0.0, velocity[2]);
+}
+
+TEST(AdmittanceController, PullsBackWithStiffness) {
+  AdmittanceParameters parameters = unfilteredParameters();
+  parameters.stiffness[1] = 100.0;
+  AdmittanceController controller(parameters);
+
+  controller(createState({}), Duration(0));
+  RobotState moved_state = createState({});
+  moved_state.O_T_EE[13] = 0.1;
+  std::array<double, 6> velocity = controller(moved_state, Duration(1)).O_dP_EE;
+  EXPECT_LT(velocity[1], 0.0);
+}
+
+TEST(AdmittanceController, CanUpdateParametersWhileRunning) {
+  AdmittanceParameters parameters = unfilteredParameters();
+  AdmittanceController controller(parameters);
+  RobotState robot_state = createState({{3.0, 0, 0, 0, 0, 0}});
+  run(controller, robot_state, 5000);
+
+  parameters.damping[0] = 60.0;
+  std::thread([&]() { controller.setParameters(parameters); }).join();
+  EXPECT_EQ(60.0, controller.parameters().damping[0]);
+
+  std::array<double, 6> velocity{};
+  for (size_t i = 0; i < 5000; i++) {
+    velocity = controller(robot_state, Duration(1)).O_dP_EE;
+  }
+  EXPECT_NEAR(0.05, velocity[0], 1e-6);
+}
+
+TEST(AdmittanceController, ComputesJointVelocities) {
+  AdmittanceController controller(unfilteredParameters());
+  RobotState robot_state = createState({{6.0, 0, 0, 0, 0, 0}});
+
+  // Joint i moves axis i, joint 7 does not contribute.
+  std::array<double, 42> jacobian{};
+  for (size_t i = 0; i < 6; i++) {
+    jacobian[i * 6 + i] = 1.0;
+  }
+
+  controller(robot_state, Duration(0), jacobian);
+  JointVelocities joint_velocities = controller(robot_state, Duration(1), jacobian);
+  EXPECT_GT(joint_velocities.dq[0], 0.0);
+  for (size_t i = 1; i < 7; i++) {
+    EXPECT_EQ(0.0, joint_velocities.dq[i]);
+  }
+}
+
+TEST(AdmittanceController, JointVelocitiesMatchDampedPseudoinverse) {
+  std::array<double, 42> jacobian;
+  for (size_t i = 0; i < jacobian.size(); i++) {
+    jacobian[i] = std::sin(0.7 * i + 0.3);
+  }
+  Eigen::Map<const Eigen::Matrix<double, 6, 7>> jacobian_matrix(jacobian.data());
+
+  for (double damping : {0.0, 0.05, 0.5}) {
+    AdmittanceParameters parameters = unfilteredParameters();
+    parameters.jacobian_damping = damping;
+    AdmittanceController controller(parameters);
+    RobotState robot_state = createState({{6.0, -3.0, 2.0, 0.5, -0.2, 0.1}});
+
+    controller(robot_state, Duration(0), jacobian);
+    std::array<double, 6> velocity = controller(robot_state, Duration(1)).O_dP_EE;
+    ASSERT_NE(0.0, velocity[0]);
+    controller.reset();
+    controller(robot_state, Duration(0), jacobian);
+    JointVelocities joint_velocities = controller(robot_state, Duration(1), jacobian);
+
+    Eigen::Matrix<double, 6, 6> damped =
+        jacobian_matrix * jacobian_matrix.transpose() +
+        damping * damping * Eigen::Matrix<double, 6, 6>::Identity();
+    Eigen::Matrix<double, 7, 1> expected =
+        jacobian_matrix.transpose() *
+        damped.ldlt().solve(Eigen::Map<Eigen::Matrix<double, 6, 1>>(velocity.data()));
+    for (size_t i = 0; i < 7; i++) {
+      EXPECT_NEAR(expected[i], joint_velocities.dq[i], 1e-9) << "Damping " << damping;
+    }
+  }
+}
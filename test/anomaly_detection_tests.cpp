@@ -0,0 +1,149 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <random>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <franka/anomaly_detection.h>
+
+using namespace franka;
+
+namespace {
+
+class AnomalyDetectorTest : public ::testing::Test {
+ protected:
+  AnomalyDetectorTest() : generator_(1), noise_(0.0, 0.01) {}
+
+  RobotState createState(double joint_angle) {
+    RobotState robot_state;
+    robot_state.time = Duration(time_++);
+    robot_state.q.fill(joint_angle);
+    for (double& tau : robot_state.tau_ext_hat_filtered) {
+      tau = 0.5 * joint_angle + noise_(generator_);
+    }
+    for (double& force : robot_state.O_F_ext_hat_K) {
+      force = noise_(generator_);
+    }
+    return robot_state;
+  }
+
+  bool feed(AnomalyDetector& detector, size_t samples, double joint_angle) {
+    bool raised = false;
+    for (size_t i = 0; i < samples; i++) {
+      raised = detector.update(createState(joint_angle), nullptr) || raised;
+    }
+    return raised;
+  }
+
+  uint64_t time_ = 0;
+  std::mt19937 generator_;
+  std::normal_distribution<double> noise_;
+};
+
+}  // anonymous namespace
+
+TEST(AnomalyDetector, ThrowsOnInvalidParameters) {
+  AnomalyDetectionParameters parameters;
+  parameters.configuration_bins = 0;
+  EXPECT_THROW(AnomalyDetector{parameters}, std::invalid_argument);
+
+  parameters = AnomalyDetectionParameters();
+  parameters.baseline_weight = 0.0;
+  EXPECT_THROW(AnomalyDetector{parameters}, std::invalid_argument);
+
+  parameters = AnomalyDetectionParameters();
+  parameters.z_score_threshold = -1.0;
+  EXPECT_THROW(AnomalyDetector{parameters}, std::invalid_argument);
+
+  parameters = AnomalyDetectionParameters();
+  parameters.minimum_wrench_deviation = 0.0;
+  EXPECT_THROW(AnomalyDetector{parameters}, std::invalid_argument);
+
+  EXPECT_NO_THROW(AnomalyDetector{});
+}
+
+TEST_F(AnomalyDetectorTest, DoesNotRaiseEventsForNominalData) {
+  AnomalyDetector detector;
+  EXPECT_FALSE(feed(detector, 5000, 0.1));
+}
+
+TEST_F(AnomalyDetectorTest, DoesNotRaiseEventsDuringWarmup) {
+  AnomalyDetector detector;
+  for (size_t i = 0; i < detector.parameters().warmup_samples; i++) {
+    RobotState robot_state = createState(0.1);
+    robot_state.tau_ext_hat_filtered[2] += (i % 2) * 5.0;
+    EXPECT_FALSE(detector.update(robot_state, nullptr));
+  }
+}
+
+TEST_F(AnomalyDetectorTest, KeepsSeparateBaselinesPerConfiguration) {
+  AnomalyDetector detector;
+  ASSERT_FALSE(feed(detector, 1000, -2.0));
+  ASSERT_FALSE(feed(detector, 1000, 2.0));
+
+  // Both configurations have a different external torque offset, but neither is anomalous.
+  EXPECT_FALSE(feed(detector, 1000, -2.0));
+  EXPECT_FALSE(feed(detector, 1000, 2.0));
+}
+
+TEST_F(AnomalyDetectorTest, RaisesEventOnStep) {
+  AnomalyDetector detector;
+  ASSERT_FALSE(feed(detector, 1000, 0.1));
+
+  RobotState robot_state = createState(0.1);
+  robot_state.tau_ext_hat_filtered[4] += 1.0;
+  AnomalyEvent event;
+  ASSERT_TRUE(detector.update(robot_state, &event));
+
+  EXPECT_EQ(robot_state.time, event.time);
+  EXPECT_TRUE(event.joint_anomaly[4]);
+  EXPECT_FALSE(event.joint_anomaly[3]);
+  EXPECT_GT(event.joint_z_score[4], detector.parameters().z_score_threshold);
+  for (bool anomaly : event.cartesian_anomaly) {
+    EXPECT_FALSE(anomaly);
+  }
+
+  // The event is only raised once while the anomaly persists.
+  robot_state = createState(0.1);
+  robot_state.tau_ext_hat_filtered[4] += 1.0;
+  EXPECT_FALSE(detector.update(robot_state, &event));
+}
+
+TEST_F(AnomalyDetectorTest, RaisesEventOnCartesianStep) {
+  AnomalyDetector detector;
+  ASSERT_FALSE(feed(detector, 1000, 0.1));
+
+  RobotState robot_state = createState(0.1);
+  robot_state.O_F_ext_hat_K[2] -= 5.0;
+  AnomalyEvent event;
+  ASSERT_TRUE(detector.update(robot_state, &event));
+  EXPECT_TRUE(event.cartesian_anomaly[2]);
+  EXPECT_LT(event.cartesian_z_score[2], -detector.parameters().z_score_threshold);
+}
+
+TEST_F(AnomalyDetectorTest, DetectsSmallPersistentDrift) {
+  AnomalyDetector detector;
+  ASSERT_FALSE(feed(detector, 1000, 0.1));
+
+  // A shift of three standard deviations stays below the z-score threshold, but is accumulated.
+  bool raised = false;
+  AnomalyEvent event;
+  for (size_t i = 0; i < 100 && !raised; i++) {
+    RobotState robot_state = createState(0.1);
+    robot_state.tau_ext_hat_filtered[1] += 0.15;
+    raised = detector.update(robot_state, &event);
+  }
+  ASSERT_TRUE(raised);
+  EXPECT_TRUE(event.joint_anomaly[1]);
+}
+
+TEST_F(AnomalyDetectorTest, CanReset) {
+  AnomalyDetector detector;
+  ASSERT_FALSE(feed(detector, 1000, 0.1));
+  detector.reset();
+
+  RobotState robot_state = createState(0.1);
+  robot_state.tau_ext_hat_filtered[4] += 1.0;
+  EXPECT_FALSE(detector.update(robot_state, nullptr));
+}
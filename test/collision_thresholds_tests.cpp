@@ -0,0 +1,127 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <franka/collision_thresholds.h>
+#include <franka/exception.h>
+#include <franka/log_file.h>
+
+using namespace franka;
+
+namespace {
+
+// Creates a log where sample i has external torques and forces of i / samples * scale.
+std::vector<Record> createLog(size_t samples, double scale, double acceleration) {
+  std::vector<Record> log(samples);
+  for (size_t i = 0; i < samples; i++) {
+    double value = scale * (i + 1) / samples;
+    log[i].state.tau_ext_hat_filtered.fill(value);
+    log[i].state.O_F_ext_hat_K.fill(-2.0 * value);
+    log[i].state.ddq_d[0] = acceleration;
+  }
+  return log;
+}
+
+}  // anonymous namespace
+
+TEST(CollisionThresholdRecommender, ThrowsWithoutSamples) {
+  CollisionThresholdRecommender recommender;
+  EXPECT_THROW(recommender.recommend(0.01), InvalidOperationException);
+}
+
+TEST(CollisionThresholdRecommender, ThrowsOnInvalidParameters) {
+  EXPECT_THROW(CollisionThresholdRecommender(-1.0), std::invalid_argument);
+
+  CollisionThresholdRecommender recommender;
+  recommender.add(createLog(10, 1.0, 0.0));
+  EXPECT_THROW(recommender.recommend(0.0), std::invalid_argument);
+  EXPECT_THROW(recommender.recommend(1.0), std::invalid_argument);
+  EXPECT_THROW(recommender.recommend(0.01, 0.5), std::invalid_argument);
+
+  CollisionThresholdRecommender other(1.0);
+  EXPECT_THROW(recommender.merge(other), std::invalid_argument);
+}
+
+TEST(CollisionThresholdRecommender, RecommendsQuantilesPerPhase) {
+  CollisionThresholdRecommender recommender;
+  recommender.add(createLog(1000, 10.0, 0.0));
+  recommender.add(createLog(1000, 20.0, 2.0));
+  EXPECT_EQ(1000u, recommender.nominalSamples());
+  EXPECT_EQ(1000u, recommender.accelerationSamples());
+
+  CollisionThresholds thresholds = recommender.recommend(0.05, 2.0);
+  for (size_t i = 0; i < 7; i++) {
+    EXPECT_NEAR(9.5, thresholds.lower_torque_thresholds_nominal[i], 0.02);
+    EXPECT_NEAR(19.0, thresholds.upper_torque_thresholds_nominal[i], 0.04);
+    EXPECT_NEAR(19.0, thresholds.lower_torque_thresholds_acceleration[i], 0.02);
+    EXPECT_NEAR(38.0, thresholds.upper_torque_thresholds_acceleration[i], 0.04);
+  }
+  for (size_t i = 0; i < 6; i++) {
+    EXPECT_NEAR(19.0, thresholds.lower_force_thresholds_nominal[i], 0.04);
+    EXPECT_NEAR(38.0, thresholds.upper_force_thresholds_nominal[i], 0.08);
+    EXPECT_NEAR(38.0, thresholds.lower_force_thresholds_acceleration[i], 0.04);
+    EXPECT_NEAR(76.0, thresholds.upper_force_thresholds_acceleration[i], 0.08);
+  }
+}
+
+TEST(CollisionThresholdRecommender, UsesOtherPhaseWithoutSamples) {
+  CollisionThresholdRecommender recommender;
+  recommender.add(createLog(1000, 10.0, 0.0));
+
+  CollisionThresholds thresholds = recommender.recommend(0.05);
+  EXPECT_EQ(thresholds.lower_torque_thresholds_nominal,
+            thresholds.lower_torque_thresholds_acceleration);
+  EXPECT_EQ(thresholds.upper_force_thresholds_nominal,
+            thresholds.upper_force_thresholds_acceleration);
+}
+
+TEST(CollisionThresholdRecommender, CanMerge) {
+  CollisionThresholdRecommender combined;
+  combined.add(createLog(100, 10.0, 0.0));
+  combined.add(createLog(300, 5.0, 0.0));
+
+  CollisionThresholdRecommender first;
+  first.add(createLog(100, 10.0, 0.0));
+  CollisionThresholdRecommender second;
+  second.add(createLog(300, 5.0, 0.0));
+  first.merge(second);
+
+  EXPECT_EQ(combined.nominalSamples(), first.nominalSamples());
+  EXPECT_EQ(combined.recommend(0.1).lower_torque_thresholds_nominal,
+            first.recommend(0.1).lower_torque_thresholds_nominal);
+}
+
+TEST(CollisionThresholdRecommender, CanProcessLogFilesInParallel) {
+  std::vector<std::string> files;
+  CollisionThresholdRecommender expected;
+  for (size_t i = 0; i < 5; i++) {
+    std::vector<Record> log = createLog(200, 2.0 * (i + 1), i % 2 == 0 ? 0.0 : 2.0);
+    expected.add(log);
+
+    files.push_back(std::string(FRANKA_TEST_BINARY_DIR) + "/collision_thresholds_" +
+                    std::to_string(i) + ".log");
+    std::ofstream stream(files.back(), std::ios::binary);
+    LogFileWriter writer(stream);
+    writer.write(log);
+  }
+
+  CollisionThresholds thresholds = recommendCollisionThresholds(files, 0.01, 1.5, 3);
+  CollisionThresholds expected_thresholds = expected.recommend(0.01, 1.5);
+  EXPECT_EQ(expected_thresholds.lower_torque_thresholds_nominal,
+            thresholds.lower_torque_thresholds_nominal);
+  EXPECT_EQ(expected_thresholds.upper_torque_thresholds_acceleration,
+            thresholds.upper_torque_thresholds_acceleration);
+  EXPECT_EQ(expected_thresholds.lower_force_thresholds_acceleration,
+            thresholds.lower_force_thresholds_acceleration);
+
+  files.push_back(std::string(FRANKA_TEST_BINARY_DIR) + "/does_not_exist.log");
+  EXPECT_THROW(recommendCollisionThresholds(files, 0.01), LogFileException);
+
+  for (size_t i = 0; i < 5; i++) {
+    std::remove(files[i].c_str());
+  }
+}
@@ -1,11 +1,15 @@
 // Copyright (c) 2017 Franka Emika GmbH
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
 #include <exception>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include <gmock/gmock.h>
 
 #include <franka/lowpass_filter.h>
+#include <franka/robot_traits.h>
 #include "control_loop.h"
 #include "motion_generator_traits.h"
 
@@ -886,3 +890,82 @@ TYPED_TEST(ControlLoops, GetsCorrectTimeStepWithMotionCallback) {
 
   loop();
 }
+
+TEST(ControlLoop, ShieldsCartesianMotionsAgainstVirtualWalls) {
+  NiceMock<MockRobotControl> robot;
+  franka::VirtualWallCuboid wall{
+      0, {{1.0, 1.0, 1.0}}, {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}}, true};
+  robot.virtual_wall_shield = std::make_unique<franka::VirtualWallShield>(
+      std::vector<franka::VirtualWallCuboid>{wall}, franka::VirtualWallShieldParameters{0.02, 5.0});
+
+  RobotState robot_state{};
+  robot_state.O_T_EE_c = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.48, 0, 0, 1}};
+
+  ControlLoop<CartesianVelocities> velocity_loop(
+      robot, ControllerMode::kJointImpedance,
+      [](const RobotState&, Duration) { return CartesianVelocities({1, 1, 0, 0, 0, 0}); }, false,
+      franka::kMaxCutoffFrequency);
+  MotionGeneratorCommand command{};
+  EXPECT_TRUE(velocity_loop.spinMotion(robot_state, Duration(1), &command));
+  EXPECT_EQ(0.0, command.O_dP_EE_c[0]);
+  EXPECT_EQ(1.0, command.O_dP_EE_c[1]);
+
+  ControlLoop<CartesianPose> pose_loop(
+      robot, ControllerMode::kJointImpedance,
+      [](const RobotState&, Duration) {
+        return CartesianPose({1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.49, 0.001, 0, 1});
+      },
+      false, franka::kMaxCutoffFrequency);
+  EXPECT_TRUE(pose_loop.spinMotion(robot_state, Duration(1), &command));
+  EXPECT_EQ(0.48, command.O_T_EE_c[12]);
+  EXPECT_EQ(0.001, command.O_T_EE_c[13]);
+}
+
+TEST(ControlLoop, ShapesJointMotionsAtPositionLimits) {
+  NiceMock<MockRobotControl> robot;
+  robot.joint_limit_shaping = true;
+
+  RobotState robot_state{};
+  robot_state.q_d = franka::PandaTraits::maxJointPosition();
+
+  ControlLoop<JointVelocities> velocity_loop(
+      robot, ControllerMode::kJointImpedance,
+      [](const RobotState&, Duration) { return JointVelocities({1, 1, 1, 1, 1, 1, -1}); }, false,
+      franka::kMaxCutoffFrequency);
+  MotionGeneratorCommand command{};
+  EXPECT_TRUE(velocity_loop.spinMotion(robot_state, Duration(1), &command));
+  EXPECT_EQ((std::array<double, 7>{{0, 0, 0, 0, 0, 0, -1}}), command.dq_c);
+
+  ControlLoop<JointPositions> position_loop(
+      robot, ControllerMode::kJointImpedance,
+      [&](const RobotState&, Duration) {
+        std::array<double, 7> q = robot_state.q_d;
+        q[0] += 0.001;
+        return JointPositions(q);
+      },
+      false, franka::kMaxCutoffFrequency);
+  EXPECT_TRUE(position_loop.spinMotion(robot_state, Duration(1), &command));
+  EXPECT_EQ(robot_state.q_d, command.q_c);
+}
+
+TEST(ControlLoop, CallbacksCanRunTasksOnControlWorkers) {
+  NiceMock<MockRobotControl> robot;
+  robot.worker_pool =
+      std::make_unique<franka::WorkerPool>(2, std::vector<int>{}, franka::RealtimeConfig::kIgnore);
+
+  std::array<double, 7> results{};
+  std::vector<franka::WorkerPool::Task> tasks;
+  for (size_t i = 0; i < results.size(); i++) {
+    tasks.emplace_back([&results, i] { results[i] = static_cast<double>(i); });
+  }
+
+  ControlLoop<JointVelocities> loop(robot, ControllerMode::kJointImpedance,
+                                    [&](const RobotState&, Duration) {
+                                      robot.worker_pool->run(tasks);
+                                      return franka::MotionFinished(JointVelocities(results));
+                                    },
+                                    false, franka::kMaxCutoffFrequency);
+  loop();
+
+  EXPECT_EQ((std::array<double, 7>{{0, 1, 2, 3, 4, 5, 6}}), results);
+}
@@ -0,0 +1,137 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cmath>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+#include <Eigen/Core>
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+#include <franka/control_math.h>
+
+using namespace franka;
+
+namespace {
+
+template <size_t N>
+void expectNear(const std::array<double, N>& expected,
+                const std::array<double, N>& actual,
+                double tolerance = 1e-12) {
+  for (size_t i = 0; i < N; i++) {
+    EXPECT_NEAR(expected[i], actual[i], tolerance) << "at index " << i;
+  }
+}
+
+std::array<double, 49> randomMassMatrix() {
+  Eigen::Matrix<double, 7, 7> random = Eigen::Matrix<double, 7, 7>::Random();
+  std::array<double, 49> mass;
+  Eigen::Map<Eigen::Matrix<double, 7, 7>>(mass.data()) =
+      random * random.transpose() + Eigen::Matrix<double, 7, 7>::Identity();
+  return mass;
+}
+
+std::array<double, 16> randomTransform() {
+  Eigen::Affine3d transform(Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized());
+  transform.pretranslate(Eigen::Vector3d::Random());
+  std::array<double, 16> output;
+  Eigen::Map<Eigen::Matrix4d>(output.data()) = transform.matrix();
+  return output;
+}
+
+}  // anonymous namespace
+
+TEST(ControlMath, SolvesMassMatrixLikeEigen) {
+  std::srand(1);
+  for (int n = 0; n < 10; n++) {
+    std::array<double, 49> mass = randomMassMatrix();
+    std::array<double, 7> b;
+    Eigen::Map<Eigen::Matrix<double, 7, 1>>(b.data()) = Eigen::Matrix<double, 7, 1>::Random();
+
+    JointMatrixLDLT ldlt(mass);
+    ASSERT_TRUE(ldlt.positiveDefinite());
+    std::array<double, 7> expected;
+    Eigen::Map<Eigen::Matrix<double, 7, 1>>(expected.data()) =
+        Eigen::Map<const Eigen::Matrix<double, 7, 7>>(mass.data())
+            .ldlt()
+            .solve(Eigen::Map<const Eigen::Matrix<double, 7, 1>>(b.data()));
+    expectNear(expected, ldlt.solve(b), 1e-9);
+  }
+}
+
+TEST(ControlMath, RejectsMatricesThatAreNotPositiveDefinite) {
+  std::array<double, 49> mass = randomMassMatrix();
+  mass[3 * 7 + 3] = -1.0;
+  JointMatrixLDLT ldlt;
+  EXPECT_FALSE(ldlt.positiveDefinite());
+  EXPECT_FALSE(ldlt.compute(mass));
+  EXPECT_FALSE(ldlt.positiveDefinite());
+
+  std::array<double, 36> result{};
+  result[0] = 42.0;
+  EXPECT_FALSE(inverseCartesianInertia(std::array<double, 42>{}, mass, &result));
+  EXPECT_EQ(42.0, result[0]);
+}
+
+TEST(ControlMath, CalculatesInverseCartesianInertiaLikeEigen) {
+  std::srand(2);
+  std::array<double, 49> mass = randomMassMatrix();
+  std::array<double, 42> jacobian;
+  Eigen::Map<Eigen::Matrix<double, 6, 7>> jacobian_matrix(jacobian.data());
+  jacobian_matrix = Eigen::Matrix<double, 6, 7>::Random();
+
+  std::array<double, 36> result;
+  ASSERT_TRUE(inverseCartesianInertia(jacobian, mass, &result));
+
+  std::array<double, 36> expected;
+  Eigen::Map<Eigen::Matrix<double, 6, 6>>(expected.data()) =
+      jacobian_matrix *
+      Eigen::Map<const Eigen::Matrix<double, 7, 7>>(mass.data()).inverse() *
+      jacobian_matrix.transpose();
+  expectNear(expected, result, 1e-9);
+
+  Eigen::Map<const Eigen::Matrix<double, 6, 6>> result_matrix(result.data());
+  EXPECT_EQ(result_matrix, result_matrix.transpose());
+}
+
+TEST(ControlMath, MultipliesAndInvertsTransformsLikeEigen) {
+  std::srand(3);
+  std::array<double, 16> a = randomTransform();
+  std::array<double, 16> b = randomTransform();
+
+  std::array<double, 16> expected;
+  Eigen::Map<Eigen::Matrix4d>(expected.data()) =
+      Eigen::Map<const Eigen::Matrix4d>(a.data()) * Eigen::Map<const Eigen::Matrix4d>(b.data());
+  expectNear(expected, multiplyTransforms(a, b));
+
+  Eigen::Map<Eigen::Matrix4d>(expected.data()) =
+      Eigen::Map<const Eigen::Matrix4d>(a.data()).inverse();
+  expectNear(expected, invertTransform(a));
+
+  const std::array<double, 16> kIdentity{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+  expectNear(kIdentity, multiplyTransforms(invertTransform(a), a));
+}
+
+TEST(ControlMath, CalculatesOrientationErrorLikeQuaternionDifference) {
+  std::srand(4);
+  for (int n = 0; n < 100; n++) {
+    std::array<double, 16> pose = randomTransform();
+    std::array<double, 16> desired_pose = randomTransform();
+
+    Eigen::Quaterniond orientation(Eigen::Map<const Eigen::Matrix4d>(pose.data())
+                                       .topLeftCorner<3, 3>()
+                                       .eval());
+    Eigen::Quaterniond desired_orientation(
+        Eigen::Map<const Eigen::Matrix4d>(desired_pose.data()).topLeftCorner<3, 3>().eval());
+    if (desired_orientation.coeffs().dot(orientation.coeffs()) < 0.0) {
+      orientation.coeffs() = -orientation.coeffs();
+    }
+    std::array<double, 3> expected;
+    Eigen::Map<Eigen::Vector3d>(expected.data()) =
+        (orientation * desired_orientation.inverse()).vec();
+    expectNear(expected, orientationError(pose, desired_pose), 1e-9);
+  }
+
+  std::array<double, 16> pose = randomTransform();
+  expectNear(std::array<double, 3>{}, orientationError(pose, pose));
+}
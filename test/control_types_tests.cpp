@@ -2,6 +2,7 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <exception>
 #include <limits>
 
@@ -137,6 +138,34 @@ TEST(CartesianPose, CanNotConstructFromInvalidMatrix) {
                std::invalid_argument);
 }
 
+TEST(CartesianPose, CanConstructFromPositionAndQuaternion) {
+  std::array<double, 3> position{{0.3, -0.1, 0.5}};
+  std::array<double, 4> orientation{{0, 0, std::sqrt(0.5), std::sqrt(0.5)}};
+  std::array<double, 2> elbow{{0, 1}};
+  franka::CartesianPose p(position, orientation, elbow);
+
+  // Rotation of 90 degrees around z.
+  std::array<double, 16> expected{{0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 1, 0, 0.3, -0.1, 0.5, 1}};
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_NEAR(expected[i], p.O_T_EE[i], 1e-12);
+  }
+  EXPECT_EQ(elbow, p.elbow);
+  EXPECT_NO_THROW(franka::CartesianPose(p.O_T_EE));
+}
+
+TEST(CartesianPose, CanNotConstructFromInvalidQuaternion) {
+  std::array<double, 3> position{{0, 0, 0}};
+  std::array<double, 4> orientation{{0, 0, 0.5, 0.5}};
+  EXPECT_THROW(franka::CartesianPose(position, orientation), std::invalid_argument);
+
+  orientation = {{0, 0, 0, std::numeric_limits<double>::quiet_NaN()}};
+  EXPECT_THROW(franka::CartesianPose(position, orientation), std::invalid_argument);
+
+  orientation = {{0, 0, 0, 1}};
+  std::array<double, 2> elbow{{0, 0.5}};
+  EXPECT_THROW(franka::CartesianPose(position, orientation, elbow), std::invalid_argument);
+}
+
 TEST(CartesianPose, CanNotConstructWithInvalidValues) {
   double nan = std::numeric_limits<double>::quiet_NaN();
   EXPECT_THROW(franka::CartesianPose({0, 0, nan, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}),
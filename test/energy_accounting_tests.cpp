@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <gtest/gtest.h>
+
+#include <franka/energy_accounting.h>
+
+using franka::Duration;
+using franka::EnergyAccumulator;
+using franka::EnergySnapshot;
+using franka::RobotState;
+
+namespace {
+
+RobotState createState(uint64_t time_ms, double tau, double dq) {
+  RobotState state;
+  state.time = Duration(time_ms);
+  state.tau_J.fill(tau);
+  state.dq.fill(dq);
+  state.dq[6] = -dq;
+  return state;
+}
+
+}  // anonymous namespace
+
+TEST(EnergyAccumulator, IsEmptyInitially) {
+  EnergyAccumulator accumulator;
+  EnergySnapshot snapshot = accumulator.snapshot();
+
+  EXPECT_EQ(0u, snapshot.lifetime.samples);
+  EXPECT_EQ(0u, snapshot.motion.samples);
+  EXPECT_EQ(0.0, snapshot.lifetime.energy[0]);
+}
+
+TEST(EnergyAccumulator, IntegratesJointPower) {
+  EnergyAccumulator accumulator;
+  for (uint64_t i = 0; i <= 1000; i++) {
+    accumulator.update(createState(i, 2.0, 0.5), false);
+  }
+  EnergySnapshot snapshot = accumulator.snapshot();
+
+  EXPECT_EQ(1001u, snapshot.lifetime.samples);
+  EXPECT_EQ(Duration(1000), snapshot.lifetime.duration);
+  for (size_t i = 0; i < 6; i++) {
+    EXPECT_DOUBLE_EQ(1.0, snapshot.joint_power[i]);
+    EXPECT_NEAR(1.0, snapshot.lifetime.energy[i], 1e-9);
+    EXPECT_NEAR(1.0, snapshot.lifetime.positive_energy[i], 1e-9);
+    EXPECT_DOUBLE_EQ(1.0, snapshot.lifetime.peak_power[i]);
+  }
+  EXPECT_DOUBLE_EQ(-1.0, snapshot.joint_power[6]);
+  EXPECT_NEAR(-1.0, snapshot.lifetime.energy[6], 1e-9);
+  EXPECT_EQ(0.0, snapshot.lifetime.positive_energy[6]);
+  EXPECT_DOUBLE_EQ(1.0, snapshot.lifetime.peak_power[6]);
+  EXPECT_DOUBLE_EQ(5.0, snapshot.lifetime.peak_total_power);
+  EXPECT_EQ(0u, snapshot.motion.samples);
+}
+
+TEST(EnergyAccumulator, AccountsForLostStates) {
+  EnergyAccumulator accumulator;
+  accumulator.update(createState(10, 1.0, 1.0), false);
+  accumulator.update(createState(15, 1.0, 1.0), false);
+
+  EXPECT_NEAR(0.005, accumulator.snapshot().lifetime.energy[0], 1e-12);
+}
+
+TEST(EnergyAccumulator, SeparatesMotions) {
+  EnergyAccumulator accumulator;
+  accumulator.update(createState(0, 1.0, 1.0), false);
+  accumulator.update(createState(1, 1.0, 1.0), false);
+
+  accumulator.startMotion();
+  for (uint64_t i = 2; i <= 12; i++) {
+    accumulator.update(createState(i, 4.0, 1.0), true);
+  }
+  accumulator.update(createState(13, 1.0, 1.0), false);
+  EnergySnapshot snapshot = accumulator.snapshot();
+
+  EXPECT_EQ(11u, snapshot.motion.samples);
+  EXPECT_EQ(Duration(10), snapshot.motion.duration);
+  EXPECT_NEAR(0.04, snapshot.motion.energy[0], 1e-12);
+  EXPECT_DOUBLE_EQ(4.0, snapshot.motion.peak_power[0]);
+  EXPECT_EQ(14u, snapshot.lifetime.samples);
+  EXPECT_NEAR(0.001 + 0.044 + 0.001, snapshot.lifetime.energy[0], 1e-12);
+
+  accumulator.startMotion();
+  EXPECT_EQ(0u, accumulator.snapshot().motion.samples);
+  EXPECT_EQ(14u, accumulator.snapshot().lifetime.samples);
+}
+
+TEST(EnergyAccumulator, CanReset) {
+  EnergyAccumulator accumulator;
+  accumulator.update(createState(0, 1.0, 1.0), true);
+  accumulator.update(createState(1, 1.0, 1.0), true);
+  accumulator.reset();
+  accumulator.update(createState(5, 1.0, 1.0), false);
+  EnergySnapshot snapshot = accumulator.snapshot();
+
+  EXPECT_EQ(1u, snapshot.lifetime.samples);
+  EXPECT_EQ(0.0, snapshot.lifetime.energy[0]);
+  EXPECT_EQ(0u, snapshot.motion.samples);
+}
@@ -0,0 +1,198 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/field_descriptors.h>
+
+#include "fields.h"
+#include "helpers.h"
+
+using namespace franka;
+
+namespace {
+
+struct Source {
+  std::array<double, 3> position;
+  double mass;
+  int mode;
+  uint32_t message_id;
+};
+
+struct Target {
+  double mass;
+  std::array<double, 3> position;
+  double mode;
+};
+
+std::vector<std::string> split(const std::string& line) {
+  std::vector<std::string> columns;
+  std::istringstream stream(line);
+  std::string column;
+  while (std::getline(stream, column, ',')) {
+    columns.push_back(column);
+  }
+  return columns;
+}
+
+}  // anonymous namespace
+
+namespace franka {
+
+template <>
+struct FieldTable<Source> {
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(
+        makeField("position", &Source::position), makeField("mass", &Source::mass),
+        makeField("mode", &Source::mode), makeField("message_id", &Source::message_id));
+  }
+};
+
+template <>
+struct FieldTable<Target> {
+  static constexpr auto fields() noexcept {
+    return std::make_tuple(makeField("mass", &Target::mass),
+                           makeField("position", &Target::position),
+                           makeField("mode", &Target::mode));
+  }
+};
+
+template <>
+struct ConvertedFields<Source, Target> {
+  static constexpr std::array<const char*, 1> names() noexcept { return {{"mode"}}; }
+};
+
+}  // namespace franka
+
+TEST(FieldDescriptors, DescribeFields) {
+  static_assert(HasFieldTable<RobotState>::value, "");
+  static_assert(!HasFieldTable<double>::value, "");
+  static_assert(fieldCount<GripperState>() == 5, "");
+  static_assert(fieldIndex<RobotState>("q") < fieldCount<RobotState>(), "");
+  static_assert(fieldIndex<RobotState>("unknown") == fieldCount<RobotState>(), "");
+
+  constexpr auto q = std::get<fieldIndex<RobotState>("q")>(FieldTable<RobotState>::fields());
+  using QDescriptor = std::decay_t<decltype(q)>;
+  static_assert(std::is_same<QDescriptor::Element, double>::value, "");
+  static_assert(QDescriptor::kExtent == 7, "");
+  static_assert(std::decay_t<decltype(std::get<0>(FieldTable<GripperState>::fields()))>::kExtent ==
+                    1,
+                "");
+
+  RobotState robot_state;
+  robot_state.q[3] = 4.0;
+  EXPECT_STREQ("q", q.name);
+  EXPECT_EQ(4.0, q.get(robot_state)[3]);
+  EXPECT_EQ(static_cast<size_t>(reinterpret_cast<const char*>(&robot_state.q) -
+                                reinterpret_cast<const char*>(&robot_state)),
+            q.offset());
+}
+
+TEST(FieldDescriptors, VisitsFieldsInDeclarationOrder) {
+  std::vector<std::string> names;
+  forEachField<GripperState>([&](const auto& field) { names.emplace_back(field.name); });
+
+  EXPECT_EQ((std::vector<std::string>{"width", "max_width", "is_grasped", "temperature", "time"}),
+            names);
+}
+
+TEST(FieldDescriptors, DescribesAllRobotStateFields) {
+  size_t size = 0;
+  forEachField<RobotState>([&](const auto& field) { size += sizeof(field.get(RobotState())); });
+
+  // Only padding may be left over.
+  EXPECT_LE(size, sizeof(RobotState));
+  EXPECT_GT(size + 16, sizeof(RobotState));
+}
+
+TEST(FieldDescriptors, CanCreateMasks) {
+  FieldMask<RobotState> mask = makeFieldMask<RobotState>({"q", "time"});
+
+  EXPECT_EQ(2u, mask.count());
+  EXPECT_TRUE(mask[fieldIndex<RobotState>("q")]);
+  EXPECT_TRUE(mask[fieldIndex<RobotState>("time")]);
+  EXPECT_THROW(makeFieldMask<RobotState>({"unknown"}), std::invalid_argument);
+}
+
+TEST(FieldDescriptors, FindsDifferingFields) {
+  RobotState robot_state;
+  randomRobotState(robot_state);
+  RobotState other = robot_state;
+  EXPECT_TRUE(differingFields(robot_state, other).none());
+
+  other.dq[6] += 1.0;
+  other.current_errors = Errors(std::array<bool, 37>{{true}});
+  other.time += Duration(1);
+  EXPECT_EQ(makeFieldMask<RobotState>({"dq", "current_errors", "time"}),
+            differingFields(robot_state, other));
+
+  RobotCommand command;
+  RobotCommand other_command;
+  other_command.cartesian_pose.elbow[0] = 1.0;
+  EXPECT_EQ(makeFieldMask<RobotCommand>({"cartesian_pose"}),
+            differingFields(command, other_command));
+}
+
+TEST(FieldDescriptors, CanWriteCsv) {
+  RobotCommand command;
+  command.joint_positions.q[2] = 3.0;
+  command.torques.tau_J[6] = -1.5;
+
+  std::ostringstream header;
+  CsvWriter(header).writeHeader<RobotCommand>();
+  std::ostringstream line;
+  CsvWriter(line).writeLine(command);
+
+  std::vector<std::string> names = split(header.str());
+  std::vector<std::string> values = split(line.str());
+  ASSERT_EQ(7u + 7u + 18u + 8u + 7u, names.size());
+  ASSERT_EQ(names.size(), values.size());
+  EXPECT_EQ("joint_positions.q[0]", names.front());
+  EXPECT_EQ("cartesian_pose.elbow[1]", names[7 + 7 + 17]);
+  EXPECT_EQ("torques.tau_J[6]", names.back());
+  EXPECT_EQ("3", values[2]);
+  EXPECT_EQ("-1.5", values.back());
+
+  std::ostringstream state_header;
+  std::ostringstream state_line;
+  FieldMask<RobotState> mask = makeFieldMask<RobotState>({"m_ee", "last_motion_errors", "time"});
+  CsvWriter(state_header).writeHeader<RobotState>(mask);
+  CsvWriter(state_line).writeLine(RobotState(), mask);
+  EXPECT_EQ(1u + 37u + 1u, split(state_header.str()).size());
+  EXPECT_EQ(split(state_header.str()).size(), split(state_line.str()).size());
+}
+
+TEST(FieldDescriptors, CanWriteJson) {
+  GripperState gripper_state;
+  gripper_state.width = 0.5;
+  gripper_state.is_grasped = true;
+  gripper_state.time = Duration(42);
+
+  std::ostringstream stream;
+  stream << gripper_state;
+
+  EXPECT_EQ(
+      "{\"width\": 0.5, \"max_width\": 0, \"is_grasped\": 1, \"temperature\": 0, \"time\": 42}",
+      stream.str());
+}
+
+TEST(FieldDescriptors, CopiesMatchingFields) {
+  static_assert(isConvertedField<Source, Target>("mode"), "");
+  static_assert(!isConvertedField<Source, Target>("mass"), "");
+  static_assert(!isConvertedField<Target, Source>("mode"), "");
+
+  Source source{{{1.0, 2.0, 3.0}}, 4.0, 5, 6};
+  Target target{0.0, {{0.0, 0.0, 0.0}}, 0.0};
+
+  copyMatchingFields(source, &target);
+
+  EXPECT_EQ(4.0, target.mass);
+  EXPECT_EQ(source.position, target.position);
+  EXPECT_EQ(0.0, target.mode);
+}
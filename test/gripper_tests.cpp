@@ -1,7 +1,9 @@
 // Copyright (c) 2017 Franka Emika GmbH
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <atomic>
+#include <chrono>
 #include <functional>
+#include <thread>
 
 #include <gmock/gmock.h>
 
@@ -17,10 +19,29 @@ using ::testing::_;
 
 using franka::Gripper;
 using franka::IncompatibleVersionException;
+using franka::InvalidOperationException;
 using franka::NetworkException;
 
 using research_interface::gripper::Connect;
+using research_interface::gripper::Grasp;
 using research_interface::gripper::GripperState;
+using research_interface::gripper::Move;
+using research_interface::gripper::Stop;
+
+namespace {
+
+bool waitFor(std::function<bool()> condition) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+}  // anonymous namespace
 
 TEST(Gripper, CannotConnectIfNoServerRunning) {
   EXPECT_THROW(Gripper gripper("127.0.0.1"), NetworkException)
@@ -41,3 +62,137 @@ TEST(Gripper, ThrowsOnIncompatibleLibraryVersion) {
 
   EXPECT_THROW(Gripper("127.0.0.1"), IncompatibleVersionException);
 }
+
+TEST(Gripper, CanStreamSetpoints) {
+  GripperMockServer server;
+  Gripper gripper("127.0.0.1");
+
+  server.sendEmptyState<GripperState>().spinOnce();
+  gripper.startStreaming();
+
+  std::atomic_bool moved(false);
+  std::atomic_bool grasped(false);
+  server
+      .waitForCommand<Move>([&](const Move::Request& request) {
+        EXPECT_EQ(0.05, request.width);
+        EXPECT_EQ(0.1, request.speed);
+        moved = true;
+        return Move::Response(Move::Status::kSuccess);
+      })
+      .waitForCommand<Grasp>([&](const Grasp::Request& request) {
+        EXPECT_EQ(0.02, request.width);
+        EXPECT_EQ(0.05, request.speed);
+        EXPECT_EQ(20.0, request.force);
+        grasped = true;
+        return Grasp::Response(Grasp::Status::kSuccess);
+      })
+      .spinOnce();
+
+  franka::GripperSetpoint setpoint;
+  setpoint.width = 0.05;
+  setpoint.speed = 0.1;
+  gripper.setStreamingSetpoint(setpoint);
+  gripper.setStreamingSetpoint(setpoint);
+  EXPECT_TRUE(waitFor([&] { return moved.load(); }));
+
+  setpoint.width = 0.02;
+  setpoint.speed = 0.05;
+  setpoint.force = 20.0;
+  gripper.setStreamingSetpoint(setpoint);
+  EXPECT_TRUE(waitFor([&] { return grasped.load(); }));
+
+  EXPECT_NO_THROW(gripper.stopStreaming());
+}
+
+TEST(Gripper, StopStreamingReceivesOutstandingResponses) {
+  GripperMockServer server;
+  Gripper gripper("127.0.0.1");
+
+  server.sendEmptyState<GripperState>().spinOnce();
+  gripper.startStreaming();
+
+  std::atomic_bool moving(false);
+  std::atomic_bool preempted(false);
+  std::atomic_bool stopping(false);
+  std::atomic_bool responded(false);
+  server
+      .generic([&](decltype(server)::Socket& tcp_socket, decltype(server)::Socket&) {
+        Move::Header move_header;
+        server.receiveRequest<Move>(tcp_socket, &move_header);
+        moving = true;
+        Stop::Header stop_header;
+        server.receiveRequest<Stop>(tcp_socket, &stop_header);
+        preempted = true;
+
+        // Answer the preempted move and its stop only once streaming is being stopped.
+        EXPECT_TRUE(waitFor([&] { return stopping.load(); }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        responded = true;
+        server.sendResponse<Move>(
+            tcp_socket,
+            Move::Header(Move::kCommand, move_header.command_id,
+                         sizeof(Move::Message<Move::Response>)),
+            Move::Response(Move::Status::kUnsuccessful));
+        server.sendResponse<Stop>(
+            tcp_socket,
+            Stop::Header(Stop::kCommand, stop_header.command_id,
+                         sizeof(Stop::Message<Stop::Response>)),
+            Stop::Response(Stop::Status::kSuccess));
+      })
+      .waitForCommand<Move>(
+          [](const Move::Request&) { return Move::Response(Move::Status::kSuccess); })
+      .spinOnce();
+
+  franka::GripperSetpoint setpoint;
+  setpoint.width = 0.05;
+  setpoint.speed = 0.1;
+  gripper.setStreamingSetpoint(setpoint);
+  EXPECT_TRUE(waitFor([&] { return moving.load(); }));
+
+  setpoint.width = 0.02;
+  gripper.setStreamingSetpoint(setpoint);
+  EXPECT_TRUE(waitFor([&] { return preempted.load(); }));
+
+  stopping = true;
+  EXPECT_NO_THROW(gripper.stopStreaming());
+  EXPECT_TRUE(responded);
+
+  // No response of a streamed command is left over, so the next command gets its own response.
+  EXPECT_TRUE(gripper.move(0.05, 0.1));
+}
+
+TEST(Gripper, ReadOnceReturnsStreamedState) {
+  GripperMockServer server;
+  Gripper gripper("127.0.0.1");
+
+  server.sendEmptyState<GripperState>().spinOnce();
+  gripper.startStreaming();
+
+  server
+      .onSendUDP<GripperState>([](GripperState& gripper_state) {
+        gripper_state.message_id = 2;
+        gripper_state.width = 0.042;
+      })
+      .spinOnce();
+
+  EXPECT_TRUE(waitFor([&] { return gripper.readOnce().width == 0.042; }));
+  gripper.stopStreaming();
+}
+
+TEST(Gripper, ThrowsOnInvalidStreamingOperations) {
+  GripperMockServer server;
+  Gripper gripper("127.0.0.1");
+
+  EXPECT_THROW(gripper.setStreamingSetpoint(franka::GripperSetpoint()), InvalidOperationException);
+
+  server.sendEmptyState<GripperState>().spinOnce();
+  gripper.startStreaming();
+
+  EXPECT_THROW(gripper.startStreaming(), InvalidOperationException);
+  EXPECT_THROW(gripper.homing(), InvalidOperationException);
+  EXPECT_THROW(gripper.move(0.05, 0.1), InvalidOperationException);
+  EXPECT_THROW(gripper.grasp(0.05, 0.1, 20.0), InvalidOperationException);
+  EXPECT_THROW(gripper.stop(), InvalidOperationException);
+
+  gripper.stopStreaming();
+}
@@ -11,6 +11,9 @@
 
 bool stringContains(const std::string& actual, const std::string& expected);
 
+double randomDouble();
+bool randomBool();
+
 void randomRobotState(franka::RobotState& robot_state);
 void randomRobotState(research_interface::robot::RobotState& robot_state);
 void testRobotStateIsZero(const franka::RobotState& actual);
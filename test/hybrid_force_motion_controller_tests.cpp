@@ -0,0 +1,129 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cmath>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <franka/hybrid_force_motion_controller.h>
+
+using namespace franka;
+
+namespace {
+
+RobotState createState() {
+  RobotState robot_state;
+  robot_state.O_T_EE = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.3, 0, 0.5, 1}};
+  return robot_state;
+}
+
+// Joint i moves axis i, joint 7 does not contribute.
+ModelQuantities createQuantities() {
+  ModelQuantities quantities;
+  for (size_t i = 0; i < 6; i++) {
+    quantities.zero_jacobian[i * 6 + i] = 1.0;
+  }
+  return quantities;
+}
+
+}  // anonymous namespace
+
+TEST(HybridForceMotionController, ThrowsOnInvalidParameters) {
+  HybridForceMotionParameters parameters;
+  parameters.stiffness[1] = -1.0;
+  EXPECT_THROW(HybridForceMotionController{parameters}, std::invalid_argument);
+
+  parameters = HybridForceMotionParameters();
+  parameters.force_integral_gain[2] = -1.0;
+  EXPECT_THROW(HybridForceMotionController{parameters}, std::invalid_argument);
+}
+
+TEST(HybridForceMotionController, HoldsInitialPose) {
+  HybridForceMotionController controller;
+  ModelQuantities quantities = createQuantities();
+  quantities.coriolis = {{1, 2, 3, 4, 5, 6, 7}};
+
+  RobotState robot_state = createState();
+  Torques torques = controller(robot_state, Duration(0), quantities);
+  EXPECT_EQ(quantities.coriolis, torques.tau_J);
+
+  robot_state.O_T_EE[12] = 0.31;
+  robot_state.O_T_EE[14] = 0.6;
+  torques = controller(robot_state, Duration(1), quantities);
+  EXPECT_NEAR(1.0 - 10.0, torques.tau_J[0], 1e-9);
+  // z is force controlled and ignores the position error.
+  EXPECT_DOUBLE_EQ(3.0, torques.tau_J[2]);
+}
+
+TEST(HybridForceMotionController, RestoresOrientation) {
+  HybridForceMotionController controller;
+  ModelQuantities quantities = createQuantities();
+  controller(createState(), Duration(0), quantities);
+
+  // Rotate about z by a small positive angle.
+  const double angle = 0.1;
+  RobotState robot_state = createState();
+  robot_state.O_T_EE[0] = std::cos(angle);
+  robot_state.O_T_EE[1] = std::sin(angle);
+  robot_state.O_T_EE[4] = -std::sin(angle);
+  robot_state.O_T_EE[5] = std::cos(angle);
+  Torques torques = controller(robot_state, Duration(1), quantities);
+  EXPECT_NEAR(-50.0 * std::sin(angle / 2), torques.tau_J[5], 1e-9);
+  EXPECT_NEAR(0.0, torques.tau_J[3], 1e-9);
+}
+
+TEST(HybridForceMotionController, DampsVelocity) {
+  HybridForceMotionController controller;
+  RobotState robot_state = createState();
+  robot_state.dq = {{0.1, 0, -0.2, 0, 0, 0, 5.0}};
+  Torques torques = controller(robot_state, Duration(1), createQuantities());
+  EXPECT_DOUBLE_EQ(-6.3, torques.tau_J[0]);
+  EXPECT_DOUBLE_EQ(12.6, torques.tau_J[2]);
+  EXPECT_EQ(0.0, torques.tau_J[6]);
+}
+
+TEST(HybridForceMotionController, RegulatesForceWithLimitedIntegral) {
+  HybridForceMotionParameters parameters;
+  parameters.coriolis_compensation = false;
+  HybridForceMotionController controller(parameters);
+  controller.setDesiredWrench({{5.0, 0, -10.0, 0, 0, 0}});
+  ModelQuantities quantities = createQuantities();
+
+  RobotState robot_state = createState();
+  robot_state.O_F_ext_hat_K[2] = -6.0;
+  Torques torques = controller(robot_state, Duration(0), quantities);
+  // Feedforward and proportional term only; x is motion controlled.
+  EXPECT_DOUBLE_EQ(-10.0 + 0.5 * -4.0, torques.tau_J[2]);
+  EXPECT_EQ(0.0, torques.tau_J[0]);
+
+  torques = controller(robot_state, Duration(100), quantities);
+  EXPECT_DOUBLE_EQ(-10.0 + 0.5 * -4.0 + 5.0 * 0.1 * -4.0, torques.tau_J[2]);
+
+  for (size_t i = 0; i < 1000; i++) {
+    torques = controller(robot_state, Duration(100), quantities);
+  }
+  EXPECT_DOUBLE_EQ(-10.0 + 0.5 * -4.0 - 20.0, torques.tau_J[2]);
+
+  // The integrator recovers from the bound immediately.
+  robot_state.O_F_ext_hat_K[2] = -14.0;
+  torques = controller(robot_state, Duration(100), quantities);
+  EXPECT_DOUBLE_EQ(-10.0 + 0.5 * 4.0 - 20.0 + 5.0 * 0.1 * 4.0, torques.tau_J[2]);
+
+  controller.reset();
+  torques = controller(robot_state, Duration(0), quantities);
+  EXPECT_DOUBLE_EQ(-10.0 + 0.5 * 4.0, torques.tau_J[2]);
+}
+
+TEST(HybridForceMotionController, TracksDesiredPose) {
+  HybridForceMotionParameters parameters;
+  parameters.coriolis_compensation = false;
+  HybridForceMotionController controller(parameters);
+  RobotState robot_state = createState();
+  std::array<double, 16> desired_pose = robot_state.O_T_EE;
+  desired_pose[13] = 0.01;
+  controller.setDesiredPose(desired_pose);
+
+  Torques torques = controller(robot_state, Duration(1), createQuantities());
+  EXPECT_DOUBLE_EQ(10.0, torques.tau_J[1]);
+  EXPECT_EQ(0.0, torques.tau_J[0]);
+}
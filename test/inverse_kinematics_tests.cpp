@@ -0,0 +1,185 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <franka/inverse_kinematics.h>
+#include <franka/kinematics.h>
+#include <franka/robot_traits.h>
+
+using namespace franka;
+
+namespace {
+
+const std::array<double, 16> kIdentity{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+
+std::array<double, 16> hand() {
+  Eigen::Affine3d transform(Eigen::AngleAxisd(-M_PI_4, Eigen::Vector3d::UnitZ()));
+  transform.pretranslate(Eigen::Vector3d(0.0, 0.0, 0.1034));
+  std::array<double, 16> F_T_EE;  // NOLINT(readability-identifier-naming)
+  Eigen::Map<Eigen::Matrix4d>(F_T_EE.data()) = transform.matrix();
+  return F_T_EE;
+}
+
+std::array<double, 7> randomJointPosition(std::mt19937* generator) {
+  std::array<double, 7> q;
+  for (size_t i = 0; i < 7; i++) {
+    // Stay away from the limits, where solutions are rejected.
+    std::uniform_real_distribution<double> distribution(
+        PandaTraits::minJointPosition()[i] + 0.01, PandaTraits::maxJointPosition()[i] - 0.01);
+    q[i] = distribution(*generator);
+  }
+  return q;
+}
+
+bool isApprox(const std::array<double, 16>& a, const std::array<double, 16>& b) {
+  return Eigen::Map<const Eigen::Matrix4d>(a.data())
+      .isApprox(Eigen::Map<const Eigen::Matrix4d>(b.data()), 1e-9);
+}
+
+double distance(const std::array<double, 7>& a, const std::array<double, 7>& b) {
+  return (Eigen::Map<const Eigen::Matrix<double, 7, 1>>(a.data()) -
+          Eigen::Map<const Eigen::Matrix<double, 7, 1>>(b.data()))
+      .norm();
+}
+
+}  // anonymous namespace
+
+TEST(InverseKinematics, FindsAllBranchesOfRandomPoses) {
+  std::mt19937 generator(42);
+  Kinematics kinematics;
+  std::array<double, 16> F_T_EE = hand();  // NOLINT(readability-identifier-naming)
+  InverseKinematics inverse_kinematics(F_T_EE);
+
+  for (int i = 0; i < 1000; i++) {
+    std::array<double, 7> q = randomJointPosition(&generator);
+    std::array<double, 16> pose = kinematics.pose(Frame::kEndEffector, q, F_T_EE, kIdentity);
+
+    InverseKinematics::Solutions solutions;
+    size_t count = inverse_kinematics.solve(pose, q[6], &solutions);
+    ASSERT_GE(count, 1u);
+    ASSERT_LE(count, InverseKinematics::kMaxSolutions);
+
+    double minimum_distance = 1.0;
+    for (size_t j = 0; j < count; j++) {
+      for (size_t k = 0; k < 7; k++) {
+        EXPECT_GT(solutions[j][k], PandaTraits::minJointPosition()[k]);
+        EXPECT_LT(solutions[j][k], PandaTraits::maxJointPosition()[k]);
+      }
+      EXPECT_EQ(q[6], solutions[j][6]);
+      EXPECT_TRUE(isApprox(pose, kinematics.pose(Frame::kEndEffector, solutions[j], F_T_EE,
+                                                 kIdentity)))
+          << "Solution " << j << " of sample " << i;
+      minimum_distance = std::min(minimum_distance, distance(q, solutions[j]));
+    }
+    EXPECT_LT(minimum_distance, 1e-6) << "Sample " << i;
+  }
+}
+
+TEST(InverseKinematics, SolvesFlangePoses) {
+  Kinematics kinematics;
+  InverseKinematics inverse_kinematics;
+  std::array<double, 7> q{{0.1, -0.4, 0.3, -2.2, 0.2, 1.7, 0.6}};
+  std::array<double, 16> pose = kinematics.pose(Frame::kFlange, q, kIdentity, kIdentity);
+
+  std::array<double, 7> solution;
+  ASSERT_TRUE(inverse_kinematics.solveClosest(pose, q, &solution));
+  EXPECT_LT(distance(q, solution), 1e-9);
+}
+
+TEST(InverseKinematics, SolvesReadyPose) {
+  // End effector pose of the Franka Hand in the ready pose of the examples, independent of
+  // franka::Kinematics.
+  const std::array<double, 7> ready{{0.0, -M_PI_4, 0.0, -3 * M_PI_4, 0.0, M_PI_2, M_PI_4}};
+  const std::array<double, 16> O_T_EE{  // NOLINT(readability-identifier-naming)
+      {1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.306890567, 0.0,
+       0.486882052, 1.0}};
+  InverseKinematics inverse_kinematics(hand());
+
+  InverseKinematics::Solutions solutions;
+  size_t count = inverse_kinematics.solve(O_T_EE, ready[6], &solutions);
+  double closest = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < count; i++) {
+    closest = std::min(closest, distance(ready, solutions[i]));
+  }
+  EXPECT_LT(closest, 1e-7);
+}
+
+TEST(InverseKinematics, UsesGivenJoint1IfJoint2IsAtZero) {
+  Kinematics kinematics;
+  InverseKinematics inverse_kinematics;
+  std::array<double, 7> q{{0.5, 0.0, 0.2, -1.8, 0.1, 1.6, 0.3}};
+  std::array<double, 16> pose = kinematics.pose(Frame::kFlange, q, kIdentity, kIdentity);
+
+  InverseKinematics::Solutions solutions;
+  size_t count = inverse_kinematics.solve(pose, q[6], &solutions, -0.3);
+  ASSERT_GE(count, 1u);
+  bool found = false;
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_TRUE(
+        isApprox(pose, kinematics.pose(Frame::kFlange, solutions[i], kIdentity, kIdentity)));
+    if (solutions[i][1] == 0.0) {
+      found = true;
+      EXPECT_EQ(-0.3, solutions[i][0]);
+      EXPECT_NEAR(q[0] + q[2], solutions[i][0] + solutions[i][2], 1e-9);
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(InverseKinematics, RejectsUnreachablePoses) {
+  InverseKinematics inverse_kinematics;
+  InverseKinematics::Solutions solutions;
+
+  std::array<double, 16> pose = kIdentity;
+  pose[12] = 2.0;
+  EXPECT_EQ(0u, inverse_kinematics.solve(pose, 0.0, &solutions));
+
+  // Reachable, but not with q7 outside of its limits.
+  Kinematics kinematics;
+  std::array<double, 7> q{{0.1, -0.4, 0.3, -2.2, 0.2, 1.7, 0.6}};
+  pose = kinematics.pose(Frame::kFlange, q, kIdentity, kIdentity);
+  EXPECT_EQ(0u, inverse_kinematics.solve(pose, 3.0, &solutions));
+
+  std::vector<std::array<double, 7>> batch{{}};
+  EXPECT_EQ(0u, inverse_kinematics.solve(pose, std::vector<double>{3.0, -3.0}, &batch));
+  EXPECT_TRUE(batch.empty());
+}
+
+TEST(InverseKinematics, BatchedSolveMatchesSingleSolves) {
+  Kinematics kinematics;
+  std::array<double, 16> F_T_EE = hand();  // NOLINT(readability-identifier-naming)
+  InverseKinematics inverse_kinematics(F_T_EE);
+  std::array<double, 7> q{{-0.2, 0.3, -0.1, -2.0, 0.4, 2.1, -0.5}};
+  std::array<double, 16> pose = kinematics.pose(Frame::kEndEffector, q, F_T_EE, kIdentity);
+
+  // Not a multiple of the block size.
+  std::vector<double> q7;
+  for (int i = 0; i < 29; i++) {
+    q7.push_back(-2.8 + 0.2 * i);
+  }
+  std::vector<std::array<double, 7>> batch;
+  size_t count = inverse_kinematics.solve(pose, q7, &batch);
+  EXPECT_EQ(batch.size(), count);
+
+  std::vector<std::array<double, 7>> expected;
+  for (double sample : q7) {
+    InverseKinematics::Solutions solutions;
+    size_t sample_count = inverse_kinematics.solve(pose, sample, &solutions);
+    expected.insert(expected.end(), solutions.begin(), solutions.begin() + sample_count);
+  }
+  ASSERT_EQ(expected.size(), batch.size());
+  ASSERT_GT(batch.size(), q7.size() / 2);
+  for (size_t i = 0; i < batch.size(); i++) {
+    EXPECT_LT(distance(expected[i], batch[i]), 1e-12);
+    EXPECT_TRUE(
+        isApprox(pose, kinematics.pose(Frame::kEndEffector, batch[i], F_T_EE, kIdentity)));
+  }
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cmath>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <franka/exception.h>
+#include <franka/kinematics.h>
+
+using franka::Frame;
+using franka::KinematicCalibration;
+using franka::Kinematics;
+
+namespace {
+
+const std::array<double, 16> kIdentity{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+const std::array<double, 7> kQ{{0.1, -0.4, 0.3, -2.0, 0.2, 1.7, 0.6}};
+
+std::array<double, 16> endEffector() {
+  Eigen::Affine3d transform(Eigen::AngleAxisd(-M_PI_4, Eigen::Vector3d::UnitZ()));
+  transform.pretranslate(Eigen::Vector3d(0.0, 0.0, 0.1034));
+  std::array<double, 16> F_T_EE;  // NOLINT(readability-identifier-naming)
+  Eigen::Map<Eigen::Matrix4d>(F_T_EE.data()) = transform.matrix();
+  return F_T_EE;
+}
+
+KinematicCalibration calibration() {
+  KinematicCalibration calibration;
+  for (size_t i = 0; i < calibration.links.size(); i++) {
+    calibration.links[i].a = 0.001 * i;
+    calibration.links[i].d = -0.0005 * i;
+    calibration.links[i].alpha = 0.002 * (i % 3);
+    calibration.links[i].theta = -0.001 * i;
+  }
+  return calibration;
+}
+
+}  // anonymous namespace
+
+TEST(Kinematics, CalculatesNominalFlangePoseInZeroConfiguration) {
+  Kinematics kinematics;
+
+  std::array<double, 16> pose = kinematics.pose(Frame::kFlange, {}, kIdentity, kIdentity);
+  Eigen::Matrix4d expected;
+  expected << 1, 0, 0, 0.088, 0, -1, 0, 0, 0, 0, -1, 0.926, 0, 0, 0, 1;
+  EXPECT_TRUE(Eigen::Map<Eigen::Matrix4d>(pose.data()).isApprox(expected));
+
+  pose = kinematics.pose(Frame::kJoint4, {}, kIdentity, kIdentity);
+  EXPECT_NEAR(0.0825, pose[12], 1e-12);
+  EXPECT_NEAR(0.0, pose[13], 1e-12);
+  EXPECT_NEAR(0.649, pose[14], 1e-12);
+}
+
+TEST(Kinematics, MatchesNominalEndEffectorPoses) {
+  // End effector poses of the robot with the Franka Hand, calculated from the joint origins in the
+  // URDF of franka_description. The first configuration is the ready pose of the examples, with
+  // the end effector at (0.307, 0, 0.487) pointing downwards.
+  const std::array<std::array<double, 7>, 4> configurations{{
+      {{0.0, -M_PI_4, 0.0, -3 * M_PI_4, 0.0, M_PI_2, M_PI_4}},
+      kQ,
+      {{-1.2, 0.8, 1.5, -1.1, -2.0, 3.1, -2.5}},
+      {{2.5, 1.2, -2.2, -0.3, 2.6, 0.4, 1.9}},
+  }};
+  const std::array<std::array<double, 16>, 4> expected_poses{{
+      {{1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.306890567, 0.0,
+        0.486882052, 1.0}},
+      {{0.849975310, 0.517677851, 0.097732368, 0.0, 0.524631555, -0.848649161, -0.067500612, 0.0,
+        0.047996921, 0.108647338, -0.992920969, 0.0, 0.396784171, 0.222840228, 0.517776925,
+        1.0}},
+      {{0.009095003, -0.964761713, -0.262967903, 0.0, 0.261540466, 0.256119458, -0.930590892, 0.0,
+        0.965149660, -0.060313021, 0.254653636, 0.0, 0.712499146, -0.186592822, 0.794301664,
+        1.0}},
+      {{0.123158756, 0.788852651, -0.602115782, 0.0, 0.967677207, 0.039089364, 0.249144224, 0.0,
+        0.220074405, -0.613338011, -0.758540533, 0.0, -0.476747233, 0.353876503, 0.450913806,
+        1.0}},
+  }};
+
+  Kinematics kinematics;
+  for (size_t i = 0; i < configurations.size(); i++) {
+    std::array<double, 16> pose =
+        kinematics.pose(Frame::kEndEffector, configurations[i], endEffector(), kIdentity);
+    for (size_t j = 0; j < pose.size(); j++) {
+      EXPECT_NEAR(expected_poses[i][j], pose[j], 1e-8)
+          << "Configuration " << i << ", element " << j;
+    }
+  }
+}
+
+TEST(Kinematics, AppliesEndEffectorAndStiffnessFrames) {
+  Kinematics kinematics(calibration());
+  std::array<double, 16> F_T_EE = endEffector();  // NOLINT(readability-identifier-naming)
+  Eigen::Affine3d EE_T_K(  // NOLINT(readability-identifier-naming)
+      Eigen::Translation3d(0.01, 0.02, 0.03));
+
+  franka::RobotState robot_state;
+  robot_state.q = kQ;
+  robot_state.F_T_EE = F_T_EE;
+  Eigen::Map<Eigen::Matrix4d>(robot_state.EE_T_K.data()) = EE_T_K.matrix();
+
+  std::array<double, 16> flange = kinematics.pose(Frame::kFlange, robot_state);
+  std::array<double, 16> end_effector = kinematics.pose(Frame::kEndEffector, robot_state);
+  std::array<double, 16> stiffness = kinematics.pose(Frame::kStiffness, robot_state);
+
+  Eigen::Matrix4d expected =
+      Eigen::Map<Eigen::Matrix4d>(flange.data()) * Eigen::Map<Eigen::Matrix4d>(F_T_EE.data());
+  EXPECT_TRUE(Eigen::Map<Eigen::Matrix4d>(end_effector.data()).isApprox(expected));
+  expected = expected * EE_T_K.matrix();
+  EXPECT_TRUE(Eigen::Map<Eigen::Matrix4d>(stiffness.data()).isApprox(expected));
+}
+
+TEST(Kinematics, CalibrationCorrectsPose) {
+  KinematicCalibration calibration;
+  calibration.links[0].d = 0.01;
+  calibration.links[0].theta = 0.2;
+  Kinematics nominal;
+  Kinematics calibrated(calibration);
+
+  std::array<double, 7> q = kQ;
+  std::array<double, 16> calibrated_pose = calibrated.pose(Frame::kFlange, q, kIdentity, kIdentity);
+  q[0] += 0.2;
+  std::array<double, 16> nominal_pose = nominal.pose(Frame::kFlange, q, kIdentity, kIdentity);
+  nominal_pose[14] += 0.01;
+
+  for (size_t i = 0; i < nominal_pose.size(); i++) {
+    EXPECT_NEAR(nominal_pose[i], calibrated_pose[i], 1e-12);
+  }
+
+  // The flange link moves and rotates the flange along and about its z axis.
+  calibration = KinematicCalibration();
+  calibration.links[7].d = 0.005;
+  calibration.links[7].theta = 0.1;
+  nominal_pose = nominal.pose(Frame::kFlange, kQ, kIdentity, kIdentity);
+  calibrated_pose = Kinematics(calibration).pose(Frame::kFlange, kQ, kIdentity, kIdentity);
+  Eigen::Affine3d offset(Eigen::Translation3d(0.0, 0.0, 0.005) *
+                         Eigen::AngleAxisd(0.1, Eigen::Vector3d::UnitZ()));
+  Eigen::Matrix4d expected = Eigen::Map<Eigen::Matrix4d>(nominal_pose.data()) * offset.matrix();
+  EXPECT_TRUE(Eigen::Map<Eigen::Matrix4d>(calibrated_pose.data()).isApprox(expected, 1e-12));
+}
+
+TEST(Kinematics, JacobiansMatchFiniteDifferences) {
+  Kinematics kinematics(calibration());
+  std::array<double, 16> F_T_EE = endEffector();  // NOLINT(readability-identifier-naming)
+  constexpr double kDelta = 1e-7;
+
+  for (Frame frame : {Frame::kJoint3, Frame::kJoint7, Frame::kFlange, Frame::kEndEffector}) {
+    std::array<double, 16> pose_array = kinematics.pose(frame, kQ, F_T_EE, kIdentity);
+    Eigen::Affine3d pose(Eigen::Map<Eigen::Matrix4d>(pose_array.data()));
+    std::array<double, 42> zero_jacobian = kinematics.zeroJacobian(frame, kQ, F_T_EE, kIdentity);
+    std::array<double, 42> body_jacobian = kinematics.bodyJacobian(frame, kQ, F_T_EE, kIdentity);
+
+    for (size_t joint = 0; joint < 7; joint++) {
+      std::array<double, 7> q = kQ;
+      q[joint] += kDelta;
+      std::array<double, 16> moved_array = kinematics.pose(frame, q, F_T_EE, kIdentity);
+      Eigen::Affine3d moved(Eigen::Map<Eigen::Matrix4d>(moved_array.data()));
+
+      Eigen::Matrix<double, 6, 1> expected;
+      expected.head<3>() = (moved.translation() - pose.translation()) / kDelta;
+      Eigen::AngleAxisd rotation(moved.linear() * pose.linear().transpose());
+      expected.tail<3>() = rotation.axis() * rotation.angle() / kDelta;
+
+      Eigen::Map<Eigen::Matrix<double, 6, 1>> actual(&zero_jacobian[6 * joint]);
+      EXPECT_TRUE(actual.isApprox(expected, 1e-5) || (actual - expected).norm() < 1e-6)
+          << "Frame " << static_cast<int>(frame) << ", joint " << joint;
+
+      Eigen::Map<Eigen::Matrix<double, 6, 1>> body(&body_jacobian[6 * joint]);
+      EXPECT_TRUE(body.head<3>().isApprox(pose.linear().transpose() * actual.head<3>()));
+      EXPECT_TRUE(body.tail<3>().isApprox(pose.linear().transpose() * actual.tail<3>()));
+    }
+  }
+}
+
+TEST(Kinematics, CanReadCalibration) {
+  std::istringstream input(
+      "# link a d alpha theta\n"
+      "joint2 0.001 -0.002 0.003 -0.004\n"
+      "\n"
+      "flange 0 0.005 0 0.1  # tool flange\n");
+
+  KinematicCalibration calibration = franka::readKinematicCalibration(input);
+
+  EXPECT_EQ(0.001, calibration.links[1].a);
+  EXPECT_EQ(-0.002, calibration.links[1].d);
+  EXPECT_EQ(0.003, calibration.links[1].alpha);
+  EXPECT_EQ(-0.004, calibration.links[1].theta);
+  EXPECT_EQ(0.005, calibration.links[7].d);
+  EXPECT_EQ(0.1, calibration.links[7].theta);
+  EXPECT_EQ(0.0, calibration.links[0].a);
+  EXPECT_EQ(0.0, calibration.links[6].theta);
+}
+
+TEST(Kinematics, ThrowsOnInvalidCalibration) {
+  for (const char* text : {"joint8 0 0 0 0\n", "joint1 0 0 0\n", "joint1 0 0 0 0 0\n",
+                           "joint1 0 x 0 0\n"}) {
+    std::istringstream input(text);
+    EXPECT_THROW(franka::readKinematicCalibration(input), franka::ModelException) << text;
+  }
+}
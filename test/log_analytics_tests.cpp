@@ -0,0 +1,233 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <franka/log_analytics.h>
+#include <franka/log_file.h>
+#include <franka/model.h>
+
+#include "helpers.h"
+#include "mock_model_library.h"
+
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::WithArgs;
+using ::testing::_;
+using namespace franka;
+
+namespace {
+
+class LogAnalytics : public ::testing::Test {
+ public:
+  ~LogAnalytics() {
+    for (const std::string& path : paths_) {
+      std::remove(path.c_str());
+    }
+  }
+
+  // Writes a log file with records at the given robot times. Each record has a host time of
+  // 1000 times its robot time in nanoseconds and q[0] equal to its robot time in seconds.
+  std::string writeLog(uint64_t first_time, size_t count) {
+    std::vector<Record> records(count);
+    for (size_t i = 0; i < count; i++) {
+      randomRobotState(records[i].state);
+      uint64_t time = first_time + i;
+      records[i].state.time = Duration(time);
+      records[i].state.q[0] = time / 1000.0;
+      records[i].state.control_command_success_rate = time % 2 == 0 ? 1.0 : 0.5;
+    }
+    return writeLog(records);
+  }
+
+  // Writes a log file with the given records. Host times are 1000 times the robot times.
+  std::string writeLog(const std::vector<Record>& records) {
+    std::string path = std::string(FRANKA_TEST_BINARY_DIR) + "/log_analytics_" +
+                       std::to_string(paths_.size()) + ".log";
+    paths_.push_back(path);
+
+    std::ofstream stream(path, std::ios::binary);
+    LogFileWriter writer(stream);
+    for (const Record& record : records) {
+      writer.write(record, std::chrono::nanoseconds(record.state.time.toMSec() * 1000));
+    }
+    return path;
+  }
+
+ private:
+  std::vector<std::string> paths_;
+};
+
+size_t countRecords(const LogDataset& dataset, const LogQuery& query, size_t threads) {
+  std::atomic<size_t> count{0};
+  dataset.forEach(query, [&](size_t, const Record&, std::chrono::nanoseconds) { count++; },
+                  threads);
+  return count;
+}
+
+}  // anonymous namespace
+
+TEST_F(LogAnalytics, CanVisitAllRecords) {
+  LogDataset dataset({writeLog(0, 3000), writeLog(10000, 2000)});
+  EXPECT_EQ(5000u, dataset.size());
+  EXPECT_EQ(5000u, countRecords(dataset, LogQuery(), 1));
+  EXPECT_EQ(5000u, countRecords(dataset, LogQuery(), 4));
+}
+
+TEST_F(LogAnalytics, CanOpenEmptyLog) {
+  LogDataset dataset({writeLog(0, 0)});
+  EXPECT_EQ(0u, dataset.size());
+  EXPECT_EQ(0u, countRecords(dataset, LogQuery(), 4));
+}
+
+TEST_F(LogAnalytics, ThrowsIfLogCannotBeOpened) {
+  EXPECT_THROW(LogDataset({std::string(FRANKA_TEST_BINARY_DIR) + "/nonexistent.log"}),
+               LogFileException);
+}
+
+TEST_F(LogAnalytics, FiltersRecords) {
+  LogDataset dataset({writeLog(0, 3000), writeLog(10000, 2000)});
+
+  EXPECT_EQ(201u, countRecords(dataset, LogQuery().robotTime(Duration(2900), Duration(10100)), 4));
+  EXPECT_EQ(101u, countRecords(dataset,
+                               LogQuery().hostTime(std::chrono::microseconds(100),
+                                                   std::chrono::microseconds(200)),
+                               4));
+  EXPECT_EQ(1000u, countRecords(dataset, LogQuery().range(&RobotState::q, 0, 11.0, 12.0), 4));
+  EXPECT_EQ(0u, countRecords(dataset,
+                             LogQuery()
+                                 .range(&RobotState::q, 0, 11.0, 12.0)
+                                 .robotTime(Duration(0), Duration(3000)),
+                             4));
+  EXPECT_EQ(2500u, countRecords(dataset,
+                                LogQuery().range(&RobotState::control_command_success_rate, 0.75,
+                                                 1.0),
+                                4));
+  EXPECT_THROW(LogQuery().range(&RobotState::q, 7, 0.0, 1.0), std::invalid_argument);
+}
+
+TEST_F(LogAnalytics, PassesDecodedRecords) {
+  LogDataset dataset({writeLog(42, 1)});
+  dataset.forEach(LogQuery(),
+                  [](size_t worker, const Record& record, std::chrono::nanoseconds host_time) {
+                    EXPECT_EQ(0u, worker);
+                    EXPECT_EQ(42u, record.state.time.toMSec());
+                    EXPECT_EQ(0.042, record.state.q[0]);
+                    EXPECT_EQ(42000, host_time.count());
+                  },
+                  4);
+}
+
+TEST_F(LogAnalytics, CanMapAndReduce) {
+  LogDataset dataset({writeLog(1, 5000)});
+  uint64_t sum = dataset.mapReduce<uint64_t>(
+      LogQuery(), 0,
+      [](uint64_t& partial, const Record& record, std::chrono::nanoseconds) {
+        partial += record.state.time.toMSec();
+      },
+      [](uint64_t& result, const uint64_t& partial) { result += partial; }, 4);
+  EXPECT_EQ(5000u * 5001u / 2, sum);
+}
+
+TEST_F(LogAnalytics, RethrowsCallbackExceptions) {
+  LogDataset dataset({writeLog(0, 5000)});
+  EXPECT_THROW(dataset.forEach(LogQuery(),
+                               [](size_t, const Record& record, std::chrono::nanoseconds) {
+                                 if (record.state.time.toMSec() == 4321) {
+                                   throw std::runtime_error("");
+                                 }
+                               },
+                               4),
+               std::runtime_error);
+}
+
+TEST_F(LogAnalytics, CanComputeSuccessRates) {
+  LogDataset dataset({writeLog(0, 3000)});
+  std::vector<SuccessRateBucket> buckets =
+      computeSuccessRates(dataset, std::chrono::milliseconds(1), LogQuery(), 4);
+  ASSERT_EQ(3u, buckets.size());
+  for (size_t i = 0; i < buckets.size(); i++) {
+    EXPECT_EQ(std::chrono::milliseconds(i), buckets[i].start);
+    EXPECT_EQ(1000u, buckets[i].samples);
+    EXPECT_DOUBLE_EQ(0.75, buckets[i].mean);
+    EXPECT_EQ(0.5, buckets[i].min);
+  }
+
+  EXPECT_THROW(computeSuccessRates(dataset, std::chrono::nanoseconds(0)), std::invalid_argument);
+}
+
+TEST_F(LogAnalytics, CanComputeModelResiduals) {
+  // The joint torques of the two records are 10 and 12 Nm.
+  std::vector<Record> records(2);
+  for (size_t i = 0; i < records.size(); i++) {
+    randomRobotState(records[i].state);
+    records[i].state.time = Duration(i);
+    records[i].state.tau_J.fill(10.0 + 2.0 * i);
+    for (size_t j = 0; j < 7; j++) {
+      records[i].state.ddq_d[j] = j;
+    }
+    records[i].state.O_T_EE = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.3, 0.0, 0.5, 1}};
+  }
+  records[1].state.O_T_EE[12] += 0.003;
+  records[1].state.O_T_EE[13] += 0.004;
+  LogDataset dataset({writeLog(records)});
+
+  NiceMock<MockModel> mock;
+  ON_CALL(mock, g_NE(_, _, _, _, _)).WillByDefault(WithArgs<4>(Invoke([](double* output) {
+    for (size_t i = 0; i < 7; i++) {
+      output[i] = i + 1.0;
+    }
+  })));
+  ON_CALL(mock, c_NE(_, _, _, _, _, _)).WillByDefault(WithArgs<5>(Invoke([](double* output) {
+    std::fill(output, output + 7, 0.5);
+  })));
+  ON_CALL(mock, M_NE(_, _, _, _, _)).WillByDefault(WithArgs<4>(Invoke([](double* output) {
+    std::fill(output, output + 49, 0.0);
+    for (size_t i = 0; i < 7; i++) {
+      output[i * 8] = 2.0;
+    }
+  })));
+  ON_CALL(mock, O_T_J9(_, _, _)).WillByDefault(WithArgs<2>(Invoke([](double* output) {
+    std::array<double, 16> pose{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.3, 0.0, 0.5, 1}};
+    std::copy(pose.cbegin(), pose.cend(), output);
+  })));
+  model_library_interface = &mock;
+
+  Model model(std::string(FRANKA_TEST_BINARY_DIR) + "/libfcimodels.so");
+  ModelResiduals residuals = computeModelResiduals(dataset, model, LogQuery(), 2);
+  model_library_interface = nullptr;
+
+  EXPECT_EQ(2u, residuals.samples);
+  for (size_t i = 0; i < 7; i++) {
+    // tau_J - g with g_i = i + 1.
+    double gravity_residuals[] = {9.0 - i, 11.0 - i};
+    EXPECT_DOUBLE_EQ(10.0 - i, residuals.gravity.mean[i]);
+    EXPECT_DOUBLE_EQ(std::sqrt((gravity_residuals[0] * gravity_residuals[0] +
+                                gravity_residuals[1] * gravity_residuals[1]) /
+                               2.0),
+                     residuals.gravity.rms[i]);
+    EXPECT_DOUBLE_EQ(11.0 - i, residuals.gravity.max[i]);
+
+    // tau_J - (M ddq_d + c + g) with M = 2 I, ddq_d,i = i and c_i = 0.5.
+    double dynamics_residuals[] = {8.5 - 3.0 * i, 10.5 - 3.0 * i};
+    EXPECT_DOUBLE_EQ(9.5 - 3.0 * i, residuals.dynamics.mean[i]);
+    EXPECT_DOUBLE_EQ(std::sqrt((dynamics_residuals[0] * dynamics_residuals[0] +
+                                dynamics_residuals[1] * dynamics_residuals[1]) /
+                               2.0),
+                     residuals.dynamics.rms[i]);
+    EXPECT_DOUBLE_EQ(
+        std::max(std::abs(dynamics_residuals[0]), std::abs(dynamics_residuals[1])),
+        residuals.dynamics.max[i]);
+  }
+  EXPECT_NEAR(0.005 / std::sqrt(2.0), residuals.translational_rms, 1e-12);
+  EXPECT_NEAR(0.005, residuals.translational_max, 1e-12);
+}
@@ -0,0 +1,220 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cstring>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <franka/field_descriptors.h>
+#include <franka/log_file.h>
+
+#include "helpers.h"
+
+using namespace franka;
+
+namespace {
+
+Record randomRecord() {
+  Record record;
+  randomRobotState(record.state);
+  for (double& element : record.command.joint_positions.q) {
+    element = randomDouble();
+  }
+  for (double& element : record.command.joint_velocities.dq) {
+    element = randomDouble();
+  }
+  for (double& element : record.command.cartesian_pose.O_T_EE) {
+    element = randomDouble();
+  }
+  for (double& element : record.command.cartesian_velocities.O_dP_EE) {
+    element = randomDouble();
+  }
+  for (double& element : record.command.torques.tau_J) {
+    element = randomDouble();
+  }
+  for (double& element : record.joint_power) {
+    element = randomDouble();
+  }
+  return record;
+}
+
+void testRecordsAreEqual(const Record& expected, const Record& actual) {
+  testRobotStatesAreEqual(expected.state, actual.state);
+  EXPECT_EQ(expected.command.joint_positions.q, actual.command.joint_positions.q);
+  EXPECT_EQ(expected.command.joint_velocities.dq, actual.command.joint_velocities.dq);
+  EXPECT_EQ(expected.command.cartesian_pose.O_T_EE, actual.command.cartesian_pose.O_T_EE);
+  EXPECT_EQ(expected.command.cartesian_pose.elbow, actual.command.cartesian_pose.elbow);
+  EXPECT_EQ(expected.command.cartesian_velocities.O_dP_EE,
+            actual.command.cartesian_velocities.O_dP_EE);
+  EXPECT_EQ(expected.command.torques.tau_J, actual.command.torques.tau_J);
+  EXPECT_EQ(expected.joint_power, actual.joint_power);
+}
+
+// Converts a log file with a single record to an older version by removing the fields that were
+// added later.
+std::string downgradeLogFile(std::string data, uint32_t version) {
+  constexpr size_t kHeaderSize = 16;
+  constexpr size_t kJointPowerSize = 7 * sizeof(double);
+  // Joint power, current and last motion errors, robot mode, robot time and host time.
+  constexpr size_t kJointPowerOffsetFromEnd =
+      kJointPowerSize + 2 * sizeof(uint64_t) + sizeof(uint8_t) + 2 * sizeof(uint64_t);
+
+  uint32_t record_size = 0;
+  std::memcpy(&record_size, &data[12], sizeof(record_size));
+  EXPECT_EQ(kHeaderSize + record_size, data.size());
+
+  data.erase(data.size() - kJointPowerOffsetFromEnd, kJointPowerSize);
+  record_size -= kJointPowerSize;
+  if (version < 2) {
+    data.resize(data.size() - sizeof(int64_t));
+    record_size -= sizeof(int64_t);
+  }
+  std::memcpy(&data[8], &version, sizeof(version));
+  std::memcpy(&data[12], &record_size, sizeof(record_size));
+  return data;
+}
+
+}  // anonymous namespace
+
+TEST(LogFile, CanWriteAndReadRecords) {
+  std::vector<Record> log{randomRecord(), randomRecord(), randomRecord()};
+
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+  writer.write(log);
+
+  LogFileReader reader(stream);
+  std::vector<Record> read_log = reader.readAll();
+  ASSERT_EQ(log.size(), read_log.size());
+  for (size_t i = 0; i < log.size(); i++) {
+    testRecordsAreEqual(log[i], read_log[i]);
+  }
+
+  Record record;
+  EXPECT_FALSE(reader.read(&record));
+}
+
+TEST(LogFile, StoresAllFields) {
+  Record expected = randomRecord();
+  for (double& element : expected.command.cartesian_pose.elbow) {
+    element = randomDouble();
+  }
+  for (double& element : expected.command.cartesian_velocities.elbow) {
+    element = randomDouble();
+  }
+
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+  writer.write(expected);
+
+  LogFileReader reader(stream);
+  Record record;
+  ASSERT_TRUE(reader.read(&record));
+  EXPECT_TRUE(differingFields(expected, record).none());
+  EXPECT_TRUE(differingFields(expected.state, record.state).none());
+  EXPECT_TRUE(differingFields(expected.command, record.command).none());
+}
+
+TEST(LogFile, CanReadEmptyLog) {
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+
+  LogFileReader reader(stream);
+  Record record;
+  EXPECT_FALSE(reader.read(&record));
+}
+
+TEST(LogFile, ThrowsOnInvalidHeader) {
+  std::stringstream stream("not a log file");
+  EXPECT_THROW(LogFileReader reader(stream), LogFileException);
+
+  std::stringstream empty_stream;
+  EXPECT_THROW(LogFileReader reader(empty_stream), LogFileException);
+}
+
+TEST(LogFile, ThrowsOnUnsupportedVersion) {
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+
+  std::string data = stream.str();
+  data[8] = static_cast<char>(kLogFileVersion + 1);
+  std::stringstream modified_stream(data);
+  EXPECT_THROW(LogFileReader reader(modified_stream), LogFileException);
+}
+
+TEST(LogFile, ThrowsOnTruncatedRecord) {
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+  writer.write(randomRecord());
+
+  std::string data = stream.str();
+  std::stringstream truncated_stream(data.substr(0, data.size() - 1));
+  LogFileReader reader(truncated_stream);
+  Record record;
+  EXPECT_THROW(reader.read(&record), LogFileException);
+}
+
+TEST(LogFile, StoresHostReceiveTime) {
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+  writer.write(randomRecord(), std::chrono::nanoseconds(123456789));
+  writer.write(randomRecord());
+
+  LogFileReader reader(stream);
+  Record record;
+  std::chrono::nanoseconds host_time;
+  ASSERT_TRUE(reader.read(&record, &host_time));
+  EXPECT_EQ(123456789, host_time.count());
+  ASSERT_TRUE(reader.read(&record, &host_time));
+  EXPECT_EQ(0, host_time.count());
+}
+
+TEST(LogFile, StoresJointPower) {
+  Record expected = randomRecord();
+  expected.joint_power = {{1.5, -2.0, 0.0, 12.25, -0.125, 3.0, 100.0}};
+
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+  writer.write(expected);
+
+  LogFileReader reader(stream);
+  Record record;
+  ASSERT_TRUE(reader.read(&record));
+  EXPECT_EQ(expected.joint_power, record.joint_power);
+  testRecordsAreEqual(expected, record);
+}
+
+TEST(LogFile, CanReadVersion2) {
+  Record expected = randomRecord();
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+  writer.write(expected, std::chrono::nanoseconds(1));
+
+  std::stringstream version2_stream(downgradeLogFile(stream.str(), 2));
+  LogFileReader reader(version2_stream);
+  Record record;
+  std::chrono::nanoseconds host_time;
+  ASSERT_TRUE(reader.read(&record, &host_time));
+  expected.joint_power = {};
+  testRecordsAreEqual(expected, record);
+  EXPECT_EQ(1, host_time.count());
+  EXPECT_FALSE(reader.read(&record));
+}
+
+TEST(LogFile, CanReadVersion1) {
+  Record expected = randomRecord();
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+  writer.write(expected, std::chrono::nanoseconds(1));
+
+  std::stringstream version1_stream(downgradeLogFile(stream.str(), 1));
+  LogFileReader reader(version1_stream);
+  Record record;
+  std::chrono::nanoseconds host_time;
+  ASSERT_TRUE(reader.read(&record, &host_time));
+  expected.joint_power = {};
+  testRecordsAreEqual(expected, record);
+  EXPECT_EQ(0, host_time.count());
+  EXPECT_FALSE(reader.read(&record));
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/log_merge.h>
+
+using namespace franka;
+
+namespace {
+
+using TimedState = std::pair<RobotState, std::chrono::nanoseconds>;
+
+RobotStateSource::ReadFunction readFrom(const std::vector<TimedState>& states) {
+  size_t index = 0;
+  return [states, index](RobotState* state, std::chrono::nanoseconds* host_time) mutable {
+    if (index >= states.size()) {
+      return false;
+    }
+    *state = states[index].first;
+    *host_time = states[index].second;
+    index++;
+    return true;
+  };
+}
+
+TimedState timedState(uint64_t robot_time, int64_t host_time, double q0) {
+  RobotState state;
+  state.time = Duration(robot_time);
+  state.q[0] = q0;
+  return {state, std::chrono::nanoseconds(host_time)};
+}
+
+std::vector<std::string> split(const std::string& line) {
+  std::vector<std::string> cells;
+  std::istringstream stream(line);
+  std::string cell;
+  while (std::getline(stream, cell, ',')) {
+    cells.push_back(cell);
+  }
+  if (!line.empty() && line.back() == ',') {
+    cells.emplace_back();
+  }
+  return cells;
+}
+
+std::vector<std::vector<std::string>> readTable(const std::string& csv) {
+  std::vector<std::vector<std::string>> table;
+  std::istringstream stream(csv);
+  std::string line;
+  while (std::getline(stream, line)) {
+    table.push_back(split(line));
+  }
+  return table;
+}
+
+}  // anonymous namespace
+
+TEST(ClockAlignment, UsesSmallestObservedOffset) {
+  ClockAlignment alignment;
+  EXPECT_FALSE(alignment.valid());
+  EXPECT_EQ(std::chrono::milliseconds(5), alignment.toHostTime(Duration(5)));
+
+  alignment.update(Duration(10), std::chrono::milliseconds(1010) + std::chrono::microseconds(300));
+  alignment.update(Duration(11), std::chrono::milliseconds(1011) + std::chrono::microseconds(100));
+  alignment.update(Duration(12), std::chrono::milliseconds(1012) + std::chrono::microseconds(900));
+  EXPECT_TRUE(alignment.valid());
+  EXPECT_EQ(std::chrono::milliseconds(1020) + std::chrono::microseconds(100),
+            alignment.toHostTime(Duration(20)));
+
+  alignment.reset();
+  EXPECT_FALSE(alignment.valid());
+}
+
+TEST(LogMerge, MergesSourcesByHostTime) {
+  // The second robot clock is 100 ms ahead and its states arrive with some jitter.
+  RobotStateSource left("left", readFrom({timedState(0, 1000000, 1.0),
+                                          timedState(1, 2000000, 2.0),
+                                          timedState(2, 3500000, 3.0)}));
+  RobotStateSource right("right", readFrom({timedState(100, 1500000, 10.0),
+                                            timedState(101, 2900000, 11.0)}));
+  std::vector<GripperState> gripper_states(1);
+  gripper_states[0].time = Duration(50);
+  gripper_states[0].width = 0.04;
+  GripperStateSource gripper("gripper", [&gripper_states](GripperState* state,
+                                                          std::chrono::nanoseconds* host_time) {
+    if (gripper_states.empty()) {
+      return false;
+    }
+    *state = gripper_states.back();
+    gripper_states.pop_back();
+    *host_time = std::chrono::nanoseconds(2200000);
+    return true;
+  });
+
+  std::ostringstream output;
+  EXPECT_EQ(6u, mergeLogs({&left, &right, &gripper}, output));
+
+  auto table = readTable(output.str());
+  ASSERT_EQ(7u, table.size());
+  const std::vector<std::string>& header = table[0];
+  size_t columns = 1 + left.columns().size() + right.columns().size() + gripper.columns().size();
+  ASSERT_EQ(columns, header.size());
+  EXPECT_EQ("host_time", header[0]);
+  EXPECT_EQ("left.time", header[1]);
+  size_t left_q0 = std::find(header.begin(), header.end(), "left.q[0]") - header.begin();
+  size_t right_q0 = std::find(header.begin(), header.end(), "right.q[0]") - header.begin();
+  size_t gripper_width =
+      std::find(header.begin(), header.end(), "gripper.width") - header.begin();
+  ASSERT_LT(gripper_width, header.size());
+
+  std::vector<std::string> host_times;
+  for (size_t i = 1; i < table.size(); i++) {
+    ASSERT_EQ(columns, table[i].size());
+    host_times.push_back(table[i][0]);
+  }
+  EXPECT_EQ((std::vector<std::string>{"1000000", "1500000", "2000000", "2200000", "2500000",
+                                      "3000000"}),
+            host_times);
+
+  // Empty before the first sample, then held until the next one.
+  EXPECT_EQ("1", table[1][left_q0]);
+  EXPECT_EQ("", table[1][right_q0]);
+  EXPECT_EQ("10", table[2][right_q0]);
+  EXPECT_EQ("1", table[2][left_q0]);
+  EXPECT_EQ("0.04", table[4][gripper_width]);
+  EXPECT_EQ("11", table[5][right_q0]);
+  EXPECT_EQ("0.04", table[6][gripper_width]);
+  EXPECT_EQ("3", table[6][left_q0]);
+}
+
+TEST(LogMerge, ReadsLogFiles) {
+  std::stringstream stream;
+  LogFileWriter writer(stream);
+  Record record;
+  record.state.time = Duration(7);
+  writer.write(record, std::chrono::nanoseconds(9000000));
+  record.state.time = Duration(8);
+  writer.write(record, std::chrono::nanoseconds(10500000));
+
+  LogFileReader reader(stream);
+  RobotStateSource source("robot", reader);
+  std::chrono::nanoseconds host_time;
+  std::vector<double> values;
+  ASSERT_TRUE(source.next(&host_time, &values));
+  EXPECT_EQ(9000000, host_time.count());
+  ASSERT_EQ(source.columns().size(), values.size());
+  EXPECT_EQ(7.0, values[0]);
+  ASSERT_TRUE(source.next(&host_time, &values));
+  EXPECT_EQ(10000000, host_time.count());
+  EXPECT_FALSE(source.next(&host_time, &values));
+}
+
+TEST(LogMerge, UsesDeviceTimeWithoutHostTime) {
+  RobotStateSource source("robot", readFrom({timedState(3, 0, 0.0), timedState(4, 0, 0.0)}));
+  std::chrono::nanoseconds host_time;
+  std::vector<double> values;
+  ASSERT_TRUE(source.next(&host_time, &values));
+  EXPECT_EQ(std::chrono::milliseconds(3), host_time);
+  ASSERT_TRUE(source.next(&host_time, &values));
+  EXPECT_EQ(std::chrono::milliseconds(4), host_time);
+}
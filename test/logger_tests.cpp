@@ -83,6 +83,49 @@ TEST(Logger, LoggerEmptyAfterFlush) {
   EXPECT_EQ(0u, log.size());
 }
 
+TEST(Logger, FlushUsesReservedMemory) {
+  size_t log_count = 5;
+  franka::Logger logger(log_count);
+
+  for (size_t i = 0; i < log_count + 2; i++) {
+    logger.log(franka::RobotState{}, research_interface::robot::RobotCommand{});
+  }
+  std::vector<franka::Record> log = logger.flush();
+  EXPECT_EQ(log_count, log.size());
+  EXPECT_EQ(log_count, log.capacity());
+
+  logger.clear();
+  logger.log(franka::RobotState{}, research_interface::robot::RobotCommand{});
+  log = logger.flush();
+  EXPECT_EQ(1u, log.size());
+  EXPECT_EQ(log_count, log.capacity());
+}
+
+TEST(Logger, ClearEmptiesLog) {
+  franka::Logger logger(5);
+  logger.log(franka::RobotState{}, research_interface::robot::RobotCommand{});
+  logger.clear();
+  EXPECT_EQ(0u, logger.flush().size());
+}
+
+TEST(Logger, CanRecordJointPower) {
+  franka::Logger logger(2);
+  franka::RobotState state;
+  state.tau_J = {1, 2, 3, 4, 5, 6, 7};
+  state.dq = {1, -1, 0.5, 0, 2, -2, 1};
+
+  logger.log(state, research_interface::robot::RobotCommand{});
+  std::vector<franka::Record> log = logger.flush();
+  ASSERT_EQ(1u, log.size());
+  EXPECT_EQ((std::array<double, 7>{}), log[0].joint_power);
+
+  logger.setRecordJointPower(true);
+  logger.log(state, research_interface::robot::RobotCommand{});
+  log = logger.flush();
+  ASSERT_EQ(1u, log.size());
+  EXPECT_EQ((std::array<double, 7>{1, -2, 1.5, 0, 10, -12, 7}), log[0].joint_power);
+}
+
 TEST(Logger, NoLogWhenLogSizeZero) {
   franka::Logger logger(0);
 
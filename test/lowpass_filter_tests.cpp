@@ -21,3 +21,41 @@ TEST(LowpassFilter, DoesFilter) {
   EXPECT_NEAR(lowpassFilter(0.001, 1.0, 0.0, 500.0), 0.7585, 1e-4);
   EXPECT_NEAR(lowpassFilter(0.001, 1.0, 0.0, 900.0), 0.8497, 1e-4);
 }
+
+TEST(LowpassFilter, FiltersEachElement) {
+  std::array<double, 6> y{{1.0, 1.0, 0.0, -1.0, 2.0, 1.0}};
+  std::array<double, 6> y_last{{1.0, 0.0, 1.0, 0.0, 0.0, 1.0}};
+  std::array<double, 6> filtered = lowpassFilter(0.001, y, y_last, 100.0);
+  for (size_t i = 0; i < y.size(); i++) {
+    EXPECT_DOUBLE_EQ(lowpassFilter(0.001, y[i], y_last[i], 100.0), filtered[i]);
+  }
+}
+
+TEST(LowpassFilter, FiltersCartesianPoses) {
+  Eigen::Affine3d pose(Eigen::AngleAxisd(M_PI / 2, Eigen::Vector3d::UnitZ()));
+  pose.translation() << 1.0, 0.0, 0.5;
+  Eigen::Affine3d last_pose(Eigen::AngleAxisd(0.0, Eigen::Vector3d::UnitZ()));
+  last_pose.translation() << 0.0, 0.0, 0.5;
+
+  std::array<double, 16> y{};
+  std::array<double, 16> y_last{};
+  Eigen::Map<Eigen::Matrix4d>(y.data()) = pose.matrix();
+  Eigen::Map<Eigen::Matrix4d>(y_last.data()) = last_pose.matrix();
+  std::array<double, 16> filtered = cartesianLowpassFilter(0.001, y, y_last, 100.0);
+  Eigen::Affine3d filtered_pose(Eigen::Matrix4d::Map(filtered.data()));
+
+  double gain = lowpassFilter(0.001, 1.0, 0.0, 100.0);
+  EXPECT_NEAR(gain, filtered_pose.translation().x(), 1e-12);
+  EXPECT_NEAR(0.5, filtered_pose.translation().z(), 1e-12);
+  EXPECT_TRUE(filtered_pose.linear().isUnitary(1e-12));
+  Eigen::AngleAxisd rotation(filtered_pose.linear());
+  EXPECT_NEAR(gain * M_PI / 2, rotation.angle(), 1e-12);
+  EXPECT_TRUE(rotation.axis().isApprox(Eigen::Vector3d::UnitZ()));
+  EXPECT_EQ(0.0, filtered[3]);
+  EXPECT_EQ(1.0, filtered[15]);
+
+  filtered = cartesianLowpassFilter(0.001, y, y, 100.0);
+  for (size_t i = 0; i < y.size(); i++) {
+    EXPECT_NEAR(y[i], filtered[i], 1e-12);
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "mailbox.h"
+
+using franka::Mailbox;
+
+namespace {
+
+struct Value {
+  uint64_t first;
+  uint64_t second;
+};
+
+}  // anonymous namespace
+
+TEST(Mailbox, ReturnsNothingIfEmpty) {
+  Mailbox<int> mailbox;
+  int value = 0;
+  EXPECT_FALSE(mailbox.read(&value));
+}
+
+TEST(Mailbox, ReturnsLatestValueOnce) {
+  Mailbox<int> mailbox;
+  int value = 0;
+
+  mailbox.write(1);
+  mailbox.write(2);
+  mailbox.write(3);
+  ASSERT_TRUE(mailbox.read(&value));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(mailbox.read(&value));
+
+  mailbox.write(4);
+  ASSERT_TRUE(mailbox.read(&value));
+  EXPECT_EQ(4, value);
+}
+
+TEST(Mailbox, TransfersConsistentValuesBetweenThreads) {
+  constexpr uint64_t kCount = 100000;
+  Mailbox<Value> mailbox;
+  std::atomic_bool done(false);
+
+  std::thread writer([&] {
+    for (uint64_t i = 1; i <= kCount; i++) {
+      mailbox.write({i, ~i});
+    }
+    done = true;
+  });
+
+  uint64_t last = 0;
+  bool consistent = true;
+  Value value{};
+  while (true) {
+    bool finished = done;
+    if (mailbox.read(&value)) {
+      consistent = consistent && value.second == ~value.first && value.first > last;
+      last = value.first;
+    } else if (finished) {
+      break;
+    }
+  }
+  writer.join();
+  EXPECT_TRUE(consistent);
+  EXPECT_EQ(kCount, last);
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2017 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <gmock/gmock.h>
+
+#include "model_library_interface.h"
+
+struct MockModel : public ModelLibraryInterface {
+  MOCK_METHOD1(Ji_J_J1, void(double*));
+  MOCK_METHOD2(Ji_J_J2, void(const double*, double*));
+  MOCK_METHOD2(Ji_J_J3, void(const double*, double*));
+  MOCK_METHOD2(Ji_J_J4, void(const double*, double*));
+  MOCK_METHOD2(Ji_J_J5, void(const double*, double*));
+  MOCK_METHOD2(Ji_J_J6, void(const double*, double*));
+  MOCK_METHOD2(Ji_J_J7, void(const double*, double*));
+  MOCK_METHOD2(Ji_J_J8, void(const double*, double*));
+  MOCK_METHOD3(Ji_J_J9, void(const double*, const double*, double*));
+
+  MOCK_METHOD5(M_NE, void(const double*, const double*, double, const double*, double*));
+
+  MOCK_METHOD1(O_J_J1, void(double*));
+  MOCK_METHOD2(O_J_J2, void(const double*, double*));
+  MOCK_METHOD2(O_J_J3, void(const double*, double*));
+  MOCK_METHOD2(O_J_J4, void(const double*, double*));
+  MOCK_METHOD2(O_J_J5, void(const double*, double*));
+  MOCK_METHOD2(O_J_J6, void(const double*, double*));
+  MOCK_METHOD2(O_J_J7, void(const double*, double*));
+  MOCK_METHOD2(O_J_J8, void(const double*, double*));
+  MOCK_METHOD3(O_J_J9, void(const double*, const double*, double*));
+
+  MOCK_METHOD2(O_T_J1, void(const double*, double*));
+  MOCK_METHOD2(O_T_J2, void(const double*, double*));
+  MOCK_METHOD2(O_T_J3, void(const double*, double*));
+  MOCK_METHOD2(O_T_J4, void(const double*, double*));
+  MOCK_METHOD2(O_T_J5, void(const double*, double*));
+  MOCK_METHOD2(O_T_J6, void(const double*, double*));
+  MOCK_METHOD2(O_T_J7, void(const double*, double*));
+  MOCK_METHOD2(O_T_J8, void(const double*, double*));
+  MOCK_METHOD3(O_T_J9, void(const double*, const double*, double*));
+
+  MOCK_METHOD6(c_NE,
+               void(const double*, const double*, const double*, double, const double*, double*));
+  MOCK_METHOD5(g_NE, void(const double*, const double*, double, const double*, double*));
+};
@@ -2,6 +2,8 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #pragma once
 
+#include <memory>
+
 #include <franka/robot_state.h>
 
 #include "robot_control.h"
@@ -30,4 +32,16 @@ class MockRobotControl : public franka::RobotControl {
   franka::RealtimeConfig realtimeConfig() const noexcept override {
     return franka::RealtimeConfig::kIgnore;
   }
+
+  const franka::VirtualWallShield* virtualWallShield() const noexcept override {
+    return virtual_wall_shield.get();
+  }
+
+  bool jointLimitShaping() const noexcept override { return joint_limit_shaping; }
+
+  franka::WorkerPool* workerPool() const noexcept override { return worker_pool.get(); }
+
+  std::unique_ptr<franka::VirtualWallShield> virtual_wall_shield;
+  bool joint_limit_shaping = false;
+  std::unique_ptr<franka::WorkerPool> worker_pool;
 };
@@ -12,52 +12,14 @@
 #include <research_interface/robot/service_types.h>
 
 #include "helpers.h"
+#include "mock_model_library.h"
 #include "mock_server.h"
-#include "model_library_interface.h"
 
 using ::testing::Invoke;
 using ::testing::WithArgs;
 using ::testing::_;
 using namespace research_interface::robot;
 
-struct MockModel : public ModelLibraryInterface {
-  MOCK_METHOD1(Ji_J_J1, void(double*));
-  MOCK_METHOD2(Ji_J_J2, void(const double*, double*));
-  MOCK_METHOD2(Ji_J_J3, void(const double*, double*));
-  MOCK_METHOD2(Ji_J_J4, void(const double*, double*));
-  MOCK_METHOD2(Ji_J_J5, void(const double*, double*));
-  MOCK_METHOD2(Ji_J_J6, void(const double*, double*));
-  MOCK_METHOD2(Ji_J_J7, void(const double*, double*));
-  MOCK_METHOD2(Ji_J_J8, void(const double*, double*));
-  MOCK_METHOD3(Ji_J_J9, void(const double*, const double*, double*));
-
-  MOCK_METHOD5(M_NE, void(const double*, const double*, double, const double*, double*));
-
-  MOCK_METHOD1(O_J_J1, void(double*));
-  MOCK_METHOD2(O_J_J2, void(const double*, double*));
-  MOCK_METHOD2(O_J_J3, void(const double*, double*));
-  MOCK_METHOD2(O_J_J4, void(const double*, double*));
-  MOCK_METHOD2(O_J_J5, void(const double*, double*));
-  MOCK_METHOD2(O_J_J6, void(const double*, double*));
-  MOCK_METHOD2(O_J_J7, void(const double*, double*));
-  MOCK_METHOD2(O_J_J8, void(const double*, double*));
-  MOCK_METHOD3(O_J_J9, void(const double*, const double*, double*));
-
-  MOCK_METHOD2(O_T_J1, void(const double*, double*));
-  MOCK_METHOD2(O_T_J2, void(const double*, double*));
-  MOCK_METHOD2(O_T_J3, void(const double*, double*));
-  MOCK_METHOD2(O_T_J4, void(const double*, double*));
-  MOCK_METHOD2(O_T_J5, void(const double*, double*));
-  MOCK_METHOD2(O_T_J6, void(const double*, double*));
-  MOCK_METHOD2(O_T_J7, void(const double*, double*));
-  MOCK_METHOD2(O_T_J8, void(const double*, double*));
-  MOCK_METHOD3(O_T_J9, void(const double*, const double*, double*));
-
-  MOCK_METHOD6(c_NE,
-               void(const double*, const double*, const double*, double, const double*, double*));
-  MOCK_METHOD5(g_NE, void(const double*, const double*, double, const double*, double*));
-};
-
 struct Model : public ::testing::Test {
   Model() {
     using namespace std::string_literals;
@@ -126,6 +88,16 @@ TEST(InvalidModel, ThrowsIfInvalidModelReceived) {
   EXPECT_THROW(robot.loadModel(), franka::ModelException);
 }
 
+TEST(OfflineModel, CanLoadModelLibraryFromFile) {
+  using namespace std::string_literals;
+  EXPECT_NO_THROW(franka::Model(FRANKA_TEST_BINARY_DIR + "/libfcimodels.so"s));
+}
+
+TEST(OfflineModel, ThrowsIfModelLibraryFileIsInvalid) {
+  using namespace std::string_literals;
+  EXPECT_THROW(franka::Model(FRANKA_TEST_BINARY_DIR + "/nonexistent.so"s), franka::ModelException);
+}
+
 TEST_F(Model, CanCreateModel) {
   EXPECT_NO_THROW(robot.loadModel());
 }
@@ -390,6 +362,48 @@ TEST_F(Model, CanGetZeroJacobian) {
   }
 }
 
+TEST_F(Model, CanComputeQuantities) {
+  franka::RobotState robot_state;
+  randomRobotState(robot_state);
+
+  MockModel mock;
+  EXPECT_CALL(mock, O_J_J9(robot_state.q.data(), robot_state.F_T_EE.data(), _))
+      .WillOnce(WithArgs<2>(Invoke([=](double* output) {
+        for (size_t i = 0; i < 42; i++) {
+          output[i] = i;
+        }
+      })));
+  EXPECT_CALL(mock, M_NE(robot_state.q.data(), robot_state.I_total.data(), robot_state.m_total,
+                         robot_state.F_x_Ctotal.data(), _))
+      .WillOnce(WithArgs<4>(Invoke([=](double* output) {
+        for (size_t i = 0; i < 49; i++) {
+          output[i] = 2 * i;
+        }
+      })));
+  EXPECT_CALL(mock, c_NE(robot_state.q.data(), robot_state.dq.data(), robot_state.I_total.data(),
+                         robot_state.m_total, robot_state.F_x_Ctotal.data(), _))
+      .WillOnce(WithArgs<5>(Invoke([=](double* output) {
+        for (size_t i = 0; i < 7; i++) {
+          output[i] = 3 * i;
+        }
+      })));
+
+  model_library_interface = &mock;
+
+  franka::Model model(robot.loadModel());
+  franka::ModelQuantities quantities;
+  model.computeQuantities(robot_state, &quantities);
+  for (size_t i = 0; i < quantities.zero_jacobian.size(); i++) {
+    EXPECT_EQ(i, quantities.zero_jacobian[i]);
+  }
+  for (size_t i = 0; i < quantities.mass.size(); i++) {
+    EXPECT_EQ(2 * i, quantities.mass[i]);
+  }
+  for (size_t i = 0; i < quantities.coriolis.size(); i++) {
+    EXPECT_EQ(3 * i, quantities.coriolis[i]);
+  }
+}
+
 TEST(Frame, CanIncrement) {
   franka::Frame frame = franka::Frame::kJoint3;
   EXPECT_EQ(franka::Frame::kJoint3, frame++);
@@ -0,0 +1,93 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/duration.h>
+#include <franka/robot_state.h>
+#include <franka/trajectory_cache.h>
+
+#include "examples_common.h"
+
+namespace {
+
+constexpr double kResolution = 1e-4;
+
+// Runs a motion to completion and returns the commanded joint positions of every control cycle.
+std::vector<std::array<double, 7>> runMotion(const std::array<double, 7>& q_start,
+                                             const std::array<double, 7>& q_goal,
+                                             franka::TrajectoryCache* cache) {
+  MotionGenerator motion_generator(0.5, q_goal, cache);
+  franka::RobotState robot_state;
+  robot_state.q_d = q_start;
+
+  std::vector<std::array<double, 7>> positions;
+  franka::Duration period(0);
+  for (size_t cycle = 0; cycle < 100000; cycle++) {
+    franka::JointPositions output = motion_generator(robot_state, period);
+    positions.push_back(output.q);
+    if (output.motion_finished) {
+      break;
+    }
+    period = franka::Duration(1);
+  }
+  return positions;
+}
+
+std::array<double, 7> offset(std::array<double, 7> q, double delta) {
+  for (double& element : q) {
+    element += delta;
+  }
+  return q;
+}
+
+}  // anonymous namespace
+
+TEST(MotionGenerator, ReplayedMotionEndsAtGoal) {
+  franka::TrajectoryCache cache(10, 100000, kResolution);
+  std::array<double, 7> q_start{{0, 0, 0, -1.6, 0, 1.5, 0}};
+  std::array<double, 7> q_goal{{0.1, -0.2, 0.3, -1.5, 0.2, 1.2, 0.5}};
+
+  std::vector<std::array<double, 7>> computed = runMotion(q_start, q_goal, &cache);
+  ASSERT_EQ(1u, cache.size());
+  EXPECT_EQ(q_goal, computed.back());
+
+  // Start and goal differ from the cached ones, but are quantized to the same key.
+  std::array<double, 7> replay_start = offset(q_start, 0.3 * kResolution);
+  std::array<double, 7> replay_goal = offset(q_goal, -0.3 * kResolution);
+  std::vector<std::array<double, 7>> replayed = runMotion(replay_start, replay_goal, &cache);
+  EXPECT_EQ(1u, cache.statistics().hits);
+  ASSERT_EQ(computed.size(), replayed.size());
+
+  for (size_t i = 0; i < 7; i++) {
+    EXPECT_DOUBLE_EQ(replay_start[i], replayed.front()[i]);
+    EXPECT_NEAR(replay_goal[i], replayed.back()[i], 1e-12);
+  }
+  for (size_t cycle = 0; cycle < replayed.size(); cycle++) {
+    for (size_t i = 0; i < 7; i++) {
+      EXPECT_NEAR(computed[cycle][i], replayed[cycle][i], kResolution);
+    }
+  }
+}
+
+TEST(MotionGenerator, ReplaysJointsWithoutCachedMotion) {
+  franka::TrajectoryCache cache(10, 100000, kResolution);
+  std::array<double, 7> q_start{{0, 0, 0, -1.6, 0, 1.5, 0}};
+  std::array<double, 7> q_goal{{0.1, 0, 0, -1.6, 0, 1.5, 0}};
+  runMotion(q_start, q_goal, &cache);
+
+  // Joint 2 does not move in the cached profile, but has to move by less than the resolution.
+  std::array<double, 7> replay_goal = q_goal;
+  replay_goal[1] += 0.4 * kResolution;
+  std::vector<std::array<double, 7>> replayed = runMotion(q_start, replay_goal, &cache);
+  EXPECT_EQ(1u, cache.statistics().hits);
+
+  EXPECT_EQ(q_start[1], replayed.front()[1]);
+  EXPECT_NEAR(replay_goal[1], replayed.back()[1], 1e-12);
+  for (size_t cycle = 1; cycle < replayed.size(); cycle++) {
+    EXPECT_GE(replayed[cycle][1], replayed[cycle - 1][1]);
+  }
+}
@@ -0,0 +1,157 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/motion_statistics.h>
+
+using namespace franka;
+
+namespace {
+
+RobotState createState(uint64_t time_ms) {
+  RobotState robot_state;
+  robot_state.time = Duration(time_ms);
+  robot_state.O_T_EE = {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.3, 0, 0.5, 1}};
+  robot_state.O_T_EE_d = robot_state.O_T_EE;
+  return robot_state;
+}
+
+}  // anonymous namespace
+
+TEST(StreamingQuantile, ReturnsZeroWithoutObservations) {
+  StreamingQuantile quantile(0.5);
+  EXPECT_EQ(0.0, quantile.value());
+}
+
+TEST(StreamingQuantile, UsesExactValueForFewObservations) {
+  StreamingQuantile quantile(0.5);
+  quantile.add(3.0);
+  quantile.add(1.0);
+  quantile.add(2.0);
+  EXPECT_EQ(2.0, quantile.value());
+
+  quantile.reset();
+  EXPECT_EQ(0.0, quantile.value());
+}
+
+TEST(StreamingQuantile, EstimatesQuantilesOfUniformDistribution) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+  StreamingQuantile p50(0.5);
+  StreamingQuantile p95(0.95);
+  StreamingQuantile p99(0.99);
+  for (size_t i = 0; i < 100000; i++) {
+    double value = distribution(generator);
+    p50.add(value);
+    p95.add(value);
+    p99.add(value);
+  }
+
+  EXPECT_NEAR(0.5, p50.value(), 0.01);
+  EXPECT_NEAR(0.95, p95.value(), 0.01);
+  EXPECT_NEAR(0.99, p99.value(), 0.01);
+}
+
+TEST(MotionStatisticsAccumulator, IsEmptyInitially) {
+  MotionStatisticsAccumulator accumulator;
+  MotionStatistics statistics = accumulator.statistics();
+
+  EXPECT_EQ(0u, statistics.samples);
+  EXPECT_EQ(0u, statistics.lost_cycles);
+  EXPECT_EQ(Duration(0), statistics.duration);
+  EXPECT_EQ(0.0, statistics.translational_error.max);
+  EXPECT_EQ(0.0, statistics.rotational_error.rms);
+}
+
+TEST(MotionStatisticsAccumulator, ComputesTrackingErrors) {
+  MotionStatisticsAccumulator accumulator;
+
+  for (uint64_t i = 0; i < 10; i++) {
+    RobotState robot_state = createState(100 + i);
+    robot_state.q_d[2] = 0.01 * (i + 1);
+    robot_state.O_T_EE_d[13] = 0.002;
+    // Rotation of 0.1 rad about the z axis.
+    robot_state.O_T_EE_d[0] = std::cos(0.1);
+    robot_state.O_T_EE_d[1] = std::sin(0.1);
+    robot_state.O_T_EE_d[4] = -std::sin(0.1);
+    robot_state.O_T_EE_d[5] = std::cos(0.1);
+    accumulator.update(robot_state);
+  }
+
+  MotionStatistics statistics = accumulator.statistics();
+  EXPECT_EQ(10u, statistics.samples);
+  EXPECT_EQ(0u, statistics.lost_cycles);
+  EXPECT_EQ(Duration(9), statistics.duration);
+
+  EXPECT_EQ(0.0, statistics.joint_position_error[0].max);
+  EXPECT_DOUBLE_EQ(0.1, statistics.joint_position_error[2].max);
+  EXPECT_NEAR(std::sqrt(0.0385 / 10), statistics.joint_position_error[2].rms, 1e-9);
+  EXPECT_GE(statistics.joint_position_error[2].p95, statistics.joint_position_error[2].p50);
+  EXPECT_LE(statistics.joint_position_error[2].p99, statistics.joint_position_error[2].max);
+
+  EXPECT_NEAR(0.002, statistics.translational_error.max, 1e-12);
+  EXPECT_NEAR(0.002, statistics.translational_error.p50, 1e-12);
+  EXPECT_NEAR(0.1, statistics.rotational_error.max, 1e-9);
+  EXPECT_NEAR(0.1, statistics.rotational_error.rms, 1e-9);
+}
+
+TEST(MotionStatisticsAccumulator, ComputesPeakJerk) {
+  MotionStatisticsAccumulator accumulator;
+
+  RobotState robot_state = createState(0);
+  accumulator.update(robot_state);
+
+  robot_state = createState(1);
+  robot_state.ddq_d[4] = -0.5;
+  robot_state.O_ddP_EE_c[0] = 0.03;
+  robot_state.O_ddP_EE_c[1] = 0.04;
+  robot_state.O_ddP_EE_c[5] = 0.2;
+  accumulator.update(robot_state);
+
+  robot_state = createState(2);
+  accumulator.update(robot_state);
+
+  MotionStatistics statistics = accumulator.statistics();
+  EXPECT_NEAR(500.0, statistics.peak_joint_jerk[4], 1e-9);
+  EXPECT_EQ(0.0, statistics.peak_joint_jerk[0]);
+  EXPECT_NEAR(50.0, statistics.peak_translational_jerk, 1e-9);
+  EXPECT_NEAR(200.0, statistics.peak_rotational_jerk, 1e-9);
+}
+
+TEST(MotionStatisticsAccumulator, CountsLostCycles) {
+  MotionStatisticsAccumulator accumulator;
+
+  accumulator.update(createState(10));
+  accumulator.update(createState(11));
+  accumulator.update(createState(14));
+  accumulator.update(createState(15));
+  accumulator.update(createState(17));
+
+  MotionStatistics statistics = accumulator.statistics();
+  EXPECT_EQ(5u, statistics.samples);
+  EXPECT_EQ(3u, statistics.lost_cycles);
+  EXPECT_EQ(Duration(7), statistics.duration);
+}
+
+TEST(MotionStatisticsAccumulator, CanReset) {
+  MotionStatisticsAccumulator accumulator;
+
+  RobotState robot_state = createState(10);
+  robot_state.q_d[0] = 1.0;
+  accumulator.update(robot_state);
+  accumulator.update(createState(20));
+  accumulator.reset();
+
+  accumulator.update(createState(30));
+  MotionStatistics statistics = accumulator.statistics();
+  EXPECT_EQ(1u, statistics.samples);
+  EXPECT_EQ(0u, statistics.lost_cycles);
+  EXPECT_EQ(Duration(0), statistics.duration);
+  EXPECT_EQ(0.0, statistics.joint_position_error[0].max);
+}
@@ -5,6 +5,7 @@
 #include <Eigen/Dense>
 
 #include <franka/rate_limiting.h>
+#include <franka/robot_traits.h>
 
 using namespace franka;
 
@@ -518,3 +519,123 @@ TEST(RateLimiting, CartesianPose) {
       kNoLimit, differentiateOneSample(limited_cartesian_pose, last_cmd_pose, kDeltaT),
       last_cmd_velocity, last_cmd_acceleration, kDeltaT));
 }
+
+TEST(RateLimiting, SupportsArbitraryNumberOfJoints) {
+  using Traits = RobotTraits<6>;
+  Traits::JointArray max_velocity{{1.0, 1.0, 1.0, 2.0, 2.0, 2.0}};
+  Traits::JointArray max_acceleration{{10.0, 10.0, 10.0, 10.0, 10.0, 10.0}};
+  Traits::JointArray max_jerk{{100.0, 100.0, 100.0, 200.0, 200.0, 200.0}};
+  Traits::JointArray commanded{{0.5, -0.5, 0.0, 1.0, -1.0, 0.001}};
+  Traits::JointArray last_commanded{{0.0, 0.0, 0.0, 0.0, 0.0, 0.0}};
+  Traits::JointArray last_derivative{{0.0, 0.01, 0.0, -0.01, 0.0, 0.0}};
+
+  Traits::JointArray limited_velocities = limitRate(max_velocity, max_acceleration, max_jerk,
+                                                    commanded, last_commanded, last_derivative);
+  Traits::JointArray limited_positions =
+      limitRate(max_velocity, max_acceleration, max_jerk, commanded, last_commanded,
+                last_derivative, last_derivative);
+  Traits::JointArray limited_values = limitRate(max_jerk, commanded, last_commanded);
+  for (size_t i = 0; i < Traits::kDof; i++) {
+    EXPECT_EQ(limitRate(max_velocity[i], max_acceleration[i], max_jerk[i], commanded[i],
+                        last_commanded[i], last_derivative[i]),
+              limited_velocities[i]);
+    EXPECT_EQ(limitRate(max_velocity[i], max_acceleration[i], max_jerk[i], commanded[i],
+                        last_commanded[i], last_derivative[i], last_derivative[i]),
+              limited_positions[i]);
+    EXPECT_EQ(std::max(std::min(commanded[i], max_jerk[i] * kDeltaT), -max_jerk[i] * kDeltaT),
+              limited_values[i]);
+  }
+}
+
+TEST(RateLimiting, PandaTraitsProvideLimits) {
+  static_assert(PandaTraits::kDof == 7, "Panda has seven joints");
+  EXPECT_EQ(kMaxTorqueRate, PandaTraits::maxTorqueRate());
+  EXPECT_EQ(kMaxJointVelocity, PandaTraits::maxJointVelocity());
+  EXPECT_EQ(kMaxJointAcceleration, PandaTraits::maxJointAcceleration());
+  EXPECT_EQ(kMaxJointJerk, PandaTraits::maxJointJerk());
+  EXPECT_EQ(kMinJointPosition, PandaTraits::minJointPosition());
+  EXPECT_EQ(kMaxJointPosition, PandaTraits::maxJointPosition());
+}
+
+TEST(RateLimiting, MaxStoppingVelocityCanStopInTime) {
+  const double max_acceleration = 10.0;
+  const double max_jerk = 1000.0;
+  for (double distance : {1e-4, 1e-3, 1e-2, 0.1, 1.0}) {
+    double velocity = maxStoppingVelocity(distance, max_acceleration, max_jerk);
+    EXPECT_GT(velocity, 0.0);
+
+    // Brake with maximum jerk until the velocity is just sufficient to ramp the acceleration back.
+    double position = 0.0;
+    double acceleration = 0.0;
+    const double dt = 1e-6;
+    while (velocity > 0.0) {
+      double ramp_down_velocity = acceleration * acceleration / (2.0 * max_jerk);
+      if (velocity > ramp_down_velocity) {
+        acceleration = std::max(acceleration - max_jerk * dt, -max_acceleration);
+      } else {
+        acceleration = std::min(acceleration + max_jerk * dt, 0.0);
+      }
+      velocity += acceleration * dt;
+      position += velocity * dt;
+    }
+    EXPECT_NEAR(distance, position, distance * 1e-2);
+  }
+
+  EXPECT_EQ(0.0, maxStoppingVelocity(-1.0, max_acceleration, max_jerk));
+  double boundary = max_acceleration * max_acceleration * max_acceleration / (max_jerk * max_jerk);
+  EXPECT_NEAR(maxStoppingVelocity(boundary * (1 - 1e-9), max_acceleration, max_jerk),
+              maxStoppingVelocity(boundary * (1 + 1e-9), max_acceleration, max_jerk), 1e-6);
+}
+
+TEST(RateLimiting, ShapingKeepsJointsWithinPositionLimits) {
+  std::array<double, 7> q = PandaTraits::maxJointPosition();
+  for (size_t i = 0; i < q.size(); i++) {
+    q[i] -= 0.5;
+  }
+  std::array<double, 7> dq{};
+  std::array<double, 7> ddq{};
+  std::array<double, 7> commanded = PandaTraits::maxJointVelocity();
+  double max_velocity_error = 0.0;
+  for (int step = 0; step < 3000; step++) {
+    std::array<double, 7> shaped = shapeJointVelocities(
+        PandaTraits::minJointPosition(), PandaTraits::maxJointPosition(),
+        PandaTraits::maxJointAcceleration(), PandaTraits::maxJointJerk(), commanded, q);
+    if (step == 0) {
+      for (size_t i = 0; i < q.size(); i++) {
+        max_velocity_error = std::max(max_velocity_error, std::abs(shaped[i] - commanded[i]));
+      }
+    }
+    std::array<double, 7> limited =
+        limitRate(PandaTraits::maxJointVelocity(), PandaTraits::maxJointAcceleration(),
+                  PandaTraits::maxJointJerk(), shaped, dq, ddq);
+    for (size_t i = 0; i < q.size(); i++) {
+      ddq[i] = (limited[i] - dq[i]) / kDeltaT;
+      dq[i] = limited[i];
+      q[i] += dq[i] * kDeltaT;
+      ASSERT_LE(q[i], PandaTraits::maxJointPosition()[i]) << "joint " << i << ", step " << step;
+    }
+  }
+  // Far from the limits, the commands are not changed.
+  EXPECT_EQ(0.0, max_velocity_error);
+  for (size_t i = 0; i < q.size(); i++) {
+    EXPECT_NEAR(PandaTraits::maxJointPosition()[i], q[i], 1e-3);
+  }
+}
+
+TEST(RateLimiting, ShapingDoesNotLimitMotionsAwayFromPositionLimits) {
+  std::array<double, 7> q = PandaTraits::maxJointPosition();
+  std::array<double, 7> commanded{{-1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0}};
+  std::array<double, 7> shaped = shapeJointVelocities(
+      PandaTraits::minJointPosition(), PandaTraits::maxJointPosition(),
+      PandaTraits::maxJointAcceleration(), PandaTraits::maxJointJerk(), commanded, q);
+  EXPECT_EQ(commanded, shaped);
+
+  std::array<double, 7> commanded_positions = q;
+  commanded_positions[0] += 1e-3;
+  commanded_positions[1] -= 1e-3;
+  std::array<double, 7> shaped_positions = shapeJointPositions(
+      PandaTraits::minJointPosition(), PandaTraits::maxJointPosition(),
+      PandaTraits::maxJointAcceleration(), PandaTraits::maxJointJerk(), commanded_positions, q);
+  EXPECT_EQ(q[0], shaped_positions[0]);
+  EXPECT_DOUBLE_EQ(commanded_positions[1], shaped_positions[1]);
+}
@@ -0,0 +1,184 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/LU>
+
+#include <franka/exception.h>
+#include <franka/inverse_kinematics.h>
+#include <franka/kinematics.h>
+#include <franka/reachability_map.h>
+
+using namespace franka;
+
+namespace {
+
+const std::array<double, 16> kIdentity{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+
+ReachabilityMapParameters smallMap() {
+  ReachabilityMapParameters parameters;
+  parameters.workspace_minimum = {{0.2, -0.2, 0.0}};
+  parameters.workspace_maximum = {{0.6, 0.2, 0.35}};
+  parameters.resolution = 0.1;
+  parameters.polar_bins = 2;
+  parameters.azimuth_bins = 3;
+  parameters.roll_bins = 2;
+  parameters.q7_samples = 4;
+  return parameters;
+}
+
+std::array<double, 16> pose(const Eigen::Matrix3d& rotation, const Eigen::Vector3d& position) {
+  std::array<double, 16> pose;
+  Eigen::Map<Eigen::Matrix4d> matrix(pose.data());
+  matrix.setIdentity();
+  matrix.topLeftCorner<3, 3>() = rotation;
+  matrix.topRightCorner<3, 1>() = position;
+  return pose;
+}
+
+class ReachabilityMapFile : public ::testing::Test {
+ public:
+  ~ReachabilityMapFile() { std::remove(path_.c_str()); }
+
+ protected:
+  const std::string path_ = std::string(FRANKA_TEST_BINARY_DIR) + "/reachability_map.bin";
+};
+
+}  // anonymous namespace
+
+TEST(ReachabilityMap, ThrowsOnInvalidParameters) {
+  ReachabilityMapParameters parameters = smallMap();
+  parameters.workspace_maximum[2] = parameters.workspace_minimum[2];
+  EXPECT_THROW(ReachabilityMap::generate(parameters), std::invalid_argument);
+
+  parameters = smallMap();
+  parameters.resolution = 0.0;
+  EXPECT_THROW(ReachabilityMap::generate(parameters), std::invalid_argument);
+
+  parameters = smallMap();
+  parameters.roll_bins = 0;
+  EXPECT_THROW(ReachabilityMap::generate(parameters), std::invalid_argument);
+}
+
+TEST(ReachabilityMap, RoundsWorkspaceToVoxels) {
+  ReachabilityMap map = ReachabilityMap::generate(smallMap(), 1);
+  ReachabilityMapParameters parameters = map.parameters();
+  EXPECT_NEAR(0.6, parameters.workspace_maximum[0], 1e-12);
+  EXPECT_NEAR(0.2, parameters.workspace_maximum[1], 1e-12);
+  EXPECT_NEAR(0.4, parameters.workspace_maximum[2], 1e-12);
+}
+
+TEST(ReachabilityMap, MatchesInverseKinematicsAtCellCenters) {
+  ReachabilityMap map = ReachabilityMap::generate(smallMap());
+  ASSERT_GT(map.maximumManipulability(), 0.0);
+
+  // Tilted downwards, the approach direction is at the center of the lower polar bin and of the
+  // azimuth bin [-pi / 3, pi / 3]. The rotation of -pi / 2 about it is the center of the roll bin
+  // [-pi, 0].
+  double theta = std::acos(-0.5);
+  Eigen::Matrix3d rotation =
+      (Eigen::AngleAxisd(theta, Eigen::Vector3d::UnitY()) *
+       Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitZ()))
+          .toRotationMatrix();
+  std::array<double, 16> center = pose(rotation, Eigen::Vector3d(0.45, 0.05, 0.25));
+
+  std::vector<double> q7;
+  for (size_t i = 0; i < 4; i++) {
+    q7.push_back(-2.8973 + 5.7946 * (i + 0.5) / 4);
+  }
+  InverseKinematics inverse_kinematics;
+  Kinematics kinematics;
+  std::vector<std::array<double, 7>> solutions;
+  ASSERT_GT(inverse_kinematics.solve(center, q7, &solutions), 0u);
+  double expected = 0.0;
+  for (const std::array<double, 7>& q : solutions) {
+    std::array<double, 42> jacobian =
+        kinematics.zeroJacobian(Frame::kEndEffector, q, kIdentity, kIdentity);
+    Eigen::Map<const Eigen::Matrix<double, 6, 7>> jacobian_matrix(jacobian.data());
+    expected = std::max(
+        expected, std::sqrt((jacobian_matrix * jacobian_matrix.transpose()).determinant()));
+  }
+
+  EXPECT_TRUE(map.reachable(center));
+  EXPECT_NEAR(expected, map.manipulability(center), map.maximumManipulability() / 254.0);
+  // Poses in the same voxel and orientation bin get the same answer.
+  std::array<double, 16> nearby =
+      pose(Eigen::AngleAxisd(0.1, Eigen::Vector3d::UnitX()) * rotation,
+           Eigen::Vector3d(0.41, 0.09, 0.21));
+  EXPECT_EQ(map.manipulability(center), map.manipulability(nearby));
+  EXPECT_GE(map.manipulability(std::array<double, 3>{{0.45, 0.05, 0.25}}),
+            map.manipulability(center));
+  EXPECT_GT(map.reachability({{0.45, 0.05, 0.25}}), 0.0);
+  EXPECT_LE(map.reachability({{0.45, 0.05, 0.25}}), 1.0);
+}
+
+TEST(ReachabilityMap, RejectsPositionsOutsideOfWorkspace) {
+  ReachabilityMap map = ReachabilityMap::generate(smallMap());
+  EXPECT_EQ(0.0, map.reachability({{0.0, 0.0, 0.2}}));
+  EXPECT_EQ(0.0, map.manipulability(std::array<double, 3>{{0.4, 0.0, 0.5}}));
+  EXPECT_FALSE(map.reachable(pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(0.4, 0.3, 0.2))));
+  EXPECT_EQ(0.0, map.reachability({{NAN, 0.0, 0.2}}));
+}
+
+TEST(ReachabilityMap, GeneratesSameMapWithSeveralThreads) {
+  ReachabilityMap single = ReachabilityMap::generate(smallMap(), 1);
+  ReachabilityMap parallel = ReachabilityMap::generate(smallMap(), 4);
+  EXPECT_EQ(single.maximumManipulability(), parallel.maximumManipulability());
+  for (double x = 0.25; x < 0.6; x += 0.1) {
+    for (double y = -0.15; y < 0.2; y += 0.1) {
+      for (double z = 0.05; z < 0.4; z += 0.1) {
+        EXPECT_EQ(single.reachability({{x, y, z}}), parallel.reachability({{x, y, z}}));
+        EXPECT_EQ(single.manipulability(std::array<double, 3>{{x, y, z}}),
+                  parallel.manipulability(std::array<double, 3>{{x, y, z}}));
+      }
+    }
+  }
+}
+
+TEST_F(ReachabilityMapFile, CanSaveAndOpen) {
+  ReachabilityMap generated = ReachabilityMap::generate(smallMap());
+  generated.save(path_);
+  ReachabilityMap opened(path_);
+
+  EXPECT_EQ(generated.maximumManipulability(), opened.maximumManipulability());
+  EXPECT_EQ(generated.parameters().workspace_maximum, opened.parameters().workspace_maximum);
+  EXPECT_EQ(smallMap().roll_bins, opened.parameters().roll_bins);
+  for (double x = 0.25; x < 0.6; x += 0.1) {
+    for (double angle = 0.0; angle < 2.0 * M_PI; angle += 0.5) {
+      std::array<double, 16> query =
+          pose(Eigen::AngleAxisd(angle, Eigen::Vector3d(1.0, 1.0, 0.0).normalized())
+                   .toRotationMatrix(),
+               Eigen::Vector3d(x, 0.0, 0.15));
+      EXPECT_EQ(generated.reachable(query), opened.reachable(query));
+      EXPECT_EQ(generated.manipulability(query), opened.manipulability(query));
+    }
+    EXPECT_EQ(generated.reachability({{x, 0.0, 0.15}}), opened.reachability({{x, 0.0, 0.15}}));
+  }
+
+  // The opened map can be saved again.
+  ReachabilityMap moved(std::move(opened));
+  moved.save(path_ + ".copy");
+  ReachabilityMap copy(path_ + ".copy");
+  std::remove((path_ + ".copy").c_str());
+  EXPECT_EQ(generated.reachability({{0.45, 0.05, 0.25}}), copy.reachability({{0.45, 0.05, 0.25}}));
+}
+
+TEST_F(ReachabilityMapFile, ThrowsOnInvalidFiles) {
+  EXPECT_THROW(ReachabilityMap(path_ + ".missing"), LogFileException);
+
+  std::ofstream(path_, std::ios::binary) << "FRRM";
+  EXPECT_THROW(ReachabilityMap{path_}, LogFileException);
+
+  ReachabilityMap::generate(smallMap()).save(path_);
+  std::ofstream(path_, std::ios::binary | std::ios::app) << "x";
+  EXPECT_THROW(ReachabilityMap{path_}, LogFileException);
+}
@@ -464,3 +464,48 @@ INSTANTIATE_TEST_CASE_P(MoveCommandTests,
                                           Move::Status::kEmergencyAborted,
                                           Move::Status::kInputErrorAborted,
                                           Move::Status::kAborted));
+
+TEST(GetVirtualWalls, CanFetchSeveralWalls) {
+  RobotMockServer server;
+  Robot::Impl robot(
+      std::make_unique<franka::Network>("127.0.0.1", research_interface::robot::kCommandPort), 0);
+
+  std::array<double, 16> object_frame{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+  for (int32_t id : {4, 2, 7}) {
+    server.waitForCommand<GetCartesianLimit>(
+        [=](const GetCartesianLimit::Request& request) -> GetCartesianLimit::Response {
+          EXPECT_EQ(id, request.id);
+          std::array<double, 3> object_world_size{{1.0 * id, 2.0, 3.0}};
+          return GetCartesianLimit::Response(GetCartesianLimit::Status::kSuccess,
+                                             object_world_size, object_frame, id != 2);
+        });
+  }
+  server.spinOnce();
+
+  std::vector<franka::VirtualWallCuboid> walls = robot.getVirtualWalls({4, 2, 7});
+  ASSERT_EQ(3u, walls.size());
+  EXPECT_EQ(4, walls[0].id);
+  EXPECT_EQ(4.0, walls[0].object_world_size[0]);
+  EXPECT_TRUE(walls[0].active);
+  EXPECT_EQ(2, walls[1].id);
+  EXPECT_FALSE(walls[1].active);
+  EXPECT_EQ(7, walls[2].id);
+  EXPECT_EQ(object_frame, walls[2].p_frame);
+}
+
+TEST(GetVirtualWalls, ThrowsIfAnyWallIsRejected) {
+  RobotMockServer server;
+  Robot::Impl robot(
+      std::make_unique<franka::Network>("127.0.0.1", research_interface::robot::kCommandPort), 0);
+
+  for (GetCartesianLimit::Status status : {GetCartesianLimit::Status::kInvalidArgumentRejected,
+                                           GetCartesianLimit::Status::kSuccess}) {
+    server.waitForCommand<GetCartesianLimit>(
+        [=](const GetCartesianLimit::Request&) -> GetCartesianLimit::Response {
+          return GetCartesianLimit::Response(status, {}, {}, true);
+        });
+  }
+  server.spinOnce();
+
+  EXPECT_THROW(robot.getVirtualWalls({1, 2}), CommandException);
+}
@@ -0,0 +1,274 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <franka/robot_daemon.h>
+
+#include "daemon_protocol.h"
+#include "helpers.h"
+
+using namespace franka;
+
+namespace {
+
+// Serves a single client with the daemon protocol and delegates configuration and control
+// requests to the test.
+class FakeDaemon {
+ public:
+  using ConfigureHandler = std::function<void(int, const std::vector<RobotConfiguration::Change>&)>;
+  using ControlHandler = std::function<void(int, const DaemonControlRequest&)>;
+
+  FakeDaemon()
+      : socket_path_("/tmp/libfranka_daemon_test_" + std::to_string(getpid()) + ".sock"),
+        shared_memory_name_("/libfranka_daemon_test_" + std::to_string(getpid())),
+        shared_memory_(SharedMemory::create(shared_memory_name_)),
+        socket_(listenOnDaemonSocket(socket_path_)) {}
+
+  ~FakeDaemon() {
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    close(socket_);
+    unlink(socket_path_.c_str());
+  }
+
+  void serve(ConfigureHandler configure_handler = {}, ControlHandler control_handler = {}) {
+    thread_ = std::thread([=] {
+      int client = accept(socket_, nullptr, nullptr);
+      std::vector<char> message;
+      while (receiveDaemonMessage(client, &message) > 0) {
+        DaemonRequestHeader header;
+        std::memcpy(&header, message.data(), sizeof(header));
+        const char* payload = message.data() + sizeof(header);
+        if (header.type == DaemonRequestType::kConnect) {
+          DaemonConnectRequest request;
+          std::memcpy(&request, payload, sizeof(request));
+          model_quantities_requested_ = request.model_quantities != 0;
+          sendDaemonResponse(client, DaemonStatus::kSuccess, "", 0, shared_memory_name_);
+        } else if (header.type == DaemonRequestType::kConfigure) {
+          std::vector<RobotConfiguration::Change> changes(header.size);
+          std::memcpy(changes.data(), payload, changes.size() * sizeof(changes[0]));
+          configure_handler(client, changes);
+        } else {
+          DaemonControlRequest request;
+          std::memcpy(&request, payload, sizeof(request));
+          control_handler(client, request);
+        }
+      }
+      close(client);
+    });
+  }
+
+  DaemonSegment* segment() { return shared_memory_.segment(); }
+  const std::string& socketPath() const { return socket_path_; }
+  bool modelQuantitiesRequested() const { return model_quantities_requested_; }
+
+ private:
+  const std::string socket_path_;
+  const std::string shared_memory_name_;
+  SharedMemory shared_memory_;
+  const int socket_;
+  std::thread thread_;
+  std::atomic<bool> model_quantities_requested_{false};
+};
+
+}  // anonymous namespace
+
+TEST(RobotDaemon, ClientThrowsIfDaemonIsNotRunning) {
+  EXPECT_THROW(DaemonClient("/tmp/libfranka_no_daemon.sock"), NetworkException);
+}
+
+TEST(RobotDaemon, ClientReadsPublishedStates) {
+  FakeDaemon daemon;
+  daemon.serve();
+  DaemonClient client(daemon.socketPath());
+  EXPECT_FALSE(daemon.modelQuantitiesRequested());
+
+  RobotState robot_state;
+  randomRobotState(robot_state);
+  ModelQuantities model;
+  model.mass[3] = 2.0;
+  std::array<double, 7> gravity{{1, 2, 3, 4, 5, 6, 7}};
+  publishState(daemon.segment(), robot_state, Duration(2), 0, model, gravity);
+
+  DaemonState state = client.readOnce();
+  testRobotStatesAreEqual(robot_state, state.robot_state);
+  EXPECT_EQ(Duration(2), state.period);
+  EXPECT_EQ(1u, state.count);
+  EXPECT_EQ(model.mass, state.model.mass);
+  EXPECT_EQ(gravity, state.gravity);
+
+  std::thread publisher([&] {
+    for (int i = 0; i < 3; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      publishState(daemon.segment(), robot_state, Duration(1), 0, model, gravity);
+    }
+  });
+  std::vector<uint64_t> counts;
+  client.read([&](const DaemonState& daemon_state) {
+    counts.push_back(daemon_state.count);
+    return daemon_state.count < 4;
+  });
+  publisher.join();
+
+  ASSERT_FALSE(counts.empty());
+  EXPECT_EQ(4u, counts.back());
+  EXPECT_TRUE(std::is_sorted(counts.cbegin(), counts.cend()));
+}
+
+TEST(RobotDaemon, ClientThrowsIfDaemonDiesWhilePublishing) {
+  FakeDaemon daemon;
+  daemon.serve();
+  DaemonClient client(daemon.socketPath());
+
+  publishState(daemon.segment(), RobotState(), Duration(1), 0, ModelQuantities(), {});
+  // A daemon that is killed while publishing leaves the sequence odd.
+  daemon.segment()->state.sequence++;
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_THROW(client.readOnce(), NetworkException);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+  RobotCommand command;
+  writeCommand(daemon.segment(), 1, 1, command);
+  daemon.segment()->command.sequence++;
+  EXPECT_FALSE(readCommand(*daemon.segment(), 1, 1, &command));
+}
+
+TEST(RobotDaemon, ClientRequestsModelQuantities) {
+  FakeDaemon daemon;
+  daemon.serve();
+  DaemonClient client(daemon.socketPath(), true);
+  EXPECT_TRUE(daemon.modelQuantitiesRequested());
+}
+
+TEST(RobotDaemon, ClientSendsConfigurationBatches) {
+  FakeDaemon daemon;
+  std::vector<RobotConfiguration::Change> received;
+  daemon.serve([&](int client, const std::vector<RobotConfiguration::Change>& changes) {
+    received = changes;
+    if (changes.size() == 1) {
+      sendDaemonResponse(client, DaemonStatus::kFailed, "libfranka: command rejected");
+    } else {
+      sendDaemonResponse(client, DaemonStatus::kSuccess, "");
+    }
+  });
+  DaemonClient client(daemon.socketPath());
+
+  RobotConfiguration configuration;
+  configuration.setJointImpedance({{1, 2, 3, 4, 5, 6, 7}})
+      .setLoad(0.5, {{0.1, 0.2, 0.3}}, {{1, 0, 0, 0, 1, 0, 0, 0, 1}})
+      .automaticErrorRecovery();
+  EXPECT_EQ(3u, configuration.size());
+  client.configure(configuration);
+
+  ASSERT_EQ(3u, received.size());
+  EXPECT_EQ(configuration.changes()[0].type, received[0].type);
+  EXPECT_EQ(configuration.changes()[1].values, received[1].values);
+  EXPECT_EQ(0.5, received[1].values[0]);
+  EXPECT_EQ(0.3, received[1].values[3]);
+
+  EXPECT_THROW(client.configure(RobotConfiguration().setCartesianImpedance({{1, 2, 3, 4, 5, 6}})),
+               CommandException);
+}
+
+TEST(RobotDaemon, ConfigurationRejectsUnknownChanges) {
+  RobotConfiguration configuration;
+  RobotConfiguration::Change change{};
+  change.type = 1000;
+  EXPECT_THROW(configuration.append({change}), std::invalid_argument);
+  EXPECT_EQ(0u, configuration.size());
+}
+
+TEST(RobotDaemon, ClientControlsRobotWithLease) {
+  FakeDaemon daemon;
+  std::vector<std::array<double, 7>> commands;
+  daemon.serve({}, [&](int client, const DaemonControlRequest& request) {
+    EXPECT_EQ(DaemonControlMode::kJointVelocities, request.mode);
+    EXPECT_EQ(ControllerMode::kCartesianImpedance, request.controller_mode);
+    EXPECT_EQ(0u, request.limit_rate);
+    EXPECT_EQ(50.0, request.cutoff_frequency);
+
+    constexpr uint64_t kLease = 7;
+    DaemonSegment* segment = daemon.segment();
+    segment->control.lease = kLease;
+    sendDaemonResponse(client, DaemonStatus::kSuccess, "", kLease);
+
+    // A state of another control loop is ignored by the client.
+    publishState(segment, RobotState(), Duration(1), 0, ModelQuantities(), {});
+    RobotCommand command;
+    for (uint64_t i = 0; i < 100; i++) {
+      RobotState robot_state;
+      robot_state.time = Duration(i);
+      publishState(segment, robot_state, Duration(i == 0 ? 0 : 1), kLease, ModelQuantities(), {});
+      while (!readCommand(*segment, kLease, segment->state.count, &command)) {
+        std::this_thread::yield();
+      }
+      commands.push_back(command.joint_velocities.dq);
+      if (command.joint_velocities.motion_finished) {
+        break;
+      }
+    }
+    finishControl(segment, kLease, DaemonStatus::kSuccess, "");
+  });
+  DaemonClient client(daemon.socketPath());
+
+  std::vector<Duration> periods;
+  client.control(
+      [&](const RobotState& robot_state, Duration period) {
+        periods.push_back(period);
+        double velocity = robot_state.time.toSec();
+        JointVelocities velocities{{velocity, 0, 0, 0, 0, 0, 0}};
+        velocities.motion_finished = periods.size() == 3;
+        return velocities;
+      },
+      ControllerMode::kCartesianImpedance, false, 50.0);
+
+  EXPECT_EQ((std::vector<Duration>{Duration(0), Duration(1), Duration(1)}), periods);
+  ASSERT_EQ(3u, commands.size());
+  EXPECT_EQ(0.0, commands[0][0]);
+  EXPECT_EQ(0.002, commands[2][0]);
+  EXPECT_EQ(0u, daemon.segment()->control.lease.load());
+}
+
+TEST(RobotDaemon, ClientThrowsIfControlIsRejectedOrAborted) {
+  FakeDaemon daemon;
+  int requests = 0;
+  daemon.serve({}, [&](int client, const DaemonControlRequest& /* request */) {
+    if (++requests == 1) {
+      sendDaemonResponse(client, DaemonStatus::kRejected,
+                         "libfranka daemon: Another client controls the robot.");
+      return;
+    }
+    DaemonSegment* segment = daemon.segment();
+    segment->control.lease = 1;
+    sendDaemonResponse(client, DaemonStatus::kSuccess, "", 1);
+    publishState(segment, RobotState(), Duration(0), 1, ModelQuantities(), {});
+    finishControl(segment, 1, DaemonStatus::kFailed, "libfranka: Motion aborted by reflex!");
+  });
+  DaemonClient client(daemon.socketPath());
+
+  auto callback = [](const RobotState&, Duration) { return Torques({0, 0, 0, 0, 0, 0, 0}); };
+  EXPECT_THROW(client.control(callback), InvalidOperationException);
+  try {
+    client.control(callback);
+    FAIL() << "Expected ControlException";
+  } catch (const ControlException& exception) {
+    EXPECT_STREQ("libfranka: Motion aborted by reflex!", exception.what());
+  }
+}
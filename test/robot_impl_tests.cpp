@@ -517,6 +517,80 @@ TEST(RobotImpl, CanStopMotion) {
   EXPECT_FALSE(robot.motionGeneratorRunning());
 }
 
+TEST(RobotImpl, ReportsMotionStatisticsOnceAfterMotion) {
+  Move::Deviation maximum_path_deviation{0, 1, 2};
+  Move::Deviation maximum_goal_pose_deviation{3, 4, 5};
+
+  RobotCommand sent_command;
+  randomRobotCommand(sent_command);
+  sent_command.motion.motion_generation_finished = false;
+
+  uint32_t move_id;
+
+  RobotMockServer server;
+  Robot::Impl robot(std::make_unique<franka::Network>("127.0.0.1", kCommandPort), 0);
+
+  size_t reports = 0;
+  franka::MotionStatistics reported_statistics;
+  robot.setMotionStatisticsCallback([&](const franka::MotionStatistics& statistics) {
+    reports++;
+    reported_statistics = statistics;
+  });
+
+  server
+      .onSendUDP<RobotState>([](RobotState& robot_state) {
+        robot_state.motion_generator_mode = MotionGeneratorMode::kCartesianVelocity;
+        robot_state.controller_mode = ControllerMode::kCartesianImpedance;
+        robot_state.robot_mode = RobotMode::kMove;
+      })
+      .spinOnce()
+      .waitForCommand<Move>(
+          [&](const Move::Request&) { return Move::Response(Move::Status::kMotionStarted); },
+          &move_id)
+      .spinOnce();
+
+  auto id = robot.startMotion(Move::ControllerMode::kCartesianImpedance,
+                              Move::MotionGeneratorMode::kCartesianVelocity, maximum_path_deviation,
+                              maximum_goal_pose_deviation);
+
+  server
+      .onSendUDP<RobotState>([](RobotState& robot_state) {
+        robot_state.motion_generator_mode = MotionGeneratorMode::kCartesianVelocity;
+        robot_state.controller_mode = ControllerMode::kCartesianImpedance;
+        robot_state.robot_mode = RobotMode::kMove;
+        robot_state.q_d[3] = 0.5;
+        robot_state.q[3] = 0.25;
+      })
+      .spinOnce()
+      .onReceiveRobotCommand([](const RobotCommand&) {})
+      .spinOnce();
+
+  robot.update(&sent_command.motion, nullptr);
+  EXPECT_EQ(0u, reports);
+
+  server
+      .onSendUDP<RobotState>([](RobotState& robot_state) {
+        robot_state.motion_generator_mode = MotionGeneratorMode::kIdle;
+        robot_state.controller_mode = ControllerMode::kCartesianImpedance;
+        robot_state.robot_mode = RobotMode::kIdle;
+      })
+      .sendResponse<Move>(move_id, []() { return Move::Response(Move::Status::kSuccess); })
+      .spinOnce()
+      .onReceiveRobotCommand([](const RobotCommand& command) {
+        EXPECT_TRUE(command.motion.motion_generation_finished);
+      })
+      .spinOnce();
+
+  robot.finishMotion(id, &sent_command.motion, nullptr);
+  EXPECT_EQ(1u, reports);
+  EXPECT_EQ(2u, reported_statistics.samples);
+  EXPECT_DOUBLE_EQ(0.25, reported_statistics.joint_position_error[3].max);
+
+  // Statistics of a finished motion are not reported again.
+  robot.finishMotion(id, &sent_command.motion, nullptr);
+  EXPECT_EQ(1u, reports);
+}
+
 TEST(RobotImpl, StopMotionErrorThrowsControlException) {
   Move::Deviation maximum_path_deviation{0, 1, 2};
   Move::Deviation maximum_goal_pose_deviation{3, 4, 5};
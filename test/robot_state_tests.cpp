@@ -39,12 +39,16 @@ TEST(RobotState, CanBeStreamed) {
   EXPECT_PRED2(stringContains, output, "I_total");
   EXPECT_PRED2(stringContains, output, "elbow");
   EXPECT_PRED2(stringContains, output, "elbow_d");
+  EXPECT_PRED2(stringContains, output, "elbow_c");
+  EXPECT_PRED2(stringContains, output, "delbow_c");
+  EXPECT_PRED2(stringContains, output, "ddelbow_c");
   EXPECT_PRED2(stringContains, output, "tau_J");
   EXPECT_PRED2(stringContains, output, "dtau_J");
   EXPECT_PRED2(stringContains, output, "q");
   EXPECT_PRED2(stringContains, output, "dq");
   EXPECT_PRED2(stringContains, output, "q_d");
   EXPECT_PRED2(stringContains, output, "dq_d");
+  EXPECT_PRED2(stringContains, output, "ddq_d");
   EXPECT_PRED2(stringContains, output, "joint_contact");
   EXPECT_PRED2(stringContains, output, "cartesian_contact");
   EXPECT_PRED2(stringContains, output, "joint_collision");
@@ -53,6 +57,9 @@ TEST(RobotState, CanBeStreamed) {
   EXPECT_PRED2(stringContains, output, "O_F_ext_hat_K");
   EXPECT_PRED2(stringContains, output, "K_F_ext_hat_K");
   EXPECT_PRED2(stringContains, output, "O_dP_EE_d");
+  EXPECT_PRED2(stringContains, output, "O_T_EE_c");
+  EXPECT_PRED2(stringContains, output, "O_dP_EE_c");
+  EXPECT_PRED2(stringContains, output, "O_ddP_EE_c");
   EXPECT_PRED2(stringContains, output, "theta");
   EXPECT_PRED2(stringContains, output, "dtheta");
   EXPECT_PRED2(stringContains, output, "current_errors");
@@ -2,10 +2,13 @@
 // Use of this source code is governed by the Apache-2.0 license, see LICENSE
 #include <gmock/gmock.h>
 
+#include <array>
 #include <atomic>
 #include <functional>
+#include <stdexcept>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <franka/exception.h>
 #include <franka/lowpass_filter.h>
@@ -60,6 +63,66 @@ TEST(Robot, CanReadRobotState) {
   robot.read([&](const RobotState& robot_state) { return callback.invoke(robot_state); });
 }
 
+TEST(Robot, CanReadRobotStatesInBatches) {
+  RobotMockServer server;
+  Robot robot("127.0.0.1");
+
+  // Lose two states between the second and the third state.
+  server.sendEmptyState<research_interface::robot::RobotState>()
+      .sendEmptyState<research_interface::robot::RobotState>()
+      .onSendUDP<research_interface::robot::RobotState>(
+          [](research_interface::robot::RobotState& robot_state) { robot_state.message_id += 2; })
+      .spinOnce();
+
+  std::array<RobotState, 3> buffer;
+  size_t batches = 0;
+  robot.readBatched(
+      [&](const RobotState* states, size_t count, uint64_t dropped_states) {
+        EXPECT_EQ(buffer.data(), states);
+        EXPECT_EQ(3u, count);
+        EXPECT_EQ(2u, dropped_states);
+        EXPECT_EQ(2u, states[0].time.toMSec());
+        EXPECT_EQ(3u, states[1].time.toMSec());
+        EXPECT_EQ(6u, states[2].time.toMSec());
+        batches++;
+        return false;
+      },
+      buffer.data(), buffer.size());
+  EXPECT_EQ(1u, batches);
+}
+
+TEST(Robot, CanReadRobotStatesInTimeWindows) {
+  RobotMockServer server;
+  Robot robot("127.0.0.1");
+
+  for (size_t i = 0; i < 4; i++) {
+    server.sendEmptyState<research_interface::robot::RobotState>();
+  }
+  server.spinOnce();
+
+  std::array<RobotState, 10> buffer;
+  std::vector<size_t> counts;
+  robot.readBatched(
+      [&](const RobotState* states, size_t count, uint64_t dropped_states) {
+        EXPECT_EQ(0u, dropped_states);
+        EXPECT_EQ(Duration(1), states[count - 1].time - states[0].time);
+        counts.push_back(count);
+        return counts.size() < 2;
+      },
+      buffer.data(), buffer.size(), Duration(1));
+  EXPECT_EQ((std::vector<size_t>{2, 2}), counts);
+}
+
+TEST(Robot, ThrowsOnInvalidBatchBuffer) {
+  RobotMockServer server;
+  Robot robot("127.0.0.1");
+
+  std::array<RobotState, 1> buffer;
+  auto callback = [](const RobotState*, size_t, uint64_t) { return false; };
+  EXPECT_THROW(robot.readBatched(callback, nullptr, 1), std::invalid_argument);
+  EXPECT_THROW(robot.readBatched(callback, buffer.data(), 0), std::invalid_argument);
+}
+
 TEST(Robot, CanReadRobotStateAfterInstanceMove) {
   struct MockCallback {
     MOCK_METHOD1(invoke, bool(const RobotState&));
@@ -446,6 +509,12 @@ TEST(Robot, ThrowsIfConflictingOperationIsRunning) {
                InvalidOperationException);
   EXPECT_THROW(robot.read(std::function<bool(const RobotState&)>()), InvalidOperationException);
   EXPECT_THROW(robot.readOnce(), InvalidOperationException);
+  std::array<RobotState, 1> buffer;
+  EXPECT_THROW(robot.readBatched([](const RobotState*, size_t, uint64_t) { return false; },
+                                 buffer.data(), buffer.size()),
+               InvalidOperationException);
+  EXPECT_THROW(robot.setEnergyAccounting(true), InvalidOperationException);
+  EXPECT_NO_THROW(robot.energySnapshot());
 
   server.ignoreUdpBuffer();
 
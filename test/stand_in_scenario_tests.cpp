@@ -0,0 +1,152 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "stand_in/scenario.h"
+
+using namespace std::chrono_literals;
+
+using franka::stand_in::Scenario;
+using franka::stand_in::ScenarioException;
+using franka::stand_in::parseScenario;
+using ::testing::HasSubstr;
+
+namespace {
+
+Scenario parse(const std::string& text) {
+  std::istringstream input(text);
+  return parseScenario(input);
+}
+
+std::string parseError(const std::string& text) {
+  try {
+    parse(text);
+  } catch (const ScenarioException& exception) {
+    return exception.what();
+  }
+  return "";
+}
+
+}  // anonymous namespace
+
+TEST(StandInScenario, HasDefaults) {
+  Scenario scenario = parse("");
+
+  ASSERT_EQ(1u, scenario.timing.size());
+  EXPECT_EQ(0ms, scenario.timing[0].start);
+  EXPECT_EQ(1000us, scenario.timing[0].period);
+  EXPECT_EQ(0us, scenario.timing[0].jitter);
+  EXPECT_EQ(0u, scenario.timing[0].drop_every);
+  EXPECT_TRUE(scenario.track_commands);
+  EXPECT_TRUE(scenario.reflexes.empty());
+  EXPECT_FALSE(scenario.gripper);
+  EXPECT_EQ("success", scenario.responseFor("Move"));
+}
+
+TEST(StandInScenario, ParsesAllDirectives) {
+  Scenario scenario = parse(
+      "# A comment on its own line\n"
+      "\n"
+      "timing 0 1000\n"
+      "timing 500 2000 100 10  # Trailing comment\n"
+      "joint 0 constant 0.5\n"
+      "joint 6 sine 1 0.25 2\n"
+      "external_wrench 1 2 3 4 5 6\n"
+      "track_commands off\n"
+      "response Move aborted\n"
+      "response gripper.Grasp fail\n"
+      "reflex 300 joint_velocity_violation\n"
+      "reflex 100 cartesian_reflex\n"
+      "model_library /tmp/model.so\n"
+      "gripper on\n"
+      "gripper_period 5000\n"
+      "gripper_max_width 0.1\n");
+
+  ASSERT_EQ(2u, scenario.timing.size());
+  EXPECT_EQ(500ms, scenario.timing[1].start);
+  EXPECT_EQ(2000us, scenario.timing[1].period);
+  EXPECT_EQ(100us, scenario.timing[1].jitter);
+  EXPECT_EQ(10u, scenario.timing[1].drop_every);
+
+  EXPECT_EQ(0.5, scenario.joints[0].offset);
+  EXPECT_EQ(0.0, scenario.joints[0].amplitude);
+  EXPECT_EQ(1.0, scenario.joints[6].offset);
+  EXPECT_EQ(0.25, scenario.joints[6].amplitude);
+  EXPECT_EQ(2.0, scenario.joints[6].frequency);
+  EXPECT_EQ((std::array<double, 6>{{1, 2, 3, 4, 5, 6}}), scenario.external_wrench);
+  EXPECT_FALSE(scenario.track_commands);
+
+  EXPECT_EQ("aborted", scenario.responseFor("Move"));
+  EXPECT_EQ("fail", scenario.responseFor("gripper.Grasp"));
+  EXPECT_EQ("success", scenario.responseFor("Grasp"));
+
+  ASSERT_EQ(2u, scenario.reflexes.size());
+  EXPECT_EQ(100ms, scenario.reflexes[0].time);
+  EXPECT_EQ("cartesian_reflex", scenario.reflexes[0].error);
+  EXPECT_EQ(300ms, scenario.reflexes[1].time);
+  EXPECT_EQ("joint_velocity_violation", scenario.reflexes[1].error);
+
+  EXPECT_EQ("/tmp/model.so", scenario.model_library);
+  EXPECT_TRUE(scenario.gripper);
+  EXPECT_EQ(5000us, scenario.gripper_period);
+  EXPECT_EQ(0.1, scenario.gripper_max_width);
+}
+
+TEST(StandInScenario, SelectsActiveTimingProfile) {
+  Scenario scenario = parse(
+      "timing 100 1000\n"
+      "timing 200 2000\n"
+      "timing 300 4000\n");
+
+  EXPECT_EQ(1000us, scenario.timingAt(0ms).period);
+  EXPECT_EQ(1000us, scenario.timingAt(100ms).period);
+  EXPECT_EQ(1000us, scenario.timingAt(199ms).period);
+  EXPECT_EQ(2000us, scenario.timingAt(200ms).period);
+  EXPECT_EQ(4000us, scenario.timingAt(300ms).period);
+  EXPECT_EQ(4000us, scenario.timingAt(1h).period);
+}
+
+TEST(StandInScenario, ReportsUnorderedTimingProfiles) {
+  std::string error = parseError(
+      "timing 0 1000\n"
+      "timing 0 2000\n");
+  EXPECT_THAT(error, HasSubstr("scenario line 2"));
+  EXPECT_THAT(error, HasSubstr("timing profiles must be ordered by start time"));
+
+  EXPECT_THAT(parseError("timing 200 1000\n\ntiming 100 1000\n"), HasSubstr("scenario line 3"));
+}
+
+TEST(StandInScenario, ReportsInvalidTimingProfiles) {
+  EXPECT_THAT(parseError("timing 0 0"), HasSubstr("period must be positive"));
+  EXPECT_THAT(parseError("timing 0 1000 -1"), HasSubstr("jitter must not be negative"));
+  EXPECT_THAT(parseError("timing 0"), HasSubstr("expected period"));
+  EXPECT_THAT(parseError("gripper_period 0"), HasSubstr("period must be positive"));
+}
+
+TEST(StandInScenario, ReportsJointIndexOutOfRange) {
+  std::string error = parseError("joint 0 constant 1\njoint 7 constant 1\n");
+  EXPECT_THAT(error, HasSubstr("scenario line 2"));
+  EXPECT_THAT(error, HasSubstr("joint index out of range"));
+}
+
+TEST(StandInScenario, ReportsUnknownGeneratorType) {
+  std::string error = parseError("joint 3 ramp 1");
+  EXPECT_THAT(error, HasSubstr("scenario line 1"));
+  EXPECT_THAT(error, HasSubstr("unknown generator type ramp"));
+
+  EXPECT_THAT(parseError("joint 3 sine 1 2"), HasSubstr("expected frequency"));
+}
+
+TEST(StandInScenario, ReportsSyntaxErrors) {
+  EXPECT_THAT(parseError("speed 1"), HasSubstr("unknown directive speed"));
+  EXPECT_THAT(parseError("track_commands maybe"), HasSubstr("expected on or off, got maybe"));
+  EXPECT_THAT(parseError("gripper on off"), HasSubstr("unexpected off"));
+  EXPECT_THAT(parseError("reflex soon cartesian_reflex"), HasSubstr("expected time"));
+  EXPECT_THAT(parseError("response Move"), HasSubstr("expected status name"));
+  EXPECT_THAT(parseError("external_wrench 1 2 3"), HasSubstr("expected wrench component"));
+}
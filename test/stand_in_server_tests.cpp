@@ -0,0 +1,217 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <franka/gripper.h>
+#include <franka/lowpass_filter.h>
+#include <franka/robot.h>
+
+#include "stand_in/command_log.h"
+#include "stand_in/gripper_server.h"
+#include "stand_in/robot_server.h"
+#include "stand_in/scenario.h"
+
+using franka::stand_in::CommandLog;
+using franka::stand_in::GripperServer;
+using franka::stand_in::RobotServer;
+using franka::stand_in::Scenario;
+using franka::stand_in::ScenarioException;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+namespace {
+
+constexpr size_t kConnectAttempts = 100;
+
+Scenario parse(const std::string& text) {
+  std::istringstream input(text);
+  return franka::stand_in::parseScenario(input);
+}
+
+// Runs a stand-in server on the loopback interface for the lifetime of the object.
+template <typename Server>
+class StandIn {
+ public:
+  explicit StandIn(const std::string& scenario)
+      : scenario_(parse(scenario)),
+        log_(&output_),
+        server_(scenario_, &log_),
+        thread_([this] { server_.run("127.0.0.1", running_); }) {}
+
+  ~StandIn() { stop(); }
+
+  // Stops the server and returns the lines of its command log.
+  std::vector<std::string> stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    std::vector<std::string> lines;
+    std::istringstream input(output_.str());
+    for (std::string line; std::getline(input, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+ private:
+  Scenario scenario_;
+  std::ostringstream output_;
+  CommandLog log_;
+  Server server_;
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+};
+
+// The server binds its port on its own thread, so connections are retried until it listens.
+template <typename T, typename... Args>
+T connectToStandIn(const Args&... args) {
+  for (size_t attempt = 1;; attempt++) {
+    try {
+      return T("127.0.0.1", args...);
+    } catch (const franka::NetworkException&) {
+      if (attempt == kConnectAttempts) {
+        throw;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+}
+
+// Returns the names of the requests the given device sent, in order.
+std::vector<std::string> requests(const std::vector<std::string>& lines,
+                                  const std::string& device) {
+  std::vector<std::string> names;
+  for (const std::string& line : lines) {
+    std::istringstream input(line);
+    std::string time, logged_device, type, name;
+    input >> time >> logged_device >> type >> name;
+    if (logged_device == device && type == "request") {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+struct LoggedCommand {
+  bool finished;
+  std::array<double, 7> q_c;
+};
+
+std::vector<LoggedCommand> robotCommands(const std::vector<std::string>& lines) {
+  std::vector<LoggedCommand> commands;
+  for (const std::string& line : lines) {
+    std::istringstream input(line);
+    std::string time, device, type;
+    uint64_t message_id;
+    input >> time >> device >> type;
+    if (device != "robot" || type != "command") {
+      continue;
+    }
+    LoggedCommand command;
+    input >> message_id >> command.finished;
+    for (double& q : command.q_c) {
+      input >> q;
+    }
+    EXPECT_FALSE(input.fail()) << line;
+    commands.push_back(command);
+  }
+  return commands;
+}
+
+template <typename Server>
+std::string constructionError(const std::string& text) {
+  Scenario scenario = parse(text);
+  CommandLog log(nullptr);
+  try {
+    Server server(scenario, &log);
+  } catch (const ScenarioException& exception) {
+    return exception.what();
+  }
+  return "";
+}
+
+}  // anonymous namespace
+
+TEST(StandInServer, ReportsUnknownNamesOnConstruction) {
+  EXPECT_THAT(constructionError<RobotServer>("response Move moving"),
+              HasSubstr("unknown status moving for Move"));
+  EXPECT_THAT(constructionError<RobotServer>("response Jump success"),
+              HasSubstr("unknown robot command Jump"));
+  EXPECT_THAT(constructionError<RobotServer>("reflex 10 no_such_reflex"),
+              HasSubstr("unknown error no_such_reflex"));
+  EXPECT_THAT(constructionError<GripperServer>("response gripper.Grasp maybe"),
+              HasSubstr("unknown status maybe for gripper.Grasp"));
+  EXPECT_THAT(constructionError<GripperServer>("response gripper.Wave success"),
+              HasSubstr("unknown gripper command gripper.Wave"));
+
+  EXPECT_EQ("", constructionError<RobotServer>("response gripper.Grasp fail"));
+  EXPECT_EQ("", constructionError<GripperServer>("response Move aborted"));
+}
+
+TEST(StandInServer, LogsRobotCommands) {
+  StandIn<RobotServer> stand_in(
+      "joint 0 constant 0.25\n"
+      "joint 3 constant -1.5\n"
+      "joint 5 constant 1.75\n");
+  const std::array<double, 7> kScenarioPosition{{0.25, 0, 0, -1.5, 0, 1.75, 0}};
+
+  std::array<double, 7> initial_position{};
+  size_t cycles = 0;
+  {
+    franka::Robot robot = connectToStandIn<franka::Robot>(franka::RealtimeConfig::kIgnore);
+    robot.setJointImpedance({{3000, 3000, 3000, 2500, 2500, 2000, 2000}});
+    robot.control(
+        [&](const franka::RobotState& robot_state, franka::Duration) -> franka::JointPositions {
+          if (cycles == 0) {
+            initial_position = robot_state.q_d;
+          }
+          cycles++;
+          franka::JointPositions output(initial_position);
+          return cycles < 50 ? output : franka::MotionFinished(output);
+        },
+        franka::ControllerMode::kJointImpedance, false, franka::kMaxCutoffFrequency);
+  }
+  EXPECT_EQ(kScenarioPosition, initial_position);
+  EXPECT_EQ(50u, cycles);
+
+  std::vector<std::string> lines = stand_in.stop();
+  EXPECT_THAT(requests(lines, "robot"), ElementsAre("Connect", "SetJointImpedance", "Move"));
+
+  std::vector<LoggedCommand> commands = robotCommands(lines);
+  ASSERT_FALSE(commands.empty());
+  EXPECT_TRUE(commands.back().finished);
+  for (const LoggedCommand& command : commands) {
+    EXPECT_EQ(kScenarioPosition, command.q_c);
+  }
+}
+
+TEST(StandInServer, LogsGripperCommands) {
+  StandIn<GripperServer> stand_in(
+      "gripper on\n"
+      "gripper_period 1000\n"
+      "gripper_max_width 0.1\n"
+      "response gripper.Grasp unsuccessful\n");
+
+  {
+    franka::Gripper gripper = connectToStandIn<franka::Gripper>();
+    EXPECT_EQ(0.1, gripper.readOnce().max_width);
+    EXPECT_TRUE(gripper.homing());
+    EXPECT_TRUE(gripper.move(0.05, 0.1));
+    EXPECT_FALSE(gripper.grasp(0.02, 0.1, 20));
+  }
+
+  EXPECT_THAT(requests(stand_in.stop(), "gripper"),
+              ElementsAre("Connect", "Homing", "Move", "Grasp"));
+}
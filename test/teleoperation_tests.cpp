@@ -0,0 +1,240 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <franka/teleoperation.h>
+
+using namespace franka;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+namespace {
+
+const std::chrono::steady_clock::time_point kStart{std::chrono::seconds(100)};
+
+RobotState initialState() {
+  RobotState robot_state;
+  Eigen::Affine3d pose(Eigen::AngleAxisd(M_PI, Eigen::Vector3d::UnitX()));
+  pose.pretranslate(Eigen::Vector3d(0.3, 0.0, 0.5));
+  Eigen::Map<Eigen::Matrix4d>(robot_state.O_T_EE_c.data()) = pose.matrix();
+  return robot_state;
+}
+
+TeleoperationTarget target(std::chrono::steady_clock::duration time,
+                           double x,
+                           double rotation = 0.0) {
+  TeleoperationTarget target;
+  target.time = kStart + time;
+  target.position = {{x, 0.2, -0.1}};
+  Eigen::Quaterniond orientation(Eigen::AngleAxisd(rotation, Eigen::Vector3d::UnitZ()));
+  Eigen::Map<Eigen::Vector4d>(target.orientation.data()) = orientation.coeffs();
+  return target;
+}
+
+Eigen::Vector3d position(const CartesianPose& pose) {
+  return Eigen::Map<const Eigen::Matrix4d>(pose.O_T_EE.data()).topRightCorner<3, 1>();
+}
+
+Eigen::Matrix3d rotation(const std::array<double, 16>& pose) {
+  return Eigen::Map<const Eigen::Matrix4d>(pose.data()).topLeftCorner<3, 3>();
+}
+
+}  // anonymous namespace
+
+TEST(TeleoperationBridge, ThrowsForInvalidParameters) {
+  TeleoperationParameters parameters;
+  parameters.interpolation_delay = -0.001;
+  EXPECT_THROW(TeleoperationBridge{parameters}, std::invalid_argument);
+
+  parameters = TeleoperationParameters();
+  parameters.translation_scale = 0.0;
+  EXPECT_THROW(TeleoperationBridge{parameters}, std::invalid_argument);
+
+  parameters = TeleoperationParameters();
+  parameters.workspace_minimum[1] = 0.5;
+  parameters.workspace_maximum[1] = 0.4;
+  EXPECT_THROW(TeleoperationBridge{parameters}, std::invalid_argument);
+
+  parameters = TeleoperationParameters();
+  parameters.maximum_rotational_velocity = 0.0;
+  EXPECT_THROW(TeleoperationBridge{parameters}, std::invalid_argument);
+}
+
+TEST(TeleoperationBridge, HoldsPoseWithoutTargets) {
+  TeleoperationBridge bridge;
+  RobotState robot_state = initialState();
+
+  EXPECT_EQ(robot_state.O_T_EE_c, bridge(robot_state, Duration(0), kStart).O_T_EE);
+  EXPECT_EQ(robot_state.O_T_EE_c,
+            bridge(robot_state, Duration(1), kStart + milliseconds(1)).O_T_EE);
+  EXPECT_EQ(0u, bridge.statistics().commands);
+}
+
+TEST(TeleoperationBridge, InterpolatesTargetsWithDelay) {
+  TeleoperationParameters parameters;
+  parameters.interpolation_delay = 0.005;
+  TeleoperationBridge bridge(parameters);
+  RobotState robot_state = initialState();
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(bridge.push(target(milliseconds(4 * i), 0.001 * i)));
+  }
+
+  // The target resampled by the first command becomes the reference.
+  CartesianPose command = bridge(robot_state, Duration(0), kStart + milliseconds(13));
+  EXPECT_EQ(robot_state.O_T_EE_c, command.O_T_EE);
+
+  command = bridge(robot_state, Duration(1), kStart + milliseconds(14));
+  EXPECT_NEAR(0.3 + 0.00025, position(command).x(), 1e-12);
+  EXPECT_NEAR(0.0, position(command).y(), 1e-12);
+
+  command = bridge(robot_state, Duration(1), kStart + milliseconds(15));
+  EXPECT_NEAR(0.3 + 0.0005, position(command).x(), 1e-12);
+
+  TeleoperationStatistics statistics = bridge.statistics();
+  EXPECT_EQ(3u, statistics.commands);
+  EXPECT_EQ(0u, statistics.extrapolated);
+  EXPECT_EQ(0u, statistics.held);
+  EXPECT_NEAR(0.003, statistics.latency, 1e-9);
+  EXPECT_NEAR(0.002, statistics.mean_latency, 1e-9);
+}
+
+TEST(TeleoperationBridge, ExtrapolatesAndHoldsMissingTargets) {
+  TeleoperationParameters parameters;
+  parameters.interpolation_delay = 0.0;
+  parameters.maximum_extrapolation = 0.004;
+  parameters.maximum_translational_velocity = 10.0;
+  TeleoperationBridge bridge(parameters);
+  RobotState robot_state = initialState();
+
+  bridge.push(target(milliseconds(0), 0.0));
+  bridge(robot_state, Duration(0), kStart);
+  bridge.push(target(milliseconds(4), 0.001));
+
+  CartesianPose command = bridge(robot_state, Duration(1), kStart + milliseconds(6));
+  EXPECT_NEAR(0.3 + 0.0015, position(command).x(), 1e-12);
+  EXPECT_EQ(1u, bridge.statistics().extrapolated);
+  EXPECT_EQ(0u, bridge.statistics().held);
+
+  for (int i = 7; i < 12; i++) {
+    command = bridge(robot_state, Duration(1), kStart + milliseconds(i));
+  }
+  EXPECT_NEAR(0.3 + 0.002, position(command).x(), 1e-12);
+  TeleoperationStatistics statistics = bridge.statistics();
+  EXPECT_EQ(6u, statistics.extrapolated);
+  EXPECT_EQ(3u, statistics.held);
+  EXPECT_NEAR(0.007, statistics.maximum_latency, 1e-9);
+}
+
+TEST(TeleoperationBridge, ScalesTranslationsAndLimitsWorkspaceAndVelocity) {
+  TeleoperationParameters parameters;
+  parameters.interpolation_delay = 0.0;
+  parameters.translation_scale = 0.5;
+  parameters.workspace_maximum = {{0.301, 1.0, 1.0}};
+  parameters.maximum_translational_velocity = 0.1;
+  TeleoperationBridge bridge(parameters);
+  RobotState robot_state = initialState();
+
+  bridge.push(target(milliseconds(0), 0.0));
+  bridge(robot_state, Duration(0), kStart);
+
+  // Scaled by 0.5 and within the velocity limit of 0.1 mm per millisecond.
+  bridge.push(target(milliseconds(1), 0.0001));
+  CartesianPose command = bridge(robot_state, Duration(1), kStart + milliseconds(1));
+  EXPECT_NEAR(0.3 + 0.00005, position(command).x(), 1e-12);
+
+  // Limited by the velocity.
+  bridge.push(target(milliseconds(2), 0.01));
+  command = bridge(robot_state, Duration(1), kStart + milliseconds(2));
+  EXPECT_NEAR(0.3 + 0.00015, position(command).x(), 1e-12);
+
+  // Limited by the workspace.
+  for (int i = 3; i < 40; i++) {
+    command = bridge(robot_state, Duration(1), kStart + milliseconds(i));
+  }
+  EXPECT_NEAR(0.301, position(command).x(), 1e-12);
+}
+
+TEST(TeleoperationBridge, RotatesRelativeToReference) {
+  TeleoperationParameters parameters;
+  parameters.interpolation_delay = 0.0;
+  parameters.maximum_rotational_velocity = 10.0;
+  TeleoperationBridge bridge(parameters);
+  RobotState robot_state = initialState();
+
+  bridge.push(target(milliseconds(0), 0.0, 0.3));
+  bridge(robot_state, Duration(0), kStart);
+
+  bridge.push(target(milliseconds(1), 0.0, 0.305));
+  CartesianPose command = bridge(robot_state, Duration(1), kStart + milliseconds(1));
+  Eigen::Matrix3d expected =
+      Eigen::AngleAxisd(0.005, Eigen::Vector3d::UnitZ()) * rotation(robot_state.O_T_EE_c);
+  EXPECT_TRUE(expected.isApprox(rotation(command.O_T_EE), 1e-9));
+
+  // Limited to 0.01 rad per millisecond.
+  bridge.push(target(milliseconds(2), 0.0, 0.5));
+  command = bridge(robot_state, Duration(1), kStart + milliseconds(2));
+  expected = Eigen::AngleAxisd(0.015, Eigen::Vector3d::UnitZ()) * rotation(robot_state.O_T_EE_c);
+  EXPECT_TRUE(expected.isApprox(rotation(command.O_T_EE), 1e-9));
+}
+
+TEST(TeleoperationBridge, DropsTargetsIfBufferIsFullOrTargetsAreOutdated) {
+  TeleoperationBridge bridge;
+  for (size_t i = 0; i < TeleoperationBridge::kCapacity; i++) {
+    EXPECT_TRUE(bridge.push(target(microseconds(i), 0.0)));
+  }
+  EXPECT_FALSE(bridge.push(target(milliseconds(1), 0.0)));
+  EXPECT_EQ(1u, bridge.statistics().dropped);
+
+  RobotState robot_state = initialState();
+  bridge(robot_state, Duration(0), kStart + milliseconds(1));
+  EXPECT_TRUE(bridge.push(target(microseconds(10), 0.0)));
+  bridge(robot_state, Duration(1), kStart + milliseconds(2));
+  EXPECT_EQ(2u, bridge.statistics().dropped);
+
+  bridge.reset();
+  EXPECT_EQ(0u, bridge.statistics().dropped);
+  EXPECT_EQ(0u, bridge.statistics().commands);
+}
+
+TEST(TeleoperationBridge, ReceivesTargetsFromInputThread) {
+  TeleoperationParameters parameters;
+  parameters.interpolation_delay = 0.0;
+  parameters.maximum_extrapolation = 0.0;
+  parameters.maximum_translational_velocity = 100.0;
+  TeleoperationBridge bridge(parameters);
+  RobotState robot_state = initialState();
+  bridge.push(target(microseconds(0), 0.0));
+  bridge(robot_state, Duration(0), kStart);
+
+  constexpr int kTargets = 2000;
+  uint64_t rejected = 0;
+  std::thread input([&] {
+    for (int i = 1; i <= kTargets; i++) {
+      while (!bridge.push(target(microseconds(i), 1e-6 * i))) {
+        rejected++;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  double last_x = 0.3;
+  for (int i = 0; i < 100000 && last_x < 0.3 + 1e-6 * kTargets - 1e-12; i++) {
+    double x = position(bridge(robot_state, Duration(1), kStart + microseconds(kTargets))).x();
+    EXPECT_GE(x, last_x);
+    last_x = x;
+    std::this_thread::yield();
+  }
+  input.join();
+
+  EXPECT_NEAR(0.3 + 1e-6 * kTargets, last_x, 1e-9);
+  // Only rejected targets were dropped, all others arrived in order.
+  EXPECT_EQ(rejected, bridge.statistics().dropped);
+}
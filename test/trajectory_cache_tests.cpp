@@ -0,0 +1,188 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/exception.h>
+#include <franka/trajectory_cache.h>
+
+using namespace franka;
+
+namespace {
+
+std::vector<TrajectoryCache::Sample> makeSamples(size_t size, double value) {
+  std::vector<TrajectoryCache::Sample> samples(size);
+  for (size_t i = 0; i < size; i++) {
+    samples[i].fill(value + i);
+  }
+  return samples;
+}
+
+TrajectoryCache::Key makeKey(const TrajectoryCache& cache, double goal) {
+  std::array<double, 7> q_start{};
+  std::array<double, 7> q_goal{};
+  q_goal.fill(goal);
+  return cache.makeKey(q_start, q_goal, {0.5});
+}
+
+void expectProfile(const std::vector<TrajectoryCache::Sample>& expected,
+                   const TrajectoryCache::Profile& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i], actual[i]);
+  }
+}
+
+}  // anonymous namespace
+
+TEST(TrajectoryCache, ThrowsOnInvalidArguments) {
+  EXPECT_THROW(TrajectoryCache(0, 10), std::invalid_argument);
+  EXPECT_THROW(TrajectoryCache(10, 0), std::invalid_argument);
+  EXPECT_THROW(TrajectoryCache(10, 10, 0.0), std::invalid_argument);
+
+  TrajectoryCache cache(2, 10);
+  EXPECT_THROW(cache.insert(makeKey(cache, 1.0), {}), std::invalid_argument);
+  EXPECT_THROW(cache.insert(makeKey(cache, 1.0), makeSamples(11, 0.0)), std::invalid_argument);
+}
+
+TEST(TrajectoryCache, QuantizesKeys) {
+  TrajectoryCache cache(2, 10, 1e-3);
+  std::array<double, 7> q_start{{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7}};
+  std::array<double, 7> q_start_nearby = q_start;
+  q_start_nearby[3] += 4e-4;
+  std::array<double, 7> q_start_far = q_start;
+  q_start_far[3] += 2e-3;
+  std::array<double, 7> q_goal{};
+
+  EXPECT_EQ(cache.makeKey(q_start, q_goal, {0.5, 2.0}),
+            cache.makeKey(q_start_nearby, q_goal, {0.5, 2.0}));
+  EXPECT_FALSE(cache.makeKey(q_start, q_goal, {0.5, 2.0}) ==
+               cache.makeKey(q_start_far, q_goal, {0.5, 2.0}));
+  EXPECT_FALSE(cache.makeKey(q_start, q_goal, {0.5, 2.0}) ==
+               cache.makeKey(q_start, q_goal, {0.5, 2.5}));
+  EXPECT_FALSE(cache.makeKey(q_start, q_goal, {0.5}) == cache.makeKey(q_goal, q_start, {0.5}));
+}
+
+TEST(TrajectoryCache, FindsInsertedProfiles) {
+  TrajectoryCache cache(4, 100);
+  std::vector<TrajectoryCache::Sample> samples = makeSamples(5, 1.0);
+
+  EXPECT_TRUE(cache.find(makeKey(cache, 1.0)).empty());
+  expectProfile(samples, cache.insert(makeKey(cache, 1.0), samples));
+
+  TrajectoryCache::Profile profile = cache.find(makeKey(cache, 1.0));
+  expectProfile(samples, profile);
+  EXPECT_EQ(Duration(4), profile.duration());
+  EXPECT_EQ(samples[2], profile.at(Duration(2)));
+  EXPECT_EQ(samples[4], profile.at(Duration(100)));
+  EXPECT_TRUE(cache.find(makeKey(cache, 2.0)).empty());
+
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(5u, cache.sampleCount());
+  EXPECT_EQ(1u, cache.statistics().hits);
+  EXPECT_EQ(2u, cache.statistics().misses);
+  EXPECT_EQ(1u, cache.statistics().insertions);
+  EXPECT_DOUBLE_EQ(1.0 / 3.0, cache.statistics().hitRate());
+
+  cache.resetStatistics();
+  EXPECT_EQ(0u, cache.statistics().hits);
+  EXPECT_EQ(0.0, cache.statistics().hitRate());
+}
+
+TEST(TrajectoryCache, ReplacesProfiles) {
+  TrajectoryCache cache(4, 100);
+  cache.insert(makeKey(cache, 1.0), makeSamples(5, 1.0));
+  cache.insert(makeKey(cache, 1.0), makeSamples(3, 2.0));
+
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(3u, cache.sampleCount());
+  expectProfile(makeSamples(3, 2.0), cache.find(makeKey(cache, 1.0)));
+  EXPECT_EQ(0u, cache.statistics().evictions);
+}
+
+TEST(TrajectoryCache, EvictsLeastRecentlyUsedProfiles) {
+  TrajectoryCache cache(3, 100);
+  cache.insert(makeKey(cache, 1.0), makeSamples(5, 1.0));
+  cache.insert(makeKey(cache, 2.0), makeSamples(5, 2.0));
+  cache.insert(makeKey(cache, 3.0), makeSamples(5, 3.0));
+  cache.find(makeKey(cache, 1.0));
+
+  cache.insert(makeKey(cache, 4.0), makeSamples(5, 4.0));
+
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_EQ(1u, cache.statistics().evictions);
+  EXPECT_FALSE(cache.find(makeKey(cache, 1.0)).empty());
+  EXPECT_TRUE(cache.find(makeKey(cache, 2.0)).empty());
+  EXPECT_FALSE(cache.find(makeKey(cache, 3.0)).empty());
+  EXPECT_FALSE(cache.find(makeKey(cache, 4.0)).empty());
+}
+
+TEST(TrajectoryCache, CompactsSamples) {
+  TrajectoryCache cache(10, 20);
+  cache.insert(makeKey(cache, 1.0), makeSamples(6, 1.0));
+  cache.insert(makeKey(cache, 2.0), makeSamples(6, 2.0));
+  cache.insert(makeKey(cache, 3.0), makeSamples(6, 3.0));
+  cache.find(makeKey(cache, 1.0));
+  cache.find(makeKey(cache, 3.0));
+
+  // Evicts the profile in the middle of the arena and moves the last one to close the gap.
+  cache.insert(makeKey(cache, 4.0), makeSamples(8, 4.0));
+
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_EQ(20u, cache.sampleCount());
+  EXPECT_EQ(1u, cache.statistics().evictions);
+  expectProfile(makeSamples(6, 1.0), cache.find(makeKey(cache, 1.0)));
+  EXPECT_TRUE(cache.find(makeKey(cache, 2.0)).empty());
+  expectProfile(makeSamples(6, 3.0), cache.find(makeKey(cache, 3.0)));
+  expectProfile(makeSamples(8, 4.0), cache.find(makeKey(cache, 4.0)));
+
+  cache.insert(makeKey(cache, 5.0), makeSamples(20, 5.0));
+  EXPECT_EQ(1u, cache.size());
+  expectProfile(makeSamples(20, 5.0), cache.find(makeKey(cache, 5.0)));
+}
+
+TEST(TrajectoryCache, CanSaveAndLoad) {
+  TrajectoryCache cache(3, 100);
+  cache.insert(makeKey(cache, 1.0), makeSamples(5, 1.0));
+  cache.insert(makeKey(cache, 2.0), makeSamples(7, 2.0));
+  cache.insert(makeKey(cache, 3.0), makeSamples(9, 3.0));
+  cache.find(makeKey(cache, 1.0));
+
+  std::stringstream stream;
+  cache.save(stream);
+
+  TrajectoryCache loaded(3, 100);
+  loaded.load(stream);
+  EXPECT_EQ(3u, loaded.size());
+  EXPECT_EQ(21u, loaded.sampleCount());
+  EXPECT_EQ(0u, loaded.statistics().insertions);
+
+  // The order of use is restored.
+  loaded.insert(makeKey(loaded, 4.0), makeSamples(1, 4.0));
+  EXPECT_TRUE(loaded.find(makeKey(loaded, 2.0)).empty());
+  expectProfile(makeSamples(5, 1.0), loaded.find(makeKey(loaded, 1.0)));
+  expectProfile(makeSamples(9, 3.0), loaded.find(makeKey(loaded, 3.0)));
+}
+
+TEST(TrajectoryCache, ThrowsOnInvalidFiles) {
+  TrajectoryCache cache(3, 100);
+  cache.insert(makeKey(cache, 1.0), makeSamples(5, 1.0));
+  std::stringstream stream;
+  cache.save(stream);
+  std::string data = stream.str();
+
+  std::istringstream truncated(data.substr(0, data.size() - 1));
+  EXPECT_THROW(cache.load(truncated), LogFileException);
+  EXPECT_EQ(0u, cache.size());
+
+  std::istringstream invalid("invalid");
+  EXPECT_THROW(cache.load(invalid), LogFileException);
+
+  std::istringstream other_resolution(data);
+  TrajectoryCache coarse_cache(3, 100, 1e-2);
+  EXPECT_THROW(coarse_cache.load(other_resolution), LogFileException);
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/virtual_wall_shield.h>
+
+using namespace franka;
+
+namespace {
+
+// Cuboid of 1 x 2 x 3 m centered at (1, 0, 0.5) and rotated by 90 degrees around the z axis, so
+// that its x axis points along the y axis of the base frame.
+VirtualWallCuboid rotatedWall() {
+  return VirtualWallCuboid{
+      1, {{1.0, 2.0, 3.0}}, {{0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 1, 0, 1.0, 0.0, 0.5, 1}}, true};
+}
+
+}  // anonymous namespace
+
+TEST(VirtualWallShield, CalculatesDistanceToNearestFace) {
+  VirtualWallShield shield({rotatedWall()});
+  EXPECT_DOUBLE_EQ(0.5, shield.distance({{1.0, 0.0, 0.5}}));
+  EXPECT_DOUBLE_EQ(0.1, shield.distance({{1.0, 0.4, 0.5}}));
+  EXPECT_DOUBLE_EQ(0.2, shield.distance({{1.8, 0.0, 0.5}}));
+  EXPECT_DOUBLE_EQ(-0.5, shield.distance({{1.0, 1.0, 0.5}}));
+}
+
+TEST(VirtualWallShield, IgnoresInactiveWalls) {
+  VirtualWallCuboid wall = rotatedWall();
+  wall.active = false;
+  VirtualWallShield shield({wall});
+  EXPECT_TRUE(std::isinf(shield.distance({{10.0, 10.0, 10.0}})));
+  std::array<double, 3> velocity{{1.0, 2.0, 3.0}};
+  EXPECT_EQ(velocity, shield.limitVelocity({{10.0, 10.0, 10.0}}, velocity, 1e-3));
+}
+
+TEST(VirtualWallShield, DeceleratesTowardsFaces) {
+  VirtualWallShieldParameters parameters;
+  parameters.margin = 0.1;
+  parameters.deceleration = 2.0;
+  VirtualWallShield shield({rotatedWall()}, parameters);
+
+  // The wall face along the base y axis is at 0.5 m, i.e. 0.2 m in front of the margin.
+  std::array<double, 3> limited = shield.limitVelocity({{1.0, 0.2, 0.5}}, {{0.3, 5.0, 0.0}}, 1e-3);
+  EXPECT_DOUBLE_EQ(0.3, limited[0]);
+  EXPECT_NEAR(std::sqrt(2.0 * 2.0 * 0.2), limited[1], 1e-12);
+  EXPECT_DOUBLE_EQ(0.0, limited[2]);
+
+  // Moving away from the face is only limited by the opposite face 0.6 m in front of the margin.
+  limited = shield.limitVelocity({{1.0, 0.2, 0.5}}, {{0.0, -1.0, 0.0}}, 1e-3);
+  EXPECT_DOUBLE_EQ(-1.0, limited[1]);
+  limited = shield.limitVelocity({{1.0, 0.2, 0.5}}, {{0.0, -5.0, 0.0}}, 1e-3);
+  EXPECT_NEAR(-std::sqrt(2.0 * 2.0 * 0.6), limited[1], 1e-12);
+
+  // Within the margin, motions towards the face are stopped.
+  limited = shield.limitVelocity({{1.0, 0.45, 0.5}}, {{0.0, 0.1, 0.0}}, 1e-3);
+  EXPECT_DOUBLE_EQ(0.0, limited[1]);
+}
+
+TEST(VirtualWallShield, StopsAtMargin) {
+  VirtualWallShield shield({rotatedWall()});
+  std::array<double, 16> pose{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 1.0, 0.0, 0.5, 1}};
+  for (int i = 0; i < 5000; i++) {
+    std::array<double, 16> command = pose;
+    command[13] += 1e-3;
+    pose = shield.limitPose(command, pose, 1e-3);
+  }
+  EXPECT_NEAR(0.48, pose[13], 1e-6);
+  EXPECT_LE(pose[13], 0.48);
+}
+
+TEST(VirtualWallShield, KeepsOrientationAndRotationalVelocity) {
+  VirtualWallShield shield({rotatedWall()});
+  std::array<double, 16> pose{{0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 1, 0, 1.0, 0.48, 0.5, 1}};
+  std::array<double, 16> command = pose;
+  command[13] = 0.6;
+  std::array<double, 16> limited = shield.limitPose(command, pose, 1e-3);
+  for (size_t i = 0; i < 12; i++) {
+    EXPECT_EQ(command[i], limited[i]);
+  }
+  EXPECT_DOUBLE_EQ(0.48, limited[13]);
+
+  std::array<double, 6> twist = shield.limitTwist({{0, 1, 0, 1, 2, 3}}, pose, 1e-3);
+  EXPECT_EQ((std::array<double, 6>{{0, 0, 0, 1, 2, 3}}), twist);
+}
+
+TEST(VirtualWallShield, ThrowsOnInvalidParameters) {
+  VirtualWallShieldParameters parameters;
+  parameters.margin = -0.1;
+  EXPECT_THROW(VirtualWallShield({rotatedWall()}, parameters), std::invalid_argument);
+  parameters = VirtualWallShieldParameters();
+  parameters.deceleration = 0.0;
+  EXPECT_THROW(VirtualWallShield({rotatedWall()}, parameters), std::invalid_argument);
+  VirtualWallCuboid wall = rotatedWall();
+  wall.object_world_size[2] = 0.0;
+  EXPECT_THROW(VirtualWallShield({wall}), std::invalid_argument);
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <franka/worker_pool.h>
+
+using franka::RealtimeConfig;
+using franka::WorkerPool;
+
+TEST(WorkerPool, RunsEveryTaskOnce) {
+  WorkerPool pool(3, {}, RealtimeConfig::kIgnore);
+  EXPECT_EQ(3u, pool.workerCount());
+
+  std::vector<std::atomic<int>> counters(100);
+  std::vector<WorkerPool::Task> tasks;
+  for (std::atomic<int>& counter : counters) {
+    counter = 0;
+    tasks.emplace_back([&counter] { counter++; });
+  }
+
+  for (int run = 1; run <= 200; run++) {
+    pool.run(tasks);
+    for (const std::atomic<int>& counter : counters) {
+      ASSERT_EQ(run, counter.load());
+    }
+  }
+}
+
+TEST(WorkerPool, RunsTasksOnSeveralThreads) {
+  WorkerPool pool(1, {}, RealtimeConfig::kIgnore);
+
+  // While one thread sleeps in a task, the other one takes the remaining task.
+  std::vector<std::thread::id> thread_ids(2);
+  std::vector<WorkerPool::Task> tasks;
+  for (size_t i = 0; i < 2; i++) {
+    tasks.emplace_back([&, i] {
+      thread_ids[i] = std::this_thread::get_id();
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+  }
+
+  pool.run(tasks);
+  EXPECT_NE(thread_ids[0], thread_ids[1]);
+}
+
+TEST(WorkerPool, RunsTasksWithoutWorkers) {
+  WorkerPool pool(0, {}, RealtimeConfig::kIgnore);
+
+  std::thread::id thread_id;
+  pool.run({[&] { thread_id = std::this_thread::get_id(); }});
+  EXPECT_EQ(std::this_thread::get_id(), thread_id);
+}
+
+TEST(WorkerPool, RethrowsExceptionsAfterAllTasksAreDone) {
+  WorkerPool pool(2, {}, RealtimeConfig::kIgnore);
+
+  std::atomic<int> counter{0};
+  std::vector<WorkerPool::Task> tasks(8, [&] { counter++; });
+  tasks[3] = [] { throw std::domain_error(""); };
+
+  EXPECT_THROW(pool.run(tasks), std::domain_error);
+  EXPECT_EQ(7, counter);
+
+  EXPECT_NO_THROW(pool.run({[&] { counter++; }}));
+  EXPECT_EQ(8, counter);
+}
+
+TEST(WorkerPool, SpinsWhenPinned) {
+  // A spinning worker must not share its CPU with the calling thread.
+  const int cpu_count = static_cast<int>(std::thread::hardware_concurrency());
+  if (cpu_count < 2) {
+    return;
+  }
+  WorkerPool pool(1, {cpu_count - 1}, RealtimeConfig::kIgnore);
+
+  std::atomic<int> counter{0};
+  std::vector<WorkerPool::Task> tasks(4, [&] { counter++; });
+
+  pool.setSpinning(true);
+  for (int i = 0; i < 100; i++) {
+    pool.run(tasks);
+  }
+  pool.setSpinning(false);
+  pool.run(tasks);
+
+  EXPECT_EQ(404, counter);
+}
+
+TEST(WorkerPool, ChecksCpus) {
+  EXPECT_THROW(WorkerPool(2, {0}, RealtimeConfig::kIgnore), std::invalid_argument);
+  EXPECT_THROW(WorkerPool(1, {-1}, RealtimeConfig::kIgnore), std::invalid_argument);
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+#include <franka/control_math.h>
+
+// Compares the kernels of control_math.h with the equivalent Eigen code. Prints the mean time
+// per call of each kernel. Runs without a robot.
+
+namespace {
+
+// Keeps the compiler from optimizing away the benchmarked calls.
+volatile double sink;
+
+template <size_t N>
+double sum(const std::array<double, N>& values) {
+  return std::accumulate(values.cbegin(), values.cend(), 0.0);
+}
+
+template <typename TFunction>
+void measure(const std::string& name, size_t iterations, TFunction function) {
+  auto start = std::chrono::steady_clock::now();
+  double sum = 0.0;
+  for (size_t i = 0; i < iterations; i++) {
+    sum += function(i);
+  }
+  auto duration = std::chrono::steady_clock::now() - start;
+  sink = sum;
+  std::cout << std::setw(40) << std::left << name << std::setw(10) << std::right
+            << std::chrono::duration<double, std::nano>(duration).count() / iterations << " ns"
+            << std::endl;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [<iterations>]" << std::endl;
+    return -1;
+  }
+  const size_t iterations = argc == 2 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  if (iterations == 0) {
+    std::cerr << "Invalid number of iterations " << argv[1] << std::endl;
+    return -1;
+  }
+
+  Eigen::Matrix<double, 7, 7> random = Eigen::Matrix<double, 7, 7>::Random();
+  std::array<double, 49> mass;
+  Eigen::Map<Eigen::Matrix<double, 7, 7>> mass_matrix(mass.data());
+  mass_matrix = random * random.transpose() + Eigen::Matrix<double, 7, 7>::Identity();
+
+  std::array<double, 42> jacobian;
+  Eigen::Map<Eigen::Matrix<double, 6, 7>> jacobian_matrix(jacobian.data());
+  jacobian_matrix = Eigen::Matrix<double, 6, 7>::Random();
+
+  std::array<double, 7> b;
+  Eigen::Map<Eigen::Matrix<double, 7, 1>> b_vector(b.data());
+  b_vector = Eigen::Matrix<double, 7, 1>::Random();
+
+  std::array<double, 16> pose;
+  std::array<double, 16> desired_pose;
+  Eigen::Map<Eigen::Matrix4d> pose_matrix(pose.data());
+  Eigen::Map<Eigen::Matrix4d> desired_pose_matrix(desired_pose.data());
+  Eigen::Affine3d transform(Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized());
+  transform.pretranslate(Eigen::Vector3d::Random());
+  pose_matrix = transform.matrix();
+  transform.rotate(Eigen::AngleAxisd(0.1, Eigen::Vector3d::UnitX()));
+  desired_pose_matrix = transform.matrix();
+
+  // The inputs are changed slightly in each iteration, so that results cannot be reused.
+  auto perturb = [](size_t i) { return 1e-12 * static_cast<double>(i % 7); };
+
+  std::cout << iterations << " iterations" << std::endl;
+
+  measure("7x7 LDLT solve", iterations, [&](size_t i) {
+    mass[0] += perturb(i);
+    return sum(franka::JointMatrixLDLT(mass).solve(b));
+  });
+  measure("7x7 LDLT solve (Eigen)", iterations, [&](size_t i) {
+    mass[0] += perturb(i);
+    return mass_matrix.ldlt().solve(b_vector).sum();
+  });
+
+  std::array<double, 36> inertia;
+  measure("6x7 J M^-1 J^T", iterations, [&](size_t i) {
+    mass[0] += perturb(i);
+    franka::inverseCartesianInertia(jacobian, mass, &inertia);
+    return sum(inertia);
+  });
+  measure("6x7 J M^-1 J^T (Eigen)", iterations, [&](size_t i) {
+    mass[0] += perturb(i);
+    Eigen::Matrix<double, 6, 6> result =
+        jacobian_matrix * mass_matrix.ldlt().solve(jacobian_matrix.transpose());
+    return result.sum();
+  });
+
+  measure("4x4 transform multiply", iterations, [&](size_t i) {
+    pose[12] += perturb(i);
+    return sum(franka::multiplyTransforms(pose, desired_pose));
+  });
+  measure("4x4 transform multiply (Eigen)", iterations, [&](size_t i) {
+    pose[12] += perturb(i);
+    Eigen::Matrix4d result = pose_matrix * desired_pose_matrix;
+    return result.sum();
+  });
+
+  measure("4x4 transform inverse", iterations, [&](size_t i) {
+    pose[12] += perturb(i);
+    return sum(franka::invertTransform(pose));
+  });
+  measure("4x4 transform inverse (Eigen)", iterations, [&](size_t i) {
+    pose[12] += perturb(i);
+    Eigen::Affine3d inverse = Eigen::Affine3d(pose_matrix).inverse(Eigen::Isometry);
+    return inverse.matrix().sum();
+  });
+
+  measure("Quaternion error", iterations, [&](size_t i) {
+    pose[0] += perturb(i);
+    return sum(franka::orientationError(pose, desired_pose));
+  });
+  measure("Quaternion error (Eigen)", iterations, [&](size_t i) {
+    pose[0] += perturb(i);
+    Eigen::Quaterniond orientation(Eigen::Matrix3d(pose_matrix.topLeftCorner<3, 3>()));
+    Eigen::Quaterniond desired_orientation(
+        Eigen::Matrix3d(desired_pose_matrix.topLeftCorner<3, 3>()));
+    if (desired_orientation.coeffs().dot(orientation.coeffs()) < 0.0) {
+      orientation.coeffs() = -orientation.coeffs();
+    }
+    return (orientation * desired_orientation.inverse()).vec().sum();
+  });
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <franka/exception.h>
+#include <franka/robot.h>
+#include <franka/robot_daemon.h>
+
+// Holds the connection to a robot and shares it with local processes using franka::DaemonClient.
+// Stop with Ctrl+C.
+
+namespace {
+
+std::atomic<bool> running{true};
+
+void stop(int /* signal */) {
+  running = false;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <robot-hostname> [<socket-path> [<command-timeout-microseconds>]]" << std::endl;
+    return -1;
+  }
+  std::string socket_path = argc >= 3 ? argv[2] : franka::kDefaultDaemonSocketPath;
+  std::chrono::microseconds command_timeout =
+      argc == 4 ? std::chrono::microseconds(std::strtol(argv[3], nullptr, 10))
+                : franka::kDefaultDaemonCommandTimeout;
+
+  try {
+    franka::Robot robot(argv[1]);
+    franka::RobotDaemon daemon(robot, socket_path, franka::kDefaultDaemonSharedMemoryName,
+                               command_timeout);
+
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+
+    std::cout << "Serving " << argv[1] << " on " << socket_path << std::endl;
+    daemon.run(running);
+  } catch (const franka::Exception& e) {
+    std::cerr << "franka_daemon: " << e.what() << std::endl;
+    return -1;
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "franka_daemon: " << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
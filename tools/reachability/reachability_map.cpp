@@ -0,0 +1,83 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <franka/exception.h>
+#include <franka/reachability_map.h>
+
+// Generates a reachability map of the flange with the default workspace and orientation bins on
+// all cores, or queries the reachability and manipulability of a position in a map file. Runs
+// without a robot.
+
+namespace {
+
+void printUsage(const char* name) {
+  std::cerr << "Usage: " << name << " generate <map-file> [<resolution> [<threads>]]" << std::endl
+            << "       " << name << " query <map-file> <x> <y> <z>" << std::endl;
+}
+
+int generate(const std::string& path, int argc, char** argv) {
+  franka::ReachabilityMapParameters parameters;
+  size_t threads = 0;
+  if (argc > 3) {
+    parameters.resolution = std::strtod(argv[3], nullptr);
+  }
+  if (argc > 4) {
+    threads = std::strtoul(argv[4], nullptr, 10);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  franka::ReachabilityMap map = franka::ReachabilityMap::generate(parameters, threads);
+  map.save(path);
+  double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  franka::ReachabilityMapParameters result = map.parameters();
+  std::cout << "Generated " << path << " in " << duration << " s" << std::endl
+            << "Workspace: [" << result.workspace_minimum[0] << ", "
+            << result.workspace_maximum[0] << "] x [" << result.workspace_minimum[1] << ", "
+            << result.workspace_maximum[1] << "] x [" << result.workspace_minimum[2] << ", "
+            << result.workspace_maximum[2] << "] m, resolution " << result.resolution << " m"
+            << std::endl
+            << "Maximum manipulability: " << map.maximumManipulability() << std::endl;
+  return 0;
+}
+
+int query(const std::string& path, char** argv) {
+  franka::ReachabilityMap map(path);
+  std::array<double, 3> position{{std::strtod(argv[3], nullptr), std::strtod(argv[4], nullptr),
+                                  std::strtod(argv[5], nullptr)}};
+  std::cout << "Reachability: " << map.reachability(position) << std::endl
+            << "Manipulability: " << map.manipulability(position) << std::endl;
+  return 0;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    printUsage(argv[0]);
+    return -1;
+  }
+  std::string command = argv[1];
+  try {
+    if (command == "generate" && argc <= 5) {
+      return generate(argv[2], argc, argv);
+    }
+    if (command == "query" && argc == 6) {
+      return query(argv[2], argv);
+    }
+  } catch (const franka::Exception& e) {
+    std::cerr << "reachability_map: " << e.what() << std::endl;
+    return -1;
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "reachability_map: " << e.what() << std::endl;
+    return -1;
+  }
+  printUsage(argv[0]);
+  return -1;
+}
@@ -0,0 +1,54 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "command_log.h"
+
+#include <array>
+
+namespace franka {
+namespace stand_in {
+
+namespace {
+
+template <size_t N>
+void writeArray(std::ostream& output, const std::array<double, N>& array) {
+  for (double value : array) {
+    output << ' ' << value;
+  }
+}
+
+}  // anonymous namespace
+
+CommandLog::CommandLog(std::ostream* output)
+    : output_(output), start_(std::chrono::steady_clock::now()) {}
+
+int64_t CommandLog::now() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                               start_)
+      .count();
+}
+
+void CommandLog::request(const char* device, const std::string& command, uint32_t command_id) {
+  if (output_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> _(mutex_);
+  *output_ << now() << ' ' << device << " request " << command << ' ' << command_id << '\n';
+}
+
+void CommandLog::robotCommand(const research_interface::robot::RobotCommand& command) {
+  if (output_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> _(mutex_);
+  *output_ << now() << " robot command " << command.message_id << ' '
+           << command.motion.motion_generation_finished;
+  writeArray(*output_, command.motion.q_c);
+  writeArray(*output_, command.motion.dq_c);
+  writeArray(*output_, command.motion.O_T_EE_c);
+  writeArray(*output_, command.motion.O_dP_EE_c);
+  writeArray(*output_, command.control.tau_J_d);
+  *output_ << '\n';
+}
+
+}  // namespace stand_in
+}  // namespace franka
@@ -0,0 +1,38 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include <research_interface/robot/rbk_types.h>
+
+namespace franka {
+namespace stand_in {
+
+// Records everything clients send, one whitespace-separated line per message:
+//
+//   <time-us> <device> request <command> <command-id>
+//   <time-us> robot command <message-id> <finished> <q_c> <dq_c> <O_T_EE_c> <O_dP_EE_c> <tau_J_d>
+//
+// Times are relative to the construction of the log. Safe to use from several threads.
+class CommandLog {
+ public:
+  explicit CommandLog(std::ostream* output);
+
+  void request(const char* device, const std::string& command, uint32_t command_id);
+  void robotCommand(const research_interface::robot::RobotCommand& command);
+
+ private:
+  int64_t now() const;
+
+  std::mutex mutex_;
+  std::ostream* output_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace stand_in
+}  // namespace franka
@@ -0,0 +1,90 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include <atomic>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <Poco/Exception.h>
+
+#include "command_log.h"
+#include "gripper_server.h"
+#include "robot_server.h"
+#include "scenario.h"
+
+// Stand-in for the robot and gripper services of the Franka Control Interface. Serves libfranka
+// clients on localhost according to a scenario file, see scenario.h for the format and the
+// scenarios directory for examples. Stop with Ctrl+C.
+
+namespace {
+
+std::atomic<bool> running{true};
+
+void stop(int /* signal */) {
+  running = false;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <scenario-file> [<command-log-file>]" << std::endl;
+    return -1;
+  }
+
+  constexpr const char* kAddress = "127.0.0.1";
+
+  try {
+    std::ifstream scenario_file(argv[1]);
+    if (!scenario_file) {
+      std::cerr << "Could not open " << argv[1] << std::endl;
+      return -1;
+    }
+    franka::stand_in::Scenario scenario = franka::stand_in::parseScenario(scenario_file);
+
+    std::unique_ptr<std::ofstream> log_file;
+    if (argc == 3) {
+      log_file.reset(new std::ofstream(argv[2]));
+      if (!*log_file) {
+        std::cerr << "Could not open " << argv[2] << std::endl;
+        return -1;
+      }
+    }
+    franka::stand_in::CommandLog log(log_file.get());
+
+    franka::stand_in::RobotServer robot_server(scenario, &log);
+    franka::stand_in::GripperServer gripper_server(scenario, &log);
+
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+
+    std::thread gripper_thread;
+    if (scenario.gripper) {
+      gripper_thread = std::thread([&] {
+        try {
+          gripper_server.run(kAddress, running);
+        } catch (const Poco::Exception& e) {
+          std::cerr << "fci_stand_in: gripper: " << e.displayText() << std::endl;
+          running = false;
+        }
+      });
+    }
+    std::cout << "Serving " << argv[1] << " on " << kAddress << std::endl;
+    try {
+      robot_server.run(kAddress, running);
+    } catch (const Poco::Exception& e) {
+      std::cerr << "fci_stand_in: robot: " << e.displayText() << std::endl;
+      running = false;
+    }
+    if (gripper_thread.joinable()) {
+      gripper_thread.join();
+    }
+  } catch (const franka::stand_in::ScenarioException& e) {
+    std::cerr << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
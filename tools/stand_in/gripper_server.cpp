@@ -0,0 +1,162 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "gripper_server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <thread>
+
+#include <Poco/Net/DatagramSocket.h>
+#include <Poco/Net/ServerSocket.h>
+
+namespace franka {
+namespace stand_in {
+
+namespace {
+
+using research_interface::gripper::Connect;
+using research_interface::gripper::Grasp;
+using research_interface::gripper::Homing;
+using research_interface::gripper::Move;
+using research_interface::gripper::Stop;
+
+constexpr const char* kCommandNames[] = {"gripper.Connect", "gripper.Homing", "gripper.Grasp",
+                                         "gripper.Move", "gripper.Stop"};
+
+}  // anonymous namespace
+
+GripperServer::GripperServer(const Scenario& scenario, CommandLog* log)
+    : scenario_(scenario), log_(log) {
+  for (const auto& response : scenario_.responses) {
+    if (isGripperCommand(response.first) &&
+        std::find(std::begin(kCommandNames), std::end(kCommandNames), response.first) ==
+            std::end(kCommandNames)) {
+      throw ScenarioException("fci_stand_in: unknown gripper command " + response.first);
+    }
+  }
+
+  // Resolve all statuses once, so that typos are reported before a client connects.
+  responseStatus<Connect>(scenario_, "gripper.Connect");
+  responseStatus<Homing>(scenario_, "gripper.Homing");
+  responseStatus<Grasp>(scenario_, "gripper.Grasp");
+  responseStatus<Move>(scenario_, "gripper.Move");
+  responseStatus<Stop>(scenario_, "gripper.Stop");
+}
+
+void GripperServer::run(const std::string& address, const std::atomic<bool>& running) {
+  Poco::Net::ServerSocket server;
+  server.bind({address, research_interface::gripper::kCommandPort}, true);
+  server.listen();
+
+  while (running) {
+    if (!server.poll(Poco::Timespan(0, 100000), Poco::Net::Socket::SELECT_READ)) {
+      continue;
+    }
+    Poco::Net::SocketAddress remote_address;
+    Poco::Net::StreamSocket tcp_socket = server.acceptConnection(remote_address);
+    tcp_socket.setBlocking(true);
+    tcp_socket.setNoDelay(true);
+    std::cout << "Gripper client connected from " << remote_address.toString() << std::endl;
+    try {
+      serve(tcp_socket, remote_address, running);
+    } catch (const Poco::Exception& e) {
+      std::cerr << "fci_stand_in: gripper connection: " << e.displayText() << std::endl;
+    } catch (const ScenarioException& e) {
+      std::cerr << e.what() << std::endl;
+    }
+    std::cout << "Gripper client disconnected" << std::endl;
+  }
+}
+
+void GripperServer::serve(Poco::Net::StreamSocket& tcp_socket,
+                          const Poco::Net::SocketAddress& remote_address,
+                          const std::atomic<bool>& running) {
+  RawMessage<Header> message;
+  if (!receiveMessage(tcp_socket, &message)) {
+    return;
+  }
+  if (message.header.command != Connect::kCommand) {
+    throw ScenarioException("fci_stand_in: expected Connect as first gripper command");
+  }
+  Connect::Request connect_request = message.request<Connect>();
+  log_->request("gripper", "Connect", message.header.command_id);
+  Connect::Status connect_status = responseStatus<Connect>(scenario_, "gripper.Connect");
+  sendResponse<Connect>(tcp_socket, message.header.command_id, Connect::Response(connect_status));
+  if (connect_status != Connect::Status::kSuccess) {
+    return;
+  }
+
+  Poco::Net::DatagramSocket udp_socket({tcp_socket.address().host(), 0});
+  Poco::Net::SocketAddress client_address(remote_address.host(), connect_request.udp_port);
+
+  state_ = research_interface::gripper::GripperState{};
+  state_.width = scenario_.gripper_max_width;
+  state_.max_width = scenario_.gripper_max_width;
+  state_.temperature = 30;
+
+  auto next_cycle = std::chrono::steady_clock::now();
+  while (running) {
+    while (tcp_socket.poll(Poco::Timespan(0), Poco::Net::Socket::SELECT_READ)) {
+      if (!receiveMessage(tcp_socket, &message)) {
+        return;
+      }
+      handleRequest(tcp_socket, message);
+    }
+
+    state_.message_id++;
+    udp_socket.sendTo(&state_, sizeof(state_), client_address);
+
+    next_cycle += scenario_.gripper_period;
+    std::this_thread::sleep_until(next_cycle);
+  }
+}
+
+template <typename T>
+bool GripperServer::respond(Poco::Net::StreamSocket& tcp_socket,
+                            uint32_t command_id,
+                            const char* name) {
+  log_->request("gripper", name + sizeof(kGripperPrefix) - 1, command_id);
+  typename T::Status status = responseStatus<T>(scenario_, name);
+  sendResponse<T>(tcp_socket, command_id, typename T::Response(status));
+  return status == T::Status::kSuccess;
+}
+
+void GripperServer::handleRequest(Poco::Net::StreamSocket& tcp_socket,
+                                  const RawMessage<Header>& message) {
+  uint32_t command_id = message.header.command_id;
+  switch (message.header.command) {
+    case Homing::kCommand:
+      if (respond<Homing>(tcp_socket, command_id, "gripper.Homing")) {
+        state_.width = state_.max_width;
+        state_.is_grasped = false;
+      }
+      break;
+    case Grasp::kCommand: {
+      Grasp::Request request = message.request<Grasp>();
+      if (respond<Grasp>(tcp_socket, command_id, "gripper.Grasp")) {
+        state_.width = request.width;
+        state_.is_grasped = true;
+      }
+      break;
+    }
+    case Move::kCommand: {
+      Move::Request request = message.request<Move>();
+      if (respond<Move>(tcp_socket, command_id, "gripper.Move")) {
+        state_.width = std::min(request.width, state_.max_width);
+        state_.is_grasped = false;
+      }
+      break;
+    }
+    case Stop::kCommand:
+      respond<Stop>(tcp_socket, command_id, "gripper.Stop");
+      break;
+    default:
+      throw ScenarioException("fci_stand_in: unsupported gripper command " +
+                              std::to_string(static_cast<uint32_t>(message.header.command)));
+  }
+}
+
+}  // namespace stand_in
+}  // namespace franka
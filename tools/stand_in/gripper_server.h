@@ -0,0 +1,46 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include <Poco/Net/StreamSocket.h>
+#include <research_interface/gripper/types.h>
+
+#include "command_log.h"
+#include "protocol.h"
+#include "scenario.h"
+
+namespace franka {
+namespace stand_in {
+
+// Serves one gripper client at a time on the gripper command port.
+//
+// Successful motions complete immediately: moving and grasping set the commanded width, homing
+// opens the gripper to its maximum width.
+class GripperServer {
+ public:
+  GripperServer(const Scenario& scenario, CommandLog* log);
+
+  // Accepts and serves clients until running becomes false.
+  void run(const std::string& address, const std::atomic<bool>& running);
+
+ private:
+  using Header = research_interface::gripper::CommandHeader;
+
+  void serve(Poco::Net::StreamSocket& tcp_socket,
+             const Poco::Net::SocketAddress& remote_address,
+             const std::atomic<bool>& running);
+  void handleRequest(Poco::Net::StreamSocket& tcp_socket, const RawMessage<Header>& message);
+
+  template <typename T>
+  bool respond(Poco::Net::StreamSocket& tcp_socket, uint32_t command_id, const char* name);
+
+  const Scenario& scenario_;
+  CommandLog* log_;
+  research_interface::gripper::GripperState state_{};
+};
+
+}  // namespace stand_in
+}  // namespace franka
@@ -0,0 +1,21 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "protocol.h"
+
+namespace franka {
+namespace stand_in {
+
+void receiveBytes(Poco::Net::StreamSocket& socket, void* data, size_t size) {
+  uint8_t* bytes = static_cast<uint8_t*>(data);
+  while (size > 0) {
+    int received = socket.receiveBytes(bytes, static_cast<int>(size));
+    if (received <= 0) {
+      throw ScenarioException("fci_stand_in: client closed connection during a message");
+    }
+    bytes += received;
+    size -= static_cast<size_t>(received);
+  }
+}
+
+}  // namespace stand_in
+}  // namespace franka
@@ -0,0 +1,197 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <Poco/Net/StreamSocket.h>
+#include <research_interface/gripper/types.h>
+#include <research_interface/robot/service_types.h>
+
+#include "scenario.h"
+
+namespace franka {
+namespace stand_in {
+
+// Prefix of gripper command names in scenario files.
+constexpr const char kGripperPrefix[] = "gripper.";
+
+inline bool isGripperCommand(const std::string& name) {
+  return name.compare(0, sizeof(kGripperPrefix) - 1, kGripperPrefix) == 0;
+}
+
+// Names of the commands and their response statuses, as used in scenario files.
+template <typename T, typename Enable = void>
+struct CommandNames;
+
+template <typename T>
+using StatusNames = std::map<std::string, typename T::Status>;
+
+template <typename T>
+using IsGetterSetter =
+    std::is_base_of<research_interface::robot::GetterSetterCommandBase<T, T::kCommand>, T>;
+
+template <typename T>
+struct CommandNames<T, std::enable_if_t<IsGetterSetter<T>::value>> {
+  static StatusNames<T> statuses() {
+    return {{"success", T::Status::kSuccess},
+            {"command_not_possible_rejected", T::Status::kCommandNotPossibleRejected},
+            {"invalid_argument_rejected", T::Status::kInvalidArgumentRejected}};
+  }
+};
+
+template <>
+struct CommandNames<research_interface::robot::Connect> {
+  static StatusNames<research_interface::robot::Connect> statuses() {
+    using Status = research_interface::robot::Connect::Status;
+    return {{"success", Status::kSuccess},
+            {"incompatible_library_version", Status::kIncompatibleLibraryVersion}};
+  }
+};
+
+template <>
+struct CommandNames<research_interface::robot::Move> {
+  static StatusNames<research_interface::robot::Move> statuses() {
+    using Status = research_interface::robot::Move::Status;
+    return {{"success", Status::kSuccess},
+            {"preempted", Status::kPreempted},
+            {"command_not_possible_rejected", Status::kCommandNotPossibleRejected},
+            {"start_at_singular_pose_rejected", Status::kStartAtSingularPoseRejected},
+            {"invalid_argument_rejected", Status::kInvalidArgumentRejected},
+            {"reflex_aborted", Status::kReflexAborted},
+            {"emergency_aborted", Status::kEmergencyAborted},
+            {"input_error_aborted", Status::kInputErrorAborted},
+            {"aborted", Status::kAborted}};
+  }
+};
+
+template <>
+struct CommandNames<research_interface::robot::StopMove> {
+  static StatusNames<research_interface::robot::StopMove> statuses() {
+    using Status = research_interface::robot::StopMove::Status;
+    return {{"success", Status::kSuccess},
+            {"command_not_possible_rejected", Status::kCommandNotPossibleRejected},
+            {"reflex_aborted", Status::kReflexAborted},
+            {"emergency_aborted", Status::kEmergencyAborted},
+            {"aborted", Status::kAborted}};
+  }
+};
+
+template <>
+struct CommandNames<research_interface::robot::AutomaticErrorRecovery> {
+  static StatusNames<research_interface::robot::AutomaticErrorRecovery> statuses() {
+    using Status = research_interface::robot::AutomaticErrorRecovery::Status;
+    return {{"success", Status::kSuccess},
+            {"command_not_possible_rejected", Status::kCommandNotPossibleRejected},
+            {"manual_error_recovery_required_rejected",
+             Status::kManualErrorRecoveryRequiredRejected},
+            {"reflex_aborted", Status::kReflexAborted},
+            {"emergency_aborted", Status::kEmergencyAborted},
+            {"aborted", Status::kAborted}};
+  }
+};
+
+template <>
+struct CommandNames<research_interface::robot::LoadModelLibrary> {
+  static StatusNames<research_interface::robot::LoadModelLibrary> statuses() {
+    using Status = research_interface::robot::LoadModelLibrary::Status;
+    return {{"success", Status::kSuccess}, {"error", Status::kError}};
+  }
+};
+
+template <>
+struct CommandNames<research_interface::gripper::Connect> {
+  static StatusNames<research_interface::gripper::Connect> statuses() {
+    using Status = research_interface::gripper::Connect::Status;
+    return {{"success", Status::kSuccess},
+            {"incompatible_library_version", Status::kIncompatibleLibraryVersion}};
+  }
+};
+
+template <typename T>
+struct CommandNames<
+    T,
+    std::enable_if_t<std::is_same<T, research_interface::gripper::Homing>::value ||
+                     std::is_same<T, research_interface::gripper::Grasp>::value ||
+                     std::is_same<T, research_interface::gripper::Move>::value ||
+                     std::is_same<T, research_interface::gripper::Stop>::value>> {
+  static StatusNames<T> statuses() {
+    return {{"success", T::Status::kSuccess},
+            {"fail", T::Status::kFail},
+            {"unsuccessful", T::Status::kUnsuccessful},
+            {"aborted", T::Status::kAborted}};
+  }
+};
+
+// Returns the response status for a command as configured in the scenario.
+template <typename T>
+typename T::Status responseStatus(const Scenario& scenario, const std::string& name) {
+  std::string status = scenario.responseFor(name);
+  StatusNames<T> statuses = CommandNames<T>::statuses();
+  auto it = statuses.find(status);
+  if (it == statuses.cend()) {
+    throw ScenarioException("fci_stand_in: unknown status " + status + " for " + name);
+  }
+  return it->second;
+}
+
+// A complete TCP message, starting with its header.
+template <typename Header>
+struct RawMessage {
+  Header header;
+  std::vector<uint8_t> data;
+
+  template <typename T>
+  typename T::Request request() const {
+    typename T::template Message<typename T::Request> message;
+    if (data.size() < sizeof(message)) {
+      throw ScenarioException("fci_stand_in: received truncated request");
+    }
+    std::memcpy(&message, data.data(), sizeof(message));
+    return message.getInstance();
+  }
+};
+
+void receiveBytes(Poco::Net::StreamSocket& socket, void* data, size_t size);
+
+// Blocks until a complete message has been received. Returns false if the client disconnected.
+template <typename Header>
+bool receiveMessage(Poco::Net::StreamSocket& socket, RawMessage<Header>* message) {
+  Header header;
+  if (socket.receiveBytes(&header, 1) == 0) {
+    return false;
+  }
+  receiveBytes(socket, reinterpret_cast<uint8_t*>(&header) + 1, sizeof(header) - 1);
+  if (header.size < sizeof(header)) {
+    throw ScenarioException("fci_stand_in: received message with invalid size");
+  }
+  message->header = header;
+  message->data.resize(header.size);
+  std::memcpy(message->data.data(), &header, sizeof(header));
+  receiveBytes(socket, &message->data[sizeof(header)], header.size - sizeof(header));
+  return true;
+}
+
+template <typename T>
+void sendResponse(Poco::Net::StreamSocket& socket,
+                  uint32_t command_id,
+                  const typename T::Response& response,
+                  const std::vector<uint8_t>& data = {}) {
+  using Message = typename T::template Message<typename T::Response>;
+  Message message(typename T::Header(T::kCommand, command_id,
+                                     static_cast<uint32_t>(sizeof(Message) + data.size())),
+                  response);
+  std::vector<uint8_t> buffer(sizeof(message) + data.size());
+  std::memcpy(buffer.data(), &message, sizeof(message));
+  std::copy(data.cbegin(), data.cend(), buffer.begin() + sizeof(message));
+  socket.sendBytes(buffer.data(), static_cast<int>(buffer.size()));
+}
+
+}  // namespace stand_in
+}  // namespace franka
@@ -0,0 +1,446 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "robot_server.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <Poco/Net/ServerSocket.h>
+#include <research_interface/robot/error.h>
+
+namespace franka {
+namespace stand_in {
+
+namespace {
+
+using research_interface::robot::AutomaticErrorRecovery;
+using research_interface::robot::Connect;
+using research_interface::robot::ControllerMode;
+using research_interface::robot::GetCartesianLimit;
+using research_interface::robot::LoadModelLibrary;
+using research_interface::robot::MotionGeneratorMode;
+using research_interface::robot::Move;
+using research_interface::robot::RobotMode;
+using research_interface::robot::SetCartesianImpedance;
+using research_interface::robot::SetCollisionBehavior;
+using research_interface::robot::SetEEToK;
+using research_interface::robot::SetFToEE;
+using research_interface::robot::SetFilters;
+using research_interface::robot::SetGuidingMode;
+using research_interface::robot::SetJointImpedance;
+using research_interface::robot::SetLoad;
+using research_interface::robot::StopMove;
+
+constexpr const char* kCommandNames[] = {"Connect",
+                                         "Move",
+                                         "StopMove",
+                                         "GetCartesianLimit",
+                                         "SetCollisionBehavior",
+                                         "SetJointImpedance",
+                                         "SetCartesianImpedance",
+                                         "SetGuidingMode",
+                                         "SetEEToK",
+                                         "SetFToEE",
+                                         "SetLoad",
+                                         "SetFilters",
+                                         "AutomaticErrorRecovery",
+                                         "LoadModelLibrary"};
+
+// Flange pointing downwards in front of the robot.
+constexpr std::array<double, 16> kInitialPose{
+    {1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.307, 0.0, 0.487, 1.0}};
+
+size_t errorIndex(const std::string& name) {
+  research_interface::robot::RobotState state{};
+  for (size_t i = 0; i < state.errors.size(); i++) {
+    if (name == research_interface::robot::getErrorName(
+                    static_cast<research_interface::robot::Error>(i))) {
+      return i;
+    }
+  }
+  throw ScenarioException("fci_stand_in: unknown error " + name);
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw ScenarioException("fci_stand_in: could not open model library " + path);
+  }
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file),
+                              std::istreambuf_iterator<char>());
+}
+
+}  // anonymous namespace
+
+RobotServer::RobotServer(const Scenario& scenario, CommandLog* log)
+    : scenario_(scenario), log_(log), random_engine_(std::random_device()()) {
+  for (const auto& response : scenario_.responses) {
+    if (isGripperCommand(response.first)) {
+      continue;
+    }
+    if (std::find(std::begin(kCommandNames), std::end(kCommandNames), response.first) ==
+        std::end(kCommandNames)) {
+      throw ScenarioException("fci_stand_in: unknown robot command " + response.first);
+    }
+  }
+  for (const Reflex& reflex : scenario_.reflexes) {
+    errorIndex(reflex.error);
+  }
+
+  // Resolve all statuses once, so that typos are reported before a client connects.
+  responseStatus<Connect>(scenario_, "Connect");
+  responseStatus<Move>(scenario_, "Move");
+  responseStatus<StopMove>(scenario_, "StopMove");
+  responseStatus<GetCartesianLimit>(scenario_, "GetCartesianLimit");
+  responseStatus<SetCollisionBehavior>(scenario_, "SetCollisionBehavior");
+  responseStatus<SetJointImpedance>(scenario_, "SetJointImpedance");
+  responseStatus<SetCartesianImpedance>(scenario_, "SetCartesianImpedance");
+  responseStatus<SetGuidingMode>(scenario_, "SetGuidingMode");
+  responseStatus<SetEEToK>(scenario_, "SetEEToK");
+  responseStatus<SetFToEE>(scenario_, "SetFToEE");
+  responseStatus<SetLoad>(scenario_, "SetLoad");
+  responseStatus<SetFilters>(scenario_, "SetFilters");
+  responseStatus<AutomaticErrorRecovery>(scenario_, "AutomaticErrorRecovery");
+  responseStatus<LoadModelLibrary>(scenario_, "LoadModelLibrary");
+}
+
+void RobotServer::run(const std::string& address, const std::atomic<bool>& running) {
+  Poco::Net::ServerSocket server;
+  server.bind({address, research_interface::robot::kCommandPort}, true);
+  server.listen();
+
+  while (running) {
+    if (!server.poll(Poco::Timespan(0, 100000), Poco::Net::Socket::SELECT_READ)) {
+      continue;
+    }
+    Poco::Net::SocketAddress remote_address;
+    Poco::Net::StreamSocket tcp_socket = server.acceptConnection(remote_address);
+    tcp_socket.setBlocking(true);
+    tcp_socket.setNoDelay(true);
+    std::cout << "Robot client connected from " << remote_address.toString() << std::endl;
+    try {
+      serve(tcp_socket, remote_address, running);
+    } catch (const Poco::Exception& e) {
+      std::cerr << "fci_stand_in: robot connection: " << e.displayText() << std::endl;
+    } catch (const ScenarioException& e) {
+      std::cerr << e.what() << std::endl;
+    }
+    std::cout << "Robot client disconnected" << std::endl;
+  }
+}
+
+void RobotServer::serve(Poco::Net::StreamSocket& tcp_socket,
+                        const Poco::Net::SocketAddress& remote_address,
+                        const std::atomic<bool>& running) {
+  RawMessage<Header> message;
+  if (!receiveMessage(tcp_socket, &message)) {
+    return;
+  }
+  if (message.header.command != Connect::kCommand) {
+    throw ScenarioException("fci_stand_in: expected Connect as first robot command");
+  }
+  Connect::Request connect_request = message.request<Connect>();
+  log_->request("robot", "Connect", message.header.command_id);
+  Connect::Status connect_status = responseStatus<Connect>(scenario_, "Connect");
+  sendResponse<Connect>(tcp_socket, message.header.command_id, Connect::Response(connect_status));
+  if (connect_status != Connect::Status::kSuccess) {
+    return;
+  }
+
+  Poco::Net::DatagramSocket udp_socket({tcp_socket.address().host(), 0});
+  Poco::Net::SocketAddress client_address(remote_address.host(), connect_request.udp_port);
+
+  state_ = research_interface::robot::RobotState{};
+  state_.robot_mode = RobotMode::kIdle;
+  state_.motion_generator_mode = MotionGeneratorMode::kIdle;
+  state_.controller_mode = ControllerMode::kJointImpedance;
+  state_.O_T_EE = kInitialPose;
+  state_.F_T_EE = {
+      {1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0}};
+  state_.EE_T_K = state_.F_T_EE;
+  moving_ = false;
+  has_command_ = false;
+  received_commands_ = 0.0;
+
+  size_t next_reflex = 0;
+  const auto start = std::chrono::steady_clock::now();
+  auto next_cycle = start;
+  while (running) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    const TimingProfile& timing =
+        scenario_.timingAt(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed));
+
+    while (tcp_socket.poll(Poco::Timespan(0), Poco::Net::Socket::SELECT_READ)) {
+      if (!receiveMessage(tcp_socket, &message)) {
+        return;
+      }
+      handleRequest(tcp_socket, message);
+    }
+
+    bool received = false;
+    while (udp_socket.available() > 0) {
+      research_interface::robot::RobotCommand command;
+      Poco::Net::SocketAddress sender;
+      if (udp_socket.receiveFrom(&command, sizeof(command), sender) ==
+          static_cast<int>(sizeof(command))) {
+        handleCommand(tcp_socket, command);
+        received = true;
+      }
+    }
+    received_commands_ = 0.99 * received_commands_ + (received ? 0.01 : 0.0);
+
+    while (next_reflex < scenario_.reflexes.size() &&
+           scenario_.reflexes[next_reflex].time <= elapsed) {
+      injectReflex(tcp_socket, scenario_.reflexes[next_reflex].error);
+      next_reflex++;
+    }
+
+    updateState(elapsed, timing.period);
+    state_.message_id++;
+    if (timing.drop_every == 0 || state_.message_id % timing.drop_every != 0) {
+      udp_socket.sendTo(&state_, sizeof(state_), client_address);
+    }
+
+    next_cycle += timing.period;
+    auto wakeup = next_cycle;
+    if (timing.jitter.count() > 0) {
+      std::uniform_int_distribution<int64_t> jitter(0, timing.jitter.count());
+      wakeup += std::chrono::microseconds(jitter(random_engine_));
+    }
+    std::this_thread::sleep_until(wakeup);
+  }
+}
+
+template <typename T>
+void RobotServer::respond(Poco::Net::StreamSocket& tcp_socket,
+                          uint32_t command_id,
+                          const char* name) {
+  log_->request("robot", name, command_id);
+  sendResponse<T>(tcp_socket, command_id,
+                  typename T::Response(responseStatus<T>(scenario_, name)));
+}
+
+void RobotServer::handleRequest(Poco::Net::StreamSocket& tcp_socket,
+                                const RawMessage<Header>& message) {
+  uint32_t command_id = message.header.command_id;
+  switch (message.header.command) {
+    case Move::kCommand:
+      startMotion(tcp_socket, command_id, message.request<Move>());
+      break;
+    case StopMove::kCommand: {
+      log_->request("robot", "StopMove", command_id);
+      StopMove::Status status = responseStatus<StopMove>(scenario_, "StopMove");
+      if (status == StopMove::Status::kSuccess && moving_) {
+        finishMotion(tcp_socket, Move::Status::kPreempted);
+      }
+      sendResponse<StopMove>(tcp_socket, command_id, StopMove::Response(status));
+      break;
+    }
+    case AutomaticErrorRecovery::kCommand: {
+      log_->request("robot", "AutomaticErrorRecovery", command_id);
+      AutomaticErrorRecovery::Status status =
+          responseStatus<AutomaticErrorRecovery>(scenario_, "AutomaticErrorRecovery");
+      if (status == AutomaticErrorRecovery::Status::kSuccess) {
+        state_.errors = {};
+        state_.robot_mode = RobotMode::kIdle;
+      }
+      sendResponse<AutomaticErrorRecovery>(tcp_socket, command_id,
+                                           AutomaticErrorRecovery::Response(status));
+      break;
+    }
+    case LoadModelLibrary::kCommand: {
+      log_->request("robot", "LoadModelLibrary", command_id);
+      LoadModelLibrary::Status status =
+          responseStatus<LoadModelLibrary>(scenario_, "LoadModelLibrary");
+      std::vector<uint8_t> library;
+      if (status == LoadModelLibrary::Status::kSuccess) {
+        if (scenario_.model_library.empty()) {
+          std::cerr << "fci_stand_in: no model library given in scenario" << std::endl;
+          status = LoadModelLibrary::Status::kError;
+        } else {
+          library = readFile(scenario_.model_library);
+        }
+      }
+      sendResponse<LoadModelLibrary>(tcp_socket, command_id, LoadModelLibrary::Response(status),
+                                     library);
+      break;
+    }
+    case GetCartesianLimit::kCommand:
+      log_->request("robot", "GetCartesianLimit", command_id);
+      sendResponse<GetCartesianLimit>(
+          tcp_socket, command_id,
+          GetCartesianLimit::Response(
+              responseStatus<GetCartesianLimit>(scenario_, "GetCartesianLimit"),
+              std::array<double, 3>{}, std::array<double, 16>{}, false));
+      break;
+    case SetCollisionBehavior::kCommand:
+      respond<SetCollisionBehavior>(tcp_socket, command_id, "SetCollisionBehavior");
+      break;
+    case SetJointImpedance::kCommand:
+      respond<SetJointImpedance>(tcp_socket, command_id, "SetJointImpedance");
+      break;
+    case SetCartesianImpedance::kCommand:
+      respond<SetCartesianImpedance>(tcp_socket, command_id, "SetCartesianImpedance");
+      break;
+    case SetGuidingMode::kCommand:
+      respond<SetGuidingMode>(tcp_socket, command_id, "SetGuidingMode");
+      break;
+    case SetEEToK::kCommand:
+      respond<SetEEToK>(tcp_socket, command_id, "SetEEToK");
+      break;
+    case SetFToEE::kCommand:
+      respond<SetFToEE>(tcp_socket, command_id, "SetFToEE");
+      break;
+    case SetLoad::kCommand:
+      respond<SetLoad>(tcp_socket, command_id, "SetLoad");
+      break;
+    case SetFilters::kCommand:
+      respond<SetFilters>(tcp_socket, command_id, "SetFilters");
+      break;
+    default:
+      throw ScenarioException("fci_stand_in: unsupported robot command " +
+                              std::to_string(static_cast<uint32_t>(message.header.command)));
+  }
+}
+
+void RobotServer::startMotion(Poco::Net::StreamSocket& tcp_socket,
+                              uint32_t command_id,
+                              const Move::Request& request) {
+  log_->request("robot", "Move", command_id);
+  Move::Status status = responseStatus<Move>(scenario_, "Move");
+  if (status == Move::Status::kSuccess && state_.robot_mode != RobotMode::kIdle) {
+    status = Move::Status::kCommandNotPossibleRejected;
+  }
+  if (status != Move::Status::kSuccess) {
+    sendResponse<Move>(tcp_socket, command_id, Move::Response(status));
+    return;
+  }
+
+  switch (request.motion_generator_mode) {
+    case Move::MotionGeneratorMode::kJointPosition:
+      state_.motion_generator_mode = MotionGeneratorMode::kJointPosition;
+      break;
+    case Move::MotionGeneratorMode::kJointVelocity:
+      state_.motion_generator_mode = MotionGeneratorMode::kJointVelocity;
+      break;
+    case Move::MotionGeneratorMode::kCartesianPosition:
+      state_.motion_generator_mode = MotionGeneratorMode::kCartesianPosition;
+      break;
+    case Move::MotionGeneratorMode::kCartesianVelocity:
+      state_.motion_generator_mode = MotionGeneratorMode::kCartesianVelocity;
+      break;
+  }
+  switch (request.controller_mode) {
+    case Move::ControllerMode::kJointImpedance:
+      state_.controller_mode = ControllerMode::kJointImpedance;
+      break;
+    case Move::ControllerMode::kCartesianImpedance:
+      state_.controller_mode = ControllerMode::kCartesianImpedance;
+      break;
+    case Move::ControllerMode::kExternalController:
+      state_.controller_mode = ControllerMode::kExternalController;
+      break;
+  }
+
+  sendResponse<Move>(tcp_socket, command_id, Move::Response(Move::Status::kMotionStarted));
+  state_.robot_mode = RobotMode::kMove;
+  state_.reflex_reason = {};
+  moving_ = true;
+  has_command_ = false;
+  move_command_id_ = command_id;
+}
+
+void RobotServer::finishMotion(Poco::Net::StreamSocket& tcp_socket, Move::Status status) {
+  sendResponse<Move>(tcp_socket, move_command_id_, Move::Response(status));
+  state_.robot_mode = RobotMode::kIdle;
+  state_.motion_generator_mode = MotionGeneratorMode::kIdle;
+  state_.controller_mode = ControllerMode::kJointImpedance;
+  moving_ = false;
+}
+
+void RobotServer::handleCommand(Poco::Net::StreamSocket& tcp_socket,
+                                const research_interface::robot::RobotCommand& command) {
+  log_->robotCommand(command);
+  if (!moving_) {
+    return;
+  }
+  last_command_ = command;
+  has_command_ = true;
+  if (command.motion.motion_generation_finished) {
+    finishMotion(tcp_socket, Move::Status::kSuccess);
+  }
+}
+
+void RobotServer::injectReflex(Poco::Net::StreamSocket& tcp_socket, const std::string& error) {
+  size_t index = errorIndex(error);
+  std::cout << "Injecting reflex " << error << std::endl;
+  state_.errors[index] = true;
+  state_.reflex_reason[index] = true;
+  if (moving_) {
+    finishMotion(tcp_socket, Move::Status::kReflexAborted);
+  }
+  state_.robot_mode = RobotMode::kReflex;
+}
+
+void RobotServer::updateState(std::chrono::duration<double> time,
+                              std::chrono::duration<double> period) {
+  const research_interface::robot::MotionGeneratorCommand& motion = last_command_.motion;
+  if (!moving_) {
+    for (size_t i = 0; i < state_.q.size(); i++) {
+      const JointGenerator& joint = scenario_.joints[i];
+      double phase = 2.0 * M_PI * joint.frequency * time.count();
+      state_.q[i] = joint.offset + joint.amplitude * std::sin(phase);
+      state_.dq[i] = 2.0 * M_PI * joint.frequency * joint.amplitude * std::cos(phase);
+    }
+  } else if (scenario_.track_commands && has_command_) {
+    switch (state_.motion_generator_mode) {
+      case MotionGeneratorMode::kJointPosition:
+        for (size_t i = 0; i < state_.q.size(); i++) {
+          state_.dq[i] = (motion.q_c[i] - state_.q[i]) / period.count();
+        }
+        state_.q = motion.q_c;
+        break;
+      case MotionGeneratorMode::kJointVelocity:
+        for (size_t i = 0; i < state_.q.size(); i++) {
+          state_.q[i] += motion.dq_c[i] * period.count();
+        }
+        state_.dq = motion.dq_c;
+        break;
+      case MotionGeneratorMode::kCartesianPosition:
+        state_.O_T_EE = motion.O_T_EE_c;
+        break;
+      case MotionGeneratorMode::kCartesianVelocity:
+        for (size_t i = 0; i < 3; i++) {
+          state_.O_T_EE[12 + i] += motion.O_dP_EE_c[i] * period.count();
+        }
+        state_.O_dP_EE_d = motion.O_dP_EE_c;
+        break;
+      default:
+        break;
+    }
+    if (state_.controller_mode == ControllerMode::kExternalController) {
+      state_.tau_J_d = last_command_.control.tau_J_d;
+      state_.tau_J = last_command_.control.tau_J_d;
+    }
+  }
+
+  state_.q_d = state_.q;
+  state_.dq_d = state_.dq;
+  state_.O_T_EE_d = state_.O_T_EE;
+  state_.O_T_EE_c = state_.O_T_EE;
+  state_.elbow = {{state_.q[2], -1.0}};
+  state_.elbow_d = state_.elbow;
+  state_.elbow_c = state_.elbow;
+  state_.O_F_ext_hat_K = scenario_.external_wrench;
+  state_.K_F_ext_hat_K = scenario_.external_wrench;
+  state_.control_command_success_rate = received_commands_;
+}
+
+}  // namespace stand_in
+}  // namespace franka
@@ -0,0 +1,68 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <Poco/Net/DatagramSocket.h>
+#include <Poco/Net/StreamSocket.h>
+#include <research_interface/robot/rbk_types.h>
+#include <research_interface/robot/service_types.h>
+
+#include "command_log.h"
+#include "protocol.h"
+#include "scenario.h"
+
+namespace franka {
+namespace stand_in {
+
+// Serves one robot client at a time on the robot command port.
+//
+// Robot states are streamed with the timing of the scenario. Joint positions come from the
+// scenario generators until a motion is started; with command tracking, the state then follows
+// the commands of the client. Reflexes are injected at the configured times after connecting.
+class RobotServer {
+ public:
+  RobotServer(const Scenario& scenario, CommandLog* log);
+
+  // Accepts and serves clients until running becomes false.
+  void run(const std::string& address, const std::atomic<bool>& running);
+
+ private:
+  using Header = research_interface::robot::CommandHeader;
+
+  void serve(Poco::Net::StreamSocket& tcp_socket,
+             const Poco::Net::SocketAddress& remote_address,
+             const std::atomic<bool>& running);
+  void handleRequest(Poco::Net::StreamSocket& tcp_socket, const RawMessage<Header>& message);
+  void handleCommand(Poco::Net::StreamSocket& tcp_socket,
+                     const research_interface::robot::RobotCommand& command);
+  void startMotion(Poco::Net::StreamSocket& tcp_socket,
+                   uint32_t command_id,
+                   const research_interface::robot::Move::Request& request);
+  void finishMotion(Poco::Net::StreamSocket& tcp_socket,
+                    research_interface::robot::Move::Status status);
+  void injectReflex(Poco::Net::StreamSocket& tcp_socket, const std::string& error);
+  void updateState(std::chrono::duration<double> time, std::chrono::duration<double> period);
+
+  template <typename T>
+  void respond(Poco::Net::StreamSocket& tcp_socket, uint32_t command_id, const char* name);
+
+  const Scenario& scenario_;
+  CommandLog* log_;
+  std::mt19937 random_engine_;
+
+  research_interface::robot::RobotState state_{};
+  research_interface::robot::RobotCommand last_command_{};
+  bool has_command_{false};
+  bool moving_{false};
+  uint32_t move_command_id_{0};
+  double received_commands_{0.0};
+};
+
+}  // namespace stand_in
+}  // namespace franka
@@ -0,0 +1,158 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#include "scenario.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace franka {
+namespace stand_in {
+
+namespace {
+
+class LineParser {
+ public:
+  LineParser(const std::string& line, size_t number) : stream_(line), number_(number) {}
+
+  template <typename T>
+  T next(const char* what) {
+    T value;
+    if (!(stream_ >> value)) {
+      fail(std::string("expected ") + what);
+    }
+    return value;
+  }
+
+  template <typename T>
+  T optional(T default_value) {
+    if ((stream_ >> std::ws).eof()) {
+      return default_value;
+    }
+    return next<T>("number");
+  }
+
+  bool flag() {
+    std::string value = next<std::string>("on or off");
+    if (value != "on" && value != "off") {
+      fail("expected on or off, got " + value);
+    }
+    return value == "on";
+  }
+
+  void finish() {
+    std::string rest;
+    if (stream_ >> rest) {
+      fail("unexpected " + rest);
+    }
+  }
+
+  [[noreturn]] void fail(const std::string& message) const {
+    throw ScenarioException("fci_stand_in: scenario line " + std::to_string(number_) + ": " +
+                            message);
+  }
+
+ private:
+  std::istringstream stream_;
+  size_t number_;
+};
+
+}  // anonymous namespace
+
+const TimingProfile& Scenario::timingAt(std::chrono::milliseconds time) const noexcept {
+  auto it = std::upper_bound(timing.cbegin(), timing.cend(), time,
+                             [](std::chrono::milliseconds lhs, const TimingProfile& rhs) {
+                               return lhs < rhs.start;
+                             });
+  return it == timing.cbegin() ? *it : *(it - 1);
+}
+
+std::string Scenario::responseFor(const std::string& command) const {
+  auto it = responses.find(command);
+  return it != responses.cend() ? it->second : "success";
+}
+
+Scenario parseScenario(std::istream& input) {
+  Scenario scenario;
+  bool has_timing = false;
+
+  std::string line;
+  for (size_t number = 1; std::getline(input, line); number++) {
+    line = line.substr(0, line.find('#'));
+    LineParser parser(line, number);
+    std::string directive = parser.optional<std::string>("");
+    if (directive.empty()) {
+      continue;
+    }
+
+    if (directive == "timing") {
+      TimingProfile profile;
+      profile.start = std::chrono::milliseconds(parser.next<int64_t>("start time"));
+      profile.period = std::chrono::microseconds(parser.next<int64_t>("period"));
+      profile.jitter = std::chrono::microseconds(parser.optional<int64_t>(0));
+      profile.drop_every = parser.optional<uint32_t>(0);
+      if (profile.period.count() <= 0 || profile.jitter.count() < 0) {
+        parser.fail("period must be positive and jitter must not be negative");
+      }
+      if (!has_timing) {
+        scenario.timing.clear();
+        has_timing = true;
+      }
+      if (!scenario.timing.empty() && profile.start <= scenario.timing.back().start) {
+        parser.fail("timing profiles must be ordered by start time");
+      }
+      scenario.timing.push_back(profile);
+    } else if (directive == "joint") {
+      size_t index = parser.next<size_t>("joint index");
+      if (index >= scenario.joints.size()) {
+        parser.fail("joint index out of range");
+      }
+      std::string type = parser.next<std::string>("generator type");
+      JointGenerator generator;
+      if (type == "constant") {
+        generator.offset = parser.next<double>("position");
+      } else if (type == "sine") {
+        generator.offset = parser.next<double>("offset");
+        generator.amplitude = parser.next<double>("amplitude");
+        generator.frequency = parser.next<double>("frequency");
+      } else {
+        parser.fail("unknown generator type " + type);
+      }
+      scenario.joints[index] = generator;
+    } else if (directive == "external_wrench") {
+      for (double& value : scenario.external_wrench) {
+        value = parser.next<double>("wrench component");
+      }
+    } else if (directive == "track_commands") {
+      scenario.track_commands = parser.flag();
+    } else if (directive == "response") {
+      std::string command = parser.next<std::string>("command name");
+      scenario.responses[command] = parser.next<std::string>("status name");
+    } else if (directive == "reflex") {
+      Reflex reflex;
+      reflex.time = std::chrono::milliseconds(parser.next<int64_t>("time"));
+      reflex.error = parser.next<std::string>("error name");
+      scenario.reflexes.push_back(reflex);
+    } else if (directive == "model_library") {
+      scenario.model_library = parser.next<std::string>("path");
+    } else if (directive == "gripper") {
+      scenario.gripper = parser.flag();
+    } else if (directive == "gripper_period") {
+      scenario.gripper_period = std::chrono::microseconds(parser.next<int64_t>("period"));
+      if (scenario.gripper_period.count() <= 0) {
+        parser.fail("period must be positive");
+      }
+    } else if (directive == "gripper_max_width") {
+      scenario.gripper_max_width = parser.next<double>("width");
+    } else {
+      parser.fail("unknown directive " + directive);
+    }
+    parser.finish();
+  }
+
+  std::stable_sort(scenario.reflexes.begin(), scenario.reflexes.end(),
+                   [](const Reflex& lhs, const Reflex& rhs) { return lhs.time < rhs.time; });
+  return scenario;
+}
+
+}  // namespace stand_in
+}  // namespace franka
@@ -0,0 +1,83 @@
+// Copyright (c) 2018 Franka Emika GmbH
+// Use of this source code is governed by the Apache-2.0 license, see LICENSE
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace franka {
+namespace stand_in {
+
+class ScenarioException : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// Timing of the state stream, active from `start` until the next profile starts.
+struct TimingProfile {
+  std::chrono::milliseconds start{0};
+  std::chrono::microseconds period{1000};
+  std::chrono::microseconds jitter{0};
+  // Every n-th state is not sent. Zero sends all states.
+  uint32_t drop_every{0};
+};
+
+// q(t) = offset + amplitude * sin(2 * pi * frequency * t)
+struct JointGenerator {
+  double offset{0.0};
+  double amplitude{0.0};
+  double frequency{0.0};
+};
+
+struct Reflex {
+  std::chrono::milliseconds time{0};
+  std::string error;
+};
+
+struct Scenario {
+  std::vector<TimingProfile> timing{TimingProfile()};
+  std::array<JointGenerator, 7> joints{};
+  std::array<double, 6> external_wrench{};
+  // Follow the commands of running motions instead of the generators.
+  bool track_commands{true};
+  // Maps command names, prefixed with "gripper." for gripper commands, to response status names.
+  std::map<std::string, std::string> responses;
+  std::vector<Reflex> reflexes;
+  std::string model_library;
+
+  bool gripper{false};
+  std::chrono::microseconds gripper_period{20000};
+  double gripper_max_width{0.08};
+
+  // Returns the timing profile active at the given time since the client connected.
+  const TimingProfile& timingAt(std::chrono::milliseconds time) const noexcept;
+
+  // Returns the status name configured for a command, or "success".
+  std::string responseFor(const std::string& command) const;
+};
+
+// Parses a scenario description. Each line holds one directive, '#' starts a comment:
+//
+//   timing <start-ms> <period-us> [<jitter-us> [<drop-every>]]
+//   joint <index> constant <position>
+//   joint <index> sine <offset> <amplitude> <frequency-hz>
+//   external_wrench <fx> <fy> <fz> <tx> <ty> <tz>
+//   track_commands on|off
+//   response [gripper.]<command> <status>
+//   reflex <time-ms> <error>
+//   model_library <path>
+//   gripper on|off
+//   gripper_period <period-us>
+//   gripper_max_width <width>
+//
+// Throws ScenarioException with the offending line number on syntax errors.
+Scenario parseScenario(std::istream& input);
+
+}  // namespace stand_in
+}  // namespace franka